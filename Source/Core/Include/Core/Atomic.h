@@ -0,0 +1,119 @@
+//======================================================================================
+//! @file         Atomic.h
+//! @brief        Atomic integer operations for values shared between threads
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+
+#ifndef CORE_ATOMIC_H
+#define CORE_ATOMIC_H
+
+#include <windows.h>
+#include "Core/BasicTypes.h"
+
+
+//namespace Core
+namespace Core
+{
+
+	//! Integer that can be safely modified by several threads at once,
+	//! using the Atomic functions below
+	typedef volatile Long AtomicLong;
+
+
+	inline Long AtomicIncrement ( AtomicLong& value ) throw();
+	inline Long AtomicDecrement ( AtomicLong& value ) throw();
+	inline Long AtomicExchange  ( AtomicLong& target, Long value ) throw();
+	inline Long AtomicRead		( AtomicLong& value ) throw();
+
+
+
+    //=========================================================================
+    //! @function    Core::AtomicIncrement
+    //! @brief       Increment a value shared between threads
+    //!              
+    //! @param       value [in/out] Value to increment
+    //!              
+    //! @return      The incremented value
+    //=========================================================================
+	Long AtomicIncrement ( AtomicLong& value )
+	{
+		return InterlockedIncrement ( &value );
+	}
+	//End Core::AtomicIncrement
+
+
+    //=========================================================================
+    //! @function    Core::AtomicDecrement
+    //! @brief       Decrement a value shared between threads
+    //!              
+    //! @param       value [in/out] Value to decrement
+    //!              
+    //! @return      The decremented value
+    //=========================================================================
+	Long AtomicDecrement ( AtomicLong& value )
+	{
+		return InterlockedDecrement ( &value );
+	}
+	//End Core::AtomicDecrement
+
+
+    //=========================================================================
+    //! @function    Core::AtomicExchange
+    //! @brief       Set a value shared between threads
+    //!              
+    //!				 Acts as a full memory barrier, so any writes made before the exchange
+    //!				 are visible to a thread that sees the new value
+    //!
+    //! @param       target [in/out] Value to set
+    //! @param       value	[in]	 New value
+    //!              
+    //! @return      The previous value of target
+    //=========================================================================
+	Long AtomicExchange ( AtomicLong& target, Long value )
+	{
+		return InterlockedExchange ( &target, value );
+	}
+	//End Core::AtomicExchange
+
+
+    //=========================================================================
+    //! @function    Core::AtomicRead
+    //! @brief       Read a value shared between threads, with a full memory barrier
+    //!              
+    //! @param       value [in] Value to read
+    //!              
+    //! @return      The current value
+    //=========================================================================
+	Long AtomicRead ( AtomicLong& value )
+	{
+		return InterlockedCompareExchange ( &value, 0, 0 );
+	}
+	//End Core::AtomicRead
+
+};
+//end namespace Core
+
+#endif //CORE_ATOMIC_H
@@ -93,6 +93,11 @@
 #			define CORE_PARTIAL_TEMPLATE_SPECIALISATION		1
 #		endif
 
+//SSE2 intrinsics can be used if the compiler is generating SSE2 code (/arch:SSE2)
+#		if defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#			define CORE_SSE2	1
+#		endif
+
 #	endif
 //=========================================================================
 // End MS Visual Studio specific
@@ -60,8 +60,10 @@ namespace Core
 	class ConsoleCommandLine;
 	class OConsoleBuf;
 	class ConsoleOutputEvent;
+	class ConsoleVariableEvent;
 	class EventConnection;
 	class IConsoleOutputListener;
+	class IConsoleVariableListener;
 
 
 	//Public types
@@ -115,6 +117,7 @@ namespace Core
 
 			//Event handlers
 			EventConnection AddOutputListener ( IConsoleOutputListener& listener ) throw();
+			EventConnection AddVariableListener ( IConsoleVariableListener& listener ) throw();
 
 		private:
 
@@ -162,6 +165,7 @@ namespace Core
 
 			//Event handlers
 			boost::shared_ptr<ConsoleOutputEvent> m_outputEvent;
+			boost::shared_ptr<ConsoleVariableEvent> m_variableEvent;
 
 			//Stores the old versions of the standard streams' buffers
 			//so they can be restored
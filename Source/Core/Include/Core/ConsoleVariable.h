@@ -68,6 +68,13 @@ namespace Core
 
 			inline const boost::any& GetValue() const;
 
+			//Typed copies of the value, for code that reads the variable every frame.
+			//The addresses stay valid for the life of the variable
+			inline const Int*	IntStorage() const;
+			inline const UInt*	UIntStorage() const;
+			inline const bool*	BoolStorage() const;
+			inline const Float* FloatStorage() const;
+
 			//Mutators
 			inline void	SetInt( Int value );
 			inline void	SetUInt( UInt value );
@@ -82,10 +89,18 @@ namespace Core
 
 		private:
 
+			inline bool Assign ( const boost::any& value );
+			inline void UpdateStorage ( );
+
 			//Private data
 			UInt		m_nameHash;
 			std::string m_name;
 			boost::any  m_value;
+
+			Int			m_intStorage;
+			UInt		m_uintStorage;
+			bool		m_boolStorage;
+			Float		m_floatStorage;
 	};
 	//end class ConsoleVariable
 
@@ -245,6 +260,54 @@ namespace Core
 	//end ConsoleVariable::GetValue
 
 
+	//=========================================================================
+    //! @function    ConsoleVariable::IntStorage
+    //! @return      Address of the variable's value, if it is an Int
+    //=========================================================================
+	const Int* ConsoleVariable::IntStorage() const
+	{
+		debug_assert ( IsInt(), "Console variable isn't an Int" );
+		return &m_intStorage;
+	}
+	//end ConsoleVariable::IntStorage
+
+
+	//=========================================================================
+    //! @function    ConsoleVariable::UIntStorage
+    //! @return      Address of the variable's value, if it is a UInt
+    //=========================================================================
+	const UInt* ConsoleVariable::UIntStorage() const
+	{
+		debug_assert ( IsUInt(), "Console variable isn't a UInt" );
+		return &m_uintStorage;
+	}
+	//end ConsoleVariable::UIntStorage
+
+
+	//=========================================================================
+    //! @function    ConsoleVariable::BoolStorage
+    //! @return      Address of the variable's value, if it is a bool
+    //=========================================================================
+	const bool* ConsoleVariable::BoolStorage() const
+	{
+		debug_assert ( IsBool(), "Console variable isn't a bool" );
+		return &m_boolStorage;
+	}
+	//end ConsoleVariable::BoolStorage
+
+
+	//=========================================================================
+    //! @function    ConsoleVariable::FloatStorage
+    //! @return      Address of the variable's value, if it is a Float
+    //=========================================================================
+	const Float* ConsoleVariable::FloatStorage() const
+	{
+		debug_assert ( IsFloat(), "Console variable isn't a Float" );
+		return &m_floatStorage;
+	}
+	//end ConsoleVariable::FloatStorage
+
+
 	//=========================================================================
     //! @function    ConsoleVariable::SetInt
     //! @return      Set the value of the variable to an integer
@@ -252,6 +315,7 @@ namespace Core
 	void ConsoleVariable::SetInt( Int value )
 	{
 		m_value = value;
+		UpdateStorage();
 	}
 	//end ConsoleVariable::SetInt
 
@@ -263,6 +327,7 @@ namespace Core
 	void ConsoleVariable::SetUInt( UInt value )
 	{
 		m_value = value;
+		UpdateStorage();
 	}
 	//end ConsoleVariable::SetUInt
 
@@ -274,6 +339,7 @@ namespace Core
 	void ConsoleVariable::SetBool( bool value )
 	{
 		m_value = value;
+		UpdateStorage();
 	}
 	//end ConsoleVariable::SetBool
 
@@ -285,6 +351,7 @@ namespace Core
 	void ConsoleVariable::SetFloat( Float value )
 	{
 		m_value = value;
+		UpdateStorage();
 	}
 	//end ConsoleVariable::SetFloat
 
@@ -295,23 +362,41 @@ namespace Core
     //=========================================================================
 	void ConsoleVariable::SetString( const std::string& value )
 	{
-		std::string* valueAsString = boost::any_cast<std::string*>(m_value);
-		*valueAsString = value;
+		*boost::any_cast<std::string>(&m_value) = value;
 	}
 	//end ConsoleVariable::SetString
 
 
     //=========================================================================
     //! @function    ConsoleVariable::Set
-    //! @brief       
-    //!              
+    //! @brief       Set the variable from a value of a compatible type
     //!              
     //! @param       value	[in] Value to set 
     //!              
-    //! @return      
-    //! @throw       
+    //! @return      true if the value was compatible, and was set
     //=========================================================================
 	bool ConsoleVariable::Set ( const boost::any& value )
+	{
+		if ( !Assign ( value ) )
+		{
+			return false;
+		}
+
+		UpdateStorage();
+		return true;
+	}
+	//end ConsoleVariable::Set
+
+
+    //=========================================================================
+    //! @function    ConsoleVariable::Assign
+    //! @brief       Convert value to the type of the variable, and store it
+    //!              
+    //! @param       value	[in] Value to set 
+    //!              
+    //! @return      true if the value was compatible, and was set
+    //=========================================================================
+	bool ConsoleVariable::Assign ( const boost::any& value )
 	{
 		if ( m_value.empty() )
 		{
@@ -435,7 +520,33 @@ namespace Core
 		debug_error ( "Shouldn't get here!!" );
 		return false;
 	}
-	//end ConsoleVariable::Set
+	//end ConsoleVariable::Assign
+
+
+    //=========================================================================
+    //! @function    ConsoleVariable::UpdateStorage
+    //! @brief       Copy the value into the typed storage that matches its type
+    //=========================================================================
+	void ConsoleVariable::UpdateStorage ( )
+	{
+		if ( IsInt() )
+		{
+			m_intStorage = GetInt();
+		}
+		else if ( IsUInt() )
+		{
+			m_uintStorage = GetUInt();
+		}
+		else if ( IsBool() )
+		{
+			m_boolStorage = GetBool();
+		}
+		else if ( IsFloat() )
+		{
+			m_floatStorage = GetFloat();
+		}
+	}
+	//end ConsoleVariable::UpdateStorage
 
 
 	//=========================================================================
@@ -47,16 +47,20 @@ namespace Core
 {
 
 	//! Console variable storing a Float
+	//!
+	//! The numeric and bool helpers keep a pointer to the variable's typed storage,
+	//! so reading one is a single load. Constructing one registers the variable
+	//! with the console, which hashes the name and searches the variable map, so
+	//! in code that runs every frame they should be function statics
 	class ConsoleFloat
 	{
 		public:
 
 			ConsoleFloat ( const Char* name, Float value );
 
-			operator Float()				 
+			operator Float() const
 			{ 
-				assert(m_variable);
-				return m_variable->GetFloat(); 
+				return *m_value; 
 			}
 
 			Float operator = ( Float value )
@@ -77,6 +81,7 @@ namespace Core
 		private:
 
 			boost::shared_ptr<ConsoleVariable> m_variable;
+			const Float* m_value;
 			
 	};
 	//end class ConsoleFloat
@@ -89,10 +94,9 @@ namespace Core
 			
 			ConsoleInt ( const Char* name, Int value );
 
-			operator Int()				 
+			operator Int() const
 			{ 
-				assert(m_variable);
-				return m_variable->GetInt(); 
+				return *m_value; 
 			}
 
 			Int operator = ( Int value )
@@ -113,6 +117,7 @@ namespace Core
 		private:
 
 			boost::shared_ptr<ConsoleVariable> m_variable;
+			const Int* m_value;
 			
 	};
 	//end class ConsoleInt
@@ -125,10 +130,9 @@ namespace Core
 
 			ConsoleUInt ( const Char* name, UInt value );
 
-			operator UInt()				 
+			operator UInt() const
 			{ 
-				assert(m_variable);
-				return m_variable->GetUInt(); 
+				return *m_value; 
 			}
 
 			UInt operator = ( UInt value )
@@ -149,6 +153,7 @@ namespace Core
 		private:
 
 			boost::shared_ptr<ConsoleVariable> m_variable;
+			const UInt* m_value;
 			
 	};
 	//end class ConsoleUInt
@@ -161,10 +166,9 @@ namespace Core
 
 			ConsoleBool ( const Char* name, bool value );
 
-			operator bool()				 
+			operator bool() const
 			{ 
-				assert(m_variable);
-				return m_variable->GetBool(); 
+				return *m_value; 
 			}
 
 			bool operator = ( bool value )
@@ -185,6 +189,7 @@ namespace Core
 		private:
 
 			boost::shared_ptr<ConsoleVariable> m_variable;
+			const bool* m_value;
 			
 	};
 	//end class Consolebool
@@ -0,0 +1,110 @@
+//======================================================================================
+//! @file         ConsoleVariableListener.h
+//! @brief        IConsoleVariableListener interface, and related event classes,
+//!               ConsoleVariableEvent, and ConsoleVariableEventHandler.
+//!               
+//!               The IConsoleVariableListener Interface allows objects to
+//!               be notified when a console variable is changed from the console
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+#ifndef CORE_CONSOLEVARIABLELISTENER_H
+#define CORE_CONSOLEVARIABLELISTENER_H
+
+
+#include "Core/Event.h"
+#include "Core/EventHandler.h"
+
+
+//namespace Core
+namespace Core
+{
+
+	class ConsoleVariable;
+
+
+	//!@class	IConsoleVariableListener
+	//!@brief	IConsoleVariableListener interface. Interface that allows objects to
+	//!         be notified when a variable is set from the console, or from a config file
+	class IConsoleVariableListener
+	{
+		public:
+
+			virtual void OnConsoleVariableChanged ( const ConsoleVariable& variable ) = 0;
+	
+	};
+	//end class IConsoleVariableListener
+
+
+	//!@class	ConsoleVariableEventHandler
+	//!@brief	Class which binds a ConsoleVariableEvent to an object implementing IConsoleVariableListener
+	class ConsoleVariableEventHandler : public EventHandler<IConsoleVariableListener>,
+										public IConsoleVariableListener
+	{
+		public:
+
+			ConsoleVariableEventHandler ( IConsoleVariableListener& listener )
+				: EventHandler<IConsoleVariableListener>(listener)
+			{
+			}
+
+			void OnConsoleVariableChanged ( const ConsoleVariable& variable ) throw()
+			{
+				GetReciever().OnConsoleVariableChanged( variable );
+			}
+	};
+	//End ConsoleVariableEventHandler
+
+
+	//!@class	ConsoleVariableEvent
+	//!@brief	Event class, triggered when a console variable is set from the console
+	class ConsoleVariableEvent : public Event<ConsoleVariableEventHandler, IConsoleVariableListener>,
+								 public IConsoleVariableListener
+	{
+		public:
+
+			void OnConsoleVariableChanged ( const ConsoleVariable& variable )
+			{
+				HandlerStore::iterator current = m_handlers.begin();
+				HandlerStore::iterator end = m_handlers.end();
+
+				for ( ; current != end; ++current )
+				{
+					//If current isn't an empty slot, then
+					//update it
+					if (current->get())
+					{
+						(*current)->OnConsoleVariableChanged ( variable );
+					}
+				}
+			}
+	
+	};
+	//End class ConsoleVariableEvent
+
+}
+//end namespace Core
+
+
+#endif
+//#ifndef CORE_CONSOLEVARIABLELISTENER_H
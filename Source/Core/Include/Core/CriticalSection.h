@@ -0,0 +1,133 @@
+//======================================================================================
+//! @file         CriticalSection.h
+//! @brief        Wrapper for a Win32 critical section, and a scoped lock to go with it
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+#ifndef CORE_CRITICALSECTION_H
+#define CORE_CRITICALSECTION_H
+
+#include <windows.h>
+#include <boost/noncopyable.hpp>
+
+
+//namespace Core
+namespace Core
+{
+
+	//! @class	CriticalSection
+	//! @brief	Mutual exclusion object for synchronising threads within the same process
+	class CriticalSection : public boost::noncopyable
+	{
+		public:
+
+			//Constructor/Destructor
+			inline CriticalSection ( ) throw();
+			inline ~CriticalSection ( ) throw();
+
+			//Lock/Unlock
+			inline void Lock ( ) throw();
+			inline void Unlock ( ) throw();
+
+		private:
+
+			CRITICAL_SECTION m_criticalSection;
+	};
+	//end class CriticalSection
+
+
+
+	//! @class	ScopedLock
+	//! @brief	Locks a critical section for the lifetime of the object
+	class ScopedLock : public boost::noncopyable
+	{
+		public:
+
+			explicit ScopedLock ( CriticalSection& section ) throw()
+				: m_section(section)
+			{
+				m_section.Lock();
+			}
+
+			~ScopedLock ( ) throw()
+			{
+				m_section.Unlock();
+			}
+
+		private:
+
+			CriticalSection& m_section;
+	};
+	//end class ScopedLock
+
+
+
+    //=========================================================================
+    //! @function    CriticalSection::CriticalSection
+    //! @brief       CriticalSection constructor
+    //=========================================================================
+	CriticalSection::CriticalSection ( )
+	{
+		InitializeCriticalSection ( &m_criticalSection );
+	}
+	//End CriticalSection::CriticalSection
+
+
+    //=========================================================================
+    //! @function    CriticalSection::~CriticalSection
+    //! @brief       CriticalSection destructor
+    //=========================================================================
+	CriticalSection::~CriticalSection ( )
+	{
+		DeleteCriticalSection ( &m_criticalSection );
+	}
+	//End CriticalSection::~CriticalSection
+
+
+    //=========================================================================
+    //! @function    CriticalSection::Lock
+    //! @brief       Enter the critical section, blocking if another thread owns it
+    //=========================================================================
+	void CriticalSection::Lock ( )
+	{
+		EnterCriticalSection ( &m_criticalSection );
+	}
+	//End CriticalSection::Lock
+
+
+    //=========================================================================
+    //! @function    CriticalSection::Unlock
+    //! @brief       Leave the critical section
+    //=========================================================================
+	void CriticalSection::Unlock ( )
+	{
+		LeaveCriticalSection ( &m_criticalSection );
+	}
+	//End CriticalSection::Unlock
+
+};
+//end namespace Core
+
+#endif //CORE_CRITICALSECTION_H
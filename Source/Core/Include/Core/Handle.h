@@ -43,6 +43,9 @@ namespace Core
 	template <class T>
 		class ResourceManager;
 
+	template <class T>
+		class BorrowedHandle;
+
 	//Exception classes
 	class NullHandleDereference : public RuntimeError
 	{
@@ -88,6 +91,7 @@ namespace Core
 
 			//Friends
 			friend class HandleManager;
+			friend class BorrowedHandle<T>;
 
 			//Accessors
 			UInt Index ( ) const throw()		{ return m_index;		}
@@ -97,6 +101,9 @@ namespace Core
 			//! Check if handle is null
 			inline bool IsNull ( ) const throw();
 
+			//! Exchange the resources referred to by two handles, without touching either reference count
+			inline void Swap ( Handle& handle ) throw();
+
 			//Safe dereferencing.
 			inline T*			SafeDereference();
 			inline const T*		SafeDereference() const;
@@ -277,7 +284,9 @@ namespace Core
 	template <class T>
 		Handle<T>& Handle<T>::operator = ( const NullHandle& null )
 	{
-		m_value = 0;
+		//Swap the resource into a temporary, which releases it on destruction
+		Handle<T> oldHandle;
+		Swap ( oldHandle );
 
 		return *this;
 	}
@@ -316,7 +325,8 @@ namespace Core
 	//=========================================================================
 	//! @function    Resources::Handle<T>::operator =
 	//! @brief       Set the handle to the value of another handle
-	//!				 Incrementing the reference count of the handle
+	//!				 Incrementing the reference count of the new resource, and
+	//!				 releasing the resource previously referred to by this handle
 	//!              
 	//! @param       handle 
 	//!              
@@ -325,16 +335,38 @@ namespace Core
 	template <class T>
 		Handle<T>& Handle<T>::operator = ( const Handle<T>& handle )
 	{
-		m_value = handle.m_value;
-
-		//Increment reference count of object this handle refers to
-		if ( m_value != 0 )
+		if ( m_value == handle.m_value )
 		{
-			ResourceManager<T>::GetManager()->IncrementReferenceCount ( *this );
+			return *this;
 		}
 
+		//Take the new reference before releasing the old one
+		Handle<T> newHandle ( handle );
+		Swap ( newHandle );
+
 		return *this;
 	}
+	//end Resources::Handle<T>::operator =
+
+
+
+	//=========================================================================
+	//! @function    Handle<T>::Swap
+	//! @brief       Exchange the resources referred to by two handles
+	//!
+	//!				 Neither reference count changes, so this is the cheap way
+	//!				 to transfer ownership of a resource out of a temporary handle
+	//!              
+	//! @param       handle [in/out] Handle to swap with
+	//=========================================================================
+	template <class T>
+		void Handle<T>::Swap ( Handle<T>& handle )
+	{
+		UInt value = m_value;
+		m_value = handle.m_value;
+		handle.m_value = value;
+	}
+	//end Handle<T>::Swap
 
 
 
@@ -529,6 +561,121 @@ namespace Core
 	//end Handle::operator*
 
 
+
+	//! @class	BorrowedHandle
+	//! @brief	Non-owning reference to a resource
+	//!
+	//!			Copying or destroying a Handle adjusts the reference count of its resource.
+	//!			A BorrowedHandle is only the handle value, so it can be copied and stored
+	//!			for free on hot paths, such as the render queue. It must not outlive
+	//!			the owning Handle that keeps its resource alive.
+	template <class T>
+	class BorrowedHandle
+	{
+		public:
+
+			//Constructors
+			BorrowedHandle ( ) throw() : m_value(0)								{ }
+			BorrowedHandle ( const NullHandle& null ) throw() : m_value(0)		{ }
+			BorrowedHandle ( const Handle<T>& handle ) throw() : m_value(handle.Value()) { }
+
+			//Accessors
+			UInt Index ( ) const throw()		{ return m_index;		}
+			UInt MagicNumber ( ) const throw()	{ return m_magicNumber; }
+			UInt Value ( ) const throw()		{ return m_value;		}
+			bool IsNull ( ) const throw()		{ return (m_value == 0); }
+
+			//! Take a reference to the resource, returning an owning handle
+			inline Handle<T> Acquire ( ) const;
+
+			//Operator overloads
+			operator UInt ( ) const throw()		{ return m_value;		}
+			inline T* operator-> ( ) const;
+			inline T* operator* ( ) const;
+
+		private:
+
+			//Private data
+			union
+			{
+				struct
+				{
+					UShort m_magicNumber;	//!< Magic number used to validate the handle
+					UShort m_index;			//!< Index into the resource managers storage
+				};
+
+				UInt m_value;
+			};
+
+	};
+	//end class BorrowedHandle
+
+
+
+	//=========================================================================
+	//! @function    BorrowedHandle<T>::Acquire
+	//! @brief       Take a new reference to the resource
+	//!
+	//!				 Use this when the resource needs to be kept beyond the
+	//!				 lifetime of the handle it was borrowed from
+	//!              
+	//! @return      An owning handle to the resource, or a null handle
+	//=========================================================================
+	template <class T>
+		Handle<T> BorrowedHandle<T>::Acquire ( ) const
+	{
+		if ( IsNull() )
+		{
+			return NullHandle();
+		}
+
+		ResourceManager<T>::GetManager()->IncrementReferenceCount ( m_index, m_magicNumber );
+
+		//The private constructor adopts the reference taken above
+		return Handle<T> ( m_index, m_magicNumber );
+	}
+	//End BorrowedHandle<T>::Acquire
+
+
+
+	//=========================================================================
+	//! @function   BorrowedHandle<T>::operator ->
+	//! @brief		Call a method of the resource referred to by this handle
+	//!
+	//! @throw		NullHandleDereference if the handle is null (debug builds only)
+	//! @throw		BadHandle if the handle does not refer to a valid resource (debug builds only)
+	//=========================================================================
+	template <class T>
+		T* BorrowedHandle<T>::operator -> ( ) const
+	{
+		#ifndef RELEASE_BUILD
+			if ( IsNull() )
+			{
+				throw NullHandleDereference ( "Tried to dereference a null handle!", 0, __FILE__, __FUNCTION__, __LINE__ );
+			}
+		#endif
+
+		return ResourceManager<T>::GetManager()->GetResourcePointer( m_index, m_magicNumber );
+	}
+	//End BorrowedHandle<T>::operator ->
+
+
+
+	//=========================================================================
+	//! @function   BorrowedHandle<T>::operator *
+	//! @brief		Dereference the handle
+	//!
+	//! @throw		NullHandleDereference if the handle is null (debug builds only)
+	//! @throw		BadHandle if the handle does not refer to a valid resource (debug builds only)
+	//=========================================================================
+	template <class T>
+		T* BorrowedHandle<T>::operator * ( ) const
+	{
+		return operator->();
+	}
+	//End BorrowedHandle<T>::operator *
+
+
 };
 //end namespace Core
 
@@ -48,8 +48,12 @@ namespace Core
 	{
 		public:
 
+			//Constructor
+			inline HandleManager ( UInt maxHandles );
+
 			//Check handle for validity
 			inline bool IsHandleValid ( const Handle<T>& handle ) const;
+			inline bool IsHandleValid ( UInt index, UInt magic ) const;
 
 			//Change handles
 			inline void GenerateHandleForIndex	( UInt index );
@@ -74,6 +78,24 @@ namespace Core
 
 
 
+	//=========================================================================
+	//! @function    HandleManager<T>::HandleManager
+	//! @brief       HandleManager constructor
+	//!
+	//!				 Reserves the magic number store up front, so that it is never
+	//!				 reallocated while another thread is validating a handle
+	//!              
+	//! @param       maxHandles [in] Maximum number of handles that will be live at once
+	//=========================================================================
+	template <class T>
+		HandleManager<T>::HandleManager ( UInt maxHandles )
+	{
+		m_magicNumbers.reserve ( maxHandles );
+	}
+	//end HandleManager<T>::HandleManager
+
+
+
 	//=========================================================================
 	//! @function    HandleManager<T>::IsHandleValid
 	//! @brief       Returns true if the handle is valid, that is, it refers
@@ -92,12 +114,36 @@ namespace Core
 		if ( handle.IsNull() )
 			return false;
 
+		return IsHandleValid ( handle.Index(), handle.MagicNumber() );
+	}
+	//end HandleManager<T>::IsHandleValid
+
+
+
+	//=========================================================================
+	//! @function    HandleManager<T>::IsHandleValid
+	//! @brief       Returns true if the index and magic number of a handle refer
+	//!				 to a valid resource. Used to validate borrowed handles, which
+	//!				 cannot be converted to a Handle without taking a reference
+	//!              
+	//! @param       index [in] Index of the handle
+	//! @param       magic [in] Magic number of the handle
+	//!              
+	//! @return      true if the handle is valid, false otherwise
+	//=========================================================================
+	template <class T>
+		bool HandleManager<T>::IsHandleValid ( UInt index, UInt magic ) const
+	{
+		//Null handles have a zero magic number
+		if ( magic == 0 )
+			return false;
+
 		//Then check that the index value isn't bigger than the magic numbers array
-		if ( handle.Index() >= m_magicNumbers.size() )
+		if ( index >= m_magicNumbers.size() )
 			return false;
 		
 		//Then check that the corresponding magic number value
-		if ( handle.MagicNumber() != m_magicNumbers[handle.Index()] )
+		if ( magic != m_magicNumbers[index] )
 			return false;
 
 		return true;
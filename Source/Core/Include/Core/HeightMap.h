@@ -0,0 +1,120 @@
+//======================================================================================
+//! @file         HeightMap.h
+//! @brief        Loads RAW heightmaps into floating point heights
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+#ifndef CORE_HEIGHTMAP_H
+#define CORE_HEIGHTMAP_H
+
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include "Core/BasicTypes.h"
+#include "Core/Debug.h"
+
+
+//namespace Core
+namespace Core
+{
+
+	//! @class	HeightMap
+	//! @brief	Square grid of heights, loaded from a headerless RAW file
+	//!
+	//!			The file is memory mapped and converted to floats in bulk, rather than
+	//!			being read a value at a time. 8 bit, 16 bit little endian, and 32 bit float
+	//!			samples are supported. Integer samples are scaled so that the largest value 
+	//!			maps to maxHeight, and float samples are expected to be in the range [0,1]
+	class HeightMap : public boost::noncopyable
+	{
+		public:
+
+			//! Sample formats
+			enum EFormat
+			{
+				FORMAT_AUTO,		//!< Guess the format from the file size
+				FORMAT_UINT8,
+				FORMAT_UINT16,
+				FORMAT_FLOAT32
+			};
+
+            //=========================================================================
+            // Constructors
+            //=========================================================================
+			HeightMap ( );
+
+            //=========================================================================
+            // Public methods
+            //=========================================================================
+			void Load ( const Char* fileName, EFormat format, Float maxHeight );
+			void Clear ( );
+
+			inline Float HeightAt ( UInt row, UInt col ) const;
+
+			UInt			Size () const		{ return m_size;		}
+			EFormat			Format () const		{ return m_format;		}
+			const Float*	Heights () const	{ return m_heights.empty() ? 0 : &m_heights[0];	}
+
+			static EFormat	DetectFormat ( UInt64 fileSize );
+			static UInt		BytesPerSample ( EFormat format );
+
+			//Bulk conversion kernels. These use SSE2 when CORE_SSE2 is defined
+			static void ConvertUInt8   ( const Byte* source, Float* dest, UInt count, Float scale );
+			static void ConvertUInt16  ( const Byte* source, Float* dest, UInt count, Float scale );
+			static void ConvertFloat32 ( const Byte* source, Float* dest, UInt count, Float scale );
+
+		private:
+
+            //=========================================================================
+            // Private data
+            //=========================================================================
+			std::vector<Float>	m_heights;
+			UInt				m_size;
+			EFormat				m_format;
+	};
+	//end class HeightMap
+
+
+
+    //=========================================================================
+    //! @function    HeightMap::HeightAt
+    //! @brief       Get the height of a sample
+    //!              
+    //! @param       row [in] Row of the sample
+    //! @param       col [in] Column of the sample
+    //!              
+    //! @return      The height of the sample
+    //=========================================================================
+	Float HeightMap::HeightAt ( UInt row, UInt col ) const
+	{
+		debug_assert ( (row < m_size) && (col < m_size), "Heightmap sample out of range!" );
+
+		return m_heights[col + (row * m_size)];
+	}
+	//End HeightMap::HeightAt
+
+};
+//end namespace Core
+
+#endif //CORE_HEIGHTMAP_H
@@ -0,0 +1,84 @@
+//======================================================================================
+//! @file         MemoryMappedFile.h
+//! @brief        Read only memory mapped view of a file
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+
+#ifndef CORE_MEMORYMAPPEDFILE_H
+#define CORE_MEMORYMAPPEDFILE_H
+
+#include <windows.h>
+#include <boost/noncopyable.hpp>
+#include "Core/BasicTypes.h"
+
+
+//namespace Core
+namespace Core
+{
+
+	//! @class	MemoryMappedFile
+	//! @brief	Maps a whole file into the address space of the process for reading
+	//!
+	//!			The operating system pages the file in as it is touched, so large
+	//!			files can be opened instantly, and only the parts that are read use memory.
+	//!			The mapping is read only, and safe to read from several threads at once.
+	class MemoryMappedFile : public boost::noncopyable
+	{
+		public:
+
+            //=========================================================================
+            // Constructors/Destructor
+            //=========================================================================
+			MemoryMappedFile ( );
+			explicit MemoryMappedFile ( const Char* fileName );
+			~MemoryMappedFile ( );
+
+            //=========================================================================
+            // Public methods
+            //=========================================================================
+			void Open ( const Char* fileName );
+			void Close ( );
+
+			bool		IsOpen () const		{ return m_file != INVALID_HANDLE_VALUE;	}
+			const Byte* Data () const		{ return m_data;		}
+			UInt64		Size () const		{ return m_size;		}
+
+		private:
+
+            //=========================================================================
+            // Private data
+            //=========================================================================
+			HANDLE		m_file;
+			HANDLE		m_mapping;
+			const Byte*	m_data;
+			UInt64		m_size;
+	};
+	//end class MemoryMappedFile
+
+};
+//end namespace Core
+
+#endif //CORE_MEMORYMAPPEDFILE_H
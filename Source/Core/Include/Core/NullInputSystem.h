@@ -0,0 +1,105 @@
+//======================================================================================
+//! @file         NullInputSystem.h
+//! @brief        Input system that never produces any input
+//!               Used when the renderer has no window that can take input
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+#ifndef CORE_NULLINPUTSYSTEM_H
+#define CORE_NULLINPUTSYSTEM_H
+
+
+#include "Core/InputSystem.h"
+#include "Core/Keyboard.h"
+#include "Core/Mouse.h"
+
+
+//namespace Core
+namespace Core
+{
+
+
+	//!@class	NullKeyboard
+	//!@brief	Keyboard that never has any keys pressed
+	class NullKeyboard : public Keyboard
+	{
+		public:
+			NullKeyboard ( InputSystem& inputSystem ) : Keyboard(inputSystem) {}
+			void Update ( ) {}
+	};
+	//End class NullKeyboard
+
+
+
+	//!@class	NullMouse
+	//!@brief	Mouse that never moves
+	class NullMouse : public Mouse
+	{
+		public:
+			NullMouse ( InputSystem& inputSystem ) : Mouse(inputSystem) {}
+			void Update ( ) {}
+	};
+	//End class NullMouse
+
+
+
+	//!@class	NullInputSystem
+	//!@brief	Input system for running without a window that can take input, 
+	//!			such as under the null renderer
+	//!
+	//!			Handlers can still be registered, but no events are ever triggered
+	class NullInputSystem : public InputSystem
+	{
+		public:
+
+			inline NullInputSystem ( );
+
+            //=========================================================================
+            // Public methods
+            //=========================================================================
+			void Update ( ) {}
+	};
+	//End class NullInputSystem
+
+
+
+    //=========================================================================
+    //! @function    NullInputSystem::NullInputSystem
+    //! @brief       NullInputSystem constructor
+    //!              
+    //=========================================================================
+	NullInputSystem::NullInputSystem ( )
+	{
+		m_keyboard = boost::shared_ptr<Keyboard>( new NullKeyboard(*this) );
+		m_mouse = boost::shared_ptr<Mouse>( new NullMouse(*this) );
+	}
+	//End NullInputSystem::NullInputSystem
+
+
+}
+//end namespace Core
+
+
+#endif
+//#ifndef CORE_NULLINPUTSYSTEM_H
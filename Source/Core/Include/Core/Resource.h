@@ -29,6 +29,7 @@
 #ifndef CORE_RESOURCE_H
 #define CORE_RESOURCE_H
 
+#include "Core/Atomic.h"
 #include "Core/ResourceManager.h"
 
 
@@ -57,19 +58,20 @@ namespace Core
 			const std::string& Name ( )	const	{ return m_name;			}
 			UInt ID ( )	const					{ return NameHash();		}
 			UInt NameHash ( ) const				{ return m_nameHash;		}
-			UInt ReferenceCount ( ) const		{ return m_referenceCount;	}
+			UInt ReferenceCount ( ) const		{ return static_cast<UInt>(m_referenceCount);	}
 			UInt SizeInBytes ( ) const			{ return m_sizeInBytes;		}
 
 		protected:
 
-			inline UInt IncrementReferenceCount ( )		{ return ++m_referenceCount;	}
-			inline UInt DecrementReferenceCount ( )		{ return --m_referenceCount;	}
+			//Handles may be copied and destroyed on any thread, so the count is atomic
+			inline UInt IncrementReferenceCount ( )		{ return static_cast<UInt>(AtomicIncrement(m_referenceCount));	}
+			inline UInt DecrementReferenceCount ( )		{ return static_cast<UInt>(AtomicDecrement(m_referenceCount));	}
 
 			void Name ( const Char* name );
 
 		private:
 
-			UInt		m_referenceCount;	//!< Count of the number of objects that have a handle to this resource
+			AtomicLong	m_referenceCount;	//!< Count of the number of objects that have a handle to this resource
 			std::string m_name;				//!< Name of the resource
 			UInt		m_nameHash;			//!< Unsigned integer value generated from the filename that uniquely identifies it
 											//!< for quick comparisons
@@ -38,6 +38,8 @@
 #include "Core/Hash.h"
 #include "Core/ManagedPool.h"
 #include "Core/HandleManager.h"
+#include "Core/CriticalSection.h"
+#include <vector>
 #include <boost/shared_ptr.hpp>
 
 
@@ -52,6 +54,12 @@ namespace Core
 	//!   		creation and deletion of resources, 
 	//!   		giving out handles to resources,
 	//!			determining which resources are no longer needed
+	//!
+	//!		Resources are indexed by ID, so finding an existing resource doesn't need
+	//!		a search of the whole store. Reference counts are atomic, so handles can
+	//!		be copied and released from any thread. Adding, acquiring and freeing
+	//!		resources are serialised by a lock, but iterating the store is not, so
+	//!		Begin and End should only be used from the main thread
 	template <class ResourceType>
 	class ResourceManager
 	{
@@ -70,11 +78,13 @@ namespace Core
             // Public types
             //=========================================================================
 			typedef Handle<ResourceType> HandleType;
+			typedef BorrowedHandle<ResourceType> BorrowedHandleType;
 			
             //=========================================================================
             // Friends
             //=========================================================================
 			friend class HandleType;
+			friend class BorrowedHandleType;
 
 		protected:
 
@@ -88,7 +98,9 @@ namespace Core
 			void					ReleaseResource (  const HandleType& resourceHandle );
 
 			ResourceType*			GetResourcePointer ( const HandleType& resourceHandle );
+			ResourceType*			GetResourcePointer ( UInt index, UInt magic );
 			void					IncrementReferenceCount ( const HandleType& resourceHandle );
+			void					IncrementReferenceCount ( UInt index, UInt magic );
 
 			bool					IsHandleValid ( const HandleType& resourceHandle ) const;
 
@@ -124,6 +136,27 @@ namespace Core
 			static ResourceManager* ms_manager;
 
 			
+            //=========================================================================
+            // Private methods
+            //=========================================================================
+			HandleType	AcquireSlot ( UInt slot );
+			UInt		FindInIndex ( UInt id ) const;
+			void		LinkToIndex ( UInt slot, UInt id );
+			void		UnlinkFromIndex ( UInt slot );
+			UInt		BucketForID ( UInt id ) const { return (id ^ (id >> 16)) & m_bucketMask; }
+
+			
+            //=========================================================================
+            // Private types
+            //=========================================================================
+			typedef std::vector<UInt> SlotList;
+
+			enum
+			{
+				NoSlot = 0xFFFFFFFF		//!< Marks the end of a bucket chain
+			};
+
+			
             //=========================================================================
             // Private data
             //=========================================================================
@@ -132,6 +165,14 @@ namespace Core
 			
 			UInt m_maxResources;
 
+			SlotList		m_buckets;			//!< First slot in each bucket of the ID index, or NoSlot
+			SlotList		m_nextInBucket;		//!< Next slot in the same bucket, for each slot
+			SlotList		m_previousInBucket;	//!< Previous slot in the same bucket, for each slot
+			SlotList		m_slotIDs;			//!< ID of the resource in each slot
+			UInt			m_bucketMask;		//!< Number of buckets - 1. The bucket count is a power of two
+
+			CriticalSection	m_lock;				//!< Serialises changes to the resource store and ID index
+
 	};
 	//end class ResourceManager
 
@@ -156,10 +197,21 @@ namespace Core
 	//=========================================================================
 	template <class ResourceType>
 	ResourceManager<ResourceType>::ResourceManager ( UInt maxResources )
-	: m_maxResources(maxResources), m_resources(maxResources)
+	: m_resources(maxResources), m_handleManager(maxResources), m_maxResources(maxResources),
+	  m_nextInBucket(maxResources, NoSlot), m_previousInBucket(maxResources, NoSlot), m_slotIDs(maxResources, 0)
 	{
 		debug_assert ( maxResources != 0, "0 is not a valid value for maxResources" );
 
+		//Keep the load factor of the index at or below one
+		UInt bucketCount = 1;
+		while ( bucketCount < maxResources )
+		{
+			bucketCount <<= 1;
+		}
+
+		m_buckets.resize ( bucketCount, NoSlot );
+		m_bucketMask = bucketCount - 1;
+
 		ms_manager = this;
 	}
 	//end ResourceManager<ResourceType>::ResourceManager
@@ -204,7 +256,8 @@ namespace Core
 															( boost::shared_ptr<ResourceType>& newResource )
 	{
 		UInt newIndex = 0;
-		UInt result = 0;
+
+		ScopedLock lock ( m_lock );
 
 		try
 		{
@@ -221,6 +274,8 @@ namespace Core
 		//Generate a valid handle for the new resource
 		m_handleManager.GenerateHandleForIndex ( newIndex );
 
+		LinkToIndex ( newIndex, newResource->ID() );
+
 		return m_handleManager.GetHandle(newIndex);
 	}
 	//end ResourceManager<ResourceType>::AddNewResource
@@ -232,8 +287,7 @@ namespace Core
 	//! @function    ResourceManager<ResourceType>::AcquireExistingResource
 	//! @brief       Get a handle to an existing resource, using a name string as the key
 	//!              
-	//!              Searches the resource store for a resource with the name
-	//!				 specified. 
+	//!              Looks up a resource with the name specified in the ID index
 	//!
 	//! @param       name [in]	Filename of the resource
 	//!              
@@ -245,36 +299,16 @@ namespace Core
 	{
 		debug_assert ( name != 0, "Attempted to pass a null pointer as a resource name!" );
 
-		//Generate a hash value from the name, for quicker searching.
-		//This way we can just compare the hash values, rather than doing a 
-		//string compare for every resource in the resource store
+		//The ID of a named resource is the hash of its name
 		UInt nameHash = Core::GenerateHashFromString ( name );
 
-		UInt index = 0;
-		bool found = false;
-		ResourceStore::iterator it = m_resources.Begin();
-		ResourceStore::iterator end = m_resources.End();
+		ScopedLock lock ( m_lock );
 
-		//Iterate through the resource store, looking for a resource with 
-		//a matching filename hash value
-		while ( (false == found) && (it != end) )
-		{
-			//Check the namehash for the resource at that location
-			//if it exists
-			if ( (it->get()) && ((*it)->ID() == nameHash) )
-			{
-				//found it
-				found = true;
-				continue;
-			}
-
-			++it;
-			++index;
-		}
+		UInt index = FindInIndex ( nameHash );
 
 		//Load the resource if it could not be found, or return
 		//a handle to the resource if it could
-		if ( found == false )
+		if ( index == NoSlot )
 		{
 			return NullHandle();
 		}
@@ -284,8 +318,7 @@ namespace Core
 					std::clog << __FUNCTION__ ": Received request for existing resource " << name << " returning handle" << std::endl;
 			#endif
 
-			m_resources[index]->IncrementReferenceCount();
-			return m_handleManager.GetHandle(index);
+			return AcquireSlot ( index );
 		}
 
 	}
@@ -298,10 +331,9 @@ namespace Core
 	//! @function    ResourceManager<ResourceType>::AcquireExistingResource
 	//! @brief       Get a handle to an existing resource, using an integer ID as the key
 	//!
-	//!              Searches the resource store for a resource with the name
-	//!				 specified. 
+	//!              Looks up a resource with the ID specified in the ID index
 	//!
-	//! @param       name [in]	Filename of the resource
+	//! @param       id [in]	ID of the resource
 	//!              
 	//! @return		 If the resource couldn't be found, then the null handle is returned
 	//!				 otherwise, a handle to the resource is returned
@@ -311,32 +343,13 @@ namespace Core
 	{
 		debug_assert ( id != 0, "0 is not an acceptable value for ID!" );
 
+		ScopedLock lock ( m_lock );
 
-		UInt index = 0;
-		bool found = false;
-		ResourceStore::iterator it = m_resources.Begin();
-		ResourceStore::iterator end = m_resources.End();
-
-		//Iterate through the resource store, looking for a resource with 
-		//a matching filename hash value
-		while ( (false == found) && (it != end) )
-		{
-			//Check the namehash for the resource at that location
-			//if it exists
-			if ( (it->get()) && ((*it)->ID() == id) )
-			{
-				//found it
-				found = true;
-				continue;
-			}
-
-			++it;
-			++index;
-		}
+		UInt index = FindInIndex ( id );
 
 		//Load the resource if it could not be found, or return
 		//a handle to the resource if it could
-		if ( found == false )
+		if ( index == NoSlot )
 		{
 			return NullHandle();
 		}
@@ -346,8 +359,7 @@ namespace Core
 					std::clog << __FUNCTION__ ": Received request for existing resource with id " << id << " returning handle" << std::endl;
 			#endif
 
-			m_resources[index]->IncrementReferenceCount();
-			return m_handleManager.GetHandle(index);
+			return AcquireSlot ( index );
 		}
 
 	}
@@ -365,6 +377,10 @@ namespace Core
 	//!				
 	//!              The handle is checked for validity, if the handle is invalid
 	//!				 then nothing will happen
+	//!
+	//!				 The decrement is lock free. Only the release that takes the count
+	//!				 to zero takes the lock, and rechecks the count under it, in case another
+	//!				 thread acquired the resource by ID in the meantime
 	//!              
 	//! @param       resourceHandle [in]	Handle to the resource to be deleted
 	//=========================================================================
@@ -388,22 +404,34 @@ namespace Core
 
 		//Decrement the reference count of the handle
 		//Note that we use the Index property of the handle class, to index into the resource array
-		m_resources[resourceHandle.Index()]->DecrementReferenceCount ( );
+		UInt index = resourceHandle.Index();
 
-		if ( m_resources[resourceHandle.Index()]->ReferenceCount ( ) <= 0 )
+		if ( m_resources[index]->DecrementReferenceCount ( ) != 0 )
 		{
+			return;
+		}
 
-			std::clog << __FUNCTION__ ": Ref count for handle " << resourceHandle.Value() 
-					  << " == 0, freeing resource" << std::endl;
+		ScopedLock lock ( m_lock );
 
-			//Delete the resource
-			m_resources[resourceHandle.Index()] = boost::shared_ptr<ResourceType>();
-			//Set the associated handle to null
-			m_handleManager.ClearHandle ( resourceHandle.Index() );
-			//Put the resource slot back into the free slot list
-			m_resources.RemoveItem(resourceHandle.Index());
+		//The resource may have been acquired again, or acquired, released and freed,
+		//by another thread since the count reached zero
+		if ( !IsHandleValid(resourceHandle) || (m_resources[index]->ReferenceCount ( ) != 0) )
+		{
+			return;
 		}
 
+		std::clog << __FUNCTION__ ": Ref count for handle " << resourceHandle.Value() 
+				  << " == 0, freeing resource" << std::endl;
+
+		//Remove the resource from the ID index
+		UnlinkFromIndex ( index );
+		//Delete the resource
+		m_resources[index] = boost::shared_ptr<ResourceType>();
+		//Set the associated handle to null
+		m_handleManager.ClearHandle ( index );
+		//Put the resource slot back into the free slot list
+		m_resources.RemoveItem(index);
+
 	}
 	//end ResourceManager<ResourceType>::ReleaseResource
 
@@ -444,6 +472,37 @@ namespace Core
 
 
 
+	//=========================================================================
+	//! @function    ResourceManager<ResourceType>::GetResourcePointer
+	//! @brief		 Get a pointer to a resource from the index and magic number of a handle
+	//!				 Used to dereference borrowed handles. Checked in debug builds only
+	//!              
+	//! @param       index [in] Index of the handle
+	//! @param       magic [in] Magic number of the handle
+	//!              
+	//! @return		 A pointer to the resource referenced by the handle      
+	//! @throw       BadHandle if the handle is invalid
+	//=========================================================================
+	template <class ResourceType>
+	ResourceType* ResourceManager<ResourceType>::GetResourcePointer ( UInt index, UInt magic )
+	{
+		#ifdef DEBUG_BUILD
+		
+			if (!m_handleManager.IsHandleValid(index, magic))
+			{
+				throw BadHandle("Handle is not valid", 0, __FILE__, __FUNCTION__, __LINE__ );
+			}
+
+		#endif
+
+		debug_assert ( m_resources[index].get() != 0, "Bad handle!" );
+
+		return m_resources[index].get();
+	}
+	//end ResourceManager<ResourceType>::GetResourcePointer
+
+
+
 
 	//=========================================================================
 	//! @function    ResourceManager<ResourceType>::IncrementReferenceCount
@@ -480,6 +539,36 @@ namespace Core
 
 
 
+	//=========================================================================
+	//! @function    ResourceManager<ResourceType>::IncrementReferenceCount
+	//! @brief       Increment the reference count for the resource referenced by 
+	//!				 the index and magic number of a handle. Used to acquire borrowed handles
+	//!
+	//! @param       index [in] Index of the handle
+	//! @param       magic [in] Magic number of the handle
+	//!              
+	//! @throw       BadHandle if the handle is invalid (debug builds only)
+	//=========================================================================
+	template <class ResourceType>
+	void ResourceManager<ResourceType>::IncrementReferenceCount ( UInt index, UInt magic )
+	{
+		#ifdef DEBUG_BUILD
+		
+			if (!m_handleManager.IsHandleValid(index, magic))
+			{
+				throw BadHandle("Handle is not valid", 0, __FILE__, __FUNCTION__, __LINE__ );
+			}
+
+		#endif
+
+		debug_assert ( m_resources[index].get() != 0, "Called IncrementReferenceCount on a bad handle!" );
+
+		m_resources[index]->IncrementReferenceCount();
+	}
+	//end ResourceManager<ResourceType>::IncrementReferenceCount
+
+
+
 
 
 	//=========================================================================
@@ -518,6 +607,120 @@ namespace Core
 	}
 	//end ResourceManager<ResourceType>::GetManager
 
+
+
+	//=========================================================================
+	//! @function    ResourceManager<ResourceType>::AcquireSlot
+	//! @brief       Take a reference to the resource in a slot, and return a handle to it
+	//!				 Must be called with the lock held
+	//!              
+	//! @param       slot [in] Slot holding the resource
+	//!              
+	//! @return      A handle to the resource
+	//=========================================================================
+	template <class ResourceType>
+	ResourceManager<ResourceType>::HandleType ResourceManager<ResourceType>::AcquireSlot ( UInt slot )
+	{
+		m_resources[slot]->IncrementReferenceCount();
+		return m_handleManager.GetHandle(slot);
+	}
+	//end ResourceManager<ResourceType>::AcquireSlot
+
+
+
+	//=========================================================================
+	//! @function    ResourceManager<ResourceType>::FindInIndex
+	//! @brief       Find the slot holding a resource with the ID provided
+	//!
+	//!				 Only the chain for the ID's bucket is searched, and the IDs are
+	//!				 stored alongside the chain, so the resources themselves aren't touched
+	//!				 Must be called with the lock held
+	//!              
+	//! @param       id [in] ID to look for
+	//!              
+	//! @return      The slot holding the resource, or NoSlot if there is no such resource
+	//=========================================================================
+	template <class ResourceType>
+	UInt ResourceManager<ResourceType>::FindInIndex ( UInt id ) const
+	{
+		UInt slot = m_buckets[BucketForID(id)];
+
+		while ( (slot != NoSlot) && (m_slotIDs[slot] != id) )
+		{
+			slot = m_nextInBucket[slot];
+		}
+
+		return slot;
+	}
+	//end ResourceManager<ResourceType>::FindInIndex
+
+
+
+	//=========================================================================
+	//! @function    ResourceManager<ResourceType>::LinkToIndex
+	//! @brief       Add a slot to the head of the chain for its ID's bucket
+	//!				 Must be called with the lock held
+	//!              
+	//! @param       slot	[in] Slot holding the new resource
+	//! @param       id		[in] ID of the new resource
+	//=========================================================================
+	template <class ResourceType>
+	void ResourceManager<ResourceType>::LinkToIndex ( UInt slot, UInt id )
+	{
+		debug_assert ( slot < m_slotIDs.size(), "Slot out of range!" );
+
+		UInt bucket = BucketForID(id);
+		UInt head = m_buckets[bucket];
+
+		m_slotIDs[slot] = id;
+		m_previousInBucket[slot] = NoSlot;
+		m_nextInBucket[slot] = head;
+
+		if ( head != NoSlot )
+		{
+			m_previousInBucket[head] = slot;
+		}
+
+		m_buckets[bucket] = slot;
+	}
+	//end ResourceManager<ResourceType>::LinkToIndex
+
+
+
+	//=========================================================================
+	//! @function    ResourceManager<ResourceType>::UnlinkFromIndex
+	//! @brief       Remove a slot from the chain for its bucket
+	//!				 Must be called with the lock held
+	//!              
+	//! @param       slot [in] Slot to remove
+	//=========================================================================
+	template <class ResourceType>
+	void ResourceManager<ResourceType>::UnlinkFromIndex ( UInt slot )
+	{
+		debug_assert ( slot < m_slotIDs.size(), "Slot out of range!" );
+
+		UInt previous = m_previousInBucket[slot];
+		UInt next = m_nextInBucket[slot];
+
+		if ( previous != NoSlot )
+		{
+			m_nextInBucket[previous] = next;
+		}
+		else
+		{
+			m_buckets[BucketForID(m_slotIDs[slot])] = next;
+		}
+
+		if ( next != NoSlot )
+		{
+			m_previousInBucket[next] = previous;
+		}
+
+		m_nextInBucket[slot] = NoSlot;
+		m_previousInBucket[slot] = NoSlot;
+	}
+	//end ResourceManager<ResourceType>::UnlinkFromIndex
+
 };
 //end namespace Core
 
@@ -0,0 +1,129 @@
+//======================================================================================
+//! @file         ThreadLocal.h
+//! @brief        Pointer with a separate value for each thread
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+#ifndef CORE_THREADLOCAL_H
+#define CORE_THREADLOCAL_H
+
+#include <windows.h>
+#include <boost/noncopyable.hpp>
+#include "Core/StandardExceptions.h"
+
+
+//namespace Core
+namespace Core
+{
+
+	//! @class	ThreadLocalPointer
+	//! @brief	Pointer that holds a separate value for each thread
+	//!
+	//!			Every thread starts out with a null pointer. The object doesn't own
+	//!			what it points to.
+	template <class T>
+	class ThreadLocalPointer : public boost::noncopyable
+	{
+		public:
+
+			//Constructor/Destructor
+			inline ThreadLocalPointer ( );
+			inline ~ThreadLocalPointer ( ) throw();
+
+			//Get/Set the value for the calling thread
+			inline T*	Get ( ) const throw();
+			inline void Set ( T* value ) throw();
+
+		private:
+
+			DWORD m_index;
+	};
+	//end class ThreadLocalPointer
+
+
+
+    //=========================================================================
+    //! @function    ThreadLocalPointer::ThreadLocalPointer
+    //! @brief       ThreadLocalPointer constructor. Allocates a TLS slot
+	//!
+	//! @throw		 Core::RuntimeError if there are no TLS slots left
+    //=========================================================================
+	template <class T>
+	ThreadLocalPointer<T>::ThreadLocalPointer ( )
+	{
+		m_index = TlsAlloc ( );
+
+		if ( m_index == TLS_OUT_OF_INDEXES )
+		{
+			throw Core::RuntimeError ( "Could not allocate a thread local storage slot!", GetLastError(), 
+									   __FILE__, __FUNCTION__, __LINE__ );
+		}
+	}
+	//End ThreadLocalPointer::ThreadLocalPointer
+
+
+    //=========================================================================
+    //! @function    ThreadLocalPointer::~ThreadLocalPointer
+    //! @brief       ThreadLocalPointer destructor. Frees the TLS slot
+    //=========================================================================
+	template <class T>
+	ThreadLocalPointer<T>::~ThreadLocalPointer ( )
+	{
+		TlsFree ( m_index );
+	}
+	//End ThreadLocalPointer::~ThreadLocalPointer
+
+
+    //=========================================================================
+    //! @function    ThreadLocalPointer::Get
+    //! @brief       Get the calling thread's value
+	//!
+	//! @return		 The value last set by the calling thread, or 0 if it hasn't set one
+    //=========================================================================
+	template <class T>
+	T* ThreadLocalPointer<T>::Get ( ) const
+	{
+		return reinterpret_cast<T*>( TlsGetValue ( m_index ) );
+	}
+	//End ThreadLocalPointer::Get
+
+
+    //=========================================================================
+    //! @function    ThreadLocalPointer::Set
+    //! @brief       Set the calling thread's value
+	//!
+	//! @param		 value [in] New value. Other threads' values are unaffected
+    //=========================================================================
+	template <class T>
+	void ThreadLocalPointer<T>::Set ( T* value )
+	{
+		TlsSetValue ( m_index, value );
+	}
+	//End ThreadLocalPointer::Set
+
+};
+//end namespace Core
+
+#endif //CORE_THREADLOCAL_H
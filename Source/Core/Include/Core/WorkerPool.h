@@ -0,0 +1,117 @@
+//======================================================================================
+//! @file         WorkerPool.h
+//! @brief        Pool of worker threads that execute jobs submitted by the main thread
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+#ifndef CORE_WORKERPOOL_H
+#define CORE_WORKERPOOL_H
+
+#include <windows.h>
+#include <deque>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include "Core/BasicTypes.h"
+#include "Core/CriticalSection.h"
+
+
+//namespace Core
+namespace Core
+{
+
+	//! @class	IJob
+	//! @brief	Interface for a unit of work that can be run on a WorkerPool
+	//!
+	//!			The job object is owned by the code that submits it, and must
+	//!			stay alive until WorkerPool::WaitForAll has returned
+	class IJob
+	{
+		public:
+
+			virtual ~IJob() {}
+
+			virtual void Execute ( ) = 0;
+	};
+	//end class IJob
+
+
+
+	//! @class	WorkerPool
+	//! @brief	Fixed size pool of worker threads
+	//!
+	//!			Jobs are queued with Submit, and picked up by the first idle worker.
+	//!			WaitForAll blocks until every submitted job has finished, and the calling
+	//!			thread executes queued jobs itself while it waits, so a pool with no worker
+	//!			threads simply runs everything on the calling thread.
+	class WorkerPool : public boost::noncopyable
+	{
+		public:
+
+            //=========================================================================
+            // Constructors/Destructor
+            //=========================================================================
+			explicit WorkerPool ( UInt threadCount );
+			~WorkerPool ( );
+
+            //=========================================================================
+            // Public methods
+            //=========================================================================
+			void Submit		 ( IJob& job );
+			void WaitForAll	 ( );
+
+			UInt ThreadCount ( ) const		{ return static_cast<UInt>(m_threads.size()); }
+
+            //=========================================================================
+            // Static public methods
+            //=========================================================================
+			static UInt HardwareThreadCount ( );
+
+		private:
+
+            //=========================================================================
+            // Private methods
+            //=========================================================================
+			bool ExecuteNextJob ( );
+
+			static unsigned __stdcall ThreadMain ( void* pool );
+
+            //=========================================================================
+            // Private data
+            //=========================================================================
+			std::deque<IJob*>	 m_jobs;			//!< Jobs waiting for a worker
+			std::vector<HANDLE>  m_threads;
+			CriticalSection		 m_lock;			//!< Guards m_jobs, m_pendingJobs and m_jobFailed
+			HANDLE				 m_jobSemaphore;	//!< Signalled once for each job submitted
+			HANDLE				 m_idleEvent;		//!< Signalled when there are no pending jobs
+			UInt				 m_pendingJobs;		//!< Jobs submitted, but not yet completed
+			bool				 m_jobFailed;		//!< Set if a job threw an exception
+			volatile bool		 m_quit;
+	};
+	//end class WorkerPool
+
+};
+//end namespace Core
+
+#endif //CORE_WORKERPOOL_H
@@ -36,6 +36,7 @@
 #include "Core/BasicTypes.h"
 #include "Core/Debug.h"
 #include "Core/ConsoleOutputListener.h"
+#include "Core/ConsoleVariableListener.h"
 #include "Core/ConsoleVariable.h"
 #include "Core/ConsoleCommand.h"
 #include "Core/ConsoleVariableManager.h"
@@ -81,6 +82,7 @@ Console::Console ( UInt maxLines, UInt lineWidth, const Char* logFileName )
 	
 	//Init event handling
 	m_outputEvent = boost::shared_ptr<ConsoleOutputEvent> ( new ConsoleOutputEvent() );
+	m_variableEvent = boost::shared_ptr<ConsoleVariableEvent> ( new ConsoleVariableEvent() );
 
 	//Set up the output streams
 	m_conOutBuf = boost::shared_ptr<OConsoleBuf>(new OConsoleBuf(STRM_CONOUT, *this ));
@@ -245,6 +247,26 @@ EventConnection Console::AddOutputListener ( IConsoleOutputListener& listener )
 
 
 
+//=========================================================================
+//! @function    Console::AddVariableListener
+//! @brief       Add a variable listener
+//!
+//!				 A variable listener is notified every time a console variable
+//!				 is set by ExecuteString, which covers the command line and
+//!				 config files run with exec
+//!
+//! @param       listener [in] Listener object 
+//!              
+//! @return      A connection object between the event and the event handler
+//=========================================================================
+EventConnection Console::AddVariableListener ( IConsoleVariableListener& listener )
+{
+	return m_variableEvent->Connect ( listener );
+}
+//End Console::AddVariableListener
+
+
+
 //=========================================================================
 //! @function    Console::ExecuteString
 //! @brief       Execute a string, as if it were typed in on the command line
@@ -292,8 +314,10 @@ bool Console::ExecuteString ( const std::string& commandString )
 		if ( commandLineParser.Arguments().size() == 1 )
 		{
 			//There's no existing variable with that name, so create one
-			Variables().GetVariable ( ConsoleVariable(commandLineParser.CommandName().c_str(), 
-														commandLineParser.Arguments()[0]));
+			boost::shared_ptr<ConsoleVariable> variable = 
+				Variables().GetVariable ( ConsoleVariable(commandLineParser.CommandName().c_str(), 
+															commandLineParser.Arguments()[0]));
+			m_variableEvent->OnConsoleVariableChanged ( *variable );
 			return true;
 		}
 		else
@@ -309,6 +333,7 @@ bool Console::ExecuteString ( const std::string& commandString )
 		if ( variableSearchResult->second->Set( commandLineParser.Arguments()[0] ) )
 		{
 			Out() << "Set " << variableSearchResult->second->Name() << " to " << *variableSearchResult->second << std::endl;	
+			m_variableEvent->OnConsoleVariableChanged ( *variableSearchResult->second );
 		}
 		else
 		{
@@ -53,7 +53,11 @@ using namespace Core;
 //!              
 //=========================================================================
 ConsoleVariable::ConsoleVariable ( const Char* name, boost::any value )
-: m_name(name)
+: m_name(name),
+  m_intStorage(0),
+  m_uintStorage(0),
+  m_boolStorage(false),
+  m_floatStorage(0.0f)
 {
 	//Convert the variable to lower case
 	std::for_each(m_name.begin(), m_name.end(), ToLowerFunc() );
@@ -49,6 +49,7 @@ using namespace Core;
 ConsoleFloat::ConsoleFloat ( const Char* name, Float value )
 {
 	m_variable = Console::GetSingleton().Variables().GetVariable(ConsoleVariable(name, value));
+	m_value = m_variable->FloatStorage();
 }
 //end ConsoleFloat::ConsoleFloat
 
@@ -68,6 +69,7 @@ ConsoleFloat::ConsoleFloat ( const Char* name, Float value )
 ConsoleInt::ConsoleInt ( const Char* name, Int value )
 {
 	m_variable = Console::GetSingleton().Variables().GetVariable(ConsoleVariable(name, value));
+	m_value = m_variable->IntStorage();
 }
 //end ConsoleInt::ConsoleInt
 
@@ -87,6 +89,7 @@ ConsoleInt::ConsoleInt ( const Char* name, Int value )
 ConsoleUInt::ConsoleUInt ( const Char* name, UInt value )
 {
 	m_variable = Console::GetSingleton().Variables().GetVariable(ConsoleVariable(name, value));
+	m_value = m_variable->UIntStorage();
 }
 //end ConsoleUInt::ConsoleUInt
 
@@ -106,6 +109,7 @@ ConsoleUInt::ConsoleUInt ( const Char* name, UInt value )
 ConsoleBool::ConsoleBool ( const Char* name, bool value )
 {
 	m_variable = Console::GetSingleton().Variables().GetVariable(ConsoleVariable(name, value));
+	m_value = m_variable->BoolStorage();
 }
 //end ConsoleBool::ConsoleBool
 
@@ -0,0 +1,360 @@
+//======================================================================================
+//! @file         HeightMap.cpp
+//! @brief        Loads RAW heightmaps into floating point heights
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+
+#include <cstring>
+#include "Core/Core.h"
+#include "Core/HeightMap.h"
+#include "Core/MemoryMappedFile.h"
+
+#ifdef CORE_SSE2
+#	include <emmintrin.h>
+#endif
+
+
+using namespace Core;
+
+
+
+//namespace
+namespace
+{
+
+	//=========================================================================
+    //! @function    IntegerSquareRoot
+    //! @brief       Get the integer square root of a value, rounded down
+    //=========================================================================
+	UInt64 IntegerSquareRoot ( UInt64 value )
+	{
+		UInt64 root = 0;
+
+		//Binary search for the largest root with root*root <= value
+		for ( UInt64 bit = static_cast<UInt64>(1) << 31; bit != 0; bit >>= 1 )
+		{
+			UInt64 trial = root | bit;
+
+			if ( (trial * trial) <= value )
+			{
+				root = trial;
+			}
+		}
+
+		return root;
+	}
+	//End IntegerSquareRoot
+
+
+	//=========================================================================
+    //! @function    SquareSideLength
+    //! @brief       Get the side length of a square grid of samples
+    //!              
+    //! @return      The side length, or 0 if the file size doesn't hold a square grid
+	//!				 of samples of the format specified
+    //=========================================================================
+	UInt64 SquareSideLength ( UInt64 fileSize, UInt bytesPerSample )
+	{
+		if ( (fileSize == 0) || ((fileSize % bytesPerSample) != 0) )
+		{
+			return 0;
+		}
+
+		UInt64 samples = fileSize / bytesPerSample;
+		UInt64 side = IntegerSquareRoot ( samples );
+
+		return ((side * side) == samples) ? side : 0;
+	}
+	//End SquareSideLength
+
+
+	//=========================================================================
+    //! @function    IsPowerOfTwoPlusOne
+    //! @brief       Check whether a value is of the form 2^n + 1
+    //=========================================================================
+	bool IsPowerOfTwoPlusOne ( UInt64 value )
+	{
+		return (value > 2) && (((value - 1) & (value - 2)) == 0);
+	}
+	//End IsPowerOfTwoPlusOne
+
+}
+//end namespace
+
+
+
+//=========================================================================
+//! @function    HeightMap::HeightMap
+//! @brief		 Construct an empty heightmap
+//=========================================================================
+HeightMap::HeightMap ( )
+: m_size(0), m_format(FORMAT_UINT8)
+{
+}
+//end HeightMap::HeightMap
+
+
+
+//=========================================================================
+//! @function    HeightMap::Load
+//! @brief		 Load a heightmap from a headerless, square RAW file
+//!
+//! @param		 fileName	[in] Name of the file to load
+//! @param		 format		[in] Format of the samples in the file
+//! @param		 maxHeight	[in] Height of the largest sample value
+//!
+//! @throw		 Core::FileNotFound if the file could not be opened
+//! @throw		 Core::RuntimeError if the file isn't a square grid of samples
+//=========================================================================
+void HeightMap::Load ( const Char* fileName, EFormat format, Float maxHeight )
+{
+	MemoryMappedFile file ( fileName );
+
+	if ( format == FORMAT_AUTO )
+	{
+		format = DetectFormat ( file.Size() );
+	}
+
+	UInt64 side = SquareSideLength ( file.Size(), BytesPerSample(format) );
+
+	if ( side < 2 )
+	{
+		throw Core::RuntimeError ( "Heightmap file isn't a square grid of samples", 0, __FILE__, __FUNCTION__, __LINE__ );
+	}
+
+	const UInt count = static_cast<UInt>(side * side);
+
+	//Convert into a temporary, so that the heightmap is left alone if this throws
+	std::vector<Float> heights ( count );
+
+	switch ( format )
+	{
+		case FORMAT_UINT8:
+			ConvertUInt8 ( file.Data(), &heights[0], count, maxHeight / 255.0f );
+			break;
+
+		case FORMAT_UINT16:
+			ConvertUInt16 ( file.Data(), &heights[0], count, maxHeight / 65535.0f );
+			break;
+
+		case FORMAT_FLOAT32:
+			ConvertFloat32 ( file.Data(), &heights[0], count, maxHeight );
+			break;
+
+		default:
+			debug_error ( "Unknown heightmap format!" );
+			break;
+	}
+
+	m_heights.swap ( heights );
+	m_size = static_cast<UInt>(side);
+	m_format = format;
+}
+//end HeightMap::Load
+
+
+
+//=========================================================================
+//! @function    HeightMap::Clear
+//! @brief		 Release the heights
+//=========================================================================
+void HeightMap::Clear ( )
+{
+	std::vector<Float>().swap ( m_heights );
+	m_size = 0;
+}
+//end HeightMap::Clear
+
+
+
+//=========================================================================
+//! @function    HeightMap::DetectFormat
+//! @brief		 Guess the sample format of a RAW heightmap from its size
+//!
+//!				 Sizes can be ambiguous, e.g. a 257x257 float heightmap is the same
+//!				 size as a 514x514 8 bit one. Terrain heightmaps are 2^n+1 samples across,
+//!				 so a format giving a side of that form is preferred. Otherwise the formats
+//!				 are tried from smallest to largest sample.
+//!
+//! @param		 fileSize [in] Size of the file in bytes
+//!
+//! @return		 The most likely format of the file
+//=========================================================================
+HeightMap::EFormat HeightMap::DetectFormat ( UInt64 fileSize )
+{
+	const EFormat formats[] = { FORMAT_UINT8, FORMAT_UINT16, FORMAT_FLOAT32 };
+	const UInt formatCount = sizeof(formats) / sizeof(formats[0]);
+
+	EFormat fallback = FORMAT_UINT8;
+	bool	foundFallback = false;
+
+	for ( UInt i = 0; i < formatCount; ++i )
+	{
+		UInt64 side = SquareSideLength ( fileSize, BytesPerSample(formats[i]) );
+
+		if ( IsPowerOfTwoPlusOne ( side ) )
+		{
+			return formats[i];
+		}
+
+		if ( (side != 0) && !foundFallback )
+		{
+			fallback = formats[i];
+			foundFallback = true;
+		}
+	}
+
+	return fallback;
+}
+//end HeightMap::DetectFormat
+
+
+
+//=========================================================================
+//! @function    HeightMap::BytesPerSample
+//! @brief		 Get the size of a sample in a format
+//=========================================================================
+UInt HeightMap::BytesPerSample ( EFormat format )
+{
+	switch ( format )
+	{
+		case FORMAT_UINT16:		return 2;
+		case FORMAT_FLOAT32:	return 4;
+		default:				return 1;
+	}
+}
+//end HeightMap::BytesPerSample
+
+
+
+//=========================================================================
+//! @function    HeightMap::ConvertUInt8
+//! @brief		 Convert 8 bit samples to scaled floats
+//!
+//! @param		 source	[in]  Samples to convert. Needn't be aligned
+//! @param		 dest	[out] Destination for count floats. Needn't be aligned
+//! @param		 count	[in]  Number of samples to convert
+//! @param		 scale	[in]  Scale applied to each sample
+//=========================================================================
+void HeightMap::ConvertUInt8 ( const Byte* source, Float* dest, UInt count, Float scale )
+{
+	UInt i = 0;
+
+#ifdef CORE_SSE2
+	const __m128  scale4 = _mm_set1_ps ( scale );
+	const __m128i zero = _mm_setzero_si128 ( );
+
+	//16 samples at a time, widened 8 -> 16 -> 32 bits
+	for ( ; (i + 16) <= count; i += 16 )
+	{
+		__m128i bytes = _mm_loadu_si128 ( reinterpret_cast<const __m128i*>(source + i) );
+		__m128i low = _mm_unpacklo_epi8 ( bytes, zero );
+		__m128i high = _mm_unpackhi_epi8 ( bytes, zero );
+
+		_mm_storeu_ps ( dest + i,	   _mm_mul_ps ( _mm_cvtepi32_ps ( _mm_unpacklo_epi16 ( low, zero ) ), scale4 ) );
+		_mm_storeu_ps ( dest + i + 4,  _mm_mul_ps ( _mm_cvtepi32_ps ( _mm_unpackhi_epi16 ( low, zero ) ), scale4 ) );
+		_mm_storeu_ps ( dest + i + 8,  _mm_mul_ps ( _mm_cvtepi32_ps ( _mm_unpacklo_epi16 ( high, zero ) ), scale4 ) );
+		_mm_storeu_ps ( dest + i + 12, _mm_mul_ps ( _mm_cvtepi32_ps ( _mm_unpackhi_epi16 ( high, zero ) ), scale4 ) );
+	}
+#endif
+
+	for ( ; i < count; ++i )
+	{
+		dest[i] = static_cast<Float>(source[i]) * scale;
+	}
+}
+//end HeightMap::ConvertUInt8
+
+
+
+//=========================================================================
+//! @function    HeightMap::ConvertUInt16
+//! @brief		 Convert 16 bit little endian samples to scaled floats
+//!
+//! @param		 source	[in]  Samples to convert. Needn't be aligned
+//! @param		 dest	[out] Destination for count floats. Needn't be aligned
+//! @param		 count	[in]  Number of samples to convert
+//! @param		 scale	[in]  Scale applied to each sample
+//=========================================================================
+void HeightMap::ConvertUInt16 ( const Byte* source, Float* dest, UInt count, Float scale )
+{
+	UInt i = 0;
+
+#ifdef CORE_SSE2
+	const __m128  scale4 = _mm_set1_ps ( scale );
+	const __m128i zero = _mm_setzero_si128 ( );
+
+	//8 samples at a time, widened 16 -> 32 bits. SSE2 is little endian, so no swap is needed
+	for ( ; (i + 8) <= count; i += 8 )
+	{
+		__m128i words = _mm_loadu_si128 ( reinterpret_cast<const __m128i*>(source + (i * 2)) );
+
+		_mm_storeu_ps ( dest + i,	  _mm_mul_ps ( _mm_cvtepi32_ps ( _mm_unpacklo_epi16 ( words, zero ) ), scale4 ) );
+		_mm_storeu_ps ( dest + i + 4, _mm_mul_ps ( _mm_cvtepi32_ps ( _mm_unpackhi_epi16 ( words, zero ) ), scale4 ) );
+	}
+#endif
+
+	for ( ; i < count; ++i )
+	{
+		UInt value = static_cast<UInt>(source[i * 2]) | (static_cast<UInt>(source[(i * 2) + 1]) << 8);
+		dest[i] = static_cast<Float>(value) * scale;
+	}
+}
+//end HeightMap::ConvertUInt16
+
+
+
+//=========================================================================
+//! @function    HeightMap::ConvertFloat32
+//! @brief		 Convert 32 bit float samples to scaled floats
+//!
+//! @param		 source	[in]  Samples to convert. Needn't be aligned
+//! @param		 dest	[out] Destination for count floats. Needn't be aligned
+//! @param		 count	[in]  Number of samples to convert
+//! @param		 scale	[in]  Scale applied to each sample
+//=========================================================================
+void HeightMap::ConvertFloat32 ( const Byte* source, Float* dest, UInt count, Float scale )
+{
+	UInt i = 0;
+
+#ifdef CORE_SSE2
+	const __m128 scale4 = _mm_set1_ps ( scale );
+
+	for ( ; (i + 4) <= count; i += 4 )
+	{
+		__m128 values = _mm_loadu_ps ( reinterpret_cast<const float*>(source + (i * 4)) );
+		_mm_storeu_ps ( dest + i, _mm_mul_ps ( values, scale4 ) );
+	}
+#endif
+
+	for ( ; i < count; ++i )
+	{
+		Float value;
+		std::memcpy ( &value, source + (i * 4), sizeof(Float) );
+		dest[i] = value * scale;
+	}
+}
+//end HeightMap::ConvertFloat32
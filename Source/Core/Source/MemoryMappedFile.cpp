@@ -0,0 +1,162 @@
+//======================================================================================
+//! @file         MemoryMappedFile.cpp
+//! @brief        Read only memory mapped view of a file
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+
+#include "Core/Core.h"
+#include "Core/FileError.h"
+#include "Core/MemoryMappedFile.h"
+
+
+
+using namespace Core;
+
+
+
+
+//=========================================================================
+//! @function    MemoryMappedFile::MemoryMappedFile
+//! @brief		 Construct a MemoryMappedFile without opening a file
+//=========================================================================
+MemoryMappedFile::MemoryMappedFile ( )
+: m_file(INVALID_HANDLE_VALUE), m_mapping(0), m_data(0), m_size(0)
+{
+}
+//end MemoryMappedFile::MemoryMappedFile
+
+
+
+//=========================================================================
+//! @function    MemoryMappedFile::MemoryMappedFile
+//! @brief		 Construct a MemoryMappedFile, and map the file specified
+//!
+//! @param		 fileName [in] Name of the file to map
+//!
+//! @throw		 Core::FileNotFound if the file could not be opened
+//! @throw		 Core::RuntimeError if the file could not be mapped
+//=========================================================================
+MemoryMappedFile::MemoryMappedFile ( const Char* fileName )
+: m_file(INVALID_HANDLE_VALUE), m_mapping(0), m_data(0), m_size(0)
+{
+	Open ( fileName );
+}
+//end MemoryMappedFile::MemoryMappedFile
+
+
+
+//=========================================================================
+//! @function    MemoryMappedFile::~MemoryMappedFile
+//! @brief		 Unmap the file
+//=========================================================================
+MemoryMappedFile::~MemoryMappedFile ( )
+{
+	Close ( );
+}
+//end MemoryMappedFile::~MemoryMappedFile
+
+
+
+//=========================================================================
+//! @function    MemoryMappedFile::Open
+//! @brief		 Map a file into memory, closing any file that is already mapped
+//!
+//! @param		 fileName [in] Name of the file to map
+//!
+//! @throw		 Core::FileNotFound if the file could not be opened
+//! @throw		 Core::RuntimeError if the file could not be mapped
+//=========================================================================
+void MemoryMappedFile::Open ( const Char* fileName )
+{
+	debug_assert ( fileName, "Null filename passed to MemoryMappedFile::Open!" );
+
+	Close ( );
+
+	m_file = CreateFileA ( fileName, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, 
+						   FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, 0 );
+
+	if ( m_file == INVALID_HANDLE_VALUE )
+	{
+		throw Core::FileNotFound ( fileName, GetLastError(), __FILE__, __FUNCTION__, __LINE__ );
+	}
+
+	DWORD sizeHigh = 0;
+	DWORD sizeLow = GetFileSize ( m_file, &sizeHigh );
+
+	m_size = (static_cast<UInt64>(sizeHigh) << 32) | sizeLow;
+
+	//An empty file can't be mapped, but it's not an error to open one
+	if ( m_size == 0 )
+	{
+		return;
+	}
+
+	m_mapping = CreateFileMappingA ( m_file, 0, PAGE_READONLY, 0, 0, 0 );
+
+	if ( m_mapping != 0 )
+	{
+		m_data = reinterpret_cast<const Byte*>( MapViewOfFile ( m_mapping, FILE_MAP_READ, 0, 0, 0 ) );
+	}
+
+	if ( m_data == 0 )
+	{
+		DWORD error = GetLastError();
+		Close ( );
+
+		throw Core::RuntimeError ( "Could not map file into memory", error, __FILE__, __FUNCTION__, __LINE__ );
+	}
+}
+//end MemoryMappedFile::Open
+
+
+
+//=========================================================================
+//! @function    MemoryMappedFile::Close
+//! @brief		 Unmap the file, if one is mapped
+//=========================================================================
+void MemoryMappedFile::Close ( )
+{
+	if ( m_data != 0 )
+	{
+		UnmapViewOfFile ( m_data );
+		m_data = 0;
+	}
+
+	if ( m_mapping != 0 )
+	{
+		CloseHandle ( m_mapping );
+		m_mapping = 0;
+	}
+
+	if ( m_file != INVALID_HANDLE_VALUE )
+	{
+		CloseHandle ( m_file );
+		m_file = INVALID_HANDLE_VALUE;
+	}
+
+	m_size = 0;
+}
+//end MemoryMappedFile::Close
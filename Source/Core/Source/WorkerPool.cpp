@@ -0,0 +1,261 @@
+//======================================================================================
+//! @file         WorkerPool.cpp
+//! @brief        Pool of worker threads that execute jobs submitted by the main thread
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+#include <process.h>
+#include "Core/Core.h"
+#include "Core/WorkerPool.h"
+
+
+
+using namespace Core;
+
+
+
+
+//=========================================================================
+//! @function    WorkerPool::WorkerPool
+//! @brief		 WorkerPool constructor. Starts the worker threads
+//! 
+//! @param		 threadCount [in] Number of worker threads to create.
+//!								  May be zero, in which case jobs are run
+//!								  on the thread that calls WaitForAll
+//!
+//! @throw		 Core::RuntimeError if the threads could not be created
+//=========================================================================
+WorkerPool::WorkerPool ( UInt threadCount )
+: m_jobSemaphore(0), m_idleEvent(0), m_pendingJobs(0), m_jobFailed(false), m_quit(false)
+{
+	m_jobSemaphore = CreateSemaphore ( 0, 0, LONG_MAX, 0 );
+	m_idleEvent	   = CreateEvent ( 0, TRUE, TRUE, 0 );
+
+	if ( (m_jobSemaphore == 0) || (m_idleEvent == 0) )
+	{
+		throw Core::RuntimeError ( "Could not create worker pool synchronisation objects!", GetLastError(), 
+								   __FILE__, __FUNCTION__, __LINE__ );
+	}
+
+	for ( UInt i=0; i < threadCount; ++i )
+	{
+		HANDLE thread = reinterpret_cast<HANDLE>( _beginthreadex ( 0, 0, &WorkerPool::ThreadMain, this, 0, 0 ) );
+
+		if ( thread == 0 )
+		{
+			std::cerr << __FUNCTION__ ": Could not create worker thread " << i 
+					  << ", continuing with " << m_threads.size() << " threads" << std::endl;
+			break;
+		}
+
+		m_threads.push_back ( thread );
+	}
+
+	std::clog << __FUNCTION__ ": Created worker pool with " << m_threads.size() << " threads" << std::endl;
+}
+//end WorkerPool::WorkerPool
+
+
+
+//=========================================================================
+//! @function    WorkerPool::~WorkerPool
+//! @brief		 WorkerPool destructor. Stops the worker threads
+//!
+//!				 Any jobs that are still queued are not executed
+//=========================================================================
+WorkerPool::~WorkerPool ( )
+{
+	m_quit = true;
+
+	if ( !m_threads.empty() )
+	{
+		ReleaseSemaphore ( m_jobSemaphore, static_cast<LONG>(m_threads.size()), 0 );
+		WaitForMultipleObjects ( static_cast<DWORD>(m_threads.size()), &m_threads[0], TRUE, INFINITE );
+
+		for ( std::vector<HANDLE>::iterator itr = m_threads.begin(); itr != m_threads.end(); ++itr )
+		{
+			CloseHandle ( *itr );
+		}
+	}
+
+	CloseHandle ( m_jobSemaphore );
+	CloseHandle ( m_idleEvent );
+}
+//end WorkerPool::~WorkerPool
+
+
+
+//=========================================================================
+//! @function    WorkerPool::Submit
+//! @brief		 Queue a job for execution on one of the worker threads
+//!
+//! @param		 job [in] Job to execute. Must remain valid until WaitForAll returns
+//=========================================================================
+void WorkerPool::Submit ( IJob& job )
+{
+	{
+		ScopedLock lock ( m_lock );
+
+		m_jobs.push_back ( &job );
+
+		if ( m_pendingJobs++ == 0 )
+		{
+			ResetEvent ( m_idleEvent );
+		}
+	}
+
+	if ( !m_threads.empty() )
+	{
+		ReleaseSemaphore ( m_jobSemaphore, 1, 0 );
+	}
+}
+//end WorkerPool::Submit
+
+
+
+//=========================================================================
+//! @function    WorkerPool::WaitForAll
+//! @brief		 Block until every submitted job has finished
+//!
+//!				 The calling thread helps out by executing queued jobs
+//!				 until the queue is empty, then waits for the workers
+//!
+//! @throw		 Core::RuntimeError if any of the jobs threw an exception
+//=========================================================================
+void WorkerPool::WaitForAll ( )
+{
+	while ( ExecuteNextJob() )
+	{
+	}
+
+	WaitForSingleObject ( m_idleEvent, INFINITE );
+
+	ScopedLock lock ( m_lock );
+
+	if ( m_jobFailed )
+	{
+		m_jobFailed = false;
+		throw Core::RuntimeError ( "A job executed by the worker pool threw an exception", 0, 
+								   __FILE__, __FUNCTION__, __LINE__ );
+	}
+}
+//end WorkerPool::WaitForAll
+
+
+
+//=========================================================================
+//! @function    WorkerPool::HardwareThreadCount
+//! @brief		 Get the number of processors available to the process
+//!
+//! @return		 The number of hardware threads
+//=========================================================================
+UInt WorkerPool::HardwareThreadCount ( )
+{
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo ( &systemInfo );
+
+	return static_cast<UInt>( systemInfo.dwNumberOfProcessors );
+}
+//end WorkerPool::HardwareThreadCount
+
+
+
+//=========================================================================
+//! @function    WorkerPool::ExecuteNextJob
+//! @brief		 Take the job at the front of the queue and execute it
+//!
+//! @return		 false if the queue was empty, true otherwise
+//=========================================================================
+bool WorkerPool::ExecuteNextJob ( )
+{
+	IJob* job = 0;
+
+	{
+		ScopedLock lock ( m_lock );
+
+		if ( m_jobs.empty() )
+		{
+			return false;
+		}
+
+		job = m_jobs.front();
+		m_jobs.pop_front();
+	}
+
+	bool failed = false;
+
+	try
+	{
+		job->Execute();
+	}
+	catch ( ... )
+	{
+		failed = true;
+	}
+
+	//The idle event must be set under the lock, otherwise it could race 
+	//with a Submit call resetting it
+	ScopedLock lock ( m_lock );
+
+	m_jobFailed = m_jobFailed || failed;
+
+	if ( --m_pendingJobs == 0 )
+	{
+		SetEvent ( m_idleEvent );
+	}
+
+	return true;
+}
+//end WorkerPool::ExecuteNextJob
+
+
+
+//=========================================================================
+//! @function    WorkerPool::ThreadMain
+//! @brief		 Entry point for the worker threads
+//!
+//! @param		 pool [in] Pointer to the WorkerPool that owns the thread
+//=========================================================================
+unsigned __stdcall WorkerPool::ThreadMain ( void* pool )
+{
+	WorkerPool& workerPool = *reinterpret_cast<WorkerPool*>(pool);
+
+	for ( ;; )
+	{
+		WaitForSingleObject ( workerPool.m_jobSemaphore, INFINITE );
+
+		if ( workerPool.m_quit )
+		{
+			break;
+		}
+
+		//The job may already have been taken by a thread in WaitForAll, 
+		//in which case there's nothing to do
+		workerPool.ExecuteNextJob();
+	}
+
+	return 0;
+}
+//end WorkerPool::ThreadMain
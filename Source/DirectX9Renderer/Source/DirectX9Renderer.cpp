@@ -3083,6 +3083,7 @@ void DirectXRenderer::CreateDevice ( )
 	Core::ConsoleUInt init_bpp("init_bpp", 32 );
 	Core::ConsoleUInt init_mode( "init_mode", 0 );
 	Core::ConsoleBool init_fullscreen ( "init_fullscreen", false );
+	Core::ConsoleBool init_multithreaded ( "init_multithreaded", false );
 
 	//Setup present parameters
 	if ( init_fullscreen )
@@ -3105,6 +3106,9 @@ void DirectXRenderer::CreateDevice ( )
 		behaviourFlags = D3DCREATE_SOFTWARE_VERTEXPROCESSING;
 	}
 
+	//The device has to guard itself if it will be called from more than one thread
+	const DWORD threadingFlags = init_multithreaded ? D3DCREATE_MULTITHREADED : 0;
+
 	//Create the device
 	HRESULT result = 0;
 	if ( m_deviceType == D3DDEVTYPE_HAL )
@@ -3133,12 +3137,13 @@ void DirectXRenderer::CreateDevice ( )
 		#endif
 
 		result = m_d3d->CreateDevice ( m_adapter, m_deviceType, Window().WindowHandle(),
-										behaviourFlags, &m_presentParameters, &m_device );
+										behaviourFlags | threadingFlags, &m_presentParameters, &m_device );
 	}
 	else
 	{
 		result = m_d3d->CreateDevice ( m_adapter, m_deviceType, Window().WindowHandle(),
-										D3DCREATE_SOFTWARE_VERTEXPROCESSING, &m_presentParameters, &m_device );
+										D3DCREATE_SOFTWARE_VERTEXPROCESSING | threadingFlags, 
+										&m_presentParameters, &m_device );
 	}
 
 	if ( SUCCEEDED(result) )
@@ -41,6 +41,11 @@
 	#define MATH_IOSTREAM_SUPPORT
 #endif
 
+//Use SSE for the matrix and vector kernels on x86. Define MATH_NO_SIMD to build the scalar versions
+#if !defined(MATH_NO_SIMD) && (defined(_M_IX86) || defined(_M_X64) || defined(__SSE__))
+	#define MATH_SSE
+#endif
+
 namespace Math
 {
 
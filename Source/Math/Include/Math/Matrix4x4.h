@@ -34,6 +34,10 @@
 #include "Math/Math.h"
 #include "Math/Vector3D.h"
 
+#ifdef MATH_SSE
+	#include <xmmintrin.h>
+#endif
+
 
 //namespace Math
 namespace Math
@@ -116,6 +120,9 @@ namespace Math
 			inline bool Inverse ( Matrix4x4& result ) const throw();
 			void		InvertByTranspose ( ) throw();
 			bool		Invert  ( ) throw ();
+			bool		InvertAffine ( ) throw ();
+			void		InvertRigid ( ) throw ();
+			inline bool IsAffine ( ) const throw ();
 			Scalar		Determinate () const;
 			void		SwapColumn ( UInt firstIndex, UInt secondIndex ) throw ();
 			void		Transpose ( ) throw ();
@@ -169,6 +176,9 @@ namespace Math
 	//Vector multiply by Matrix4x4
 	inline Vector3D  operator *   ( const Vector3D& lhs, const Matrix4x4& rhs );
 	inline Vector3D& operator *= ( Vector3D& lhs, const Matrix4x4& rhs );
+
+	//Transform an array of points by a Matrix4x4
+	void TransformPoints ( const Vector3D* points, Vector3D* result, UInt count, const Matrix4x4& matrix ) throw();
 	
 
     //=========================================================================
@@ -483,6 +493,20 @@ namespace Math
 	//End Matrix4x4::FastInvert
 	
 
+    //=========================================================================
+    //! @function    Matrix4x4::IsAffine
+    //! @brief       Check whether the last column of the matrix is (0, 0, 0, 1)
+    //!              
+    //! @return      true if the matrix can be inverted with InvertAffine
+    //=========================================================================
+	bool Matrix4x4::IsAffine ( ) const
+	{
+		return (m_03 == 0.0f) && (m_13 == 0.0f) && (m_23 == 0.0f) && (m_33 == 1.0f);
+	}
+	//End Matrix4x4::IsAffine
+
+
+
     //=========================================================================
     //! @function    Matrix4x4::operator ()
     //! @brief       Access the element at row,col
@@ -557,6 +581,26 @@ namespace Math
     //=========================================================================
 	Matrix4x4& Matrix4x4::operator *= ( const Matrix4x4& rhs )
 	{
+#ifdef MATH_SSE
+
+		//Each row of the result is a combination of the rows of rhs. They're all
+		//loaded first, so this works when rhs is *this
+		const __m128 rhs0 = _mm_loadu_ps ( rhs.m[0] );
+		const __m128 rhs1 = _mm_loadu_ps ( rhs.m[1] );
+		const __m128 rhs2 = _mm_loadu_ps ( rhs.m[2] );
+		const __m128 rhs3 = _mm_loadu_ps ( rhs.m[3] );
+
+		for ( UInt row = 0; row < ms_numRows; ++row )
+		{
+			__m128 result = _mm_mul_ps ( _mm_set1_ps(m[row][0]), rhs0 );
+			result = _mm_add_ps ( result, _mm_mul_ps ( _mm_set1_ps(m[row][1]), rhs1 ) );
+			result = _mm_add_ps ( result, _mm_mul_ps ( _mm_set1_ps(m[row][2]), rhs2 ) );
+			result = _mm_add_ps ( result, _mm_mul_ps ( _mm_set1_ps(m[row][3]), rhs3 ) );
+
+			_mm_storeu_ps ( m[row], result );
+		}
+
+#else
 		Scalar m00 = m_00;
 		Scalar m01 = m_01;
 		Scalar m02 = m_02;
@@ -597,6 +641,8 @@ namespace Math
 		m_32 = (m30 * rhs(0,2)) + (m31 * rhs(1,2)) + (m32 * rhs(2,2)) + (m33 * rhs(3,2));
 		m_33 = (m30 * rhs(0,3)) + (m31 * rhs(1,3)) + (m32 * rhs(2,3)) + (m33 * rhs(3,3));
 
+#endif
+
 		return (*this);
 	}
 	//end Matrix4x4::operator *=
@@ -620,6 +666,8 @@ namespace Math
 				m[row][col] *= rhs;
 			}
 		}
+
+		return (*this);
 	}
 	//end operator *= ( Scalar )
 
@@ -745,6 +793,22 @@ namespace Math
     //=========================================================================
 	Vector3D& operator *= ( Vector3D& lhs, const Matrix4x4& rhs )
 	{
+#ifdef MATH_SSE
+
+		const Scalar* matrix = rhs.GetPointer();
+
+		__m128 result = _mm_mul_ps ( _mm_set1_ps(lhs.X()), _mm_loadu_ps(matrix) );
+		result = _mm_add_ps ( result, _mm_mul_ps ( _mm_set1_ps(lhs.Y()), _mm_loadu_ps(matrix + 4) ) );
+		result = _mm_add_ps ( result, _mm_mul_ps ( _mm_set1_ps(lhs.Z()), _mm_loadu_ps(matrix + 8) ) );
+		result = _mm_add_ps ( result, _mm_mul_ps ( _mm_set1_ps(lhs.W()), _mm_loadu_ps(matrix + 12) ) );
+
+		Scalar transformed[4];
+		_mm_storeu_ps ( transformed, result );
+
+		lhs.Set ( transformed[0], transformed[1], transformed[2] );
+
+#else
+
 		//This could be optimised if need be by passing these values
 		//directly to the set method of lhs instead of using these three temporaries
 		//It's just a bit easier to read this way
@@ -754,6 +818,8 @@ namespace Math
 
 		lhs.Set ( x,y,z );
 
+#endif
+
 		return lhs;
 	}
 	//end operator *= ( Vector3D, Matrix4x4 )
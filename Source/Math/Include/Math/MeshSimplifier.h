@@ -0,0 +1,143 @@
+//======================================================================================
+//! @file         MeshSimplifier.h
+//! @brief        Simplifies indexed triangle lists with quadric error metrics
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+#ifndef MATH_MESHSIMPLIFIER_H
+#define MATH_MESHSIMPLIFIER_H
+
+
+#include <vector>
+#include <queue>
+#include <boost/noncopyable.hpp>
+#include "Math/Math.h"
+#include "Math/Vector3D.h"
+
+
+//namespace Math
+namespace Math
+{
+
+	//!@class	MeshSimplifier
+	//!@brief	Simplifies an indexed triangle list by collapsing edges, cheapest first,
+	//!			using the quadric error metric of Garland and Heckbert
+	//!
+	//!			Edges are collapsed by moving one of their vertices onto the other, so 
+	//!			every level of detail uses the original vertices, and only the indices change.
+	//!			Vertices on open edges are never moved. Meshes split their vertices along 
+	//!			texture and smoothing seams, so this keeps seams and silhouettes from tearing.
+	//!
+	//!			SimplifyTo can be called repeatedly with smaller targets to generate 
+	//!			successive levels of detail, each simplified from the last.
+	class MeshSimplifier : public boost::noncopyable
+	{
+		public:
+
+            //=========================================================================
+            // Constructors
+            //=========================================================================
+			MeshSimplifier ( );
+
+            //=========================================================================
+            // Public methods
+            //=========================================================================
+			void Initialise ( const Vector3D* positions, UInt vertexCount, const UInt* indices, UInt triangleCount );
+			void SimplifyTo ( UInt targetTriangleCount );
+
+			void GetTriangles ( std::vector<UInt>& indices, std::vector<UInt>& sourceTriangles ) const;
+
+			//! Number of triangles left
+			UInt	TriangleCount () const		{ return m_triangleCount;	}
+
+			//! Largest quadric error of any collapse so far
+			Double	Error () const				{ return m_error;			}
+
+		private:
+
+            //=========================================================================
+            // Private types
+            //=========================================================================
+
+			//Symmetric 4x4 matrix, the sum of squared distances to a set of planes
+			struct Quadric
+			{
+				Double	m[10];
+
+				Quadric ( );
+				Quadric ( Double a, Double b, Double c, Double d, Double weight );
+
+				Quadric& operator+= ( const Quadric& rhs );
+				Double	 Evaluate ( const Vector3D& point ) const;
+			};
+
+			//Collapse of the edge from one vertex onto another. The stamps are the
+			//vertices' stamps when the cost was calculated, and it's stale if they've changed
+			struct Collapse
+			{
+				Double	cost;
+				UInt	from;
+				UInt	to;
+				UInt	fromStamp;
+				UInt	toStamp;
+
+				//The priority queue puts the largest first, so the cheapest collapse is the "largest"
+				bool operator< ( const Collapse& rhs ) const	{ return cost > rhs.cost;	}
+			};
+
+            //=========================================================================
+            // Private methods
+            //=========================================================================
+			bool CanCollapse ( UInt from, UInt to );
+			void DoCollapse ( UInt from, UInt to );
+			void PushCollapse ( UInt from, UInt to );
+			void PushCollapses ( UInt vertex );
+			void GatherNeighbours ( UInt vertex, std::vector<UInt>& neighbours ) const;
+
+            //=========================================================================
+            // Private data
+            //=========================================================================
+			std::vector<Vector3D>				m_positions;
+			std::vector<UInt>					m_indices;
+			std::vector<bool>					m_triangleAlive;
+			std::vector< std::vector<UInt> >	m_vertexTriangles;
+			std::vector<Quadric>				m_quadrics;
+			std::vector<UInt>					m_stamps;
+			std::vector<bool>					m_locked;
+			std::vector<bool>					m_collapsed;
+			std::priority_queue<Collapse>		m_collapses;
+			UInt								m_triangleCount;
+			Double								m_error;
+
+			//Scratch space for CanCollapse
+			std::vector<UInt>					m_fromNeighbours;
+			std::vector<UInt>					m_toNeighbours;
+	};
+	//End class MeshSimplifier
+
+};
+//end namespace Math
+
+
+#endif //MATH_MESHSIMPLIFIER_H
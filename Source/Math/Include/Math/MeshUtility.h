@@ -0,0 +1,106 @@
+//======================================================================================
+//! @file         MeshUtility.h
+//! @brief        Helper functions for indexed triangle lists
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+
+#ifndef MATH_MESHUTILITY_H
+#define MATH_MESHUTILITY_H
+
+
+#include <vector>
+#include "Core/BasicTypes.h"
+
+
+//namespace Math
+namespace Math
+{
+
+    //=========================================================================
+    // Function prototypes
+    //=========================================================================
+	template <class IndexType>
+		inline void BuildVertexTriangleAdjacency ( const IndexType* indices, UInt indexCount, UInt vertexCount,
+												   std::vector<UInt>& cornerStart, std::vector<UInt>& corners );
+
+
+
+	//=========================================================================
+    //! @function    Math::BuildVertexTriangleAdjacency<IndexType>
+    //! @brief       Find the triangle corners that use each vertex of an indexed triangle list
+    //!              
+	//!				 The corners are gathered with a counting sort, so this is linear in 
+	//!				 the number of vertices and indices. A corner is the position of an index 
+	//!				 in the index array, so the triangle it belongs to is corner / 3.
+	//!				 The corners of vertex v are corners[cornerStart[v]] up to corners[cornerStart[v+1]],
+	//!				 in the order they appear in the index array.
+	//!
+    //! @param       indices	 [in]  Indices of the triangle list
+    //! @param       indexCount	 [in]  Number of indices
+    //! @param       vertexCount [in]  Number of vertices the indices refer to
+    //! @param       cornerStart [out] vertexCount + 1 offsets into corners
+    //! @param       corners	 [out] indexCount corners, grouped by vertex
+    //=========================================================================
+	template <class IndexType>
+	inline void BuildVertexTriangleAdjacency ( const IndexType* indices, UInt indexCount, UInt vertexCount,
+											   std::vector<UInt>& cornerStart, std::vector<UInt>& corners )
+	{
+		//Count into the slot after each vertex, and turn the counts into start offsets
+		cornerStart.assign ( vertexCount + 1, 0 );
+		corners.resize ( indexCount );
+
+		for ( UInt corner = 0; corner < indexCount; ++corner )
+		{
+			debug_assert ( indices[corner] < vertexCount, "Index is out of range!" );
+
+			++cornerStart[indices[corner] + 1];
+		}
+
+		for ( UInt vertex = 0; vertex < vertexCount; ++vertex )
+		{
+			cornerStart[vertex + 1] += cornerStart[vertex];
+		}
+
+		//Filling each vertex's corners advances its start to the next vertex's start,
+		//so shift the starts back down afterwards
+		for ( UInt corner = 0; corner < indexCount; ++corner )
+		{
+			corners[cornerStart[indices[corner]]++] = corner;
+		}
+
+		for ( UInt vertex = vertexCount; vertex > 0; --vertex )
+		{
+			cornerStart[vertex] = cornerStart[vertex - 1];
+		}
+		cornerStart[0] = 0;
+	}
+	//End Math::BuildVertexTriangleAdjacency<IndexType>
+
+}
+//end namespace Math
+
+
+#endif //MATH_MESHUTILITY_H
@@ -0,0 +1,96 @@
+//======================================================================================
+//! @file         VertexNormalGenerator.h
+//! @brief        Generates smoothed vertex normals for an indexed triangle list
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+#ifndef MATH_VERTEXNORMALGENERATOR_H
+#define MATH_VERTEXNORMALGENERATOR_H
+
+
+#include <vector>
+#include "Math/Math.h"
+#include "Math/Vector3D.h"
+
+
+//namespace Math
+namespace Math
+{
+
+	//!@class	VertexNormalGenerator
+	//!@brief	Generates face normals, and vertex normals that respect smoothing groups,
+	//!			for an indexed triangle list
+	//!
+	//!			The triangle corners that use each vertex are gathered with a counting sort,
+	//!			so generation is linear in the number of vertices and triangles, rather than
+	//!			scanning every triangle for every vertex. A vertex's normal is only averaged 
+	//!			over triangles in the same smoothing group. Where triangles from several groups
+	//!			share a vertex, a new vertex is made for each group after the first, and the
+	//!			triangle indices are changed to point at it. Triangles in group 0 aren't smoothed,
+	//!			so every corner in group 0 gets its own vertex.
+	class VertexNormalGenerator
+	{
+		public:
+
+            //=========================================================================
+            // Constructors
+            //=========================================================================
+			VertexNormalGenerator ( );
+
+            //=========================================================================
+            // Public methods
+            //=========================================================================
+			void Generate ( const Vector3D* positions, UInt vertexCount, 
+							UInt* indices, const UInt* smoothingGroups, UInt triangleCount );
+
+			//! Number of vertices after splitting. Never less than the vertex count passed to Generate
+			UInt			VertexCount () const				{ return m_sourceVertices.size();	}
+
+			//! The input vertex that a vertex was copied from. Input vertices are their own source
+			UInt			SourceVertex ( UInt vertex ) const	{ return m_sourceVertices[vertex];	}
+
+			const Vector3D& VertexNormal ( UInt vertex ) const	{ return m_vertexNormals[vertex];	}
+			const Vector3D& FaceNormal ( UInt triangle ) const	{ return m_faceNormals[triangle];	}
+
+		private:
+
+            //=========================================================================
+            // Private data
+            //=========================================================================
+			std::vector<Vector3D>	m_faceNormals;
+			std::vector<Vector3D>	m_vertexNormals;
+			std::vector<UInt>		m_sourceVertices;
+
+			//Corners (triangle * 3 + corner) that use each vertex. The corners of vertex v
+			//are m_corners[m_cornerStart[v]] up to m_corners[m_cornerStart[v+1]]
+			std::vector<UInt>		m_cornerStart;
+			std::vector<UInt>		m_corners;
+	};
+	//End class VertexNormalGenerator
+
+};
+//end namespace Math
+
+
+#endif //MATH_VERTEXNORMALGENERATOR_H
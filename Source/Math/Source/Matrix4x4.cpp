@@ -29,6 +29,7 @@
 
 #include <iostream>
 #include <algorithm>
+#include <boost/static_assert.hpp>
 #include "Math/Vector3D.h"
 #include "Math/Matrix4x4.h"
 #include "Math/MatrixNxN.h"
@@ -39,6 +40,33 @@ using namespace Math;
 
 
 
+#ifdef MATH_SSE
+
+//namespace
+namespace
+{
+	//=========================================================================
+    //! @function    CrossProduct
+    //! @brief       Cross product of the xyz parts of two vectors. w of the result is zero
+    //=========================================================================
+	inline __m128 CrossProduct ( __m128 lhs, __m128 rhs )
+	{
+		const __m128 lhsYZX = _mm_shuffle_ps ( lhs, lhs, _MM_SHUFFLE(3, 0, 2, 1) );
+		const __m128 rhsYZX = _mm_shuffle_ps ( rhs, rhs, _MM_SHUFFLE(3, 0, 2, 1) );
+		const __m128 lhsZXY = _mm_shuffle_ps ( lhs, lhs, _MM_SHUFFLE(3, 1, 0, 2) );
+		const __m128 rhsZXY = _mm_shuffle_ps ( rhs, rhs, _MM_SHUFFLE(3, 1, 0, 2) );
+
+		return _mm_sub_ps ( _mm_mul_ps ( lhsYZX, rhsZXY ), _mm_mul_ps ( lhsZXY, rhsYZX ) );
+	}
+	//End CrossProduct
+}
+//end namespace
+
+#endif
+//#ifdef MATH_SSE
+
+
+
 //=========================================================================
 // Static initialisation
 //=========================================================================
@@ -275,7 +303,7 @@ void Matrix4x4::CreateRotationMatrix ( Matrix4x4& mat, const Vector3D& axis, Sca
 
 	mat(1,0) = (axis.X() * axis.Y()) * (1.0f-cosTheta) - (axis.Z() * sinTheta);
 	mat(1,1) = cosTheta + (axis.Y()*axis.Y()) * (1.0f-cosTheta);
-	mat(1,2) = (axis.X() * axis.Z()) * (1.0f-cosTheta) - (axis.X() * sinTheta);
+	mat(1,2) = (axis.Y() * axis.Z()) * (1.0f-cosTheta) + (axis.X() * sinTheta);
 	mat(1,3) = 0.0f;
 
 	mat(2,0) = (axis.X() * axis.Z()) * (1.0f-cosTheta) + (axis.Y() * sinTheta);
@@ -839,7 +867,10 @@ bool Matrix4x4::Invert ( )
 						aug.AddMultipleOfRowToRow(j, r, -aug(r,j)); 
 					}
 				}
-				
+
+				//Column j is done. Carrying on would pick another pivot from the 
+				//rounding error left in the rows below
+				break;
 			}
 		}
 	}
@@ -867,6 +898,162 @@ bool Matrix4x4::Invert ( )
 
 
 
+//=========================================================================
+//! @function    Matrix4x4::InvertAffine
+//! @brief       Invert an affine matrix, if possible
+//!              
+//!				 Much cheaper than Invert, but the last column of the matrix must be
+//!				 (0, 0, 0, 1). The upper 3x3 is inverted from its cofactors, and the
+//!				 translation is the negated old translation transformed by that inverse
+//!              
+//! @return      Returns true if the matrix was inverted successfully
+//!				 Returns false if the matrix could not be inverted. The matrix is unchanged
+//=========================================================================
+bool Matrix4x4::InvertAffine ( )
+{
+	debug_assert ( IsAffine(), "Matrix isn't affine!" );
+
+#ifdef MATH_SSE
+
+	const __m128 row0 = _mm_loadu_ps ( m[0] );
+	const __m128 row1 = _mm_loadu_ps ( m[1] );
+	const __m128 row2 = _mm_loadu_ps ( m[2] );
+	const __m128 translation = _mm_loadu_ps ( m[3] );
+
+	//The columns of the inverse are the cross products of the rows, over the determinant
+	__m128 column0 = CrossProduct ( row1, row2 );
+	__m128 column1 = CrossProduct ( row2, row0 );
+	__m128 column2 = CrossProduct ( row0, row1 );
+	__m128 column3 = _mm_setzero_ps();
+
+	Scalar products[4];
+	_mm_storeu_ps ( products, _mm_mul_ps ( row0, column0 ) );
+
+	const Scalar determinant = products[0] + products[1] + products[2];
+
+	if ( determinant == 0.0f )
+	{
+		return false;
+	}
+
+	const __m128 inverseDeterminant = _mm_set1_ps ( 1.0f / determinant );
+
+	column0 = _mm_mul_ps ( column0, inverseDeterminant );
+	column1 = _mm_mul_ps ( column1, inverseDeterminant );
+	column2 = _mm_mul_ps ( column2, inverseDeterminant );
+
+	_MM_TRANSPOSE4_PS ( column0, column1, column2, column3 );
+
+	//column3 is now zero, with w = 0, so the last column comes out as (0, 0, 0, 1)
+	__m128 newTranslation = _mm_mul_ps ( _mm_shuffle_ps ( translation, translation, _MM_SHUFFLE(0, 0, 0, 0) ), column0 );
+	newTranslation = _mm_add_ps ( newTranslation, _mm_mul_ps ( _mm_shuffle_ps ( translation, translation, _MM_SHUFFLE(1, 1, 1, 1) ), column1 ) );
+	newTranslation = _mm_add_ps ( newTranslation, _mm_mul_ps ( _mm_shuffle_ps ( translation, translation, _MM_SHUFFLE(2, 2, 2, 2) ), column2 ) );
+	newTranslation = _mm_sub_ps ( _mm_set_ps ( 1.0f, 0.0f, 0.0f, 0.0f ), newTranslation );
+
+	_mm_storeu_ps ( m[0], column0 );
+	_mm_storeu_ps ( m[1], column1 );
+	_mm_storeu_ps ( m[2], column2 );
+	_mm_storeu_ps ( m[3], newTranslation );
+
+#else
+
+	//Cofactors of the upper 3x3
+	const Scalar c00 = (m_11 * m_22) - (m_12 * m_21);
+	const Scalar c01 = (m_12 * m_20) - (m_10 * m_22);
+	const Scalar c02 = (m_10 * m_21) - (m_11 * m_20);
+
+	const Scalar determinant = (m_00 * c00) + (m_01 * c01) + (m_02 * c02);
+
+	if ( determinant == 0.0f )
+	{
+		return false;
+	}
+
+	const Scalar inverseDeterminant = 1.0f / determinant;
+
+	const Scalar i00 = c00 * inverseDeterminant;
+	const Scalar i10 = c01 * inverseDeterminant;
+	const Scalar i20 = c02 * inverseDeterminant;
+	const Scalar i01 = ((m_02 * m_21) - (m_01 * m_22)) * inverseDeterminant;
+	const Scalar i11 = ((m_00 * m_22) - (m_02 * m_20)) * inverseDeterminant;
+	const Scalar i21 = ((m_01 * m_20) - (m_00 * m_21)) * inverseDeterminant;
+	const Scalar i02 = ((m_01 * m_12) - (m_02 * m_11)) * inverseDeterminant;
+	const Scalar i12 = ((m_02 * m_10) - (m_00 * m_12)) * inverseDeterminant;
+	const Scalar i22 = ((m_00 * m_11) - (m_01 * m_10)) * inverseDeterminant;
+
+	const Scalar t0 = m_30;
+	const Scalar t1 = m_31;
+	const Scalar t2 = m_32;
+
+	Set ( i00, i01, i02, 0.0f,
+		  i10, i11, i12, 0.0f,
+		  i20, i21, i22, 0.0f,
+		  -((t0 * i00) + (t1 * i10) + (t2 * i20)), 
+		  -((t0 * i01) + (t1 * i11) + (t2 * i21)), 
+		  -((t0 * i02) + (t1 * i12) + (t2 * i22)), 
+		  1.0f );
+
+#endif
+
+	return true;
+}
+//end Matrix4x4::InvertAffine ( )
+
+
+
+//=========================================================================
+//! @function    Matrix4x4::InvertRigid
+//! @brief       Invert a matrix made only of a rotation and a translation
+//!              
+//!				 The inverse of the rotation is its transpose, so this is cheaper
+//!				 again than InvertAffine. The upper 3x3 must be orthonormal,
+//!				 and the last column (0, 0, 0, 1)
+//=========================================================================
+void Matrix4x4::InvertRigid ( )
+{
+	debug_assert ( IsAffine(), "Matrix isn't affine!" );
+
+#ifdef MATH_SSE
+
+	__m128 row0 = _mm_loadu_ps ( m[0] );
+	__m128 row1 = _mm_loadu_ps ( m[1] );
+	__m128 row2 = _mm_loadu_ps ( m[2] );
+	__m128 row3 = _mm_setzero_ps();
+	const __m128 translation = _mm_loadu_ps ( m[3] );
+
+	//The w of the first three rows is zero, so it stays zero after the transpose
+	_MM_TRANSPOSE4_PS ( row0, row1, row2, row3 );
+
+	__m128 newTranslation = _mm_mul_ps ( _mm_shuffle_ps ( translation, translation, _MM_SHUFFLE(0, 0, 0, 0) ), row0 );
+	newTranslation = _mm_add_ps ( newTranslation, _mm_mul_ps ( _mm_shuffle_ps ( translation, translation, _MM_SHUFFLE(1, 1, 1, 1) ), row1 ) );
+	newTranslation = _mm_add_ps ( newTranslation, _mm_mul_ps ( _mm_shuffle_ps ( translation, translation, _MM_SHUFFLE(2, 2, 2, 2) ), row2 ) );
+	newTranslation = _mm_sub_ps ( _mm_set_ps ( 1.0f, 0.0f, 0.0f, 0.0f ), newTranslation );
+
+	_mm_storeu_ps ( m[0], row0 );
+	_mm_storeu_ps ( m[1], row1 );
+	_mm_storeu_ps ( m[2], row2 );
+	_mm_storeu_ps ( m[3], newTranslation );
+
+#else
+
+	const Scalar t0 = m_30;
+	const Scalar t1 = m_31;
+	const Scalar t2 = m_32;
+
+	std::swap ( m_01, m_10 );
+	std::swap ( m_02, m_20 );
+	std::swap ( m_12, m_21 );
+
+	m_30 = -((t0 * m_00) + (t1 * m_10) + (t2 * m_20));
+	m_31 = -((t0 * m_01) + (t1 * m_11) + (t2 * m_21));
+	m_32 = -((t0 * m_02) + (t1 * m_12) + (t2 * m_22));
+
+#endif
+}
+//end Matrix4x4::InvertRigid ( )
+
+
+
 //=========================================================================
 //! @function    Matrix4x4::InvertByTranspose
 //! @brief       Invert a matrix by setting it to its inverse transpose
@@ -876,27 +1063,9 @@ bool Matrix4x4::Invert ( )
 //=========================================================================
 void Matrix4x4::InvertByTranspose ( )
 {
-	//Get the translation component, we'll need it later
-	Scalar transX = m_30;
-	Scalar transY = m_31;
-	Scalar transZ = m_32;
-
-	//Zero out the translation component, we don't want it to 
-	//form part of the transpose
-	m_30 = 0.0f;
-	m_31 = 0.0f;
-	m_32 = 0.0f;
-
-	//Transpose the matrix
-	Transpose();
-
-	//Set the translation component of the matrix
-	//by multiplying the old translation component, by
-	//the rotation part of the newly transposed matrix
-	m_30 = transX * m_00 + transY * m_10 + transZ * m_20;
-	m_31 = transX * m_01 + transY * m_11 + transZ * m_21; 
-	m_32 = transX * m_02 + transY * m_12 + transZ * m_22; 
-
+	//This used to add the rotated translation rather than subtract it,
+	//which isn't the inverse. InvertRigid gets the sign right
+	InvertRigid();
 }
 //End Matrix4x4::InvertByTranspose
 
@@ -968,4 +1137,62 @@ void Matrix4x4::Transpose ( )
 	std::swap ( m_23,  m_32 );
 
 }
-//Matrix4x4::Transpose ( )
\ No newline at end of file
+//Matrix4x4::Transpose ( )
+
+
+
+//=========================================================================
+//! @function    Math::TransformPoints
+//! @brief       Transform an array of points by a matrix
+//!              
+//!				 Gives the same results as multiplying each point by the matrix with
+//!				 operator *=, so the w of each point is used, and the w of each
+//!				 result is 1. points and result may be the same array.
+//!
+//! @param       points [in]  Array of points to transform
+//! @param       result [out] Array that receives the transformed points
+//! @param       count  [in]  Number of points
+//! @param       matrix [in]  Matrix to transform the points by
+//=========================================================================
+void Math::TransformPoints ( const Vector3D* points, Vector3D* result, UInt count, const Matrix4x4& matrix )
+{
+#ifdef MATH_SSE
+
+	//Vector3D is read and written as four packed Scalars
+	BOOST_STATIC_ASSERT ( sizeof(Vector3D) == (4 * sizeof(Scalar)) );
+
+	const Scalar* rows = matrix.GetPointer();
+
+	const __m128 row0 = _mm_loadu_ps ( rows );
+	const __m128 row1 = _mm_loadu_ps ( rows + 4 );
+	const __m128 row2 = _mm_loadu_ps ( rows + 8 );
+	const __m128 row3 = _mm_loadu_ps ( rows + 12 );
+	const __m128 one  = _mm_set1_ps ( 1.0f );
+
+	const Scalar* input  = reinterpret_cast<const Scalar*>(points);
+	Scalar*		  output = reinterpret_cast<Scalar*>(result);
+
+	for ( UInt i = 0; i < count; ++i, input += 4, output += 4 )
+	{
+		const __m128 point = _mm_loadu_ps ( input );
+
+		__m128 transformed = _mm_mul_ps ( _mm_shuffle_ps ( point, point, _MM_SHUFFLE(0, 0, 0, 0) ), row0 );
+		transformed = _mm_add_ps ( transformed, _mm_mul_ps ( _mm_shuffle_ps ( point, point, _MM_SHUFFLE(1, 1, 1, 1) ), row1 ) );
+		transformed = _mm_add_ps ( transformed, _mm_mul_ps ( _mm_shuffle_ps ( point, point, _MM_SHUFFLE(2, 2, 2, 2) ), row2 ) );
+		transformed = _mm_add_ps ( transformed, _mm_mul_ps ( _mm_shuffle_ps ( point, point, _MM_SHUFFLE(3, 3, 3, 3) ), row3 ) );
+
+		//Replace w with 1, keeping x, y and z
+		const __m128 zOne = _mm_unpackhi_ps ( transformed, one );
+		_mm_storeu_ps ( output, _mm_shuffle_ps ( transformed, zOne, _MM_SHUFFLE(1, 0, 1, 0) ) );
+	}
+
+#else
+
+	for ( UInt i = 0; i < count; ++i )
+	{
+		result[i] = points[i] * matrix;
+	}
+
+#endif
+}
+//End Math::TransformPoints
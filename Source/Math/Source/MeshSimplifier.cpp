@@ -0,0 +1,477 @@
+//======================================================================================
+//! @file         MeshSimplifier.cpp
+//! @brief        Simplifies indexed triangle lists with quadric error metrics
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+#include <algorithm>
+#include "Core/Core.h"
+#include "Math/MeshSimplifier.h"
+
+
+using namespace Math;
+
+
+//namespace
+namespace
+{
+	//Collapses that turn a triangle's normal by more than about 75 degrees are rejected
+	const Scalar minNormalCosine = 0.25f;
+
+	//=========================================================================
+    //! @function    TriangleNormal
+    //! @brief       Unnormalised normal of a triangle, with a length of twice its area
+    //=========================================================================
+	Vector3D TriangleNormal ( const Vector3D& p0, const Vector3D& p1, const Vector3D& p2 )
+	{
+		Vector3D normal;
+		Vector3D::CrossProduct ( p1 - p0, p2 - p0, normal );
+		return normal;
+	}
+	//End TriangleNormal
+}
+//end namespace
+
+
+
+//=========================================================================
+//! @function    MeshSimplifier::Quadric::Quadric
+//! @brief       Construct a zero quadric
+//=========================================================================
+MeshSimplifier::Quadric::Quadric ( )
+{
+	std::fill ( m, m + 10, 0.0 );
+}
+//End MeshSimplifier::Quadric::Quadric
+
+
+
+//=========================================================================
+//! @function    MeshSimplifier::Quadric::Quadric
+//! @brief       Construct the quadric for the squared distance to a plane
+//!              
+//! @param       a, b, c, d [in] Plane equation, with a unit normal
+//! @param       weight		[in] Weight of the plane
+//=========================================================================
+MeshSimplifier::Quadric::Quadric ( Double a, Double b, Double c, Double d, Double weight )
+{
+	m[0] = a * a * weight;	m[1] = a * b * weight;	m[2] = a * c * weight;	m[3] = a * d * weight;
+							m[4] = b * b * weight;	m[5] = b * c * weight;	m[6] = b * d * weight;
+													m[7] = c * c * weight;	m[8] = c * d * weight;
+																			m[9] = d * d * weight;
+}
+//End MeshSimplifier::Quadric::Quadric
+
+
+
+//=========================================================================
+//! @function    MeshSimplifier::Quadric::operator+=
+//! @brief       Add another quadric to this one
+//=========================================================================
+MeshSimplifier::Quadric& MeshSimplifier::Quadric::operator+= ( const Quadric& rhs )
+{
+	for ( UInt i = 0; i < 10; ++i )
+	{
+		m[i] += rhs.m[i];
+	}
+
+	return *this;
+}
+//End MeshSimplifier::Quadric::operator+=
+
+
+
+//=========================================================================
+//! @function    MeshSimplifier::Quadric::Evaluate
+//! @brief       Sum of the weighted squared distances from a point to the planes
+//=========================================================================
+Double MeshSimplifier::Quadric::Evaluate ( const Vector3D& point ) const
+{
+	const Double x = point.X();
+	const Double y = point.Y();
+	const Double z = point.Z();
+
+	return (m[0] * x * x) + (2.0 * m[1] * x * y) + (2.0 * m[2] * x * z) + (2.0 * m[3] * x)
+		 + (m[4] * y * y) + (2.0 * m[5] * y * z) + (2.0 * m[6] * y)
+		 + (m[7] * z * z) + (2.0 * m[8] * z)
+		 + m[9];
+}
+//End MeshSimplifier::Quadric::Evaluate
+
+
+
+//=========================================================================
+//! @function    MeshSimplifier::MeshSimplifier
+//! @brief       MeshSimplifier constructor
+//=========================================================================
+MeshSimplifier::MeshSimplifier ( )
+: m_triangleCount(0), m_error(0.0)
+{
+}
+//End MeshSimplifier::MeshSimplifier
+
+
+
+//=========================================================================
+//! @function    MeshSimplifier::Initialise
+//! @brief       Set up the mesh to simplify
+//!              
+//! @param       positions		[in] Array of vertexCount vertex positions
+//! @param       vertexCount	[in] Number of vertices
+//! @param       indices		[in] Array of triangleCount * 3 vertex indices
+//! @param       triangleCount	[in] Number of triangles
+//=========================================================================
+void MeshSimplifier::Initialise ( const Vector3D* positions, UInt vertexCount, const UInt* indices, UInt triangleCount )
+{
+	m_positions.assign ( positions, positions + vertexCount );
+	m_indices.assign ( indices, indices + (triangleCount * 3) );
+	m_triangleAlive.assign ( triangleCount, true );
+	m_vertexTriangles.assign ( vertexCount, std::vector<UInt>() );
+	m_quadrics.assign ( vertexCount, Quadric() );
+	m_stamps.assign ( vertexCount, 0 );
+	m_locked.assign ( vertexCount, false );
+	m_collapsed.assign ( vertexCount, false );
+	m_collapses = std::priority_queue<Collapse>();
+	m_triangleCount = triangleCount;
+	m_error = 0.0;
+
+	//Each vertex's quadric is the sum of the planes of its triangles, weighted by area
+	for ( UInt triangle = 0; triangle < triangleCount; ++triangle )
+	{
+		const UInt* corner = &m_indices[triangle * 3];
+
+		debug_assert ( (corner[0] < vertexCount) && (corner[1] < vertexCount) && (corner[2] < vertexCount), 
+					   "Triangle has an invalid vertex index!" );
+
+		Vector3D normal = TriangleNormal ( m_positions[corner[0]], m_positions[corner[1]], m_positions[corner[2]] );
+		const Scalar area = normal.Length() * 0.5f;
+
+		normal.Normalise();
+
+		Quadric plane ( normal.X(), normal.Y(), normal.Z(), -Vector3D::DotProduct(normal, m_positions[corner[0]]), area );
+
+		for ( UInt vertex = 0; vertex < 3; ++vertex )
+		{
+			m_quadrics[corner[vertex]] += plane;
+			m_vertexTriangles[corner[vertex]].push_back ( triangle );
+		}
+	}
+
+	//Lock the vertices of every edge that doesn't have exactly two triangles. Edges 
+	//are sorted by their vertices so that the triangles on each edge can be counted
+	std::vector<UInt64> edges;
+	edges.reserve ( triangleCount * 3 );
+
+	for ( UInt corner = 0; corner < (triangleCount * 3); ++corner )
+	{
+		const UInt v0 = m_indices[corner];
+		const UInt v1 = m_indices[((corner % 3) == 2) ? (corner - 2) : (corner + 1)];
+
+		edges.push_back ( (static_cast<UInt64>(std::min(v0, v1)) << 32) | std::max(v0, v1) );
+	}
+
+	std::sort ( edges.begin(), edges.end() );
+
+	for ( UInt first = 0; first < edges.size(); )
+	{
+		UInt last = first + 1;
+
+		while ( (last < edges.size()) && (edges[last] == edges[first]) )
+		{
+			++last;
+		}
+
+		if ( (last - first) != 2 )
+		{
+			m_locked[static_cast<UInt>(edges[first] >> 32)] = true;
+			m_locked[static_cast<UInt>(edges[first] & 0xFFFFFFFF)] = true;
+		}
+
+		first = last;
+	}
+
+	for ( UInt vertex = 0; vertex < vertexCount; ++vertex )
+	{
+		PushCollapses ( vertex );
+	}
+}
+//End MeshSimplifier::Initialise
+
+
+
+//=========================================================================
+//! @function    MeshSimplifier::SimplifyTo
+//! @brief       Collapse edges until there are no more than a target number of
+//!				 triangles, or no more edges can be collapsed
+//!              
+//! @param       targetTriangleCount [in] Number of triangles to simplify to
+//=========================================================================
+void MeshSimplifier::SimplifyTo ( UInt targetTriangleCount )
+{
+	while ( (m_triangleCount > targetTriangleCount) && !m_collapses.empty() )
+	{
+		const Collapse collapse = m_collapses.top();
+		m_collapses.pop();
+
+		if ( m_collapsed[collapse.from] || m_collapsed[collapse.to] )
+		{
+			continue;
+		}
+
+		if ( (m_stamps[collapse.from] != collapse.fromStamp) || (m_stamps[collapse.to] != collapse.toStamp) )
+		{
+			continue;
+		}
+
+		if ( !CanCollapse ( collapse.from, collapse.to ) )
+		{
+			continue;
+		}
+
+		m_error = std::max ( m_error, collapse.cost );
+
+		DoCollapse ( collapse.from, collapse.to );
+	}
+}
+//End MeshSimplifier::SimplifyTo
+
+
+
+//=========================================================================
+//! @function    MeshSimplifier::GetTriangles
+//! @brief       Get the triangles that are left, in their original order
+//!              
+//! @param       indices		 [out] Three vertex indices for each triangle
+//! @param       sourceTriangles [out] Index of each triangle in the original mesh
+//=========================================================================
+void MeshSimplifier::GetTriangles ( std::vector<UInt>& indices, std::vector<UInt>& sourceTriangles ) const
+{
+	indices.clear();
+	sourceTriangles.clear();
+
+	for ( UInt triangle = 0; triangle < m_triangleAlive.size(); ++triangle )
+	{
+		if ( m_triangleAlive[triangle] )
+		{
+			indices.insert ( indices.end(), &m_indices[triangle * 3], &m_indices[triangle * 3] + 3 );
+			sourceTriangles.push_back ( triangle );
+		}
+	}
+}
+//End MeshSimplifier::GetTriangles
+
+
+
+//=========================================================================
+//! @function    MeshSimplifier::CanCollapse
+//! @brief       Check that moving a vertex onto another won't fold the surface
+//!				 over, or join it in a way that isn't a manifold
+//=========================================================================
+bool MeshSimplifier::CanCollapse ( UInt from, UInt to )
+{
+	//The two vertices should only share the vertices opposite their edge
+	GatherNeighbours ( from, m_fromNeighbours );
+	GatherNeighbours ( to, m_toNeighbours );
+
+	UInt shared = 0;
+	std::vector<UInt>::const_iterator current = m_fromNeighbours.begin();
+
+	for ( ; current != m_fromNeighbours.end(); ++current )
+	{
+		if ( std::binary_search ( m_toNeighbours.begin(), m_toNeighbours.end(), *current ) )
+		{
+			++shared;
+		}
+	}
+
+	if ( shared > 2 )
+	{
+		return false;
+	}
+
+	//None of the triangles that stay should flip, or become degenerate
+	const std::vector<UInt>& triangles = m_vertexTriangles[from];
+
+	for ( UInt i = 0; i < triangles.size(); ++i )
+	{
+		const UInt* corner = &m_indices[triangles[i] * 3];
+
+		if ( (corner[0] == to) || (corner[1] == to) || (corner[2] == to) )
+		{
+			continue;
+		}
+
+		const Vector3D& p0 = (corner[0] == from) ? m_positions[to] : m_positions[corner[0]];
+		const Vector3D& p1 = (corner[1] == from) ? m_positions[to] : m_positions[corner[1]];
+		const Vector3D& p2 = (corner[2] == from) ? m_positions[to] : m_positions[corner[2]];
+
+		Vector3D oldNormal = TriangleNormal ( m_positions[corner[0]], m_positions[corner[1]], m_positions[corner[2]] );
+		Vector3D newNormal = TriangleNormal ( p0, p1, p2 );
+
+		const Scalar oldLength = oldNormal.Length();
+		const Scalar newLength = newNormal.Length();
+
+		if ( newLength <= (oldLength * EpsilonE4) )
+		{
+			return false;
+		}
+
+		if ( Vector3D::DotProduct ( oldNormal, newNormal ) < (minNormalCosine * oldLength * newLength) )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+//End MeshSimplifier::CanCollapse
+
+
+
+//=========================================================================
+//! @function    MeshSimplifier::DoCollapse
+//! @brief       Move a vertex onto another, removing the triangles on their edge
+//=========================================================================
+void MeshSimplifier::DoCollapse ( UInt from, UInt to )
+{
+	std::vector<UInt>& fromTriangles = m_vertexTriangles[from];
+
+	for ( UInt i = 0; i < fromTriangles.size(); ++i )
+	{
+		const UInt triangle = fromTriangles[i];
+		UInt*	   corner = &m_indices[triangle * 3];
+
+		if ( (corner[0] == to) || (corner[1] == to) || (corner[2] == to) )
+		{
+			//The triangle is on the collapsed edge, so it disappears
+			m_triangleAlive[triangle] = false;
+			--m_triangleCount;
+
+			for ( UInt vertex = 0; vertex < 3; ++vertex )
+			{
+				if ( corner[vertex] != from )
+				{
+					std::vector<UInt>& triangles = m_vertexTriangles[corner[vertex]];
+					triangles.erase ( std::find ( triangles.begin(), triangles.end(), triangle ) );
+				}
+			}
+		}
+		else
+		{
+			for ( UInt vertex = 0; vertex < 3; ++vertex )
+			{
+				if ( corner[vertex] == from )
+				{
+					corner[vertex] = to;
+				}
+			}
+
+			m_vertexTriangles[to].push_back ( triangle );
+		}
+	}
+
+	fromTriangles.clear();
+	m_collapsed[from] = true;
+
+	m_quadrics[to] += m_quadrics[from];
+	++m_stamps[to];
+
+	PushCollapses ( to );
+}
+//End MeshSimplifier::DoCollapse
+
+
+
+//=========================================================================
+//! @function    MeshSimplifier::PushCollapse
+//! @brief       Add the collapse of one vertex onto another to the queue
+//=========================================================================
+void MeshSimplifier::PushCollapse ( UInt from, UInt to )
+{
+	if ( m_locked[from] )
+	{
+		return;
+	}
+
+	Quadric quadric = m_quadrics[from];
+	quadric += m_quadrics[to];
+
+	Collapse collapse;
+	collapse.cost = quadric.Evaluate ( m_positions[to] );
+	collapse.from = from;
+	collapse.to = to;
+	collapse.fromStamp = m_stamps[from];
+	collapse.toStamp = m_stamps[to];
+
+	m_collapses.push ( collapse );
+}
+//End MeshSimplifier::PushCollapse
+
+
+
+//=========================================================================
+//! @function    MeshSimplifier::PushCollapses
+//! @brief       Add the collapses of every edge of a vertex to the queue, in both directions
+//=========================================================================
+void MeshSimplifier::PushCollapses ( UInt vertex )
+{
+	GatherNeighbours ( vertex, m_fromNeighbours );
+
+	for ( UInt i = 0; i < m_fromNeighbours.size(); ++i )
+	{
+		PushCollapse ( vertex, m_fromNeighbours[i] );
+		PushCollapse ( m_fromNeighbours[i], vertex );
+	}
+}
+//End MeshSimplifier::PushCollapses
+
+
+
+//=========================================================================
+//! @function    MeshSimplifier::GatherNeighbours
+//! @brief       Get the sorted list of vertices that share a triangle with a vertex
+//=========================================================================
+void MeshSimplifier::GatherNeighbours ( UInt vertex, std::vector<UInt>& neighbours ) const
+{
+	neighbours.clear();
+
+	const std::vector<UInt>& triangles = m_vertexTriangles[vertex];
+
+	for ( UInt i = 0; i < triangles.size(); ++i )
+	{
+		const UInt* corner = &m_indices[triangles[i] * 3];
+
+		for ( UInt other = 0; other < 3; ++other )
+		{
+			if ( corner[other] != vertex )
+			{
+				neighbours.push_back ( corner[other] );
+			}
+		}
+	}
+
+	std::sort ( neighbours.begin(), neighbours.end() );
+	neighbours.erase ( std::unique ( neighbours.begin(), neighbours.end() ), neighbours.end() );
+}
+//End MeshSimplifier::GatherNeighbours
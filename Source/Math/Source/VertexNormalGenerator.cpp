@@ -0,0 +1,166 @@
+//======================================================================================
+//! @file         VertexNormalGenerator.cpp
+//! @brief        Generates smoothed vertex normals for an indexed triangle list
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+#include "Core/Core.h"
+#include "Math/VertexNormalGenerator.h"
+#include "Math/MeshUtility.h"
+
+
+using namespace Math;
+
+
+//namespace
+namespace
+{
+	//Marks a corner in the adjacency list that has already been given a vertex
+	const UInt cornerDone = 0xFFFFFFFF;
+}
+//end namespace
+
+
+
+//=========================================================================
+//! @function    VertexNormalGenerator::VertexNormalGenerator
+//! @brief       VertexNormalGenerator constructor
+//=========================================================================
+VertexNormalGenerator::VertexNormalGenerator ( )
+{
+}
+//End VertexNormalGenerator::VertexNormalGenerator
+
+
+
+//=========================================================================
+//! @function    VertexNormalGenerator::Generate
+//! @brief       Generate face and vertex normals for a triangle list
+//!              
+//!				 After this returns, the vertices from vertexCount up to VertexCount()
+//!				 are new vertices, which should be copies of SourceVertex(), and 
+//!				 indices may have been changed to use them.
+//!
+//! @param       positions		 [in]	  Array of vertexCount vertex positions
+//! @param       vertexCount	 [in]	  Number of vertices
+//! @param       indices		 [in,out] Array of triangleCount * 3 vertex indices
+//! @param       smoothingGroups [in]	  Array of triangleCount smoothing groups
+//! @param       triangleCount	 [in]	  Number of triangles
+//=========================================================================
+void VertexNormalGenerator::Generate ( const Vector3D* positions, UInt vertexCount, 
+									   UInt* indices, const UInt* smoothingGroups, UInt triangleCount )
+{
+	const UInt cornerCount = triangleCount * 3;
+
+	//Face normals
+	m_faceNormals.resize ( triangleCount );
+
+	for ( UInt triangle = 0; triangle < triangleCount; ++triangle )
+	{
+		const UInt* corner = &indices[triangle * 3];
+
+		debug_assert ( corner[0] < vertexCount, "v0 has an invalid vertex index!" );
+		debug_assert ( corner[1] < vertexCount, "v1 has an invalid vertex index!" );
+		debug_assert ( corner[2] < vertexCount, "v2 has an invalid vertex index!" );
+
+		Vector3D v0v1 = positions[corner[1]] - positions[corner[0]];
+		Vector3D v0v2 = positions[corner[2]] - positions[corner[0]];
+
+		Vector3D::CrossProduct ( v0v1, v0v2, m_faceNormals[triangle] );
+		m_faceNormals[triangle].Normalise();
+	}
+
+	//Gather the corners that use each vertex
+	BuildVertexTriangleAdjacency ( indices, cornerCount, vertexCount, m_cornerStart, m_corners );
+
+	//Vertex normals. Each vertex starts out as its own source, with a zero normal
+	m_sourceVertices.resize ( vertexCount );
+	m_vertexNormals.assign ( vertexCount, Vector3D() );
+
+	for ( UInt vertex = 0; vertex < vertexCount; ++vertex )
+	{
+		m_sourceVertices[vertex] = vertex;
+	}
+
+	for ( UInt vertex = 0; vertex < vertexCount; ++vertex )
+	{
+		const UInt begin = m_cornerStart[vertex];
+		const UInt end = m_cornerStart[vertex + 1];
+		bool	   vertexUsed = false;
+
+		//Each pass takes the first corner that hasn't been done, and gives it and every other
+		//corner of this vertex in the same smoothing group one vertex. There is one pass per group
+		//here, and group 0 corners are never grouped together
+		for ( UInt first = begin; first < end; ++first )
+		{
+			if ( m_corners[first] == cornerDone )
+			{
+				continue;
+			}
+
+			const UInt group = smoothingGroups[m_corners[first] / 3];
+
+			UInt outputVertex = vertex;
+
+			if ( vertexUsed )
+			{
+				outputVertex = m_sourceVertices.size();
+				m_sourceVertices.push_back ( vertex );
+				m_vertexNormals.push_back ( Vector3D() );
+			}
+
+			vertexUsed = true;
+
+			Vector3D normal;
+
+			for ( UInt current = first; current < end; ++current )
+			{
+				const UInt corner = m_corners[current];
+
+				if ( corner == cornerDone )
+				{
+					continue;
+				}
+
+				if ( smoothingGroups[corner / 3] != group )
+				{
+					continue;
+				}
+
+				normal += m_faceNormals[corner / 3];
+				indices[corner] = outputVertex;
+				m_corners[current] = cornerDone;
+
+				if ( group == 0 )
+				{
+					break;
+				}
+			}
+
+			m_vertexNormals[outputVertex] = normal.Normalise();
+		}
+	}
+
+}
+//End VertexNormalGenerator::Generate
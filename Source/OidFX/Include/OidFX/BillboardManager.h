@@ -6,6 +6,10 @@
 //!				  All billboards to be rendered in a frame, are added to the BillboardManager's
 //!				  list of billboards. These are then put into batches, by their effect allowing
 //!				  them to be rendered efficiently.
+//!
+//!				  Billboards are drawn as indexed quads from a ring buffered dynamic vertex buffer.
+//!				  Batches larger than the space left in the ring are split, so there is no limit
+//!				  on the number of billboards that can be drawn in a frame.
 //!               
 //! @author       Bryan Robertson
 //! @date         Saturday, 15 October 2005
@@ -33,7 +37,9 @@
 #define OIDFX_BILLBOARDMANAGER_H
 
 
+#include "Math/Vector3D.h"
 #include "Renderer/Effect.h"
+#include "Renderer/IndexBuffer.h"
 #include "Renderer/VertexStreamBinding.h"
 #include "Renderer/VertexDeclaration.h"
 #include "OidFX/Constants.h"
@@ -44,7 +50,7 @@
 // Forward declarations
 //=========================================================================
 namespace Renderer		{ class IRenderer; class StateManager;	}
-namespace OidFX			{ class Camera; class Billboard;		}
+namespace OidFX			{ struct CameraView; class Billboard;	}
 
 
 //namespace OidFX
@@ -55,6 +61,14 @@ namespace OidFX
 	//!@class	BillboardManager
 	//!@brief	Manager class for billboarded sprites. Provides
 	//!         a method to efficiently render multiple billboards
+	//!
+	//!			The state needed to draw each billboard is copied into a structure of arrays
+	//!			when it is added to the list, so expanding the billboards into vertices
+	//!			doesn't touch the Billboard objects at all.
+	//!
+	//!			Billboards are added to one list while another is drawn, and
+	//!			SwapBillboardLists hands the filled list over to Render. This lets a frame's
+	//!			billboards be drawn while the next update is adding its own.
 	class BillboardManager
 	{
 
@@ -72,12 +86,13 @@ namespace OidFX
             // Public methods
             //=========================================================================
 			void CompileRenderQueue();
-			void Render ( Renderer::IRenderer& renderer, Camera& camera );
+			void Render ( Renderer::IRenderer& renderer, const CameraView& view );
 
 			inline void Update ( Float timeElapsedInSeconds );
+			inline void SwapBillboardLists ( );
 
 			inline void ClearBillboardList();
-			inline void AddToBillboardList ( Billboard& billboard );
+			void AddToBillboardList ( Billboard& billboard );
 
 		private:
 
@@ -85,12 +100,12 @@ namespace OidFX
             // Private types
             //=========================================================================
 			
-			//! Keeps track of a set of vertices to be rendered with a specific effect
+			//! Keeps track of a range of the sorted billboard list to be rendered with a specific effect
 			struct RenderQueueEntry
 			{
 				Renderer::HEffect	effect;
-				UInt				startIndex;
-				UInt				vertexCount;
+				UInt				first;
+				UInt				count;
 			};
 
 			//! Stores vertex data for the renderer
@@ -101,16 +116,60 @@ namespace OidFX
 				Float	texCoord0[2];
 			};
 
-			//! List of billboards to be rendered this frame
-			typedef std::multimap<Renderer::HEffect, Billboard*>	BillboardList;
+			//! Per billboard state, stored as a structure of arrays
+			struct BillboardStore
+			{
+				Core::Vector<Float>::Type	positionX;
+				Core::Vector<Float>::Type	positionY;
+				Core::Vector<Float>::Type	positionZ;
+				Core::Vector<Float>::Type	scaledCos;	//!< Scale * cos(rotation)
+				Core::Vector<Float>::Type	scaledSin;	//!< Scale * sin(rotation)
+				Core::Vector<UInt32>::Type	colour;
+				Core::Vector<UInt>::Type	effect;		//!< Index into the list's effects
+				Core::Vector<Float>::Type	depth;		//!< Distance along the camera's view direction
+
+				inline void Clear ( );
+				inline void Swap ( BillboardStore& other );
+			};
+
+			//! Orders billboard indices back to front
+			struct FurthestFirst
+			{
+				FurthestFirst ( const Core::Vector<Float>::Type& depth ) : m_depth(depth) { }
+
+				bool operator() ( UInt lhs, UInt rhs ) const	{ return m_depth[lhs] > m_depth[rhs]; }
+
+				const Core::Vector<Float>::Type& m_depth;
+			};
+
+			//! Effects used by the billboards in the list
+			typedef Core::Vector<Renderer::HEffect>::Type	EffectList;
+
+			//! Indices of billboards in the store, in the order they are to be rendered
+			typedef Core::Vector<UInt>::Type				BillboardOrder;
 
 			//! Stores data about batches of billboards with the same effect
 			typedef Core::Deque<RenderQueueEntry>::Type	RenderQueue;								
 
+			//! Billboards added over one update, grouped by effect for rendering
+			struct BillboardList
+			{
+				BillboardStore	billboards;
+				EffectList		effects;
+				BillboardOrder	order;
+				RenderQueue		renderQueue;
+
+				inline void Clear ( );
+				inline void Swap ( BillboardList& other );
+			};
+
             //=========================================================================
             // Private methods
             //=========================================================================
-			
+			void CreateQuadIndexBuffer ( );
+			void SortBatchesByDepth ( const CameraView& view );
+			void RenderBatch ( const RenderQueueEntry& entry, const CameraView& view );
+			void ExpandBillboards ( const UInt* order, UInt count, const CameraView& view, Vertex* vertices ) const;
 
             //=========================================================================
             // Private data
@@ -122,9 +181,14 @@ namespace OidFX
 			Renderer::StateManager&			m_stateManager;
 			Renderer::VertexStreamBinding	m_streamBinding;
 			Renderer::HVertexDeclaration	m_vertexDeclaration;
+			Renderer::HIndexBuffer			m_indexBuffer;
 
-			BillboardList					m_billboardList;
-			RenderQueue						m_renderQueue;
+			//! Next free quad in the ring buffered vertex buffer
+			UInt							m_ringPosition;
+
+			BillboardList					m_filling;		//!< Billboards are added to this list
+			BillboardList					m_drawing;		//!< Render draws this list
+			BillboardOrder					m_effectStart;
 
 	};
 	//End class BillboardManager
@@ -145,33 +209,102 @@ namespace OidFX
 
 
 
+    //=========================================================================
+    //! @function    BillboardManager::SwapBillboardLists
+    //! @brief       Make the billboards added since the last swap the ones that Render draws
+    //!
+    //!				 The list being drawn can't change until this is called, so it's
+    //!				 safe to add billboards while the previous list is rendered
+    //=========================================================================
+	void BillboardManager::SwapBillboardLists ( )
+	{
+		m_filling.Swap ( m_drawing );
+	}
+	//End BillboardManager::SwapBillboardLists
+
+
+
     //=========================================================================
     //! @function    BillboardManager::ClearBillboardList
     //! @brief       
     //=========================================================================
 	void BillboardManager::ClearBillboardList()
 	{
-		m_billboardList.clear();
-		m_renderQueue.clear();
+		m_filling.Clear();
 	}
 	//End BillboardManager::ClearBillboardList
 
 
 
     //=========================================================================
-    //! @function    BillboardManager::AddToBillboardList
-    //! @brief       Add a billboard to the billboard list
-    //!              
-	//!				 A billboard must add itself to the billboard list, in order to be rendered
-	//!
-    //! @param       billboard [in]
-    //!              
+    //! @function    BillboardManager::BillboardStore::Clear
+    //! @brief       Remove all billboards from the store
+    //=========================================================================
+	void BillboardManager::BillboardStore::Clear ( )
+	{
+		positionX.clear();
+		positionY.clear();
+		positionZ.clear();
+		scaledCos.clear();
+		scaledSin.clear();
+		colour.clear();
+		effect.clear();
+		depth.clear();
+	}
+	//End BillboardManager::BillboardStore::Clear
+
+
+
+    //=========================================================================
+    //! @function    BillboardManager::BillboardStore::Swap
+    //! @brief       Exchange the contents of two stores, without copying them
+    //!
+    //! @param       other [in] Store to swap with
+    //=========================================================================
+	void BillboardManager::BillboardStore::Swap ( BillboardStore& other )
+	{
+		positionX.swap ( other.positionX );
+		positionY.swap ( other.positionY );
+		positionZ.swap ( other.positionZ );
+		scaledCos.swap ( other.scaledCos );
+		scaledSin.swap ( other.scaledSin );
+		colour.swap ( other.colour );
+		effect.swap ( other.effect );
+		depth.swap ( other.depth );
+	}
+	//End BillboardManager::BillboardStore::Swap
+
+
+
+    //=========================================================================
+    //! @function    BillboardManager::BillboardList::Clear
+    //! @brief       Remove all billboards from the list
+    //=========================================================================
+	void BillboardManager::BillboardList::Clear ( )
+	{
+		billboards.Clear();
+		effects.clear();
+		order.clear();
+		renderQueue.clear();
+	}
+	//End BillboardManager::BillboardList::Clear
+
+
+
+    //=========================================================================
+    //! @function    BillboardManager::BillboardList::Swap
+    //! @brief       Exchange the contents of two lists, without copying them
+    //!
+    //! @param       other [in] List to swap with
     //=========================================================================
-	void BillboardManager::AddToBillboardList ( Billboard& billboard )
+	void BillboardManager::BillboardList::Swap ( BillboardList& other )
 	{
-		m_billboardList.insert( BillboardList::value_type(billboard.GetEffect(), &billboard) );
+		billboards.Swap ( other.billboards );
+		effects.swap ( other.effects );
+		order.swap ( other.order );
+		renderQueue.swap ( other.renderQueue );
 	}
-	//End BillboardManager::AddToBillboardList
+	//End BillboardManager::BillboardList::Swap
 
 
 
@@ -183,4 +316,3 @@ namespace OidFX
 
 #endif
 //#ifndef OIDFX_BILLBOARDMANAGER_H
-
@@ -49,6 +49,24 @@ namespace OidFX
 {
 
 
+	//!@struct	CameraView
+	//!@brief	Copy of the camera state needed to draw a frame
+	//!
+	//!			Lets a queued frame be drawn from where the camera was when it was culled,
+	//!			while the camera itself moves on for the next frame
+	struct CameraView
+	{
+		Math::Matrix4x4	viewMatrix;
+		Math::Matrix4x4	projectionMatrix;
+		Math::Vector3D	position;
+		Math::Vector3D	forward;
+		Math::Vector3D	up;
+		Math::Vector3D	right;
+	};
+	//End struct CameraView
+
+
+
 	//!@class	Camera
 	//!@brief	Base class for a camera
 	class Camera : public Core::IMouseSensitive,
@@ -100,6 +118,8 @@ namespace OidFX
 			inline const Math::Vector3D& Up() const throw();
 			inline const Math::Vector3D& Right() const throw();
 
+			inline void CaptureView ( CameraView& view ) const;
+
 			//=========================================================================
             // IMouseSensitive implementation
             //=========================================================================
@@ -527,6 +547,25 @@ namespace OidFX
 
 
 
+    //=========================================================================
+    //! @function    Camera::CaptureView
+    //! @brief       Copy the state needed to draw a frame from the camera
+    //!              
+    //! @param       view [out] Receives the camera's current view
+    //=========================================================================
+	void Camera::CaptureView ( CameraView& view ) const
+	{
+		view.viewMatrix = m_viewMatrix;
+		view.projectionMatrix = m_projMatrix;
+		view.position = m_position;
+		view.forward = m_forward;
+		view.up = m_up;
+		view.right = m_right;
+	}
+	//End Camera::CaptureView
+
+
+
 }
 //end namespace OidFX
 
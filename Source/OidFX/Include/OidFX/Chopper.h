@@ -76,8 +76,6 @@ namespace OidFX
             // Public methods
             //=========================================================================
 
-			virtual void Update ( Math::MatrixStack& toWorldStack, Math::MatrixStack& fromWorldStack, Float timeElapsedInSeconds );
-
 			virtual void OnSpawn ( const Math::Vector3D& spawnPoint );
 			virtual void OnThink ( Float timeElapsed );
 			virtual void OnTouch ( );
@@ -132,6 +130,9 @@ namespace OidFX
 
 			bool				  m_launch; //!< Indicates whether or not a missile should be launched this frame
 
+			Float				  m_timeSinceLastLaunch;
+			UInt				  m_currentLauncher;	//!< Launcher to fire the next missile from
+
 			boost::shared_ptr<TargetingComputer> m_targetingComputer;
 			std::vector<boost::shared_ptr<MissileLauncher> >	 m_missileLaunchers;
 
@@ -31,12 +31,13 @@
 #include "Math/Vector3D.h"
 #include "OidFX/NewtonWorld.h"
 #include "OidFX/NewtonCollision.h"
+#include "OidFX/SpatialHash.h"
 
 
 //=========================================================================
 // Forward declarations
 //=========================================================================
-namespace OidFX	{ class EntityNode; class SceneObject; class Scene;	class CollisionRecord;	}
+namespace OidFX	{ class EntityNode; class SceneObject; class SceneNode; class Scene;	class CollisionRecord;	}
 namespace Newton { }
 
 
@@ -54,6 +55,10 @@ namespace OidFX
 	//!
 	//!			Every frame, the CollisionRecord manager builds a list of pairs of colliding objects,
 	//!			and calls their CollisionRecord callbacks
+	//!
+	//!			Entities attached to the root of the scene graph are inserted into a spatial hash
+	//!			at the start of CheckCollisions. Each collider is only checked against the entities
+	//!			sharing a cell with it, rather than walking every entity in the scene.
 	class CollisionManager
 	{
 
@@ -75,6 +80,8 @@ namespace OidFX
 			typedef Newton::World::CollisionInfo	CollisionInfo;
 			typedef Newton::World::PenetrationInfo	PenetrationInfo;
 
+			enum { InvalidSlot = 0xFFFFFFFF };
+
 
             //=========================================================================
             // Public methods
@@ -118,21 +125,27 @@ namespace OidFX
             //=========================================================================
             // Private types
             //=========================================================================
-			typedef Core::List<EntityNode*>::Type				ColliderStore;
+			typedef Core::Vector<EntityNode*>::Type				ColliderStore;
 			typedef Core::Vector<CollisionRecord>::Type 		CollisionRecordStore;
 
             //=========================================================================
             // Private methods
             //=========================================================================
 			void ClearCollisions ( );
+			void BuildBroadPhase ( Float cellSize );
+			void MergeSubtreeBounds ( const SceneNode& node, Math::Vector3D& minCorner, Math::Vector3D& maxCorner ) const;
+			void CheckCollisionsBruteForce ( );
 
             //=========================================================================
             // Private data
             //=========================================================================
 			boost::shared_ptr<Newton::World>		m_world;
-			ColliderStore			m_colliders;
+			ColliderStore			m_colliders;	//!< Unordered, each collider knows its own slot
 			CollisionRecordStore	m_collisions;
 
+			SpatialHash				  m_broadPhase;
+			SpatialHash::ObjectList	  m_broadPhaseCandidates;
+
 			Scene&					m_scene;
 
 			
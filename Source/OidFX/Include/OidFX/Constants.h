@@ -52,8 +52,20 @@ namespace OidFX
 	//! Maximum number of projectiles that can be active at any one time
 	const UInt g_maxProjectiles = 32;
 
-	//! Maximum number of billboards that can be renderered per frame
-	const UInt g_maxBillboards = 128;
+	//! Number of billboards the billboard vertex buffer holds. More can be rendered per frame,
+	//! but they are drawn in several batches. Can't be more than 16384, because of 16 bit indices
+	const UInt g_maxBillboards = 16384;
+
+	//! Number of entities the physics store reserves space for. It grows past this if needed,
+	//! but growing invalidates references to entity physics state
+	const UInt g_entityPhysicsReserve = 1024;
+
+	//! Cell size of the entity index used by scene queries. Entities over half a cell
+	//! across are checked by every query, so this should be about twice the size of a vehicle
+	const Float g_entityIndexCellSize = 40.0f * meters;
+
+	//! Number of hash buckets in the entity index
+	const UInt g_entityIndexBuckets = 4096;
 
 
 }
@@ -0,0 +1,171 @@
+//======================================================================================
+//! @file         CookedMeshLoader.h
+//! @brief        Loader for cooked mesh files
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+#ifndef OIDFX_COOKEDMESHLOADER_H
+#define OIDFX_COOKEDMESHLOADER_H
+
+
+#include "OidFX/Mesh.h"
+
+
+//=========================================================================
+// Forward declarations
+//=========================================================================
+namespace Renderer	{ class EffectManager; class IRenderer;	}
+namespace Core		{ class MemoryMappedFile;				}
+
+
+namespace CookedMesh
+{
+
+	//=========================================================================
+	// Constants
+	//=========================================================================
+	const UInt32 fileId  = 0x48534D4F;	// "OMSH"
+	const UInt32 version = 3;	// 2: triangles and vertices are ordered for the vertex cache
+								// 3: groups have generated LODs
+
+	//Extension added to the name of the source file to get the name of the cooked file
+	const Char* const fileExtension = ".cooked";
+
+
+	//=========================================================================
+	// Structures stored in a cooked mesh file
+	//
+	// A cooked file is a Header, followed by vertexCount Mesh::MeshStream0 vertices,
+	// indexCount 16 bit indices, padding to a multiple of four bytes, groupCount Groups
+	// and effectCount Effects. Everything is little endian, as written by the engine
+	//=========================================================================
+	#include "Core/PushPack1.h" //Change the packing to 1
+
+	//Header
+	struct Header
+	{
+		UInt32	id;
+		UInt32	version;
+		UInt32	vertexCount;
+		UInt32	indexCount;
+		UInt32	groupCount;
+		UInt32	effectCount;
+		UInt32	lodCount;			// Number of LODs of every group
+		Float	boundsMin[3];
+		Float	boundsMax[3];
+	};
+	//End Header
+
+	//Group
+	struct Group
+	{
+		Char	name[32];
+		UInt32	effectIndex;
+		UInt32	startOffset[OidFX::g_maxMeshLODs];		// First index of each LOD in the index buffer
+		UInt32	triangleCount[OidFX::g_maxMeshLODs];	// Unused LODs are zero
+		UInt32	minVertexIndex;
+		UInt32	maxVertexIndex;
+	};
+	//End Group
+
+	//Effect
+	struct Effect
+	{
+		Char	fileName[128];
+	};
+	//End Effect
+
+	#include "Core/PopPack.h"	//Restore the packing
+
+
+	//=========================================================================
+	// Layout helpers, shared by the loader and Mesh::WriteCooked
+	//=========================================================================
+	inline UInt IndexPadding ( UInt indexCount )	{ return (indexCount & 1) ? sizeof(UInt16) : 0;	}
+	UInt64 FileSize ( const Header& header );
+
+
+    //=========================================================================
+    // Cooked mesh loader 
+    //=========================================================================
+	
+	//!@class	CookedMeshLoader
+	//!@brief	Class used to load cooked mesh files
+	//!
+	//!			Cooked files hold vertices and indices in the format of the vertex 
+	//!			and index buffers, so the mesh is built from a mapped file without
+	//!			reading, converting or generating anything.
+	class CookedMeshLoader
+	{
+
+		public:
+
+
+            //=========================================================================
+            // Constructors/Destructor
+            //=========================================================================
+			inline CookedMeshLoader ( Renderer::IRenderer& renderer, Renderer::EffectManager& effectManager );
+
+
+            //=========================================================================
+            // Public methods
+            //=========================================================================
+			boost::shared_ptr<OidFX::Mesh> Load ( const Core::MemoryMappedFile& file, const Char* name );
+
+
+		private:
+
+            //=========================================================================
+            // Private data
+            //=========================================================================
+			Renderer::IRenderer&		m_renderer;
+			Renderer::EffectManager&	m_effectManager;
+
+
+	};
+	//End class CookedMeshLoader
+
+
+
+	//=========================================================================
+    //! @function    CookedMeshLoader::CookedMeshLoader
+    //! @brief       CookedMeshLoader constructor
+    //!              
+    //! @param       renderer		[in] Renderer used to request vertex\index buffer resources
+    //! @param       effectManager	[in] Effect manager used to request effects
+    //!              
+    //=========================================================================
+	CookedMeshLoader::CookedMeshLoader ( Renderer::IRenderer& renderer, Renderer::EffectManager& effectManager )
+		: m_renderer(renderer), m_effectManager(effectManager)
+	{
+
+	}
+	//End CookedMeshLoader::CookedMeshLoader
+
+}
+//end namespace CookedMesh
+
+
+#endif
+//#ifndef OIDFX_COOKEDMESHLOADER_H
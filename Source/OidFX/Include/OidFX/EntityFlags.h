@@ -0,0 +1,83 @@
+//======================================================================================
+//! @file         EntityFlags.h
+//! @brief        Flags that determine entity behaviour
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+
+#ifndef OIDFX_ENTITYFLAGS_H
+#define OIDFX_ENTITYFLAGS_H
+
+
+#include <bitset>
+
+
+//namespace OidFX
+namespace OidFX
+{
+
+
+	//! Flags that determine entity behaviour
+	enum EEntityFlag
+	{
+		EF_STATIC,					//!< Entity is static, and cannot move under any circumstances (except through parent-child relationships)
+		EF_NODRAW,					//!< Entity should not be rendered, even if it is in the view frustum
+		EF_SPAWNED,					//!< Entity has been spawned
+		EF_DEAD,					//!< Entity has been spawned but it is dead
+		EF_SPAWNONGROUND,			//!< If this flag is set, then the game engine will spawn the entity on the ground
+		EF_NOWORLDCOLLIDE,			//!< Entity never checks collision against the world
+		EF_NOENTITYCOLLIDE,			//!< Entity never checks collision against other entities
+		EF_NOPROJECTILECOLLIDE,		//!< Entity never checks collision against projectiles
+		EF_NOCOLLIDE,				//!< Entity never does any collision checks
+		EF_PROJECTILE,				//!< Entity is a projectile
+		EF_FLAMMABLE,				//!< Entity is flammable
+		EF_EXPLOSIVE,				//!< Entity is explosive
+		EF_PLAYER,					//!< Entity is the player
+		EF_INVINCIBLE,				//!< Entity cannot be hurt
+		EF_ANTIGRAVITY,				//!< Entity is immune to the effects of gravity
+		EF_ENEMY,					//!< Entity is an enemy of the player
+		EF_ALLY,					//!< Entity is an ally of the player
+		EF_POWERUP,					//!< Entity is a power-up
+		EF_BUILDING,				//!< Entity is a building
+		EF_NOEXPLOSIONKICKBACK,		//!< Entity doesn't get kicked back by explosions
+		EF_OBJECTIVEDESTROY,		//!< Entity is to be destroyed as part of an objective
+		EF_OBJECTIVEPROTECT,		//!< Game will end if the entity is destroyed
+		EF_DESPAWNPENDING,			//!< Entity requests that it be despawned soon
+
+		EF_COUNT			//!< Maximum entity flag count
+	};
+	//End enum EEntityFlag
+
+
+	//! Set of EEntityFlag values
+	typedef std::bitset<EF_COUNT>	EntityFlagSet;
+
+
+}
+//end namespace OidFX
+
+
+#endif
+//#ifndef OIDFX_ENTITYFLAGS_H
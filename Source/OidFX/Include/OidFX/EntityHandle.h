@@ -0,0 +1,103 @@
+//======================================================================================
+//! @file         EntityHandle.h
+//! @brief        Reference to an entity that knows when the entity has despawned
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+
+#ifndef OIDFX_ENTITYHANDLE_H
+#define OIDFX_ENTITYHANDLE_H
+
+
+#include "OidFX/EntityNode.h"
+
+
+//namespace OidFX
+namespace OidFX
+{
+
+
+	//!@class	EntityHandle
+	//!@brief	Reference to one life of an entity
+	//!
+	//!			Entities are pooled, so a pointer to a despawned entity may later
+	//!			point to an unrelated entity of the same type. The handle keeps the
+	//!			generation of the entity it was taken from, and Get returns null once
+	//!			that entity has despawned
+	class EntityHandle
+	{
+		public:
+
+            //=========================================================================
+            // Constructors
+            //=========================================================================
+			EntityHandle ( )
+				: m_entity(0), m_generation(0)						{ }
+
+			explicit EntityHandle ( EntityNode* entity )
+				: m_entity(entity), m_generation(entity ? entity->Generation() : 0)	{ }
+
+            //=========================================================================
+            // Public methods
+            //=========================================================================
+			inline EntityNode* Get ( ) const throw();
+			inline void Reset ( ) throw()							{ m_entity = 0;	}
+
+		private:
+
+            //=========================================================================
+            // Private data
+            //=========================================================================
+			EntityNode*	m_entity;
+			UInt		m_generation;
+	};
+	//End class EntityHandle
+
+
+
+    //=========================================================================
+    //! @function    EntityHandle::Get
+    //! @brief       Get the entity, if it hasn't despawned since the handle was taken
+    //!              
+    //! @return      The entity, or null
+    //=========================================================================
+	EntityNode* EntityHandle::Get ( ) const
+	{
+		if ( m_entity && (m_entity->Generation() == m_generation) )
+		{
+			return m_entity;
+		}
+
+		return 0;
+	}
+	//End EntityHandle::Get
+
+
+}
+//end namespace OidFX
+
+
+#endif
+//#ifndef OIDFX_ENTITYHANDLE_H
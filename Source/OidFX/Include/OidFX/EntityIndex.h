@@ -0,0 +1,302 @@
+//======================================================================================
+//! @file         EntityIndex.h
+//! @brief        Loose grid of entities, kept up to date as they move, used to
+//!               answer sphere, box, ray and nearest entity queries
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+
+#ifndef OIDFX_ENTITYINDEX_H
+#define OIDFX_ENTITYINDEX_H
+
+
+#include <vector>
+#include <bitset>
+#include <boost/utility.hpp>
+#include "Core/CriticalSection.h"
+#include "Math/Math.h"
+#include "OidFX/EntityFlags.h"
+#include "OidFX/SceneQueryResult.h"
+
+
+//=========================================================================
+// Forward declaration
+//=========================================================================
+namespace Math  { class AxisAlignedBoundingBox; class BoundingSphere3D; class ParametricLine3D; class Vector3D; }
+namespace OidFX { class EntityNode; }
+
+
+//namespace OidFX
+namespace OidFX
+{
+
+
+	//!@class	EntityQueryFilter
+	//!@brief	Flags an entity must, or must not, have to be returned by an entity query
+	//!
+	//!			Dead entities, and entities waiting to be despawned, are always excluded.
+	//!			For example, EntityQueryFilter().AnyOf(EF_ENEMY).NoneOf(EF_PROJECTILE)
+	class EntityQueryFilter
+	{
+		public:
+
+			inline EntityQueryFilter ( );
+
+			inline EntityQueryFilter& AnyOf ( EEntityFlag flag );
+			inline EntityQueryFilter& NoneOf ( EEntityFlag flag );
+
+			inline bool Accepts ( const EntityFlagSet& flags ) const;
+
+		private:
+
+			EntityFlagSet	m_anyOf;	//!< Entity needs at least one of these, unless none are set
+			EntityFlagSet	m_noneOf;	//!< Entity can't have any of these
+	};
+	//End class EntityQueryFilter
+
+
+
+	//!@class	EntityIndex
+	//!@brief	Loose grid over world space holding every entity in the scene
+	//!
+	//!			Each entity is stored in the cell containing the centre of its bounding box. 
+	//!			An entity whose bounding sphere is no more than half a cell across fits inside 
+	//!			its cell grown by half a cell on each side, so a query only has to visit the
+	//!			cells it overlaps once grown by the same amount. Larger entities are kept in a
+	//!			separate list which every query checks.
+	//!
+	//!			Cells are hashed into a fixed number of buckets, the same way as SpatialHash, so
+	//!			the world doesn't need bounds. Moving an entity only touches the index when it
+	//!			moves into a cell in a different bucket, which is cheap, so unlike SpatialHash 
+	//!			the index isn't rebuilt every frame.
+	//!
+	//!			Queries may be made from several update jobs at once. They share the bucket 
+	//!			visit stamps, so they take a lock. Inserting, updating and removing entities 
+	//!			must only be done on one thread, while nothing is querying the index.
+	//!
+	//!			The index never dereferences the entities. It reads their flags through the
+	//!			flag set passed to Insert, which must live as long as the entity is in the index
+	class EntityIndex : public boost::noncopyable
+	{
+		public:
+
+            //=========================================================================
+            // Constructors
+            //=========================================================================
+			EntityIndex ( Float cellSize, UInt bucketCount );
+
+            //=========================================================================
+            // Public methods
+            //=========================================================================
+			void SetCellSize ( Float cellSize );
+			inline Float CellSize () const				{ return m_cellSize;	}
+
+			UInt Insert ( EntityNode* entity, const EntityFlagSet& flags, const Math::AxisAlignedBoundingBox& box );
+			void Update ( UInt slot, const Math::AxisAlignedBoundingBox& box );
+			void Remove ( UInt slot );
+
+			void Query ( const Math::BoundingSphere3D& sphere, const EntityQueryFilter& filter, EntityQueryResult& result );
+			void Query ( const Math::AxisAlignedBoundingBox& box, const EntityQueryFilter& filter, EntityQueryResult& result );
+			void Query ( const Math::ParametricLine3D& ray, bool sortResults, const EntityQueryFilter& filter, 
+						 EntityQueryResult& result );
+
+			void QueryNearest ( const Math::Vector3D& point, UInt count, Float maxDistance, 
+								const EntityQueryFilter& filter, EntityQueryResult& result );
+
+			inline UInt EntityCount () const			{ return m_entityCount;	}
+
+            //=========================================================================
+            // Public constants
+            //=========================================================================
+			enum { InvalidSlot = 0xFFFFFFFF };
+
+		private:
+
+            //=========================================================================
+            // Private types
+            //=========================================================================
+			struct Entry
+			{
+				EntityNode*	entity;				//!< NULL if the slot is free
+				const EntityFlagSet* flags;		//!< The entity's flags
+				Float		centre[3];
+				Float		halfExtent[3];
+				Float		radius;
+				UInt		bucket;
+				UInt		bucketPosition;		//!< Index of the slot within its bucket
+			};
+
+			typedef std::vector<UInt>			Bucket;
+			typedef std::vector<Bucket>			BucketStore;
+			typedef std::vector<Entry>			EntryStore;
+
+			struct Candidate
+			{
+				Float		distance;
+				EntityNode*	entity;
+
+				bool operator < ( const Candidate& rhs ) const	{ return distance < rhs.distance; }
+			};
+
+			typedef std::vector<Candidate>		CandidateStore;
+
+            //=========================================================================
+            // Private methods
+            //=========================================================================
+			void SetBounds ( Entry& entry, const Math::AxisAlignedBoundingBox& box ) const;
+			UInt BucketForEntry ( const Entry& entry ) const;
+			void AddToBucket ( UInt slot, UInt bucket );
+			void RemoveFromBucket ( UInt slot );
+			void GatherBuckets ( const Float minCorner[3], const Float maxCorner[3] );
+			inline UInt HashCell ( Int x, Int y, Int z ) const;
+			inline Int CellCoordinate ( Float position ) const;
+
+            //=========================================================================
+            // Private data
+            //=========================================================================
+			Float			m_cellSize;
+			Float			m_inverseCellSize;
+			UInt			m_entityCount;
+			UInt			m_queryStamp;
+
+			EntryStore		m_entries;
+			Bucket			m_freeSlots;
+			BucketStore		m_buckets;			//!< The last bucket holds the entities too large for a cell
+			Bucket			m_bucketStamps;		//!< Stamp of the last query that visited each bucket
+			Bucket			m_queryBuckets;		//!< Buckets visited by the current query
+			CandidateStore	m_candidates;		//!< Reused by ray and nearest queries
+			Core::CriticalSection m_queryLock;	//!< Guards the query stamps, buckets and candidates
+	};
+	//End class EntityIndex
+
+
+
+    //=========================================================================
+    //! @function    EntityQueryFilter::EntityQueryFilter
+    //! @brief       Construct a filter that accepts every live entity
+    //=========================================================================
+	EntityQueryFilter::EntityQueryFilter ( )
+	{
+		m_noneOf.set ( EF_DEAD );
+		m_noneOf.set ( EF_DESPAWNPENDING );
+	}
+	//End EntityQueryFilter::EntityQueryFilter
+
+
+
+    //=========================================================================
+    //! @function    EntityQueryFilter::AnyOf
+    //! @brief       Only accept entities with at least one of the AnyOf flags
+    //!              
+    //! @param       flag [in] Flag to add
+    //!              
+    //! @return      *this
+    //=========================================================================
+	EntityQueryFilter& EntityQueryFilter::AnyOf ( EEntityFlag flag )
+	{
+		m_anyOf.set ( flag );
+		return *this;
+	}
+	//End EntityQueryFilter::AnyOf
+
+
+
+    //=========================================================================
+    //! @function    EntityQueryFilter::NoneOf
+    //! @brief       Reject entities with this flag
+    //!              
+    //! @param       flag [in] Flag to add
+    //!              
+    //! @return      *this
+    //=========================================================================
+	EntityQueryFilter& EntityQueryFilter::NoneOf ( EEntityFlag flag )
+	{
+		m_noneOf.set ( flag );
+		return *this;
+	}
+	//End EntityQueryFilter::NoneOf
+
+
+
+    //=========================================================================
+    //! @function    EntityQueryFilter::Accepts
+    //! @brief       Check an entity's flags against the filter
+    //!              
+    //! @param       flags [in] Flags of the entity to check
+    //!              
+    //! @return      true if the entity passes the filter
+    //=========================================================================
+	bool EntityQueryFilter::Accepts ( const EntityFlagSet& flags ) const
+	{
+		return ( (m_anyOf.none()) || ((flags & m_anyOf).any()) )
+			&& ( (flags & m_noneOf).none() );
+	}
+	//End EntityQueryFilter::Accepts
+
+
+
+    //=========================================================================
+    //! @function    EntityIndex::HashCell
+    //! @brief       Hash a cell coordinate to a bucket index
+    //!              
+    //! @param       x [in] Cell x coordinate
+    //! @param       y [in] Cell y coordinate
+    //! @param       z [in] Cell z coordinate
+    //!              
+    //! @return      Index of the bucket holding the cell
+    //=========================================================================
+	UInt EntityIndex::HashCell ( Int x, Int y, Int z ) const
+	{
+		UInt hash = (static_cast<UInt>(x) * 73856093U) 
+				  ^ (static_cast<UInt>(y) * 19349663U) 
+				  ^ (static_cast<UInt>(z) * 83492791U);
+
+		//The last bucket is reserved for oversized entities
+		return hash % static_cast<UInt>(m_buckets.size() - 1);
+	}
+	//End EntityIndex::HashCell
+
+
+
+    //=========================================================================
+    //! @function    EntityIndex::CellCoordinate
+    //! @brief       Get the coordinate of the cell containing a position, along one axis
+    //!              
+    //! @param       position [in] World space position along the axis
+    //!              
+    //! @return      Cell coordinate
+    //=========================================================================
+	Int EntityIndex::CellCoordinate ( Float position ) const
+	{
+		return static_cast<Int>( Math::Floor( position * m_inverseCellSize ) );
+	}
+	//End EntityIndex::CellCoordinate
+
+
+}
+//end namespace OidFX
+
+
+#endif
+//#ifndef OIDFX_ENTITYINDEX_H
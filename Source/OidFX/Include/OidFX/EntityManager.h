@@ -43,7 +43,10 @@ namespace OidFX
 	//!@class	EntityManager
 	//!@brief	Class to manage the creation, storage, and destruction of entities
 	//!
-	//!
+	//!			Entities are never destroyed once created. Each type has a pool of
+	//!			spawned and unspawned entities, so spawning and despawning an entity
+	//!			takes constant time, and doesn't allocate once the pool is big enough.
+	//!			Use ReserveEntity at load time to size the pools.
 	class EntityManager
 	{
 
@@ -74,26 +77,34 @@ namespace OidFX
             //=========================================================================
             // Private types
             //=========================================================================
-			typedef std::list<boost::shared_ptr<EntityNode>, boost::fast_pool_allocator<boost::shared_ptr<EntityNode> > > EntityList;
-			typedef std::map<UInt, EntityList>  EntityListMapping;
+			typedef std::vector<boost::shared_ptr<EntityNode> > EntityStore;
+
+			//!@struct	EntityPool
+			//!@brief	Entities of a single type
+			//!
+			//!			Spawned entities are packed densely, and removed by moving the
+			//!			last one into their place. Unspawned entities are used as a stack
+			struct EntityPool
+			{
+				EntityStore spawned;
+				EntityStore unspawned;
+			};
 
-			typedef std::vector<boost::shared_ptr<EntityNode>, boost::fast_pool_allocator<boost::shared_ptr<EntityNode> > >
-					EntityStore;
+			typedef std::map<UInt, EntityPool>  EntityPoolMapping;
 
 
             //=========================================================================
             // Private methods
             //=========================================================================
-			void UpdateSpawnedList ( UInt type, EntityList& list );
-			void DespawnEntitiesInList ( UInt type, EntityList& list );
+			void UpdatePool ( EntityPool& pool );
+			void DespawnEntitiesInPool ( EntityPool& pool );
+			void ReleaseSpawnedEntity ( EntityPool& pool, UInt index );
 
 
             //=========================================================================
             // Private data
             //=========================================================================
-			EntityStore				m_entities;
-			EntityListMapping		m_spawnedEntities;
-			EntityListMapping		m_unspawnedEntities;
+			EntityPoolMapping		m_pools;
 
 			boost::shared_ptr<EntityFactory> m_entityFactory;
 			Scene&							 m_scene;
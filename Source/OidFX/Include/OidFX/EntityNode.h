@@ -35,7 +35,9 @@
 #include "OidFX/Mesh.h"
 #include "OidFX/SceneObject.h"
 #include "OidFX/Scene.h"
+#include "OidFX/EntityPhysics.h"
 #include "OidFX/EntityDeathEvent.h"
+#include "OidFX/EntityFlags.h"
 
 
 
@@ -52,38 +54,6 @@ namespace OidFX
 {
 
 
-	//! Flags that determine entity behaviour
-	enum EEntityFlag
-	{
-		EF_STATIC,					//!< Entity is static, and cannot move under any circumstances (except through parent-child relationships)
-		EF_NODRAW,					//!< Entity should not be rendered, even if it is in the view frustum
-		EF_SPAWNED,					//!< Entity has been spawned
-		EF_DEAD,					//!< Entity has been spawned but it is dead
-		EF_SPAWNONGROUND,			//!< If this flag is set, then the game engine will spawn the entity on the ground
-		EF_NOWORLDCOLLIDE,			//!< Entity never checks collision against the world
-		EF_NOENTITYCOLLIDE,			//!< Entity never checks collision against other entities
-		EF_NOPROJECTILECOLLIDE,		//!< Entity never checks collision against projectiles
-		EF_NOCOLLIDE,				//!< Entity never does any collision checks
-		EF_PROJECTILE,				//!< Entity is a projectile
-		EF_FLAMMABLE,				//!< Entity is flammable
-		EF_EXPLOSIVE,				//!< Entity is explosive
-		EF_PLAYER,					//!< Entity is the player
-		EF_INVINCIBLE,				//!< Entity cannot be hurt
-		EF_ANTIGRAVITY,				//!< Entity is immune to the effects of gravity
-		EF_ENEMY,					//!< Entity is an enemy of the player
-		EF_ALLY,					//!< Entity is an ally of the player
-		EF_POWERUP,					//!< Entity is a power-up
-		EF_BUILDING,				//!< Entity is a building
-		EF_NOEXPLOSIONKICKBACK,		//!< Entity doesn't get kicked back by explosions
-		EF_OBJECTIVEDESTROY,		//!< Entity is to be destroyed as part of an objective
-		EF_OBJECTIVEPROTECT,		//!< Game will end if the entity is destroyed
-		EF_DESPAWNPENDING,			//!< Entity requests that it be despawned soon
-
-		EF_COUNT			//!< Maximum entity flag count
-	};
-	//End enum EEntityFlag
-
-
 	//!@class	IEntity
 	//!@brief	Interface which all entities must adhere to
 	class IEntity
@@ -112,6 +82,11 @@ namespace OidFX
 
 		public:
 
+            //=========================================================================
+            // Public types
+            //=========================================================================
+			typedef OidFX::EntityFlagSet	EntityFlagSet;
+
             //=========================================================================
             // Constructors
             //=========================================================================
@@ -121,22 +96,24 @@ namespace OidFX
 						 const Math::Matrix4x4& toWorld = Math::Matrix4x4::IdentityMatrix, 
 						 const Math::Matrix4x4& fromWorld = Math::Matrix4x4::IdentityMatrix );
 
+			virtual ~EntityNode ( );
+
 
             //=========================================================================
             // Public methods
             //=========================================================================
 			void Spawn ( const Math::Vector3D& spawnPoint );
-			void UpdatePhysics ( Float timeElapsedInSeconds );
-			
-			void Update( Math::MatrixStack& toWorldStack, 
-						 Math::MatrixStack& fromWorldStack, 
-						 Float timeElapsedInSeconds );
+
+			void Think ( Float timeElapsedInSeconds );
+			inline bool HasThought ( ) const throw()	{ return m_hasThought;	}
 
 			//Fill visible object list
 			void FillVisibleObjectList ( VisibleObjectList& visibleObjectList, const Camera& camera );
 
 			bool CanCollideWith ( const EntityNode* entity ) const;
 
+			Math::Matrix4x4 InterpolatedObjectToWorld ( ) const;
+
 			void QueryScene ( const Math::BoundingSphere3D& sphere, EntityQueryResult& result );
 
 			
@@ -149,11 +126,11 @@ namespace OidFX
             //=========================================================================
             // Accessors for physics properites
             //=========================================================================
-			inline const Math::Quaternion& GetOrientation() const throw();
-			inline const Math::Vector3D&   GetAcceleration() const throw();
-			inline const Math::Vector3D&   GetVelocity() const throw();
-			inline const Math::Vector3D&   GetAngularAcceleration() const throw();
-			inline const Math::Vector3D&   GetAngularVelocity() const throw();
+			inline Math::Quaternion GetOrientation() const throw();
+			inline Math::Vector3D   GetAcceleration() const throw();
+			inline Math::Vector3D   GetVelocity() const throw();
+			inline Math::Vector3D   GetAngularAcceleration() const throw();
+			inline Math::Vector3D   GetAngularVelocity() const throw();
 
 			inline void SetOrientation( const Math::Quaternion& orientation );
 			inline void SetAcceleration( const Math::Vector3D& acceleration );
@@ -187,10 +164,13 @@ namespace OidFX
 			inline void  Heal ( Float amount ) throw();
 			inline bool  IsDead ( ) const throw();
 			inline bool	 IsSpawned ( ) const throw();
+			inline UInt	 Generation ( ) const throw()	{ return m_generation;	}
+			bool		 IsCollider ( ) const throw();
 
 			inline void SetFlag ( EEntityFlag flag ) throw();
 			inline void ClearFlag ( EEntityFlag flag ) throw();
 			inline bool IsFlagSet ( EEntityFlag flag ) const throw();
+			inline const EntityFlagSet& Flags ( ) const throw()	{ return m_flags;	}
 
 			inline void SetExplosiveStrength( Float strength ) throw();
 			inline Float GetExplosiveStrength () const throw();
@@ -218,27 +198,42 @@ namespace OidFX
 
 		protected:
 
+            //=========================================================================
+            // Protected methods
+            //=========================================================================
+
+			//Physics state lives in the scene's EntityPhysics store. These references
+			//are invalidated when another entity is created, so don't hold on to them
+			inline Math::Vector3D&	 Position ( );
+			inline Math::Quaternion& Orientation ( );
+			inline Math::Vector3D&	 Acceleration ( );
+			inline Math::Vector3D&	 Velocity ( );
+			inline Math::Vector3D&	 AngularVelocity ( );
+			inline Math::Vector3D&	 AngularAcceleration ( );
+
+			virtual void OnTransformChanged ( );
 
             //=========================================================================
             // Protected data
             //=========================================================================
-			Math::Vector3D				m_position;
-			Math::Quaternion			m_orientation;
-			Math::Vector3D				m_acceleration;
-			Math::Vector3D				m_velocity;
-			Math::Vector3D				m_angularVelocity;
-			Math::Vector3D				m_angularAcceleration;
-
 			Float						m_explosiveStrength;
 
 			ECollisionType				m_preferredCollisionType;
 
 		private:
 
+			friend class EntityPhysics;
+			friend class SceneCommandBuffer;
+			friend class CollisionManager;
+
             //=========================================================================
-            // Private types
+            // Private methods
             //=========================================================================
-			typedef std::bitset<EF_COUNT>	EntityFlagSet;
+			void SetLocalTransform ( const Math::Quaternion& orientation, const Math::Vector3D& position );
+			void SetInterpolatedTransform ( const Math::Quaternion& orientation, const Math::Vector3D& position );
+			void UpdatePhysicsMotion ( );
+			void UpdateEntityIndex ( );
+			void LeaveEntityIndex ( );
 
             //=========================================================================
             // Private data
@@ -253,13 +248,26 @@ namespace OidFX
 			
 			//Rendering related
 			HMesh				m_mesh;
+			Math::Matrix4x4		m_interpolatedObjectToParent;	//!< Local transform between the last two physics states
+			Float				m_screenSize;					//!< Projected radius, as a fraction of half the screen height
 
 			//
 			Float				m_deathTimer;
+			bool				m_hasThought;	//!< Set after the first call to Think
+			UInt				m_generation;	//!< Incremented each time the entity despawns. @see EntityHandle
 
 			//
 			EntityDeathEvent	m_deathEvent;
 
+			//Physics
+			EntityPhysics&		m_physics;
+			UInt				m_physicsSlot;	//!< Updated by EntityPhysics when the slot moves
+
+			//Scene queries
+			UInt				m_indexSlot;	//!< Slot in the scene's EntityIndex, or EntityIndex::InvalidSlot
+
+			//Collisions
+			UInt				m_colliderSlot;	//!< Slot in the CollisionManager's colliders, or CollisionManager::InvalidSlot
 			
 
 	};
@@ -321,9 +329,9 @@ namespace OidFX
     //!              
 	//! @return		 The orientation of the entity
     //=========================================================================
-	const Math::Quaternion& EntityNode::GetOrientation() const
+	Math::Quaternion EntityNode::GetOrientation() const
 	{
-		return m_orientation;
+		return m_physics.Orientation( m_physicsSlot );
 	}
 	//End EntityNode::GetOrientation
 
@@ -453,6 +461,11 @@ namespace OidFX
 		debug_assert ( flag != EF_COUNT, "Error, invalid flag" );
 
 		m_flags[flag] = true;
+
+		if ( (flag == EF_SPAWNED) || (flag == EF_STATIC) || (flag == EF_ANTIGRAVITY) )
+		{
+			UpdatePhysicsMotion();
+		}
 	}
 	//End EntityNode::SetFlag
 
@@ -470,6 +483,11 @@ namespace OidFX
 		debug_assert ( flag != EF_COUNT, "Error, invalid flag" );
 
 		m_flags[flag] = false;
+
+		if ( (flag == EF_SPAWNED) || (flag == EF_STATIC) || (flag == EF_ANTIGRAVITY) )
+		{
+			UpdatePhysicsMotion();
+		}
 	}
 	//End EntityNode::ClearFlag
 
@@ -515,10 +533,15 @@ namespace OidFX
 		//Clear the spawned flag
 		ClearFlag ( EF_SPAWNED );
 
+		//Handles to this life of the entity are no longer valid
+		++m_generation;
+
+		LeaveEntityIndex ( );
+
 		if ( m_parent )
 		{
 			//Remove the entity from the scene graph
-			m_parent->RemoveChild ( ID() );
+			m_parent->RemoveChild ( *this );
 		}
 
 	}
@@ -531,9 +554,9 @@ namespace OidFX
     //!              
     //! @return      The acceleration of the entity
     //=========================================================================
-	const Math::Vector3D& EntityNode::GetAcceleration() const
+	Math::Vector3D EntityNode::GetAcceleration() const
 	{
-		return m_acceleration;
+		return m_physics.Acceleration( m_physicsSlot );
 	}
 	//End EntityNode::GetAcceleration
 
@@ -544,9 +567,9 @@ namespace OidFX
     //!              
     //! @return      The velocity of the entity
     //=========================================================================
-	const Math::Vector3D& EntityNode::GetVelocity() const
+	Math::Vector3D EntityNode::GetVelocity() const
 	{
-		return m_velocity;
+		return m_physics.Velocity( m_physicsSlot );
 	}
 	//End EntityNode::GetVelocity
 
@@ -557,9 +580,9 @@ namespace OidFX
 	//!
     //! @return      The angular acceleration of the entity
     //=========================================================================
-	const Math::Vector3D& EntityNode::GetAngularAcceleration() const
+	Math::Vector3D EntityNode::GetAngularAcceleration() const
 	{
-		return m_angularAcceleration;
+		return m_physics.AngularAcceleration( m_physicsSlot );
 	}
 	//End EntityNode::GetAngularAcceleration
 
@@ -570,9 +593,9 @@ namespace OidFX
     //!              
     //! @return      The angular velocity of the entity
     //=========================================================================
-	const Math::Vector3D& EntityNode::GetAngularVelocity() const
+	Math::Vector3D EntityNode::GetAngularVelocity() const
 	{
-		return m_angularVelocity;
+		return m_physics.AngularVelocity( m_physicsSlot );
 	}
 	//End EntityNode::GetAngularVelocity
 
@@ -586,7 +609,7 @@ namespace OidFX
     //=========================================================================
 	void EntityNode::SetOrientation( const Math::Quaternion& orientation )
 	{
-		m_orientation = orientation;
+		m_physics.Orientation( m_physicsSlot ) = orientation;
 	}
 	//End EntityNode::SetOrientation
 
@@ -599,7 +622,7 @@ namespace OidFX
     //=========================================================================
 	void EntityNode::SetAcceleration( const Math::Vector3D& acceleration )
 	{
-		m_acceleration = acceleration;
+		m_physics.Acceleration( m_physicsSlot ) = acceleration;
 	}
 	//End EntityNode::SetAcceleration
 
@@ -612,7 +635,7 @@ namespace OidFX
     //=========================================================================
 	void EntityNode::SetVelocity( const Math::Vector3D& velocity )
 	{
-		m_velocity = velocity;
+		m_physics.Velocity( m_physicsSlot ) = velocity;
 	}
 	//End EntityNode::SetVelocity
 
@@ -626,7 +649,7 @@ namespace OidFX
     //=========================================================================
 	void EntityNode::SetAngularAcceleration ( const Math::Vector3D& angularAccel )
 	{
-		m_angularAcceleration = angularAccel;
+		m_physics.AngularAcceleration( m_physicsSlot ) = angularAccel;
 	}
 	//End EntityNode::SetAngularAcceleration
 
@@ -640,11 +663,89 @@ namespace OidFX
     //=========================================================================
 	void EntityNode::SetAngularVelocity ( const Math::Vector3D& angularVelocity )
 	{
-		m_angularVelocity = angularVelocity;
+		m_physics.AngularVelocity( m_physicsSlot ) = angularVelocity;
 	}
 	//End Entitynode::SetAngularVelocity
 
 
+    //=========================================================================
+    //! @function    EntityNode::Position
+    //! @brief       Return a reference to the position of the entity
+    //!              
+    //! @return      The position of the entity, stored in the scene's EntityPhysics
+    //=========================================================================
+	Math::Vector3D& EntityNode::Position ( )
+	{
+		return m_physics.Position( m_physicsSlot );
+	}
+	//End EntityNode::Position
+
+
+    //=========================================================================
+    //! @function    EntityNode::Orientation
+    //! @brief       Return a reference to the orientation of the entity
+    //!              
+    //! @return      The orientation of the entity, stored in the scene's EntityPhysics
+    //=========================================================================
+	Math::Quaternion& EntityNode::Orientation ( )
+	{
+		return m_physics.Orientation( m_physicsSlot );
+	}
+	//End EntityNode::Orientation
+
+
+    //=========================================================================
+    //! @function    EntityNode::Acceleration
+    //! @brief       Return a reference to the acceleration of the entity
+    //!              
+    //! @return      The acceleration of the entity, stored in the scene's EntityPhysics
+    //=========================================================================
+	Math::Vector3D& EntityNode::Acceleration ( )
+	{
+		return m_physics.Acceleration( m_physicsSlot );
+	}
+	//End EntityNode::Acceleration
+
+
+    //=========================================================================
+    //! @function    EntityNode::Velocity
+    //! @brief       Return a reference to the velocity of the entity
+    //!              
+    //! @return      The velocity of the entity, stored in the scene's EntityPhysics
+    //=========================================================================
+	Math::Vector3D& EntityNode::Velocity ( )
+	{
+		return m_physics.Velocity( m_physicsSlot );
+	}
+	//End EntityNode::Velocity
+
+
+    //=========================================================================
+    //! @function    EntityNode::AngularVelocity
+    //! @brief       Return a reference to the angular velocity of the entity
+    //!              
+    //! @return      The angular velocity of the entity, stored in the scene's EntityPhysics
+    //=========================================================================
+	Math::Vector3D& EntityNode::AngularVelocity ( )
+	{
+		return m_physics.AngularVelocity( m_physicsSlot );
+	}
+	//End EntityNode::AngularVelocity
+
+
+    //=========================================================================
+    //! @function    EntityNode::AngularAcceleration
+    //! @brief       Return a reference to the angular acceleration of the entity
+    //!              
+    //! @return      The angular acceleration of the entity, stored in the scene's EntityPhysics
+    //=========================================================================
+	Math::Vector3D& EntityNode::AngularAcceleration ( )
+	{
+		return m_physics.AngularAcceleration( m_physicsSlot );
+	}
+	//End EntityNode::AngularAcceleration
+
+
     //=========================================================================
     //! @function    EntityNode::QueryInterface
     //! @brief       Query the entity to see if it supports an interface
@@ -0,0 +1,141 @@
+//======================================================================================
+//! @file         EntityPhysics.h
+//! @brief        Structure of arrays store for entity rigid body state
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+
+#ifndef OIDFX_ENTITYPHYSICS_H
+#define OIDFX_ENTITYPHYSICS_H
+
+
+#include <vector>
+#include <boost/utility.hpp>
+#include "Math/Vector3D.h"
+#include "Math/Quaternion.h"
+
+
+//=========================================================================
+// Forward declaration
+//=========================================================================
+namespace OidFX { class EntityNode;	}
+
+
+//namespace OidFX
+namespace OidFX
+{
+
+
+	//!@class	EntityPhysics
+	//!@brief	Holds the rigid body state of every entity in a scene, one array per field
+	//!
+	//!			Each entity owns a slot for its lifetime. Slots are kept densely packed, freeing
+	//!			a slot moves the last slot into the hole, and tells its owner about the move.
+	//!
+	//!			Integrate steps every moving entity in one pass over the arrays, instead of
+	//!			each entity integrating itself while the scene graph is being walked. 
+	//!			WriteTransforms then rebuilds the local transforms of the owners, so the scene 
+	//!			graph update only has to concatenate them.
+	//!
+	//!			The positions and orientations from before the last Integrate are kept, so that
+	//!			when the simulation runs at a fixed rate, WriteInterpolatedTransforms can place
+	//!			each owner part way between its last two states for rendering.
+	//!
+	//!			References returned by the slot accessors are only valid until the next
+	//!			slot is allocated.
+	class EntityPhysics : public boost::noncopyable
+	{
+		public:
+
+            //=========================================================================
+            // Constructors
+            //=========================================================================
+			EntityPhysics ( UInt reserveCount );
+
+            //=========================================================================
+            // Public methods
+            //=========================================================================
+			UInt Allocate ( EntityNode& owner );
+			void Free ( UInt slot );
+
+			void SetMotion ( UInt slot, bool integrate, bool gravity );
+
+			void Snap ( UInt slot );
+
+			void Integrate ( Float timeElapsedInSeconds );
+			void WriteTransforms ( );
+			void WriteInterpolatedTransforms ( Float interpolation );
+
+			inline UInt SlotCount ( ) const								{ return static_cast<UInt>(m_owners.size());	}
+
+            //=========================================================================
+            // Slot accessors
+            //=========================================================================
+			inline Math::Vector3D&	 Position ( UInt slot )				{ return m_positions[slot];				}
+			inline Math::Quaternion& Orientation ( UInt slot )			{ return m_orientations[slot];			}
+			inline Math::Vector3D&	 Velocity ( UInt slot )				{ return m_velocities[slot];			}
+			inline Math::Vector3D&	 Acceleration ( UInt slot )			{ return m_accelerations[slot];			}
+			inline Math::Vector3D&	 AngularVelocity ( UInt slot )		{ return m_angularVelocities[slot];		}
+			inline Math::Vector3D&	 AngularAcceleration ( UInt slot )	{ return m_angularAccelerations[slot];	}
+
+		private:
+
+            //=========================================================================
+            // Private types
+            //=========================================================================
+			typedef std::vector<Math::Vector3D>		VectorArray;
+			typedef std::vector<Math::Quaternion>	QuaternionArray;
+			typedef std::vector<Float>				ScalarArray;
+			typedef std::vector<EntityNode*>		OwnerArray;
+
+            //=========================================================================
+            // Private data
+            //=========================================================================
+			VectorArray		m_positions;
+			QuaternionArray	m_orientations;
+			VectorArray		m_velocities;
+			VectorArray		m_accelerations;
+			VectorArray		m_angularVelocities;
+			VectorArray		m_angularAccelerations;
+
+			//State before the last Integrate
+			VectorArray		m_previousPositions;
+			QuaternionArray	m_previousOrientations;
+
+			//Stored as 0 or 1, so they can scale the integration terms instead of branching
+			ScalarArray		m_integrateMask;	//!< 1 if the entity is spawned and not static
+			ScalarArray		m_gravityMask;		//!< 1 if the entity moves and is affected by gravity
+
+			OwnerArray		m_owners;
+	};
+	//End class EntityPhysics
+
+
+}
+//end namespace OidFX
+
+
+#endif
+//#ifndef OIDFX_ENTITYPHYSICS_H
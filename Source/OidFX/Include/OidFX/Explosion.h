@@ -73,11 +73,8 @@ namespace OidFX
             //=========================================================================
             // Public methods
             //=========================================================================
-			void Update( Math::MatrixStack& toWorldStack, 
-						 Math::MatrixStack& fromWorldStack, 
-						 Float timeElapsedInSeconds );
-
 			virtual void OnSpawn( const Math::Vector3D& spawnPoint );
+			virtual void OnThink( Float timeElapsed );
 			virtual void OnDeath();
 
 		private:
@@ -34,6 +34,9 @@
 
 #include "Core/Singleton.h"
 #include "Core/FramerateCounter.h"
+#include "Core/Timer.h"
+#include "OidFX/Camera.h"
+#include "OidFX/VisibleObjectList.h"
 
 
 //=========================================================================
@@ -41,7 +44,7 @@
 //=========================================================================
 namespace Core
 {
-	class InputSystem;
+	class InputSystem; class WorkerPool;
 }
 
 namespace Renderer 
@@ -52,7 +55,7 @@ namespace Renderer
 
 namespace OidFX
 {
-	class Scene; class Camera; class MeshManager; class BillboardManager;
+	class Scene; class Camera; class MeshManager; class BillboardManager; class FrameSimulationJob;
 }
 
 
@@ -63,8 +66,15 @@ namespace OidFX
 	//!@class	GameApplication
 	//!@brief	Base class encapsulating the initialisation, update, and shutdown
 	//!			of the game engine
+	//!
+	//!			Each frame is simulated and culled, then queued, then drawn. If init_pipelineframes
+	//!			is set, the next frame is simulated and culled on its own thread while the
+	//!			current one is drawn. Only the render queue, the billboard list and the camera
+	//!			view captured by QueueFrame are used to draw a frame, so the scene is free to move on.
 	class GameApplication : public Core::Singleton<GameApplication>
 	{
+		friend class FrameSimulationJob;
+
 		public:
 
 
@@ -99,6 +109,7 @@ namespace OidFX
 			inline const Core::FramerateCounter&	GetFramerateCounter()	{ return m_framerateCounter;	}
 			inline Core::InputSystem&				GetInputSystem()		{ return *m_inputSystem;	}
 			inline BillboardManager&				GetBillboardManager()	{ return *m_billboardManager;	}
+			inline Core::WorkerPool&				GetWorkerPool()			{ return *m_workerPool;		}
 
 		protected:
 
@@ -117,14 +128,20 @@ namespace OidFX
 			virtual void InitialiseScene();
 			virtual void InitialiseInputSystem();
 			virtual void InitialiseBillboardManager();
+			virtual void InitialiseWorkerPool();
 
 			virtual void PostInitialise() {};
 			virtual void CheckRendererMeetsMinimumSpec();
 
 			//Update
 			void Update( Float timeElapsed );
+			void UpdateCamera( Float timeElapsed );
 			virtual void UpdateScene( Float timeElapsed );
 
+			//Frame stages
+			UInt SimulateFrame ( Float timeElapsed, bool updateInput );
+			void QueueFrame ( bool swapBillboards );
+
 			//Rendering
 			virtual void PreRender();
 			virtual void Render();
@@ -152,12 +169,22 @@ namespace OidFX
 			boost::shared_ptr<Camera>					 m_camera;
 			boost::shared_ptr<Core::InputSystem>		 m_inputSystem;
 			boost::shared_ptr<BillboardManager>			 m_billboardManager;
+			boost::shared_ptr<Core::WorkerPool>			 m_workerPool;
 
 			Core::FramerateCounter						m_framerateCounter;
 			
 			bool m_quit;
 			std::string m_windowTitle;
 
+			//Frame state
+			Core::TimerValue							m_simulationTime;	//!< Simulation time not yet covered by a whole tick
+			VisibleObjectList							m_visibleObjects;
+			CameraView									m_frameView;		//!< View the queued frame is drawn from
+
+			//Declared last, so that the simulation thread is stopped before anything it uses is destroyed
+			boost::shared_ptr<FrameSimulationJob>		 m_simulationJob;
+			boost::shared_ptr<Core::WorkerPool>			 m_simulationThread;	//!< Only created if frames are pipelined
+
 		private:
 		
 	};
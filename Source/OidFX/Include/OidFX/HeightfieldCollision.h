@@ -0,0 +1,138 @@
+//======================================================================================
+//! @file         HeightfieldCollision.h
+//! @brief        Collision queries against a terrain heightmap
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+#ifndef OIDFX_HEIGHTFIELDCOLLISION_H
+#define OIDFX_HEIGHTFIELDCOLLISION_H
+
+#include "Core/HeightMap.h"
+#include "Math/Vector3D.h"
+
+
+//=========================================================================
+// Forward declaration
+//=========================================================================
+namespace Math	{ class ParametricLine3D;	}
+
+
+//namespace OidFX
+namespace OidFX
+{
+
+	//!@class	HeightfieldCollision
+	//!@brief	Ray and box queries against a heightmap, without building any triangles
+	//!
+	//!			Works in the local space of the terrain. Sample (row, col) is at
+	//!			(col * spacing, height, row * spacing). Each grid cell is split into two
+	//!			triangles along the same diagonal as the rendered terrain, so queries
+	//!			match what is drawn at the most detailed LOD level.
+	//!
+	//!			Queries can be limited to a range of samples, so that each terrain
+	//!			chunk only reports collisions with its own part of the heightmap.
+	class HeightfieldCollision
+	{
+		public:
+
+            //=========================================================================
+            // Public types
+            //=========================================================================
+
+			//! Range of samples, inclusive. The cells queried are the ones between them
+			struct Region
+			{
+				UInt firstRow;
+				UInt firstCol;
+				UInt lastRow;
+				UInt lastCol;
+			};
+
+            //=========================================================================
+            // Constructors
+            //=========================================================================
+			HeightfieldCollision ( );
+
+            //=========================================================================
+            // Public methods
+            //=========================================================================
+			void Initialise ( const Core::HeightMap& heightMap, UInt size, Float spacing );
+
+			Float			HeightAt ( Float x, Float z ) const;
+			Math::Vector3D	NormalAt ( Float x, Float z ) const;
+
+			bool IntersectRay ( const Math::ParametricLine3D& line, 
+								const Region& region, 
+								Float& t ) const;
+
+			bool Collide ( const Math::Vector3D& minCorner, 
+						   const Math::Vector3D& maxCorner,
+						   const Region& region,
+						   Math::Vector3D& normal,
+						   Float& depth ) const;
+
+			Region	WholeRegion () const;
+			UInt	Size () const			{ return m_size;		}
+			Float	Spacing () const		{ return m_spacing;		}
+
+		private:
+
+            //=========================================================================
+            // Private methods
+            //=========================================================================
+			inline Float Sample ( UInt row, UInt col ) const;
+
+			bool IntersectCell ( const Math::Vector3D& p0, 
+								 const Math::Vector3D& v, 
+								 UInt row, 
+								 UInt col, 
+								 Float& t ) const;
+
+            //=========================================================================
+            // Private data
+            //=========================================================================
+			const Core::HeightMap*	m_heightMap;
+			UInt					m_size;		//!< Samples along each side that are used
+			Float					m_spacing;	//!< Distance between samples
+	};
+	//End class HeightfieldCollision
+
+
+
+    //=========================================================================
+    //! @function    HeightfieldCollision::Sample
+    //! @brief       Get the height of a sample
+    //=========================================================================
+	Float HeightfieldCollision::Sample ( UInt row, UInt col ) const
+	{
+		return m_heightMap->HeightAt ( row, col );
+	}
+	//End HeightfieldCollision::Sample
+
+}
+//end namespace OidFX
+
+#endif
+//#ifndef OIDFX_HEIGHTFIELDCOLLISION_H
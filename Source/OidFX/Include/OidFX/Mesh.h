@@ -95,40 +95,94 @@ namespace OidFX
 
 
 
-	//!@class	MeshGroup
-	//!@brief	Class representing a named subset of a mesh, covered uniformly
-	//!			by one effect
-	class MeshGroup : public Renderer::IRenderable
+	//=========================================================================
+	// Constants
+	//=========================================================================
+
+	//Maximum number of geometry LODs of a mesh, including the full detail mesh
+	const UInt g_maxMeshLODs = 4;
+
+
+
+	//!@class	MeshGroupLOD
+	//!@brief	Range of the mesh index buffer that draws one level of detail of a mesh group
+	class MeshGroupLOD : public Renderer::IRenderable
 	{
 
 		public:
 
             //=========================================================================
-            // Public types
+            // Constructors/Destructor
             //=========================================================================
-			typedef std::vector<UInt>			IndexStore;
-			typedef IndexStore::const_iterator	ConstIndexIterator;
+			MeshGroupLOD ( UInt startOffset, UInt triangleCount, UInt minVertexIndex, UInt maxVertexIndex )
+				: m_startOffset(startOffset), m_triangleCount(triangleCount), 
+				  m_minVertexIndex(minVertexIndex), m_maxVertexIndex(maxVertexIndex)
+			{
+			}
+
+
+            //=========================================================================
+            // Public methods
+            //=========================================================================
+			UInt	StartOffset() const		{ return m_startOffset;		}
+			UInt	TriangleCount() const	{ return m_triangleCount;	}
+
+			// IRenderable implementation
+			void Render( Renderer::IRenderer& renderer );
+			void QueueForRendering ( Renderer::RenderQueue& renderer ) {}
+
+
+		private:
+
+            //=========================================================================
+            // Private data
+            //=========================================================================
+			UInt					m_startOffset;
+			UInt					m_triangleCount;
+			UInt					m_minVertexIndex;
+			UInt					m_maxVertexIndex;
+
+	};
+	//End class MeshGroupLOD
+
+
+
+	//!@class	MeshGroup
+	//!@brief	Class representing a named subset of a mesh, covered uniformly
+	//!			by one effect
+	//!
+	//!			Each level of detail of the group is a separate range of the mesh's index
+	//!			buffer. All of them index the same vertices. LOD 0 is the full detail group.
+	class MeshGroup : public Renderer::IRenderable
+	{
 
+		public:
 
             //=========================================================================
             // Constructors/Destructor
             //=========================================================================
 			MeshGroup ( const Char* name, Renderer::HEffect& effect, UInt startOffset,
-						const IndexStore& triangleIndices, UInt minVertexIndex, UInt maxVertexIndex )
+						UInt triangleCount, UInt minVertexIndex, UInt maxVertexIndex )
 
 				: 
-				  m_name(name), m_effect(effect), m_startOffset(startOffset), 
-				  m_triangleIndices(triangleIndices), m_minVertexIndex(minVertexIndex), m_maxVertexIndex(maxVertexIndex)
+				  m_name(name), m_effect(effect), m_minVertexIndex(minVertexIndex), m_maxVertexIndex(maxVertexIndex)
 			{
+				AddLOD ( startOffset, triangleCount );
 			}
 
 
             //=========================================================================
             // Public methods
             //=========================================================================
-			ConstIndexIterator	IndicesBegin() const	{ return m_triangleIndices.begin();	}
-			ConstIndexIterator	IndicesEnd() const		{ return m_triangleIndices.end();	}
-			UInt				IndexCount() const		{ return m_triangleIndices.size();	}
+			const std::string&			Name() const			{ return m_name;				}
+			const Renderer::HEffect&	GetEffect() const		{ return m_effect;			}
+			UInt						MinVertexIndex() const	{ return m_minVertexIndex;	}
+			UInt						MaxVertexIndex() const	{ return m_maxVertexIndex;	}
+
+			//Levels of detail
+			void						AddLOD ( UInt startOffset, UInt triangleCount );
+			UInt						LODCount() const		{ return m_lods.size();		}
+			const MeshGroupLOD&			LOD ( UInt lod ) const	{ return m_lods[lod];		}
 
 
 			// IRenderable implementation
@@ -138,7 +192,8 @@ namespace OidFX
 									 Renderer::HIndexBuffer& indexBuffer,
 									 Renderer::VertexStreamBinding& streamBinding,
 									 const Math::Matrix4x4& worldMatrix,
-									 UInt lodIndex );
+									 UInt lodIndex,
+									 UInt geometryLOD );
 
 			void QueueForRendering ( Renderer::RenderQueue& renderer ) {}
 
@@ -148,12 +203,11 @@ namespace OidFX
             //=========================================================================
             // Private data
             //=========================================================================
-			std::string				m_name;
-			UInt					m_startOffset;
-			UInt					m_minVertexIndex;
-			UInt					m_maxVertexIndex;
-			IndexStore				m_triangleIndices;
-			Renderer::HEffect		m_effect;
+			std::string					m_name;
+			UInt						m_minVertexIndex;
+			UInt						m_maxVertexIndex;
+			std::vector<MeshGroupLOD>	m_lods;
+			Renderer::HEffect			m_effect;
 
 
 	};
@@ -199,6 +253,16 @@ namespace OidFX
 				UInt			smoothingGroup;
 			};
 
+			//! Format for first stream of mesh data in the vertex buffer. Cooked mesh files
+			//! store their vertices in this format, so they can be copied straight in
+			struct MeshStream0
+			{
+				Float	position [3];
+				Float   normal   [3];
+				UInt32	colour;
+				Float	texcoord [2];
+			};
+
 
             //=========================================================================
             // Constructors/Destructor
@@ -210,6 +274,16 @@ namespace OidFX
 				   const std::vector<Renderer::HEffect>& effects,
 				   std::vector<MeshGroupDescriptor>& groupDescriptor );
 
+			Mesh ( Renderer::IRenderer& renderer,
+				   const Char* name,
+				   const MeshStream0* vertices,
+				   UInt vertexCount,
+				   const UInt16* indices,
+				   UInt indexCount,
+				   const Math::AxisAlignedBoundingBox& boundingBox,
+				   const std::vector<Renderer::HEffect>& effects,
+				   const std::vector<MeshGroup>& groups );
+
 
             //=========================================================================
             // More public types
@@ -239,9 +313,12 @@ namespace OidFX
 			
 			void Unload() {}
 
+			void WriteCooked ( std::ostream& file ) const;
+
             // IRenderable implementation
 			void Render( Renderer::IRenderer& renderer );
-			void QueueForRendering ( Renderer::RenderQueue& queue, const Math::Matrix4x4& worldMatrix, UInt lodIndex );
+			void QueueForRendering ( Renderer::RenderQueue& queue, const Math::Matrix4x4& worldMatrix, 
+									 UInt lodIndex, Float screenSize );
 
 			void QueueForRendering ( Renderer::RenderQueue& queue ) {}
       
@@ -264,23 +341,10 @@ namespace OidFX
 			inline UInt	TriangleCount ( ) const		{ return m_triangles.size();	}
 			inline UInt	MeshGroupCount ( ) const	{ return m_groups.size();		}
 			inline UInt	EffectCount ( ) const		{ return m_effects.size();		}
+			inline UInt	LODCount ( ) const			{ return m_lodCount;			}
 			
 		private:
 
-            //=========================================================================
-            // Private types
-            //=========================================================================
-			
-			//! Format for first stream of mesh data in the vertex buffer
-			struct MeshStream0
-			{
-				Float	position [3];
-				Float   normal   [3];
-				UInt32	colour;
-				Float	texcoord [2];
-			};
-
-
             //=========================================================================
             // Private methods
             //=========================================================================
@@ -291,12 +355,17 @@ namespace OidFX
 									 const std::vector<MeshGroupDescriptor>& groupDescriptor );
 
 			void BuildGroups ( std::vector<MeshGroupDescriptor>& groupDescriptor );
+			void GenerateLODs();
+			void OptimiseVertexCache();
 			void GenerateBoundingVolumes(); 
 			void GenerateNormals();
-			void CreateMeshVertexBuffer( Renderer::IRenderer& renderer );
-			void CreateMeshIndexBuffer( Renderer::IRenderer& renderer );
+			void CreateMeshVertexBuffer( Renderer::IRenderer& renderer, UInt vertexCount );
+			void CreateMeshIndexBuffer( Renderer::IRenderer& renderer, UInt indexCount );
 			void FillVertexBuffer();
-			void FillIndexBuffer();
+			void FillVertexBuffer( const MeshStream0* vertices, UInt vertexCount );
+			void FillIndexBuffer( const UInt16* indices, UInt indexCount );
+
+			static void ConvertVertex ( const Vertex& vertex, MeshStream0& streamVertex );
 
 			//Private iterator methods
 			inline VertexIterator		VerticesBegin ( ) 	{ return m_vertices.begin();	}
@@ -313,16 +382,23 @@ namespace OidFX
             // Private data
             //=========================================================================
 
-			//Vertices and triangles
+			//Vertices and triangles. These are empty for meshes loaded from cooked files,
+			//which are copied straight from the file into the vertex and index buffers
 			VertexStore						m_vertices;
 			TriangleStore					m_triangles;
 
+			//Indices of every group, in index buffer order
+			std::vector<UInt16>				m_indices;
+
 			//Bounding volume
 			Math::AxisAlignedBoundingBox	m_boundingBox;
 			
 			//Mesh groups
 			MeshGroupStore					m_groups;
 
+			//Number of geometry LODs of every group
+			UInt							m_lodCount;
+
 			//Materials
 			EffectStore						m_effects;
 			
@@ -80,9 +80,7 @@ namespace OidFX
             //=========================================================================
             // Public methods
             //=========================================================================
-			void Update( Math::MatrixStack& toWorldStack, 
-						 Math::MatrixStack& fromWorldStack, 
-						 Float timeElapsedInSeconds );
+			void OnThink ( Float timeElapsed );
 
 			bool LaunchMissile ( );
 
@@ -109,10 +107,12 @@ namespace OidFX
 
 		private:
 
+			friend class SceneCommandBuffer;
+
             //=========================================================================
             // Private methods
             //=========================================================================
-
+			void FireMissile ( );
             //=========================================================================
             // Private data
             //=========================================================================
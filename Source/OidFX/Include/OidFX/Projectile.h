@@ -29,6 +29,9 @@
 #define OIDFX_PROJECTILE_H
 
 
+#include "OidFX/EntityHandle.h"
+
+
 //namespace OidFX
 namespace OidFX
 {
@@ -77,10 +80,6 @@ namespace OidFX
 						 UInt ownerID,
 						 HMesh& mesh );
 
-			void Update( Math::MatrixStack& toWorldStack, 
-						 Math::MatrixStack& fromWorldStack, 
-						 Float timeElapsedInSeconds );
-
 			//Mutators
 			inline void SetTimeout ( Float timeOut ) throw();
 			inline void ClearTarget ( ) throw();
@@ -136,7 +135,7 @@ namespace OidFX
 			std::bitset<PF_COUNT>		m_projectileFlags;
 			EProjectileState			m_projectileState;
 
-			EntityNode*					m_target;
+			EntityHandle				m_target;		//!< Lets go of the target if it despawns
 			UInt						m_ownerID;
 			Float						m_timeOut;
 
@@ -175,7 +174,7 @@ namespace OidFX
     //=========================================================================
 	void Projectile::ClearTarget ( )
 	{
-		m_target = 0;
+		m_target.Reset();
 	}
 	//End Projectile::ClearTarget
 
@@ -191,7 +190,7 @@ namespace OidFX
     //=========================================================================
 	void Projectile::SetTarget ( EntityNode* target )
 	{
-		m_target = target;
+		m_target = EntityHandle ( target );
 	}
 	//End Projectile::SetTarget
 
@@ -201,14 +200,14 @@ namespace OidFX
     //! @function    Projectile::GetTarget
     //! @brief       Return the target of the projectile
     //!              
-	//!				 If the projectile is not targeting anything, then a null
-	//!				 pointer will be returned
+	//!				 If the projectile is not targeting anything, or the target
+	//!				 has despawned, then a null pointer will be returned
     //!              
     //! @return      A pointer to the target
     //=========================================================================
 	EntityNode* Projectile::GetTarget ( )
 	{
-		return m_target;
+		return m_target.Get();
 	}
 	//End Projectile::GetTarget
 
@@ -70,6 +70,9 @@ namespace OidFX
 
 			//Fill visible object list
 			void FillVisibleObjectList ( VisibleObjectList& visibleObjectList, const Camera& camera );
+			void FillSubtreeVisibleObjectList ( VisibleObjectList& visibleObjectList, const Camera& camera );
+
+			UInt TreeLevel() const		{ return m_treeLevel;	}
 
 		private:
 
@@ -74,8 +74,6 @@ namespace OidFX
 			//=========================================================================
             // Public methods
             //=========================================================================
-			virtual void Update ( Math::MatrixStack& toWorldStack, Math::MatrixStack& fromWorldStack, Float timeElapsedInSeconds );
-
 			virtual void OnSpawn ( const Math::Vector3D& spawnPoint );
 			virtual void OnThink ( Float timeElapsed );
 			virtual void OnTouch ( );
@@ -32,6 +32,7 @@
 
 
 #include <boost/noncopyable.hpp>
+#include "Core/ThreadLocal.h"
 #include "Math/Triangle.h"
 #include "Renderer/Renderable.h"
 #include "OidFX/SceneNode.h"
@@ -43,8 +44,11 @@
 // Forward declarations
 //=========================================================================
 namespace Renderer { class RenderQueue; class IRenderer;				}
+namespace Math	   { class AxisAlignedBoundingBox;	}
 namespace OidFX	   { class VisibleObjectList; class GameApplication; class ProjectileManager; 
-					 class CollisionManager; class EntityManager; class SceneNode;	}
+					 class CollisionManager; class EntityManager; class SceneNode; class SubtreeCullJob;
+					 class EntityPhysics; class EntityIndex; class EntityQueryFilter; class EntityNode;
+					 class SceneCommandBuffer; class EntityUpdateJob;	}
 
 
 //namespace OidFX
@@ -59,6 +63,15 @@ namespace OidFX
 
 		public:
 
+            //=========================================================================
+            // Public types
+            //=========================================================================
+			enum EEntityPhase
+			{
+				PHASE_UPDATE,	//!< Update transforms and bounds
+				PHASE_THINK		//!< Update behaviour
+			};
+
             //=========================================================================
             // Constructors/Destructor
             //=========================================================================
@@ -69,30 +82,77 @@ namespace OidFX
             // Public methods
             //=========================================================================
 			virtual void Update  ( Float timeElapsedInSeconds );
+			virtual void Interpolate ( Float interpolation );
 			virtual void Restore ();
 			virtual void FillVisibleObjectList ( VisibleObjectList& visibleObjectList, const Camera& camera );
 
+			void ReleaseAfterFrame ( boost::shared_ptr<SceneNode> node );
+			void ReleaseRemovedNodes ( );
+
 			virtual void QueryScene ( const Math::ParametricLine3D& ray, bool sortResults, SceneQueryResult& result );
 			
 			virtual void QueryScene ( const Math::BoundingSphere3D& sphere, EntityQueryResult& result );
 
+			//Entity queries, answered by the entity index
+			void QueryScene ( const Math::BoundingSphere3D& sphere, const EntityQueryFilter& filter, EntityQueryResult& result );
+			void QueryScene ( const Math::AxisAlignedBoundingBox& box, const EntityQueryFilter& filter, EntityQueryResult& result );
+			void QueryScene ( const Math::ParametricLine3D& ray, bool sortResults, const EntityQueryFilter& filter, 
+							  EntityQueryResult& result );
+			void QueryNearest ( const Math::Vector3D& point, UInt count, Float maxDistance, 
+								const EntityQueryFilter& filter, EntityQueryResult& result );
+
 			boost::shared_ptr<SceneNode> Root()			{ return m_rootNode;	}
 			GameApplication&			 Application()  { return m_application; }
 
 			ProjectileManager& GetProjectileManager() { return *m_projectileManager; }	
 			CollisionManager&  GetCollisionManager()  { return *m_collisionManager;  }
 			EntityManager&	   GetEntityManager()	  { return *m_entityManager;	 }
+			EntityPhysics&	   GetEntityPhysics()	  { return *m_entityPhysics;	 }
+			EntityIndex&	   GetEntityIndex()		  { return *m_entityIndex;		 }
+
+			SceneCommandBuffer& Commands();
+
+			//Dirty transform bookkeeping, see SceneNode::MarkTransformDirty
+			bool UpdatingGraph() const	{ return m_updatingGraph; }
+			bool OnUpdateJob() const	{ return (m_threadCommands.Get() != 0); }
+			void QueueTransformDirty ( SceneNode* node );
 
 		protected:
+
+            //=========================================================================
+            //  Protected methods
+            //=========================================================================
+			void FillVisibleObjectListParallel ( VisibleObjectList& visibleObjectList, const Camera& camera,
+												 UInt splitLevel );
+
+			void UpdateEntities ( Float timeElapsedInSeconds );
+			void UpdateSpawnedEntities ( UInt firstChild, Float timeElapsedInSeconds );
+			void RunEntityPhase ( EEntityPhase phase, UInt batchSize, Float timeElapsedInSeconds );
+			void ApplyQueuedTransformDirty ( );
 		
             //=========================================================================
             //  Private data
             //=========================================================================
+			std::vector<boost::shared_ptr<SubtreeCullJob> >	m_cullJobs;	//!< Reused from frame to frame
+
+			std::vector<boost::shared_ptr<EntityUpdateJob> >	m_updateJobs;		//!< Reused from frame to frame
+			std::vector<EntityNode*>							m_newEntities;		//!< Updated on this thread, before the jobs run
+			std::vector<EntityNode*>							m_updateEntities;	//!< Updated in batches by the jobs
+			boost::shared_ptr<SceneCommandBuffer>				m_commands;			//!< Commands made outside the update jobs
+			Core::ThreadLocalPointer<SceneCommandBuffer>		m_threadCommands;	//!< Buffer of the job running on each thread
+
+			std::vector<SceneNode*>	m_dirtyNodes;		//!< Nodes marked dirty while the graph was being updated
+			bool					m_updatingGraph;	//!< Set while the scene graph is being traversed by Update
+
+			boost::shared_ptr<EntityPhysics>	 m_entityPhysics;	//!< Declared first so it outlives every entity
+			boost::shared_ptr<EntityIndex>		 m_entityIndex;		//!< Also outlives every entity
+
 			boost::shared_ptr<CollisionManager>	 m_collisionManager;
 			boost::shared_ptr<ProjectileManager> m_projectileManager;
 			boost::shared_ptr<EntityManager>	 m_entityManager;
 
 			boost::shared_ptr<SceneNode> m_rootNode;
+			std::vector<boost::shared_ptr<SceneNode> > m_removedNodes;	//!< Kept alive until the frame that may draw them is done
 			GameApplication&			 m_application;
 
 
@@ -0,0 +1,135 @@
+//======================================================================================
+//! @file         SceneCommandBuffer.h
+//! @brief        Side effects of entity updates, recorded on update jobs and applied
+//!               on the thread that runs the scene update
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+#ifndef OIDFX_SCENECOMMANDBUFFER_H
+#define OIDFX_SCENECOMMANDBUFFER_H
+
+
+#include <vector>
+#include <boost/utility.hpp>
+#include "Math/Vector3D.h"
+#include "OidFX/EntityNode.h"
+
+
+//=========================================================================
+// Forward declarations
+//=========================================================================
+namespace OidFX { class Scene; class MissileLauncher; class Billboard; }
+
+
+//namespace OidFX
+namespace OidFX
+{
+
+
+	//!@class	SceneCommandBuffer
+	//!@brief	List of changes to shared scene state, made by entities while they are updated
+	//!
+	//!			Entities are updated by jobs on the worker pool, so an entity may only change
+	//!			itself and the entities attached to it. Anything else, such as spawning an entity,
+	//!			hurting another entity, or adding a billboard, is recorded here instead, and 
+	//!			executed once the jobs have finished. Scene::Commands returns the buffer for 
+	//!			the calling thread.
+	//!
+	//!			Each update job has its own buffer, and the scene executes them in the same 
+	//!			order as the entities they updated, so commands are applied in the order 
+	//!			a serial update would have made the calls
+	class SceneCommandBuffer : public boost::noncopyable
+	{
+		public:
+
+            //=========================================================================
+            // Constructors
+            //=========================================================================
+			SceneCommandBuffer ( );
+
+            //=========================================================================
+            // Public methods
+            //=========================================================================
+			void UpdateEntityIndex ( EntityNode& entity );
+			void SpawnEntity ( const Char* type, const Math::Vector3D& position, 
+							   Float explosiveStrength, const EntityNode::EntityFlagSet& flags );
+			void LaunchMissile ( MissileLauncher& launcher );
+			void SetVelocity ( EntityNode& entity, const Math::Vector3D& velocity );
+			void Hurt ( EntityNode& entity, Float amount );
+			void AddBillboard ( Billboard& billboard );
+
+			void Execute ( Scene& scene );
+
+			inline bool Empty ( ) const		{ return m_commands.empty();	}
+
+		private:
+
+            //=========================================================================
+            // Private types
+            //=========================================================================
+			enum ECommandType
+			{
+				CMD_UPDATEENTITYINDEX,
+				CMD_SPAWNENTITY,
+				CMD_LAUNCHMISSILE,
+				CMD_SETVELOCITY,
+				CMD_HURT,
+				CMD_ADDBILLBOARD
+			};
+
+			struct Command
+			{
+				ECommandType				type;
+				EntityNode*					entity;			//!< Entity the command applies to, if any
+				MissileLauncher*			launcher;
+				Billboard*					billboard;
+				UInt						entityType;		//!< Hash of the type name to spawn
+				Math::Vector3D				vector;			//!< Spawn position, or new velocity
+				Float						amount;			//!< Explosive strength, or damage
+				EntityNode::EntityFlagSet	flags;			//!< Flags to set on a spawned entity
+			};
+
+			typedef std::vector<Command> CommandList;
+
+            //=========================================================================
+            // Private methods
+            //=========================================================================
+			Command& Record ( ECommandType type );
+			void ExecuteCommand ( Scene& scene, const Command& command );
+
+            //=========================================================================
+            // Private data
+            //=========================================================================
+			CommandList		m_commands;
+			CommandList		m_executing;	//!< Commands being executed, kept to reuse the storage
+	};
+	//End class SceneCommandBuffer
+
+
+}
+//end namespace OidFX
+
+
+#endif
+//#ifndef OIDFX_SCENECOMMANDBUFFER_H
@@ -125,6 +125,7 @@ namespace OidFX
             //=========================================================================
 			void AddChild ( boost::shared_ptr<SceneNode> node );
 			void RemoveChild ( UInt id );
+			void RemoveChild ( SceneNode& node );
 			
 			//Transformation
 			void SetTransform ( const Math::Matrix4x4& toWorld );
@@ -132,6 +133,9 @@ namespace OidFX
 
 			void SetConcatTransform ( const Math::Matrix4x4& concatToWorld, const Math::Matrix4x4& concatFromWorld );
 
+			void MarkTransformDirty ( );
+			inline bool TransformDirty() const							{ return m_transformDirty;		  }
+
 			void UpdateLODLevel ( const Camera& camera );
 
 			inline const Math::Matrix4x4& ObjectToWorld () const		{ return m_objectToWorld;		  }
@@ -140,6 +144,9 @@ namespace OidFX
 			inline const Math::Matrix4x4& ConcatObjectToWorld() const	{ return m_concatObjectToWorld;	  }
 			inline const Math::Matrix4x4& ConcatObjectFromWorld() const	{ return m_concatObjectFromWorld; }
 
+			//! Object to world transform to draw the node with, between the last two simulation ticks
+			virtual Math::Matrix4x4 InterpolatedObjectToWorld() const	{ return m_concatObjectToWorld;	  }
+
 			inline Math::Vector3D Forward() const throw();
 			inline Math::Vector3D Up() const throw();
 			inline Math::Vector3D Right() const throw();
@@ -148,6 +155,7 @@ namespace OidFX
 
 			UInt ID () const				{ return m_id;			}
 			ENodeType NodeType() const		{ return m_nodeType;	}
+			SceneNode* Parent() const		{ return m_parent;		}
 
 			//Restore
 			virtual void Restore( );
@@ -212,6 +220,9 @@ namespace OidFX
 			virtual void ConcatenateTransformFromParent ( );
 			void PropagateTransformsToChildren( );
 
+			//! Called by Update when the concatenated transform has been recalculated
+			virtual void OnTransformChanged ( ) { }
+
 
             //=========================================================================
             // Private data
@@ -220,6 +231,7 @@ namespace OidFX
 			SceneNode*	 m_parent;
 			Scene&		 m_scene;
 			List		 m_children;
+			iterator	 m_positionInParent;	//!< Position in the parent's list of children, valid while m_parent is set
 
 			UInt		 m_lodLevel;
 
@@ -231,6 +243,9 @@ namespace OidFX
 			UInt			 m_id;
 
 			ENodeType		 m_nodeType;
+
+			bool			 m_transformDirty;		//!< The local transform, or a parent's, has changed since the last update
+			bool			 m_childTransformDirty;	//!< A node below this one has a dirty transform
 			
 	};
 	//End SceneNode
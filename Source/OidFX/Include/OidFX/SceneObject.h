@@ -60,10 +60,6 @@ namespace OidFX
 						  const Math::Matrix4x4& toWorld = Math::Matrix4x4::IdentityMatrix, 
 						  const Math::Matrix4x4& fromWorld = Math::Matrix4x4::IdentityMatrix );
 
-			virtual void Update( Math::MatrixStack& toWorldStack, 
-								 Math::MatrixStack& fromWorldStack, 
-								 Float timeElapsedInSeconds );
-
 			//Fill visible object list
 			void FillVisibleObjectList ( VisibleObjectList& visibleObjectList, const Camera& camera );
 
@@ -103,6 +99,7 @@ namespace OidFX
             // Protected methods
             //=========================================================================
 			virtual void ConcatenateTransformFromParent ( );
+			virtual void OnTransformChanged ( );
 
 
             //=========================================================================
@@ -145,6 +142,9 @@ namespace OidFX
 	{
 		m_boundingBox = box;
 
+		//The box is positioned from the concatenated transform on the next update
+		MarkTransformDirty();
+
 		m_collisionVolume = m_scene.GetCollisionManager().CreateSphere( Math::Vector3D(m_boundingBox.ExtentX(), 
 																						m_boundingBox.ExtentY(),
 																						m_boundingBox.ExtentZ() ) );
@@ -0,0 +1,207 @@
+//======================================================================================
+//! @file         SpatialHash.h
+//! @brief        Uniform grid spatial hash used as a collision broad phase
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+
+#ifndef OIDFX_SPATIALHASH_H
+#define OIDFX_SPATIALHASH_H
+
+
+#include <vector>
+#include <boost/utility.hpp>
+
+
+//=========================================================================
+// Forward declaration
+//=========================================================================
+namespace Math  { class AxisAlignedBoundingBox; }
+namespace OidFX { class SceneObject;	}
+
+
+//namespace OidFX
+namespace OidFX
+{
+
+
+	//!@class	SpatialHash
+	//!@brief	Uniform grid over world space, hashed into a fixed number of buckets
+	//!
+	//!			Objects are inserted into every cell that their world space bounding box
+	//!			overlaps. A query returns each object sharing a cell with the query box
+	//!			exactly once. Hash collisions between distant cells only add extra candidates,
+	//!			so callers must still do an exact bounds test on the results.
+	//!
+	//!			Objects covering more than MaxCellsPerObject cells are kept in a separate list
+	//!			which is returned by every query, rather than being written to every cell they touch.
+	//!
+	//!			The hash is intended to be cleared and rebuilt every frame. Clear keeps the 
+	//!			memory allocated by the buckets, so rebuilding doesn't allocate once it has warmed up.
+	class SpatialHash : public boost::noncopyable
+	{
+		public:
+
+            //=========================================================================
+            // Constructors
+            //=========================================================================
+			SpatialHash ( Float cellSize, UInt bucketCount );
+
+            //=========================================================================
+            // Public types
+            //=========================================================================
+			typedef std::vector<SceneObject*>	ObjectList;
+
+            //=========================================================================
+            // Public methods
+            //=========================================================================
+			void SetCellSize ( Float cellSize );
+			inline Float CellSize () const				{ return m_cellSize;		}
+
+			void Clear ( );
+			void Insert ( SceneObject* object, const Math::AxisAlignedBoundingBox& box );
+			void Query ( const Math::AxisAlignedBoundingBox& box, ObjectList& results );
+
+			inline UInt ObjectCount () const			{ return static_cast<UInt>(m_objects.size());	}
+
+            //=========================================================================
+            // Public constants
+            //=========================================================================
+			enum { MaxCellsPerObject = 64 };
+
+		private:
+
+            //=========================================================================
+            // Private types
+            //=========================================================================
+			struct Entry
+			{
+				SceneObject*	object;
+				UInt			queryStamp;	//!< Stamp of the last query that returned this object
+			};
+
+			struct CellRange
+			{
+				Int minX, minY, minZ;
+				Int maxX, maxY, maxZ;
+			};
+
+			typedef std::vector<UInt>			Bucket;
+			typedef std::vector<Bucket>			BucketStore;
+			typedef std::vector<Entry>			EntryStore;
+
+            //=========================================================================
+            // Private methods
+            //=========================================================================
+			void GetCellRange ( const Math::AxisAlignedBoundingBox& box, CellRange& range ) const;
+			inline UInt HashCell ( Int x, Int y, Int z ) const;
+			inline static UInt64 CellCount ( const CellRange& range );
+			inline void AddResult ( UInt entryIndex, ObjectList& results );
+
+            //=========================================================================
+            // Private data
+            //=========================================================================
+			Float			m_cellSize;
+			Float			m_inverseCellSize;
+			UInt			m_queryStamp;
+
+			EntryStore		m_objects;
+			BucketStore		m_buckets;
+			Bucket			m_oversized;
+			Bucket			m_usedBuckets;	//!< Indices of non-empty buckets, so Clear doesn't touch every bucket
+	};
+	//End class SpatialHash
+
+
+
+    //=========================================================================
+    //! @function    SpatialHash::HashCell
+    //! @brief       Hash a cell coordinate to a bucket index
+    //!              
+    //! @param       x [in] Cell x coordinate
+    //! @param       y [in] Cell y coordinate
+    //! @param       z [in] Cell z coordinate
+    //!              
+    //! @return      Index of the bucket holding the cell
+    //=========================================================================
+	UInt SpatialHash::HashCell ( Int x, Int y, Int z ) const
+	{
+		UInt hash = (static_cast<UInt>(x) * 73856093U) 
+				  ^ (static_cast<UInt>(y) * 19349663U) 
+				  ^ (static_cast<UInt>(z) * 83492791U);
+
+		return hash % static_cast<UInt>(m_buckets.size());
+	}
+	//End SpatialHash::HashCell
+
+
+
+    //=========================================================================
+    //! @function    SpatialHash::CellCount
+    //! @brief       Return the number of cells in an inclusive cell range
+    //!              
+    //!				 Very large boxes can cover more than 2^32 cells, so the count is 64 bit
+    //!
+    //! @param       range [in] Range of cells
+    //!              
+    //! @return      Number of cells in the range
+    //=========================================================================
+	UInt64 SpatialHash::CellCount ( const SpatialHash::CellRange& range )
+	{
+		return static_cast<UInt64>(range.maxX - range.minX + 1)
+			 * static_cast<UInt64>(range.maxY - range.minY + 1)
+			 * static_cast<UInt64>(range.maxZ - range.minZ + 1);
+	}
+	//End SpatialHash::CellCount
+
+
+
+    //=========================================================================
+    //! @function    SpatialHash::AddResult
+    //! @brief       Add an object to the results of the current query, 
+    //!				 unless the query has already returned it
+    //!              
+    //! @param       entryIndex [in]	Index of the object entry
+    //! @param       results	[out]	Query results
+    //=========================================================================
+	void SpatialHash::AddResult ( UInt entryIndex, SpatialHash::ObjectList& results )
+	{
+		Entry& entry = m_objects[entryIndex];
+
+		if ( entry.queryStamp != m_queryStamp )
+		{
+			entry.queryStamp = m_queryStamp;
+			results.push_back( entry.object );
+		}
+	}
+	//End SpatialHash::AddResult
+
+
+}
+//end namespace OidFX
+
+
+#endif
+//#ifndef OIDFX_SPATIALHASH_H
@@ -36,6 +36,7 @@
 
 #include "OidFX/Billboard.h"
 #include "OidFX/EntityNode.h"
+#include "OidFX/EntityHandle.h"
 
 
 
@@ -78,9 +79,7 @@ namespace OidFX
             //=========================================================================
             // Public methods
             //=========================================================================	
-			void Update( Math::MatrixStack& toWorldStack, 
-						 Math::MatrixStack& fromWorldStack, 
-						 Float timeElapsedInSeconds );
+			void OnThink ( Float timeElapsed );
 
 			//Get the closest target
 			void AcquireTarget ();
@@ -119,7 +118,7 @@ namespace OidFX
             //=========================================================================
             // Private data
             //=========================================================================
-			EntityNode*			  m_currentTarget;
+			EntityHandle		  m_currentTarget;
 			TargetComputerFlagSet m_targetComputerFlags;
 
 			Float				  m_maxRange;
@@ -182,13 +181,14 @@ namespace OidFX
     //=========================================================================
     //! @function    TargetingComputer::GetCurrentTarget
     //! @brief       Return a pointer to the entity that this targeting computer 
-    //!              is currently targeting, this will be null if there is no target
+    //!              is currently targeting, this will be null if there is no target,
+	//!				 or the target has despawned since it was acquired
     //!              
     //! @return      The entity that is being targeted, or null if no entity is being targeted
     //=========================================================================
 	EntityNode* TargetingComputer::GetCurrentTarget ()
 	{
-		return m_currentTarget;
+		return m_currentTarget.Get();
 	}
 	//End TargetingComputer::GetCurrentTarget
 
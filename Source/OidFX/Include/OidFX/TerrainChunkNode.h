@@ -32,19 +32,19 @@
 
 #include <vector>
 #include <boost/shared_ptr.hpp>
-#include "Math/Triangle.h"
 #include "Renderer/VertexData.h"
 #include "Renderer/IndexBuffer.h"
 #include "Renderer/Texture.h"
 #include "OidFX/SceneObject.h"
 #include "OidFX/TerrainNode.h"
+#include "OidFX/HeightfieldCollision.h"
 #include "OidFX/CollisionManager.h"
 
 
 //=========================================================================
 // Forward declaration
 //=========================================================================
-namespace Math		{ class Vector3D; class Triangle; }
+namespace Math		{ class Vector3D; }
 namespace Renderer	{ class VertexData; }
 namespace OidFX		{ class Scene;		}
 
@@ -55,6 +55,13 @@ namespace OidFX
 
 	//!@class	TerrainChunkNode
 	//!@brief	Scene graph node representing a single chunk of terrain
+	//!
+	//!			Construction only builds the chunk mesh from the heightmap, and doesn't touch
+	//!			the renderer or the collision world, so chunks can be built on a loader thread.
+	//!			CreateResources must be called on the main thread before the chunk is added to the scene
+	//!
+	//!			Collisions and ray queries go straight to the terrain's heightfield, limited
+	//!			to the part of the heightmap that this chunk covers
 	class TerrainChunkNode : public SceneObject
 	{
 		public:
@@ -68,14 +75,14 @@ namespace OidFX
 								const Math::Matrix4x4& fromWorld,
 								TerrainNode& terrainNode,
 								UInt chunkRow,
-								UInt chunkColumn,
-								Renderer::HIndexBuffer indexBuffer,
-								Renderer::HEffect effect );
+								UInt chunkColumn );
 
 
             //=========================================================================
             // Public methods
             //=========================================================================
+			void CreateResources ( );
+
 			void Update( Math::MatrixStack& toWorldStack, 
 						 Math::MatrixStack& fromWorldStack, 
 						 Float timeElapsedInSeconds );			
@@ -87,6 +94,9 @@ namespace OidFX
 			//Fill visible object list
 			void FillVisibleObjectList ( VisibleObjectList& visibleObjectList, const Camera& camera );
 
+			//Geomorphing
+			void SetLOD ( UInt lodLevel, UInt stitchMask, Float morphFactor );
+
 
 			//Collisions
 			bool CanCollideWith ( EntityNode* entity );
@@ -111,6 +121,7 @@ namespace OidFX
             // Static methods
             //=========================================================================
 			static UInt	NodesRenderedThisFrame () 			{ return ms_nodesRendered;	}
+			static void ResetNodesRendered ()				{ ms_nodesRendered = 0;		}
 
 		private:
 
@@ -126,13 +137,11 @@ namespace OidFX
 				Math::Vector3D		texCoord1;
 			};
 
-			struct CollisionMesh
+			struct ChunkMesh
 			{
 				typedef Core::Vector<TerrainMeshVertex>::Type	VertexStore;
-				typedef Core::Vector<Math::Triangle>::Type 		TriangleStore;
 				
 				VertexStore   vertices;
-				TriangleStore triangles;
 			};
 
 			//Vertex type used in the index buffer
@@ -149,7 +158,6 @@ namespace OidFX
             //=========================================================================
             // Private methods
             //=========================================================================
-			void BuildCollisionMesh ( );
 			void BuildVertexList  ( );
 			void SmoothTerrainHeights ( );
 			void CalculateNormals ( );
@@ -157,6 +165,7 @@ namespace OidFX
 
 			void CreateChunkVertexBuffer();
 			void FillChunkVertexBuffer();
+			Float MorphedHeight ( UInt row, UInt col ) const;
 			void InitialiseAutogenAlphaTextures();
 
 
@@ -171,7 +180,16 @@ namespace OidFX
 			Renderer::HIndexBuffer					m_indexBuffer;
 			Renderer::HEffect						m_effect;
 
-			CollisionMesh							m_collisionMesh;
+			ChunkMesh								m_mesh;
+			HeightfieldCollision::Region			m_heightfieldRegion; //!< Heightmap samples covered by this chunk
+
+			UInt									m_stitchMask;		 //!< Edges stitched to coarser neighbours, @see TerrainNode::EStitchSide
+			Float									m_morphFactor;		 //!< Amount vertices are morphed towards the next LOD level
+			UInt									m_filledLODLevel;	 //!< LOD level the vertex buffer was last filled for
+			Float									m_filledMorphFactor; //!< Morph factor the vertex buffer was last filled with
+			bool									m_dynamicVertices;	 //!< Vertex buffer is dynamic, so it can be refilled when morphing
+			UInt									m_queuedLODLevel;	 //!< LOD level the chunk was last queued for rendering with
+			UInt									m_queuedStitchMask;	 //!< Stitch mask the chunk was last queued for rendering with
 
 			static UInt								ms_nodesRendered;
 			
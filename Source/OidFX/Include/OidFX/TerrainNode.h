@@ -30,7 +30,9 @@
 
 
 #include <vector>
+#include "Core/HeightMap.h"
 #include "OidFX/SceneObject.h"
+#include "OidFX/HeightfieldCollision.h"
 #include "Renderer/Effect.h"
 #include "Renderer/IndexBuffer.h"
 
@@ -38,7 +40,8 @@
 //=========================================================================
 // Forward declaration
 //=========================================================================
-namespace OidFX		{ class Scene;		}
+namespace OidFX		{ class Scene; class TerrainChunkNode; class TerrainChunkLoadJob; class QuadtreeNode;	}
+namespace Core		{ class WorkerPool;	}
 namespace Math		{ class Vector3D;	}
 namespace Renderer	{ class EffectManager;	}
 
@@ -49,6 +52,18 @@ namespace OidFX
 
 	//!@class	TerrainNode
 	//!@brief	Scene graph node representing a whole terrain
+	//!
+	//!			When geomorphing is enabled (ter_geomorph), the terrain picks the LOD level of
+	//!			every chunk itself each frame, and makes sure that neighbouring chunks are never
+	//!			more than one level apart. A chunk next to a coarser neighbour draws with an index
+	//!			range that stitches its edge to the neighbour's vertices, so there are no cracks.
+	//!			Chunks also morph their vertices towards the next LOD level as they approach the switch
+	//!			distance, so that LOD changes don't pop.
+	//!
+	//!			The heightmap is loaded through Core::HeightMap, which supports 8 bit, 16 bit and float
+	//!			RAW files. When paging is
+	//!			enabled (ter_paged), chunks are only built within ter_pageradius of the camera.
+	//!			The chunk meshes are built on a loader thread, and chunks that move out of range are evicted.
 	class TerrainNode : public SceneObject
 	{
 		public:
@@ -65,7 +80,8 @@ namespace OidFX
 						  const Char* heightMapFileName, 
 						  const Char* terrainEffectName,
 						  const Math::Matrix4x4& toWorld = Math::Matrix4x4::IdentityMatrix, 
-						  const Math::Matrix4x4& fromWorld = Math::Matrix4x4::IdentityMatrix
+						  const Math::Matrix4x4& fromWorld = Math::Matrix4x4::IdentityMatrix,
+						  Core::HeightMap::EFormat heightMapFormat = Core::HeightMap::FORMAT_AUTO
 						  );
 
 
@@ -78,14 +94,17 @@ namespace OidFX
 				UInt  indexCount;
 			};
 
-			struct Triangle
+			//! Chunk edges that border a neighbour of the next coarser LOD level.
+			//! Used to select the stitched index range for a chunk
+			enum EStitchSide
 			{
-				UInt v0;
-				UInt v1;
-				UInt v2;
-			};
+				STITCH_NORTH = 1,	//!< Row 0 edge
+				STITCH_SOUTH = 2,	//!< Last row edge
+				STITCH_WEST  = 4,	//!< Column 0 edge
+				STITCH_EAST  = 8,	//!< Last column edge
 
-			typedef Core::Vector<Triangle>::Type	TriangleStore;
+				STITCH_COMBINATIONS = 16
+			};
             
             //=========================================================================
             // Public methods
@@ -94,18 +113,32 @@ namespace OidFX
 
 			void Restore();
 
+			//Update
+			void Update ( Math::MatrixStack& toWorldStack, 
+						  Math::MatrixStack& fromWorldStack, 
+						  Float timeElapsedInSeconds );
+
 			//Fill visible object list
 			void FillVisibleObjectList ( VisibleObjectList& visibleObjectList, const Camera& camera );
 
 			inline Float					HeightMapValueAt ( UInt row, UInt col ) const;
 	
 			inline const LODInfo& GetLODInfo ( UInt lod ) const throw();
+			inline const LODInfo& GetLODInfo ( UInt lod, UInt stitchMask ) const throw();
+			inline UInt LODCount () const;
+
+			bool  GeomorphEnabled () const		{ return m_geomorphEnabled;		}
+			bool  Paged () const				{ return m_paged;				}
+
+			Renderer::HIndexBuffer	GetIndexBuffer () const		{ return m_indexBuffer;		}
+			Renderer::HEffect		GetEffect () const			{ return m_effect;			}
 
 			UInt  HeightmapSize () const		{ return m_heightmapSize;		}
 			UInt  ChunkSize () const			{ return m_chunkSize;			}
 			Float TerrainSize () const			{ return m_terrainSize;			}
 			Float TerrainMaxY () const			{ return m_terrainMaxY;			}
-			const TriangleStore& GetTriangles()	const { return m_triangles;		}
+
+			const HeightfieldCollision& Heightfield () const	{ return m_heightfield;		}
 
 
 			virtual void CheckCollisions ( EntityNode* entity, 
@@ -113,34 +146,63 @@ namespace OidFX
 										   const NodeCollisionFlags& collisionFlags,
 										   CollisionManager& collisionManager );		
 
+			virtual void QueryScene ( const Math::ParametricLine3D& ray, 
+									  SceneQueryResult& result );
+
 		private:
 
             //=========================================================================
             // Private types
             //=========================================================================
-			typedef std::vector<Float>				HeightStore;
+			//! Paging state of a chunk
+			enum EChunkState
+			{
+				CHUNK_UNLOADED,
+				CHUNK_LOADING,		//!< Mesh is being built on the loader thread
+				CHUNK_LOADED
+			};
+
+			typedef std::vector<EChunkState>		ChunkStateStore;
+			typedef std::vector< boost::shared_ptr<TerrainChunkLoadJob> > LoadJobStore;
+			typedef std::vector<UShort>				IndexStore;
+			typedef std::vector<TerrainChunkNode*>	ChunkStore;
+			typedef std::vector<UInt>				ChunkLODStore;
+			typedef std::vector<Float>				ChunkMorphStore;
 			
 
             //=========================================================================
             // Private methods
             //=========================================================================
-			void LoadHeightMap ( const Char* fileName );
+			void LoadHeightMap ( const Char* fileName, Core::HeightMap::EFormat format );
 			void PopulateTerrainChunks();
+			void AddChunk ( boost::shared_ptr<TerrainChunkNode> node, UInt row, UInt col );
+			void EvictChunk ( UInt row, UInt col );
+			void UpdatePagedChunks ( const Math::Vector3D& cameraPosition );
+			void GetChunkBounds ( UInt row, UInt col, Math::Vector3D& minCorner, Math::Vector3D& maxCorner ) const;
+			Float ChunkDistanceXZ ( UInt row, UInt col, const Math::Vector3D& position ) const;
 			void CreateChunkIndexBuffer ( );
 			void PopulateChunkIndexBuffer ( );
 
 			void FillIndexBufferLODLevel ( UInt lodLevel, 
-										   UShort* buffer,
-										   UInt chunkVertsX,
-										   UInt chunkVertsZ,
-										   UInt xSkip,
-										   UInt ySkip,
-										   UInt bufferPitch ) throw();
+										   UInt stitchMask,
+										   UInt vertexSkip,
+										   IndexStore& indices );
+
+			inline void StitchVertex ( UInt& row, UInt& col, UInt vertexSkip, UInt stitchMask ) const throw();
+			void AddStitchedTriangle ( IndexStore& indices, 
+									   UInt row0, UInt col0,
+									   UInt row1, UInt col1,
+									   UInt row2, UInt col2,
+									   UInt vertexSkip,
+									   UInt stitchMask ) const;
+
+			void UpdateChunkLODs ( const Camera& camera );
 
             //=========================================================================
             // Private data
             //=========================================================================
-			HeightStore		m_heights;			//!< Heights of the terrain
+			Core::HeightMap	m_heightMap;		//!< Heights of the terrain
+			HeightfieldCollision m_heightfield;	//!< Collision queries against m_heightMap
 			UInt			m_heightmapSize;	//!< Width/Height of the heightmap in pixels
 			UInt			m_chunkSize;		//!< Width/Height of a single terrain chunk in pixels
 			Float			m_terrainSize;		//!< Size of the terrain in the x and z dimensions
@@ -149,9 +211,24 @@ namespace OidFX
 			Renderer::HIndexBuffer	m_indexBuffer;	//!< Shared index buffer for the terrain
 			Renderer::HEffect		m_effect;		//!< Shared effect for the terrain
 
-			std::vector<LODInfo>		m_lodStartIndices; //!< Offset into index buffer for each detail level
+			std::vector<LODInfo>		m_lodStartIndices; //!< Offset into index buffer for each detail level and stitch mask
+			IndexStore					m_indices;		   //!< Copy of the index buffer contents, used to refill it on restore
+
+			ChunkStore		m_chunks;			//!< Terrain chunks, in row major order
+			ChunkLODStore	m_chunkLODs;		//!< LOD level picked for each chunk this frame
+			ChunkLODStore	m_chunkBandLODs;	//!< LOD level each chunk would have from distance alone
+			ChunkMorphStore	m_chunkMorphFactors;//!< Morph factor towards the next level, for the band LOD level
+			bool			m_geomorphEnabled;	//!< Whether chunk LOD levels are being picked by UpdateChunkLODs
+
+			boost::shared_ptr<QuadtreeNode>	m_quadtree;	//!< Quadtree the chunks are sorted into
+			bool			m_paged;			//!< Whether chunks are built on demand around the camera
+			ChunkStateStore	m_chunkStates;		//!< Paging state of each chunk, in row major order
+			LoadJobStore	m_loadJobs;			//!< Chunks being built on the loader thread
+
+			//The loader pool is declared last, so that it is destroyed first, and its thread
+			//has stopped before the jobs and the heightmap it reads from are destroyed
+			boost::shared_ptr<Core::WorkerPool> m_loaderPool;
 
-			TriangleStore	m_triangles;	//!< Triangle indices for the most detailed LOD
 
 	};
 	//End class TerrainNode
@@ -172,9 +249,8 @@ namespace OidFX
 	{
 		debug_assert ( row < m_heightmapSize, "Invalid row index" );
 		debug_assert ( col < m_heightmapSize, "Invalid column index" );
-		debug_assert ( col + (row * m_heightmapSize) < m_heights.size(), "Invalid index!" );
 
-		return m_heights [ col + (row * m_heightmapSize) ];
+		return m_heightMap.HeightAt ( row, col );
 	}
 	//End TerrainNode::HeightMapValueAt
 
@@ -209,10 +285,98 @@ namespace OidFX
 			lod = m_lodStartIndices.size() - 1;
 		}
 
-		return m_lodStartIndices[lod];
+		return m_lodStartIndices[lod * STITCH_COMBINATIONS];
 	}
 	//End  TerrainNode::GetLODInfo
 
+
+
+    //=========================================================================
+    //! @function    TerrainNode::GetLODInfo
+    //! @brief       Get information about the stitched index range for an LOD level
+    //!              
+    //! @param       lod		[in] Level of detail to get information for 
+    //! @param       stitchMask	[in] Combination of EStitchSide flags, for the edges
+    //!								 that border a coarser chunk
+    //!              
+    //=========================================================================
+	const TerrainNode::LODInfo& TerrainNode::GetLODInfo ( UInt lod, UInt stitchMask ) const
+	{
+		debug_assert ( !m_lodStartIndices.empty(), "LOD levels are empty!" );
+		debug_assert ( stitchMask < STITCH_COMBINATIONS, "Invalid stitch mask!" );
+
+		static Core::ConsoleBool dbg_terrainlodenable ( "dbg_terrainlodenable", true );
+
+		if ( !dbg_terrainlodenable )
+		{
+			lod = 0;
+			stitchMask = 0;
+		}
+
+		if ( lod >= LODCount() )
+		{
+			lod = LODCount() - 1;
+		}
+
+		return m_lodStartIndices[(lod * STITCH_COMBINATIONS) + stitchMask];
+	}
+	//End  TerrainNode::GetLODInfo
+
+
+
+    //=========================================================================
+    //! @function    TerrainNode::LODCount
+    //! @brief       Return the number of LOD levels generated for the terrain chunks
+    //!              
+    //=========================================================================
+	UInt TerrainNode::LODCount () const
+	{
+		return static_cast<UInt>(m_lodStartIndices.size() / STITCH_COMBINATIONS);
+	}
+	//End TerrainNode::LODCount
+
+
+
+    //=========================================================================
+    //! @function    TerrainNode::StitchVertex
+    //! @brief       Move a chunk vertex onto the grid of the next coarser LOD level,
+    //!				 if it lies on an edge which borders a coarser chunk
+    //!              
+	//!				 Vertices that the coarser neighbour doesn't have are moved back along
+	//!				 the edge onto the previous vertex that it does have. This collapses the edge
+	//!				 triangles onto the neighbour's edge, without changing their winding
+	//!
+    //! @param       row		[in/out] Row of the vertex within the chunk
+    //! @param       col		[in/out] Column of the vertex within the chunk
+    //! @param       vertexSkip [in]	 Distance between vertices at the current LOD level
+    //! @param       stitchMask [in]	 Combination of EStitchSide flags
+    //!              
+    //=========================================================================
+	void TerrainNode::StitchVertex ( UInt& row, UInt& col, UInt vertexSkip, UInt stitchMask ) const
+	{
+		const UInt last = m_chunkSize - 1;
+		const UInt coarseSkip = vertexSkip * 2;
+
+		if ( (row == 0) && (stitchMask & STITCH_NORTH) && (col % coarseSkip) )
+		{
+			col -= vertexSkip;
+		}
+		else if ( (row == last) && (stitchMask & STITCH_SOUTH) && (col % coarseSkip) )
+		{
+			col -= vertexSkip;
+		}
+
+		if ( (col == 0) && (stitchMask & STITCH_WEST) && (row % coarseSkip) )
+		{
+			row -= vertexSkip;
+		}
+		else if ( (col == last) && (stitchMask & STITCH_EAST) && (row % coarseSkip) )
+		{
+			row -= vertexSkip;
+		}
+	}
+	//End TerrainNode::StitchVertex
+
 }
 //end namespace OidFX
 
@@ -43,6 +43,7 @@ using namespace OidFX;
 //! @brief       
 //=========================================================================
 VisibleObjectList::VisibleObjectList ( )
+: m_splitLevel(0)
 {
 }
 //End VisibleObjectList::VisibleObjectList
@@ -66,4 +67,53 @@ void VisibleObjectList::QueueAllForRendering ( Renderer::RenderQueue& renderQueu
 		(*current)->QueueForRendering( renderQueue );
 	}
 }
-//End VisibleObjectList::QueueAllForRendering
\ No newline at end of file
+//End VisibleObjectList::QueueAllForRendering
+
+
+//=========================================================================
+//! @function    VisibleObjectList::MergeDeferredSubtrees
+//! @brief       Insert the results of culling each deferred subtree into the list
+//!              
+//!				 Each subtree's objects are inserted at the point the subtree was
+//!				 deferred, so the final list is in the same order as a serial traversal
+//!
+//! @param       subtreeLists [in] One list per deferred subtree, in the order that
+//!								   the subtrees were deferred
+//=========================================================================
+void VisibleObjectList::MergeDeferredSubtrees ( const std::vector<VisibleObjectList*>& subtreeLists )
+{
+	debug_assert ( subtreeLists.size() == m_deferred.size(), "One list is required for each deferred subtree" );
+
+	if ( m_deferred.empty() )
+	{
+		return;
+	}
+
+	size_t totalSize = m_list.size();
+
+	for ( UInt i=0; i < subtreeLists.size(); ++i )
+	{
+		totalSize += subtreeLists[i]->Size();
+	}
+
+	List merged;
+	merged.reserve ( totalSize );
+
+	iterator source = m_list.begin();
+
+	for ( UInt i=0; i < m_deferred.size(); ++i )
+	{
+		iterator deferredPosition = m_list.begin() + m_deferred[i].position;
+
+		merged.insert ( merged.end(), source, deferredPosition );
+		merged.insert ( merged.end(), subtreeLists[i]->Begin(), subtreeLists[i]->End() );
+
+		source = deferredPosition;
+	}
+
+	merged.insert ( merged.end(), source, m_list.end() );
+
+	m_list.swap ( merged );
+	m_deferred.clear();
+}
+//End VisibleObjectList::MergeDeferredSubtrees
\ No newline at end of file
@@ -30,15 +30,14 @@
 #define OIDFX_VISIBLEOBJECTLIST_H
 
 
-#include <list>
-#include <boost/pool/pool_alloc.hpp>
+#include <vector>
 
 
 //=========================================================================
 // Forward declaration
 //=========================================================================
 namespace Renderer { class RenderQueue; }
-namespace OidFX	   { class SceneNode;	}
+namespace OidFX	   { class SceneNode; class QuadtreeNode;	}
 
 
 //namespace OidFX
@@ -51,6 +50,11 @@ namespace OidFX
 	//!
 	//!			When the scene is rendered, all visible objects add themselves               
 	//!			to a VisibleObjectList, in order to be queued for rendering
+	//!
+	//!			For parallel culling, quadtree nodes at the subtree split level
+	//!			don't recurse into their children. They record themselves as deferred
+	//!			subtrees instead, which are culled into separate lists on worker threads, 
+	//!			and merged back in by MergeDeferredSubtrees at the position they were deferred.
 	class VisibleObjectList
 	{
 		public:
@@ -63,7 +67,7 @@ namespace OidFX
             //=========================================================================
             // Public types
             //=========================================================================
-			typedef std::list<SceneNode*, boost::fast_pool_allocator<SceneNode*> > List;
+			typedef std::vector<SceneNode*>		List;
 			typedef List::iterator				iterator;
 			typedef List::const_iterator		const_iterator;
 
@@ -73,9 +77,18 @@ namespace OidFX
 			void QueueAllForRendering ( Renderer::RenderQueue& queue );
 			
 			inline void AddObject ( SceneNode& node )		{ m_list.push_back(&node);		}
-			inline void Clear()								{ m_list.clear();				}
+			inline void Clear();
 			inline size_t Size() const						{ return m_list.size();			}
 
+			//Parallel culling
+			inline void	SetSubtreeSplitLevel ( UInt level )	{ m_splitLevel = level;			}
+			inline UInt	SubtreeSplitLevel ( ) const			{ return m_splitLevel;			}
+			inline void DeferSubtree ( QuadtreeNode& node );
+			inline size_t DeferredSubtreeCount() const		{ return m_deferred.size();		}
+			inline QuadtreeNode& DeferredSubtree ( UInt index ) { return *m_deferred[index].node; }
+
+			void MergeDeferredSubtrees ( const std::vector<VisibleObjectList*>& subtreeLists );
+
 			inline iterator			Begin()					{ return m_list.begin();		}
 			inline iterator			End()					{ return m_list.end();			}
 			inline const_iterator	Begin()	const			{ return m_list.begin();		}
@@ -83,15 +96,57 @@ namespace OidFX
 
 		private:
 
+            //=========================================================================
+            // Private types
+            //=========================================================================
+			struct DeferredSubtree
+			{
+				QuadtreeNode*	node;
+				size_t			position;	//!< Size of m_list when the subtree was deferred
+			};
+
             //=========================================================================
             // Private data
             //=========================================================================
-			List m_list;
+			List							m_list;
+			std::vector<DeferredSubtree>	m_deferred;
+			UInt							m_splitLevel;	//!< Quadtree level at which subtrees are deferred, 0 to disable
 
 	};
 	//End class VisibleObjectList
 
 
+
+	//=========================================================================
+	//! @function    VisibleObjectList::Clear
+	//! @brief       Empty the list
+	//=========================================================================
+	void VisibleObjectList::Clear ( )
+	{
+		m_list.clear();
+		m_deferred.clear();
+	}
+	//End VisibleObjectList::Clear
+
+
+
+	//=========================================================================
+	//! @function    VisibleObjectList::DeferSubtree
+	//! @brief       Record a quadtree node whose children should be culled later
+	//!              
+	//! @param       node [in] Quadtree node at the root of the subtree
+	//=========================================================================
+	void VisibleObjectList::DeferSubtree ( QuadtreeNode& node )
+	{
+		DeferredSubtree subtree;
+		subtree.node = &node;
+		subtree.position = m_list.size();
+
+		m_deferred.push_back ( subtree );
+	}
+	//End VisibleObjectList::DeferSubtree
+
+
 };
 //end namespace OidFX
 
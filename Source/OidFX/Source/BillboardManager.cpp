@@ -29,11 +29,14 @@
 
 
 #include "Core/Core.h"
+#include "Math/Math.h"
 #include "Math/Matrix4x4.h"
 #include "Renderer/Renderer.h"
 #include "Renderer/StateManager.h"
+#include "OidFX/Camera.h"
 #include "OidFX/Billboard.h"
 #include "OidFX/BillboardManager.h"
+#include <algorithm>
 
 
 
@@ -41,13 +44,29 @@ using namespace OidFX;
 
 
 
+//=========================================================================
+// Constants
+//=========================================================================
+namespace
+{
+	const UInt g_verticesPerBillboard = 4;
+	const UInt g_indicesPerBillboard  = 6;
+
+	//The quad index buffer uses 16 bit indices
+	const UInt g_maxBillboardsPerDraw = 0x10000 / g_verticesPerBillboard;
+}
+
+
+
 //=========================================================================
 //! @function    BillboardManager::BillboardManager
 //! @brief       BillboardManager constructor
 //!              
 //! @param       renderer		[in]
 //! @param       stateManager	[in]
-//! @param       maxBillboards	[in]
+//! @param       maxBillboards	[in] Number of billboards the vertex buffer can hold.
+//!									 More than this can be drawn in a frame, but they
+//!									 will be drawn in several batches
 //!              
 //=========================================================================
 BillboardManager::BillboardManager ( Renderer::IRenderer& renderer,
@@ -55,8 +74,13 @@ BillboardManager::BillboardManager ( Renderer::IRenderer& renderer,
 									 UInt maxBillboards )
 									 : m_maxBillboards(maxBillboards),
 									   m_renderer(renderer),
-									   m_stateManager(stateManager)
+									   m_stateManager(stateManager),
+									   m_ringPosition(0)
 {
+	if ( (m_maxBillboards == 0) || (m_maxBillboards > g_maxBillboardsPerDraw) )
+	{
+		throw Core::RuntimeError ( "Invalid billboard buffer size!", 0, __FILE__, __FUNCTION__, __LINE__ );
+	}
 
 	//Create the vertex declaration
 	Renderer::VertexDeclarationDescriptor desc;
@@ -68,68 +92,166 @@ BillboardManager::BillboardManager ( Renderer::IRenderer& renderer,
 
 
 	Renderer::HVertexBuffer stream0 = renderer.CreateVertexBuffer ( sizeof(Vertex), 
-																	maxBillboards * 6, 
+																	maxBillboards * g_verticesPerBillboard, 
 																	Renderer::USAGE_DYNAMICWRITEONLY );
 
+	if ( !stream0 )
+	{
+		throw Core::RuntimeError ( "Couldn't create billboard vertex buffer!", 0, __FILE__, __FUNCTION__, __LINE__ );
+	}
+
 	m_streamBinding.SetStream( stream0, 0 );
 
-	//Reserve some space in the render queue and render list
-	//renderQueue.reserve( maxBillboards );
-	//renderList.reserve( maxBillboards );
+	CreateQuadIndexBuffer();
 }
 //End BillboardManager::BillboardManager
 
 
 
+//=========================================================================
+//! @function    BillboardManager::CreateQuadIndexBuffer
+//! @brief       Create the index buffer shared by all billboards
+//!              
+//!				 The buffer holds two triangles for each quad in the vertex buffer,
+//!				 relative to the start of the buffer. Batches that start part
+//!				 way through the ring buffer are drawn with a base vertex index,
+//!				 so the same indices can always be used
+//!              
+//=========================================================================
+void BillboardManager::CreateQuadIndexBuffer ( )
+{
+	m_indexBuffer = m_renderer.CreateIndexBuffer ( Renderer::INDEX_16BIT, 
+												   m_maxBillboards * g_indicesPerBillboard,
+												   Renderer::USAGE_STATICWRITEONLY );
+
+	if ( !m_indexBuffer )
+	{
+		throw Core::RuntimeError ( "Couldn't create billboard index buffer!", 0, __FILE__, __FUNCTION__, __LINE__ );
+	}
+
+	Renderer::ScopedIndexBufferLock lock = m_indexBuffer->LockAll(Renderer::LOCK_NORMAL);
+
+	if ( !lock )
+	{
+		throw Core::RuntimeError ( "Couldn't lock billboard index buffer!", 0, __FILE__, __FUNCTION__, __LINE__ );
+	}
+
+	UShort* indexPtr = reinterpret_cast<UShort*>(lock.GetLockPointer());
+
+	//Vertices are stored top left, bottom left, top right, bottom right
+	for ( UInt i=0; i < m_maxBillboards; ++i )
+	{
+		UShort base = static_cast<UShort>(i * g_verticesPerBillboard);
+
+		*indexPtr++ = base;
+		*indexPtr++ = base + 1;
+		*indexPtr++ = base + 2;
+		*indexPtr++ = base + 2;
+		*indexPtr++ = base + 1;
+		*indexPtr++ = base + 3;
+	}
+}
+//End BillboardManager::CreateQuadIndexBuffer
+
+
+
+//=========================================================================
+//! @function    BillboardManager::AddToBillboardList
+//! @brief       Add a billboard to the billboard list
+//!              
+//!				 A billboard must add itself to the billboard list, in order to be rendered.
+//!				 The billboard's current state is copied, so later changes to it
+//!				 won't be seen until it is added again next frame
+//!
+//! @param       billboard [in]
+//!              
+//=========================================================================
+void BillboardManager::AddToBillboardList ( Billboard& billboard )
+{
+	//Find the effect. Billboards with the same effect tend to be added together,
+	//so search from the most recently added effect
+	Renderer::HEffect effect = billboard.GetEffect();
+	UInt effectIndex = static_cast<UInt>(m_filling.effects.size());
+
+	while ( effectIndex > 0 )
+	{
+		if ( m_filling.effects[effectIndex-1].Value() == effect.Value() )
+		{
+			break;
+		}
+
+		--effectIndex;
+	}
+
+	if ( effectIndex == 0 )
+	{
+		m_filling.effects.push_back ( effect );
+		effectIndex = static_cast<UInt>(m_filling.effects.size());
+	}
+
+	const Math::Vector3D& position = billboard.GetPosition();
+
+	m_filling.billboards.positionX.push_back ( position.X() );
+	m_filling.billboards.positionY.push_back ( position.Y() );
+	m_filling.billboards.positionZ.push_back ( position.Z() );
+	m_filling.billboards.scaledCos.push_back ( billboard.GetScale() * Math::Cos(billboard.GetRotation()) );
+	m_filling.billboards.scaledSin.push_back ( billboard.GetScale() * Math::Sin(billboard.GetRotation()) );
+	m_filling.billboards.colour.push_back ( Renderer::Colour4f( 1.0f, 1.0f, 1.0f, billboard.GetOpacity()) );
+	m_filling.billboards.effect.push_back ( effectIndex - 1 );
+	m_filling.billboards.depth.push_back ( 0.0f );
+}
+//End BillboardManager::AddToBillboardList
+
+
+
 //=========================================================================
 //! @function    BillboardManager::CompileRenderQueue
-//! @brief       Compiles the render list into a list of startindices
-//!              and vertex counts for each effect (the render queue).
+//! @brief       Groups the billboard list by effect, and compiles a list 
+//!				 of ranges of the grouped list for each effect (the render queue).
+//!
+//!				 Billboards are grouped with a counting sort, so the
+//!				 order that billboards with the same effect were added in is kept
 //!
 //=========================================================================
 void BillboardManager::CompileRenderQueue ( )
 {
-	
-	Renderer::HEffect currentEffect;
-	UInt			  startIndex = 0;
-	UInt			  count = 1;
+	m_filling.renderQueue.clear();
 
-	if ( m_billboardList.size() > 0 )
+	const UInt billboardCount = static_cast<UInt>(m_filling.billboards.effect.size());
+	const UInt effectCount = static_cast<UInt>(m_filling.effects.size());
+
+	if ( billboardCount == 0 )
 	{
-		currentEffect = m_billboardList.begin()->first;
+		return;
 	}
-	else
+
+	//Count the billboards using each effect
+	m_effectStart.assign ( effectCount + 1, 0 );
+
+	for ( UInt i=0; i < billboardCount; ++i )
 	{
-		return;
+		++m_effectStart[ m_filling.billboards.effect[i] + 1 ];
 	}
 
-	for ( BillboardList::const_iterator itr = m_billboardList.begin();
-		  itr != m_billboardList.end();
-		  ++itr )
+	//Turn the counts into the start of each effect's range
+	for ( UInt i=0; i < effectCount; ++i )
 	{
+		RenderQueueEntry entry;
+		entry.effect = m_filling.effects[i];
+		entry.first = m_effectStart[i];
+		entry.count = m_effectStart[i+1];
 
-		BillboardList::const_iterator temp = itr;
-		++temp;
+		m_filling.renderQueue.push_back ( entry );
 
-		if ( (itr->first != currentEffect) 
-			|| (temp == m_billboardList.end()) )
-		{
-			//Add the list of billboards with the previous effect
-			//to the render queue
-			RenderQueueEntry entry;
-			entry.effect = currentEffect;
-			entry.startIndex = startIndex;
-			entry.vertexCount = count * 6;
-
-			m_renderQueue.push_back( entry );
-
-			//Reset the variables for the next queue entry
-			startIndex += count * 6;
-			currentEffect = itr->first;
-			count = 0;
-		}
+		m_effectStart[i+1] += m_effectStart[i];
+	}
+
+	//Scatter the billboard indices into their ranges
+	m_filling.order.resize ( billboardCount );
 
-		++count;
+	for ( UInt i=0; i < billboardCount; ++i )
+	{
+		m_filling.order[ m_effectStart[ m_filling.billboards.effect[i] ]++ ] = i;
 	}
 
 }
@@ -137,119 +259,238 @@ void BillboardManager::CompileRenderQueue ( )
 
 
 
+//=========================================================================
+//! @function    BillboardManager::SortBatchesByDepth
+//! @brief       Sort the billboards in each batch back to front
+//!              
+//!				 Batches aren't split up, so billboards with different effects
+//!				 aren't sorted relative to each other
+//!
+//! @param       view [in] View the billboards are being rendered from
+//!              
+//=========================================================================
+void BillboardManager::SortBatchesByDepth ( const CameraView& view )
+{
+	const UInt billboardCount = static_cast<UInt>(m_drawing.billboards.depth.size());
+	const Math::Vector3D& eye = view.position;
+	const Math::Vector3D& forward = view.forward;
+
+	const Float* x = &m_drawing.billboards.positionX[0];
+	const Float* y = &m_drawing.billboards.positionY[0];
+	const Float* z = &m_drawing.billboards.positionZ[0];
+	Float* depth = &m_drawing.billboards.depth[0];
+
+	for ( UInt i=0; i < billboardCount; ++i )
+	{
+		depth[i] = ( (x[i] - eye.X()) * forward.X() ) 
+				 + ( (y[i] - eye.Y()) * forward.Y() ) 
+				 + ( (z[i] - eye.Z()) * forward.Z() );
+	}
+
+	for ( RenderQueue::iterator itr = m_drawing.renderQueue.begin(); itr != m_drawing.renderQueue.end(); ++itr )
+	{
+		BillboardOrder::iterator first = m_drawing.order.begin() + itr->first;
+		std::sort ( first, first + itr->count, FurthestFirst(m_drawing.billboards.depth) );
+	}
+}
+//End BillboardManager::SortBatchesByDepth
+
+
+
 //=========================================================================
 //! @function    BillboardManager::Render 
 //! @brief       Renders all billboards in the billboard list
 //!
-//!				 Updates all billboards to face the camera
-//!				 Copies the billboards vertices to the vertex buffer
-//!				 Renders all items in the render queue
+//!				 Expands the billboards into camera facing quads
+//!				 in the vertex buffer, and renders all items in the render queue
 //!
 //! @param		 renderer [in]	Renderer to draw the billboard list with
-//! @param		 camera	  [in]	Camera from which to render the billboards
+//! @param		 view	  [in]	View of the camera from which to render the billboards
 //!								the billboards will be aligned to this camera
 //!								
 //!
 //=========================================================================
-void BillboardManager::Render ( Renderer::IRenderer& renderer, Camera& camera )
+void BillboardManager::Render ( Renderer::IRenderer& renderer, const CameraView& view )
 {
-	if ( m_renderQueue.empty() )
+	static Core::ConsoleBool ren_billboardsort ( "ren_billboardsort", true );
+
+	if ( m_drawing.renderQueue.empty() )
 	{
 		return;
 	}
 
-	Renderer::ScopedVertexBufferLock lock = 
-		m_streamBinding.GetStream(0)->LockAll(Renderer::LOCK_NORMAL);
-
-	if ( !lock )
+	if ( ren_billboardsort )
 	{
-		throw Core::RuntimeError ( "Error, couldn't lock vertex buffer!", 0,
-									__FILE__, __FUNCTION__, __LINE__ );
+		SortBatchesByDepth ( view );
 	}
 
-	BillboardManager::Vertex* buffer = reinterpret_cast<Vertex*>(lock.GetLockPointer());
-
-	//Update the billboards to face the camera
-	for ( BillboardList::iterator itr = m_billboardList.begin();
-		  itr != m_billboardList.end();
-		  ++itr )
-	{
-		//Recalculate the vertices so that they face the camera
-		itr->second->RecalculateVertices( camera );
-
-		//Copy the new vertices to the vertex buffer
-		(buffer)->position[0] = itr->second->GetVertex( Billboard::VERT_TOPLEFT ).X();
-		(buffer)->position[1] = itr->second->GetVertex( Billboard::VERT_TOPLEFT ).Y();
-		(buffer)->position[2] = itr->second->GetVertex( Billboard::VERT_TOPLEFT ).Z();
-		(buffer)->texCoord0[0] = 0.0f;
-		(buffer)->texCoord0[1] = 0.0f;
-		(buffer)->colour	  = Renderer::Colour4f( 1.0f, 1.0f, 1.0f, itr->second->GetOpacity());
-		++buffer;
-
-		(buffer)->position[0] = itr->second->GetVertex( Billboard::VERT_BOTTOMLEFT ).X();
-		(buffer)->position[1] = itr->second->GetVertex( Billboard::VERT_BOTTOMLEFT ).Y();
-		(buffer)->position[2] = itr->second->GetVertex( Billboard::VERT_BOTTOMLEFT ).Z();
-		(buffer)->texCoord0[0] = 0.0f;
-		(buffer)->texCoord0[1] = 1.0f;
-		(buffer)->colour	  = Renderer::Colour4f( 1.0f, 1.0f, 1.0f, itr->second->GetOpacity());
-		++buffer;
-		
-		(buffer)->position[0] = itr->second->GetVertex( Billboard::VERT_TOPRIGHT ).X();
-		(buffer)->position[1] = itr->second->GetVertex( Billboard::VERT_TOPRIGHT ).Y();
-		(buffer)->position[2] = itr->second->GetVertex( Billboard::VERT_TOPRIGHT ).Z();
-		(buffer)->texCoord0[0] = 1.0f;
-		(buffer)->texCoord0[1] = 0.0f;
-		(buffer)->colour	  = Renderer::Colour4f( 1.0f, 1.0f, 1.0f, itr->second->GetOpacity());
-		++buffer;
-
-		(buffer)->position[0] = itr->second->GetVertex( Billboard::VERT_TOPRIGHT ).X();
-		(buffer)->position[1] = itr->second->GetVertex( Billboard::VERT_TOPRIGHT ).Y();
-		(buffer)->position[2] = itr->second->GetVertex( Billboard::VERT_TOPRIGHT ).Z();
-		(buffer)->texCoord0[0] = 1.0f;
-		(buffer)->texCoord0[1] = 0.0f;
-		(buffer)->colour	  = Renderer::Colour4f( 1.0f, 1.0f, 1.0f, itr->second->GetOpacity());
-		++buffer;
-
-		(buffer)->position[0] = itr->second->GetVertex( Billboard::VERT_BOTTOMLEFT ).X();
-		(buffer)->position[1] = itr->second->GetVertex( Billboard::VERT_BOTTOMLEFT ).Y();
-		(buffer)->position[2] = itr->second->GetVertex( Billboard::VERT_BOTTOMLEFT ).Z();
-		(buffer)->texCoord0[0] = 0.0f;
-		(buffer)->texCoord0[1] = 1.0f;
-		(buffer)->colour	  = Renderer::Colour4f( 1.0f, 1.0f, 1.0f, itr->second->GetOpacity());
-		++buffer;
-	
-		(buffer)->position[0] = itr->second->GetVertex( Billboard::VERT_BOTTOMRIGHT ).X();
-		(buffer)->position[1] = itr->second->GetVertex( Billboard::VERT_BOTTOMRIGHT ).Y();
-		(buffer)->position[2] = itr->second->GetVertex( Billboard::VERT_BOTTOMRIGHT ).Z();
-		(buffer)->texCoord0[0] = 1.0f;
-		(buffer)->texCoord0[1] = 1.0f;
-		(buffer)->colour	  = Renderer::Colour4f( 1.0f, 1.0f, 1.0f, itr->second->GetOpacity());
-		++buffer;
-	}
-
-	lock.Release();
-
-	//Bind the vertex buffer for rendering
+	//Bind the buffers for rendering
 	m_stateManager.ActivateVertexStreamBinding( m_streamBinding );
 	m_stateManager.ActivateVertexDeclaration( m_vertexDeclaration );
+	m_stateManager.ActivateIndexBuffer( m_indexBuffer );
 	m_renderer.SetMatrix( Renderer::MAT_WORLD, Math::Matrix4x4::IdentityMatrix );
 
 	//Render all billboards in the render queue
-	for ( RenderQueue::iterator itr = m_renderQueue.begin();
-		  itr != m_renderQueue.end();
+	for ( RenderQueue::iterator itr = m_drawing.renderQueue.begin();
+		  itr != m_drawing.renderQueue.end();
 		  ++itr )
 	{
-		
-		for ( UInt i=0; i < itr->effect->Techniques(0).PassCount(); ++i )
+		RenderBatch ( *itr, view );
+	}
+
+}
+//End BillboardManager::Render
+
+
+
+//=========================================================================
+//! @function    BillboardManager::RenderBatch
+//! @brief       Render all billboards that use one effect
+//!              
+//!				 Vertices are appended to the ring buffer with no-overwrite locks,
+//!				 so the GPU can keep drawing from earlier parts of the buffer.
+//!				 When the ring is full, it wraps around with a discard lock, and the
+//!				 batch is drawn in as many pieces as necessary
+//!              
+//! @param       entry  [in] Batch to render
+//! @param       view   [in] View of the camera to align the billboards to
+//!              
+//=========================================================================
+void BillboardManager::RenderBatch ( const RenderQueueEntry& entry, const CameraView& view )
+{
+	Renderer::HEffect effect = entry.effect;
+	Renderer::HVertexBuffer buffer = m_streamBinding.GetStream(0);
+
+	UInt first = entry.first;
+	UInt remaining = entry.count;
+
+	while ( remaining > 0 )
+	{
+		if ( m_ringPosition == m_maxBillboards )
+		{
+			m_ringPosition = 0;
+		}
+
+		const UInt count = Core::Min ( remaining, m_maxBillboards - m_ringPosition );
+
+		Renderer::ScopedVertexBufferLock lock = 
+			buffer->Lock ( m_ringPosition * g_verticesPerBillboard * sizeof(Vertex), 
+						   count * g_verticesPerBillboard * sizeof(Vertex),
+						   (m_ringPosition == 0) ? Renderer::LOCK_DISCARD : Renderer::LOCK_NOOVERWRITE );
+
+		if ( !lock )
+		{
+			throw Core::RuntimeError ( "Error, couldn't lock vertex buffer!", 0,
+										__FILE__, __FUNCTION__, __LINE__ );
+		}
+
+		ExpandBillboards ( &m_drawing.order[first], count, view, reinterpret_cast<Vertex*>(lock.GetLockPointer()) );
+
+		lock.Release();
+
+		for ( UInt i=0; i < effect->Techniques(0).PassCount(); ++i )
 		{
-			m_stateManager.ActivateRenderState( itr->effect, 0, i );
+			m_stateManager.ActivateRenderState( effect, 0, i );
 
-			m_renderer.DrawPrimitive ( Renderer::PRIM_TRIANGLELIST, 
-									   itr->startIndex, 
-									   itr->vertexCount );
+			m_renderer.DrawIndexedPrimitive ( Renderer::PRIM_TRIANGLELIST, 
+											  m_ringPosition * g_verticesPerBillboard,
+											  count * g_verticesPerBillboard,
+											  0,
+											  count * g_indicesPerBillboard );
 		}
 
+		m_ringPosition += count;
+		first += count;
+		remaining -= count;
 	}
+}
+//End BillboardManager::RenderBatch
+
 
+
+//=========================================================================
+//! @function    BillboardManager::ExpandBillboards
+//! @brief       Write camera facing quads for a list of billboards
+//!              
+//!				 The billboard's rotation is around the view direction, so
+//!				 the rotated quad axes are combinations of the camera's right and up
+//!				 vectors, and their cross products with the view direction.
+//!				 Those are calculated once, leaving a few multiply-adds per billboard
+//!              
+//! @param       order	  [in]  Indices of the billboards to expand
+//! @param       count	  [in]  Number of billboards to expand
+//! @param       view	  [in]  View of the camera to align the billboards to
+//! @param       vertices [out] Receives count * 4 vertices
+//!              
+//=========================================================================
+void BillboardManager::ExpandBillboards ( const UInt* order, UInt count, 
+										  const CameraView& view, Vertex* vertices ) const
+{
+	const Math::Vector3D& right = view.right;
+	const Math::Vector3D& up = view.up;
+	const Math::Vector3D axis = -view.forward;
+
+	Math::Vector3D rotatedRight;
+	Math::Vector3D rotatedUp;
+	Math::Vector3D::CrossProduct ( axis, right, rotatedRight );
+	Math::Vector3D::CrossProduct ( axis, up, rotatedUp );
+
+	const Float* positionX = &m_drawing.billboards.positionX[0];
+	const Float* positionY = &m_drawing.billboards.positionY[0];
+	const Float* positionZ = &m_drawing.billboards.positionZ[0];
+	const Float* scaledCos = &m_drawing.billboards.scaledCos[0];
+	const Float* scaledSin = &m_drawing.billboards.scaledSin[0];
+	const UInt32* colour   = &m_drawing.billboards.colour[0];
+
+	for ( UInt i=0; i < count; ++i, vertices += g_verticesPerBillboard )
+	{
+		const UInt index = order[i];
+		const Float c = scaledCos[index];
+		const Float s = scaledSin[index];
+
+		//Scaled and rotated half axes of the quad
+		const Float rx = (right.X() * c) + (rotatedRight.X() * s);
+		const Float ry = (right.Y() * c) + (rotatedRight.Y() * s);
+		const Float rz = (right.Z() * c) + (rotatedRight.Z() * s);
+		const Float ux = (up.X() * c) + (rotatedUp.X() * s);
+		const Float uy = (up.Y() * c) + (rotatedUp.Y() * s);
+		const Float uz = (up.Z() * c) + (rotatedUp.Z() * s);
+
+		const Float px = positionX[index];
+		const Float py = positionY[index];
+		const Float pz = positionZ[index];
+
+		//Top left
+		vertices[0].position[0] = px - rx + ux;
+		vertices[0].position[1] = py - ry + uy;
+		vertices[0].position[2] = pz - rz + uz;
+		vertices[0].colour		= colour[index];
+		vertices[0].texCoord0[0] = 0.0f;
+		vertices[0].texCoord0[1] = 0.0f;
+
+		//Bottom left
+		vertices[1].position[0] = px - rx - ux;
+		vertices[1].position[1] = py - ry - uy;
+		vertices[1].position[2] = pz - rz - uz;
+		vertices[1].colour		= colour[index];
+		vertices[1].texCoord0[0] = 0.0f;
+		vertices[1].texCoord0[1] = 1.0f;
+
+		//Top right
+		vertices[2].position[0] = px + rx + ux;
+		vertices[2].position[1] = py + ry + uy;
+		vertices[2].position[2] = pz + rz + uz;
+		vertices[2].colour		= colour[index];
+		vertices[2].texCoord0[0] = 1.0f;
+		vertices[2].texCoord0[1] = 0.0f;
+
+		//Bottom right
+		vertices[3].position[0] = px + rx - ux;
+		vertices[3].position[1] = py + ry - uy;
+		vertices[3].position[2] = pz + rz - uz;
+		vertices[3].colour		= colour[index];
+		vertices[3].texCoord0[0] = 1.0f;
+		vertices[3].texCoord0[1] = 1.0f;
+	}
 }
-//End BillboardManager::Render
+//End BillboardManager::ExpandBillboards
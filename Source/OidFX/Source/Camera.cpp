@@ -199,24 +199,24 @@ void Camera::SetToIdealPosition ( )
 
 	debug_assert ( m_entity, "SetToIdealPosition called when entity is null!" );
 
+	//Follow the entity where it is drawn, rather than where the simulation
+	//has got to, otherwise it would jitter on screen
+	const Math::Matrix4x4 toWorld ( m_entity->InterpolatedObjectToWorld() );
+
 	//Get the entity position
-	Vector3D entityPos = m_entity->GetWorldSpacePosition();
+	Vector3D entityPos;
+	entityPos *= toWorld;
 	
 	//Get the basis vectors of the entity
-	Vector3D entityForward = m_entity->Forward();
-	entityForward.Normalise();
-
-	Vector3D entityUp = m_entity->Up();
-	entityUp.Normalise();
-
-	Vector3D entityRight = m_entity->Right();
-	entityRight.Normalise();
+	Vector3D entityForward ( toWorld(2,0), toWorld(2,1), toWorld(2,2) );
+	Vector3D entityUp ( toWorld(1,0), toWorld(1,1), toWorld(1,2) );
+	Vector3D entityRight ( toWorld(0,0), toWorld(0,1), toWorld(0,2) );
 
 	//Set the camera behind the entity
 	m_position = entityPos;
-	m_position += (m_entity->Forward() * m_offset.Z());
-	m_position += (m_entity->Up() * m_offset.Y());
-	m_position += (m_entity->Right() * m_offset.X());
+	m_position += (entityForward * m_offset.Z());
+	m_position += (entityUp * m_offset.Y());
+	m_position += (entityRight * m_offset.X());
 
 	//Set the look at position
 	m_lookAt = entityPos;
@@ -298,7 +298,7 @@ void Camera::OnMouseScroll ( Int scroll )
 //=========================================================================
 void Camera::OnKeyDown ( UInt keyCode )
 {
-	Core::ConsoleFloat cam_movespeed ( "cam_movespeed", 1.0f );
+	static Core::ConsoleFloat cam_movespeed ( "cam_movespeed", 1.0f );
 
 	switch ( keyCode )
 	{
@@ -264,6 +264,9 @@ void CameraNode::Update ( Math::MatrixStack& toWorldStack,
 		debug_assert ( false, "Couldn't invert matrix!" );
 	}
 
+	//The camera is rebuilt every frame, so it's always dirty
+	MarkTransformDirty();
+
 	//Call the base class update method to propagate the call to children,
 	SceneNode::Update ( toWorldStack, fromWorldStack, timeElapsedInSeconds );
 
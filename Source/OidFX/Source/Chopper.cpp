@@ -95,7 +95,9 @@ Chopper::Chopper ( Scene& scene,
 					m_accelX(0.0f),
 					m_accelY(0.0f),
 					m_accelZ(0.0f),
-					m_launch(false)
+					m_launch(false),
+					m_timeSinceLastLaunch(1000.0f),
+					m_currentLauncher(0)
 {
 
 	Core::ConsoleFloat chopper_targetrange ( "chopper_targetrange", 500.0f );
@@ -133,84 +135,6 @@ Chopper::Chopper ( Scene& scene,
 //End Chopper::Chopper
 
 
-//=========================================================================
-//! @function    Chopper::Update
-//! @brief       Called to update the chopper every frame
-//!              
-//!              
-//! @param       toWorldStack			[in]
-//! @param       fromWorldStack			[in]
-//! @param       timeElapsedInSeconds	[in]
-//!              
-//=========================================================================
-void Chopper::Update ( Math::MatrixStack& toWorldStack, Math::MatrixStack& fromWorldStack, Float timeElapsedInSeconds )
-{
-
-	//Make the chopper accelerate in the direction it is facing
-
-	m_orientation.Normalise();
-
-	//Get the basis vectors from the orientation
-	Math::Vector3D forward = Math::Vector3D::ZAxis * m_orientation;
-	Math::Vector3D right   = Math::Vector3D::XAxis * m_orientation;
-	Math::Vector3D up	   = Math::Vector3D::YAxis * m_orientation;
-
-	forward.Normalise();
-	right.Normalise();
-	up.Normalise();
-
-	//Update the acceleration based on user input
-	m_acceleration += forward * m_accelZ;
-	m_acceleration += right	  * m_accelX;
-	m_acceleration += up	  * m_accelY;
-
-	//Update orientation
-	if ( IsFlagSet(EF_SPAWNED) )
-	{
-		UpdatePhysics( timeElapsedInSeconds );
-
-		m_orientation.Normalise();
-		
-		m_objectToWorld.Identity();
-		m_objectToWorld *= Math::Matrix4x4 ( m_orientation );
-		m_objectToWorld.Translate ( m_position );
-		
-		m_objectFromWorld.Identity();
-		m_objectFromWorld *= Math::Matrix4x4 ( -m_orientation );
-		m_objectFromWorld.Translate ( -m_position );
-	}
-
-	SceneObject::Update( toWorldStack, fromWorldStack, timeElapsedInSeconds );
-
-	//If the launch button was pressed, then launch a missile
-	static Float timeSinceLastLaunch = 1000.0f;	
-	timeSinceLastLaunch += timeElapsedInSeconds;
-	
-	static Core::ConsoleFloat copter_minlaunchwindow ( "copter_minlaunchwindow", 1.0f );
-
-	if ( (m_launch) && (timeSinceLastLaunch > copter_minlaunchwindow) )
-	{
-		LaunchMissile();
-
-		timeSinceLastLaunch = 0.0f;
-	}
-
-	//Clear out the acceleration
-	m_acceleration.Set ( 0.0f, 0.0f, 0.0f );
-	m_angularAcceleration.Set ( 0.0f, 0.0f, 0.0f );
-
-	m_accelX = 0.0f;
-	m_accelY = 0.0f;
-	m_accelZ = 0.0f;
-
-	m_launch = false;
-
-	OnThink ( timeElapsedInSeconds );
-}
-//End Chopper::Update
-
-
-
 //=========================================================================
 //! @function    Chopper::LaunchMissile
 //! @brief       Launch a missile if possible
@@ -218,15 +142,13 @@ void Chopper::Update ( Math::MatrixStack& toWorldStack, Math::MatrixStack& fromW
 void Chopper::LaunchMissile ( )
 {
 
-	static UInt currentLauncher = 0;
+	debug_assert( m_missileLaunchers[m_currentLauncher], "Missile launcher does not exist!" );
 
-	debug_assert( m_missileLaunchers[currentLauncher], "Missile launcher does not exist!" );
 
-
-	m_missileLaunchers[currentLauncher]->LaunchMissile();
+	m_missileLaunchers[m_currentLauncher]->LaunchMissile();
 
 	//Alternate between the different missile launchers
-	currentLauncher = (currentLauncher + 1) % m_missileLaunchers.size();
+	m_currentLauncher = (m_currentLauncher + 1) % static_cast<UInt>(m_missileLaunchers.size());
 
 }
 //End Chopper::LaunchMissile
@@ -263,19 +185,57 @@ void Chopper::OnSpawn ( const Math::Vector3D& spawnPoint )
 
 //=========================================================================
 //! @function    Chopper::OnThink
-//! @brief       Called every frame to update chopper AI
+//! @brief       Called every frame to apply the player's input to the chopper
 //!              
 //! @param       timeElapsed [in]
 //!              
 //=========================================================================
 void Chopper::OnThink ( Float timeElapsed )
 {
+	static Core::ConsoleFloat copter_minlaunchwindow ( "copter_minlaunchwindow", 1.0f );
+
+	//Make the chopper accelerate in the direction it is facing
+
+	Math::Quaternion& orientation = Orientation();
+	orientation.Normalise();
+
+	//Get the basis vectors from the orientation
+	Math::Vector3D forward = Math::Vector3D::ZAxis * orientation;
+	Math::Vector3D right   = Math::Vector3D::XAxis * orientation;
+	Math::Vector3D up	   = Math::Vector3D::YAxis * orientation;
+
+	forward.Normalise();
+	right.Normalise();
+	up.Normalise();
+
+	//Update the acceleration based on user input. It is applied by the next physics pass
+	Math::Vector3D& acceleration = Acceleration();
+	acceleration += forward * m_accelZ;
+	acceleration += right	* m_accelX;
+	acceleration += up		* m_accelY;
+
+	//If the launch button was pressed, then launch a missile
+	m_timeSinceLastLaunch += timeElapsed;
+
+	if ( (m_launch) && (m_timeSinceLastLaunch > copter_minlaunchwindow) )
+	{
+		LaunchMissile();
+
+		m_timeSinceLastLaunch = 0.0f;
+	}
+
+	//Clear out the input. The acceleration is cleared by the physics pass, once it has been applied
+	m_accelX = 0.0f;
+	m_accelY = 0.0f;
+	m_accelZ = 0.0f;
+
+	m_launch = false;
 
 	//If the chopper is dead, then make it rotate around its y axis,
 	//as if its tail rotor was damaged
 	if ( IsFlagSet(EF_DEAD) )
 	{
-		m_angularAcceleration += Math::Vector3D( 0.0f, 2.0f * timeElapsed, 0.0f );
+		AngularAcceleration() += Math::Vector3D( 0.0f, 2.0f * timeElapsed, 0.0f );
 	}
 }
 //End Chopper::OnThink
@@ -311,18 +271,22 @@ void Chopper::OnWorldCollide (  const Math::Vector3D& collisionNormal, Float dep
 		Explode();
 	}
 
-	m_position -= m_velocity;
+	//Explode may create an entity, so only get these afterwards
+	Math::Vector3D& position = Position();
+	Math::Vector3D& velocity = Velocity();
+
+	position -= velocity;
 
 	//Project -velocity onto the collision normal 
-	Float proj = Math::Vector3D::DotProduct(-m_velocity, collisionNormal);
+	Float proj = Math::Vector3D::DotProduct(-velocity, collisionNormal);
 
 	//Get the reflection vector
 	Math::Vector3D reflect = (collisionNormal * proj) * 2.0f;
 
 	//Make the chopper bounce back from the terrain a bit
-	m_velocity =  reflect + m_velocity;
+	velocity =  reflect + velocity;
 
-	m_position += m_velocity;
+	position += velocity;
 }
 //End Chopper::OnWorldCollide
 
@@ -344,16 +308,18 @@ void Chopper::OnEntityCollide ( const Math::Vector3D& collisionNormal, Float dep
 	//Cheap collision response! 
 	//m_position -= collisionNormal * (depth+0.1f);
 
+	Math::Vector3D& velocity = Velocity();
+
 	//Project -velocity onto the collision normal 
-	Float proj = Math::Vector3D::DotProduct(-m_velocity, collisionNormal);
+	Float proj = Math::Vector3D::DotProduct(-velocity, collisionNormal);
 
 	//Get the reflection vector
 	Math::Vector3D reflect = (collisionNormal * proj) * 2.0f;
 
 	//Make the chopper bounce back from the object a bit
-	m_velocity =  reflect + m_velocity;
+	velocity =  reflect + velocity;
 
-	m_position += m_velocity;
+	Position() += velocity;
 
 }
 //End Chopper::OnEntityCollide
@@ -391,9 +357,9 @@ void Chopper::OnDeath ( )
 void Chopper::OnMouseMove ( Int movementX, Int movementY )
 {
 
-	Core::ConsoleFloat gam_copterrotatefactor ( "gam_copterrotatefactor", 0.8f );
+	static Core::ConsoleFloat gam_copterrotatefactor ( "gam_copterrotatefactor", 0.8f );
 
-	m_angularAcceleration += Math::Vector3D ( 0.0f,
+	AngularAcceleration() += Math::Vector3D ( 0.0f,
 											  Math::DegreesToRadians(-movementX * gam_copterrotatefactor), 
 											  0.0f );
 }
@@ -26,18 +26,31 @@
 //======================================================================================
 
 
+#include <algorithm>
 #include "Core/Core.h"
 #include "OidFX/Scene.h"
 #include "OidFX/SceneObject.h"
 #include "OidFX/EntityNode.h"
 #include "OidFX/CollisionManager.h"
 #include "OidFX/NewtonWrapper.h"
+#include "OidFX/Constants.h"
 
 
 
 using namespace OidFX;
 
 
+//=========================================================================
+// Constants
+//=========================================================================
+namespace
+{
+	const Float defaultBroadPhaseCellSize = 20.0f * meters;
+	const Float minBroadPhaseCellSize = 1.0f * meters;
+	const UInt  broadPhaseBucketCount = 1021;
+}
+
+
 //=========================================================================
 //! @function    CollisionManager::CollisionManager
 //! @brief       CollisionManager constructor
@@ -46,7 +59,7 @@ using namespace OidFX;
 //!              
 //=========================================================================
 CollisionManager::CollisionManager ( Scene& scene )
-: m_scene(scene)
+: m_scene(scene), m_broadPhase(defaultBroadPhaseCellSize, broadPhaseBucketCount)
 {
 	m_world = boost::shared_ptr<Newton::World>( new Newton::World() );
 }
@@ -65,7 +78,9 @@ CollisionManager::CollisionManager ( Scene& scene )
 void CollisionManager::AddCollider ( EntityNode* entityNode )
 {
 	debug_assert ( entityNode, "entityNode should not be null!" );
+	debug_assert ( entityNode->m_colliderSlot == InvalidSlot, "Entity is already a collider!" );
 
+	entityNode->m_colliderSlot = static_cast<UInt>(m_colliders.size());
 	m_colliders.push_back( entityNode );
 }
 //End CollisionManager::AddCollider
@@ -77,6 +92,9 @@ void CollisionManager::AddCollider ( EntityNode* entityNode )
 //! @brief       Remove an entity from the list of objects that will be checked
 //!				 for collisions
 //!              
+//!				 The last collider is moved into the entity's slot, so this takes
+//!				 constant time
+//!
 //! @param       entityNode [in] 
 //!              
 //=========================================================================
@@ -84,12 +102,16 @@ void CollisionManager::RemoveCollider ( EntityNode* entityNode )
 {
 	debug_assert ( entityNode, "entityNode should not be null!" );
 
-	ColliderStore::iterator item = std::find<ColliderStore::iterator, EntityNode*>
-												(m_colliders.begin(), m_colliders.end(), entityNode);
+	const UInt slot = entityNode->m_colliderSlot;
+
+	debug_assert ( (slot < m_colliders.size()) && (m_colliders[slot] == entityNode), "Item not in list!" );
 
-	debug_assert ( item != m_colliders.end(), "Item not in list!" );
+	EntityNode* last = m_colliders.back();
+	m_colliders[slot] = last;
+	last->m_colliderSlot = slot;
 
-	m_colliders.erase ( item );
+	m_colliders.pop_back();
+	entityNode->m_colliderSlot = InvalidSlot;
 }
 //End CollisionManager::RemoveCollider
 
@@ -115,14 +137,87 @@ void CollisionManager::AddCollision ( const CollisionRecord& collision )
 //! @function    CollisionManager::CheckCollisions
 //! @brief       Check all colliders for collisions 
 //!
+//!				 The world is still checked by walking the scene graph, but entity
+//!				 collisions use the broad phase spatial hash to find candidate entities.
+//!				 The candidates are then checked using SceneNode::CheckCollisions as normal,
+//!				 so the narrow phase, and the records generated, are the same as for a full walk.
+//!
+//!				 Setting col_broadphase to false falls back to walking the whole scene graph
+//!				 for every collider
 //=========================================================================
 void CollisionManager::CheckCollisions ( )
 {
+	static Core::ConsoleBool  col_broadphase ( "col_broadphase", true );
+	static Core::ConsoleFloat col_broadphasecellsize ( "col_broadphasecellsize", defaultBroadPhaseCellSize );
+
 	debug_assert ( m_scene.Root(), "Scene graph is empty!" );
 
 	//Clear the collision list
 	ClearCollisions();
 
+	if ( !col_broadphase )
+	{
+		CheckCollisionsBruteForce();
+		return;
+	}
+
+	BuildBroadPhase ( col_broadphasecellsize );
+
+	//Check each collider against the world, and against the entities found by the broad phase
+	for ( ColliderStore::const_iterator itr = m_colliders.begin();
+		  itr != m_colliders.end();
+		  ++itr )
+	{
+
+		SceneNode::NodeCollisionFlags flags;
+
+		if ( (*itr)->IsFlagSet( EF_NOCOLLIDE ) )
+		{
+			continue;
+		}
+
+		if ( !(*itr)->IsFlagSet( EF_NOWORLDCOLLIDE ) )
+		{
+			flags[NODETYPE_WORLD] = true;
+		}
+
+		flags[NODETYPE_SCENEPARTITION] = true;
+
+		//Entities attached to the root are dealt with by the broad phase, so skip them in the walk
+		m_scene.Root()->CheckCollisions( *itr, (*itr)->PreferredCollisionType(), flags, *this );
+
+		if ( (*itr)->IsFlagSet( EF_NOENTITYCOLLIDE ) )
+		{
+			continue;
+		}
+
+		//Child entities can still be reached through the candidates, so they need the entity flag
+		flags[NODETYPE_ENTITY] = true;
+
+		m_broadPhaseCandidates.clear();
+		m_broadPhase.Query ( (*itr)->BoundingBox(), m_broadPhaseCandidates );
+
+		for ( SpatialHash::ObjectList::const_iterator candidate = m_broadPhaseCandidates.begin();
+			  candidate != m_broadPhaseCandidates.end();
+			  ++candidate )
+		{
+			(*candidate)->CheckCollisions( *itr, (*itr)->PreferredCollisionType(), flags, *this );
+		}
+	}
+		  
+}
+//End CollisionManager::CheckCollisions
+
+
+
+//=========================================================================
+//! @function    CollisionManager::CheckCollisionsBruteForce
+//! @brief       Check all colliders for collisions by walking the whole scene graph
+//!				 for each collider
+//!
+//=========================================================================
+void CollisionManager::CheckCollisionsBruteForce ( )
+{
 	//Check each collider against the scene for collisions
 	for ( ColliderStore::const_iterator itr = m_colliders.begin();
 		  itr != m_colliders.end();
@@ -151,9 +246,89 @@ void CollisionManager::CheckCollisions ( )
 
 		m_scene.Root()->CheckCollisions( *itr, (*itr)->PreferredCollisionType(), flags, *this );
 	}
-		  
 }
-//End CollisionManager::CheckCollisions
+//End CollisionManager::CheckCollisionsBruteForce
+
+
+
+//=========================================================================
+//! @function    CollisionManager::BuildBroadPhase
+//! @brief       Rebuild the broad phase spatial hash from the entities
+//!				 attached to the root of the scene graph
+//!
+//!				 Static entities aren't colliders, but colliders can still hit them,
+//!				 so every entity goes into the hash, not just the colliders.
+//!
+//!				 Each entity is inserted with the bounds of its whole subtree, since
+//!				 the entities attached to it are reached through it as a candidate.
+//!
+//! @param		 cellSize [in] Size of a spatial hash cell, in world units. Clamped
+//!							   to minBroadPhaseCellSize
+//=========================================================================
+void CollisionManager::BuildBroadPhase ( Float cellSize )
+{
+	m_broadPhase.Clear();
+
+	cellSize = std::max ( cellSize, minBroadPhaseCellSize );
+
+	if ( cellSize != m_broadPhase.CellSize() )
+	{
+		m_broadPhase.SetCellSize ( cellSize );
+	}
+
+	for ( SceneNode::const_iterator itr = m_scene.Root()->ChildrenBegin();
+		  itr != m_scene.Root()->ChildrenEnd();
+		  ++itr )
+	{
+		if ( (*itr)->NodeType() == NODETYPE_ENTITY )
+		{
+			SceneObject* object = static_cast<SceneObject*>( itr->get() );
+
+			Math::Vector3D minCorner = object->BoundingBox().GetCorner ( Math::AxisAlignedBoundingBox::MIN_X_MIN_Y_MIN_Z );
+			Math::Vector3D maxCorner = object->BoundingBox().GetCorner ( Math::AxisAlignedBoundingBox::MAX_X_MAX_Y_MAX_Z );
+
+			MergeSubtreeBounds ( *object, minCorner, maxCorner );
+
+			m_broadPhase.Insert ( object, Math::AxisAlignedBoundingBox(minCorner, maxCorner) );
+		}
+	}
+}
+//End CollisionManager::BuildBroadPhase
+
+
+
+//=========================================================================
+//! @function    CollisionManager::MergeSubtreeBounds
+//! @brief       Grow a box to enclose the bounding boxes of every entity
+//!				 below a node
+//!
+//! @param		 node		[in]	 Node whose children are merged
+//! @param		 minCorner	[in/out] Minimum corner of the box, in world space
+//! @param		 maxCorner	[in/out] Maximum corner of the box, in world space
+//=========================================================================
+void CollisionManager::MergeSubtreeBounds ( const SceneNode& node, Math::Vector3D& minCorner, Math::Vector3D& maxCorner ) const
+{
+	for ( SceneNode::const_iterator itr = node.ChildrenBegin(); itr != node.ChildrenEnd(); ++itr )
+	{
+		if ( (*itr)->NodeType() == NODETYPE_ENTITY )
+		{
+			const Math::AxisAlignedBoundingBox& box = static_cast<const SceneObject*>( itr->get() )->BoundingBox();
+
+			const Math::Vector3D childMin = box.GetCorner ( Math::AxisAlignedBoundingBox::MIN_X_MIN_Y_MIN_Z );
+			const Math::Vector3D childMax = box.GetCorner ( Math::AxisAlignedBoundingBox::MAX_X_MAX_Y_MAX_Z );
+
+			minCorner = Math::Vector3D ( std::min(minCorner.X(), childMin.X()), 
+										 std::min(minCorner.Y(), childMin.Y()), 
+										 std::min(minCorner.Z(), childMin.Z()) );
+			maxCorner = Math::Vector3D ( std::max(maxCorner.X(), childMax.X()), 
+										 std::max(maxCorner.Y(), childMax.Y()), 
+										 std::max(maxCorner.Z(), childMax.Z()) );
+		}
+
+		MergeSubtreeBounds ( **itr, minCorner, maxCorner );
+	}
+}
+//End CollisionManager::BuildBroadPhase
 
 
 
@@ -0,0 +1,199 @@
+//======================================================================================
+//! @file         CookedMeshLoader.cpp
+//! @brief        Loader for cooked mesh files
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+#include <algorithm>
+#include "Core/Core.h"
+#include "Core/MemoryMappedFile.h"
+#include "Renderer/EffectManager.h"
+#include "OidFX/Mesh.h"
+#include "OidFX/CookedMeshLoader.h"
+
+
+
+using namespace CookedMesh;
+
+
+
+//namespace
+namespace
+{
+
+	//=========================================================================
+    //! @function    FixedLengthString
+    //! @brief       Make a string from a fixed length field, which is only null 
+	//!				 terminated if it's shorter than the field
+    //=========================================================================
+	std::string FixedLengthString ( const Char* field, UInt fieldLength )
+	{
+		return std::string ( field, std::find ( field, field + fieldLength, '\0' ) );
+	}
+	//End FixedLengthString
+
+}
+//end namespace
+
+
+
+//=========================================================================
+//! @function    CookedMesh::FileSize
+//! @brief       Get the size of a cooked mesh file from its header
+//!              
+//! @param       header [in] Header of the file
+//!              
+//! @return      Size of the file in bytes
+//=========================================================================
+UInt64 CookedMesh::FileSize ( const Header& header )
+{
+	return sizeof(Header)
+		 + (static_cast<UInt64>(header.vertexCount) * sizeof(OidFX::Mesh::MeshStream0))
+		 + (static_cast<UInt64>(header.indexCount) * sizeof(UInt16))
+		 + IndexPadding(header.indexCount)
+		 + (static_cast<UInt64>(header.groupCount) * sizeof(Group))
+		 + (static_cast<UInt64>(header.effectCount) * sizeof(Effect));
+}
+//End CookedMesh::FileSize
+
+
+
+//=========================================================================
+//! @function    CookedMeshLoader::Load
+//! @brief       Load a mesh from a mapped cooked mesh file
+//!              
+//!				 Vertices and indices are copied straight from the mapped pages
+//!				 into the mesh's vertex and index buffers.
+//!              
+//! @param       file [in] Mapped cooked mesh file
+//! @param		 name [in] Name used to identify the mesh
+//!              
+//! @return      A pointer to a new OidFX::Mesh object
+//! @throw       Core::RuntimeError if the file is invalid, or is from an older version
+//=========================================================================
+boost::shared_ptr<OidFX::Mesh> CookedMeshLoader::Load ( const Core::MemoryMappedFile& file, const Char* name )
+{
+	debug_assert ( file.IsOpen(), "Cooked mesh file isn't open!" );
+
+	if ( file.Size() < sizeof(Header) )
+	{
+		throw Core::RuntimeError ( "Error, cooked mesh file is too small to have a header", 0, __FILE__, __FUNCTION__, __LINE__ );
+	}
+
+	const Byte*	  data = file.Data();
+	const Header& header = *reinterpret_cast<const Header*>(data);
+
+	if ( (header.id != fileId) || (header.version != version) )
+	{
+		throw Core::RuntimeError ( "Error, invalid or out of date cooked mesh file", 0, __FILE__, __FUNCTION__, __LINE__ );
+	}
+
+	if ( (header.lodCount == 0) || (header.lodCount > OidFX::g_maxMeshLODs) )
+	{
+		throw Core::RuntimeError ( "Error, cooked mesh has an invalid number of LODs", 0, __FILE__, __FUNCTION__, __LINE__ );
+	}
+
+	if ( FileSize(header) != file.Size() )
+	{
+		throw Core::RuntimeError ( "Error, cooked mesh file size doesn't match its header", 0, __FILE__, __FUNCTION__, __LINE__ );
+	}
+
+	//Find each array in the mapped file
+	data += sizeof(Header);
+
+	const OidFX::Mesh::MeshStream0* vertices = reinterpret_cast<const OidFX::Mesh::MeshStream0*>(data);
+	data += header.vertexCount * sizeof(OidFX::Mesh::MeshStream0);
+
+	const UInt16* indices = reinterpret_cast<const UInt16*>(data);
+	data += (header.indexCount * sizeof(UInt16)) + IndexPadding(header.indexCount);
+
+	const Group* groups = reinterpret_cast<const Group*>(data);
+	data += header.groupCount * sizeof(Group);
+
+	const Effect* effects = reinterpret_cast<const Effect*>(data);
+
+	//Acquire the effects
+	OidFX::Mesh::EffectStore outputEffects;
+	outputEffects.reserve ( header.effectCount );
+
+	for ( UInt effect = 0; effect < header.effectCount; ++effect )
+	{
+		std::string effectFileName = FixedLengthString ( effects[effect].fileName, sizeof(effects[effect].fileName) );
+
+		outputEffects.push_back ( m_effectManager.AcquireEffect ( effectFileName.c_str() ) );
+	}
+
+	//Build the groups
+	OidFX::Mesh::MeshGroupStore outputGroups;
+	outputGroups.reserve ( header.groupCount );
+
+	for ( UInt group = 0; group < header.groupCount; ++group )
+	{
+		const Group& currentGroup = groups[group];
+
+		if ( currentGroup.effectIndex >= header.effectCount )
+		{
+			throw Core::RuntimeError ( "Error, cooked mesh group has an invalid effect", 0, __FILE__, __FUNCTION__, __LINE__ );
+		}
+
+		for ( UInt lod = 0; lod < header.lodCount; ++lod )
+		{
+			if (	( currentGroup.startOffset[lod] > header.indexCount )
+				 || ( currentGroup.triangleCount[lod] > ((header.indexCount - currentGroup.startOffset[lod]) / 3) ) )
+			{
+				throw Core::RuntimeError ( "Error, cooked mesh group is out of range", 0, __FILE__, __FUNCTION__, __LINE__ );
+			}
+		}
+
+		std::string groupName = FixedLengthString ( currentGroup.name, sizeof(currentGroup.name) );
+
+		outputGroups.push_back ( OidFX::MeshGroup ( groupName.c_str(),
+													outputEffects[currentGroup.effectIndex],
+													currentGroup.startOffset[0],
+													currentGroup.triangleCount[0],
+													currentGroup.minVertexIndex,
+													currentGroup.maxVertexIndex ) );
+
+		for ( UInt lod = 1; lod < header.lodCount; ++lod )
+		{
+			outputGroups.back().AddLOD ( currentGroup.startOffset[lod], currentGroup.triangleCount[lod] );
+		}
+	}
+
+	Math::AxisAlignedBoundingBox boundingBox ( Math::Vector3D ( header.boundsMin[0], header.boundsMin[1], header.boundsMin[2] ),
+											   Math::Vector3D ( header.boundsMax[0], header.boundsMax[1], header.boundsMax[2] ) );
+
+	boost::shared_ptr<OidFX::Mesh> mesh ( new OidFX::Mesh ( m_renderer,
+															name,
+															vertices,
+															header.vertexCount,
+															indices,
+															header.indexCount,
+															boundingBox,
+															outputEffects,
+															outputGroups ) );
+
+	return mesh;
+}
+//End CookedMeshLoader::Load
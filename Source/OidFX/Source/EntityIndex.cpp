@@ -0,0 +1,624 @@
+//======================================================================================
+//! @file         EntityIndex.cpp
+//! @brief        Loose grid of entities, kept up to date as they move, used to
+//!               answer sphere, box, ray and nearest entity queries
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+
+#include <algorithm>
+#include "Core/Core.h"
+#include "Math/Math.h"
+#include "Math/BoundingBox3D.h"
+#include "Math/BoundingSphere3D.h"
+#include "Math/ParametricLine3D.h"
+#include "OidFX/EntityIndex.h"
+
+
+using namespace OidFX;
+
+
+
+//namespace
+namespace
+{
+
+	//=========================================================================
+    //! @function    RayHitsBox
+    //! @brief       Slab test of a line segment against an axis aligned box
+    //!              
+    //! @param       origin		[in]	Start of the segment
+    //! @param       direction	[in]	End of the segment minus the start
+    //! @param       centre		[in]	Centre of the box
+    //! @param       halfExtent	[in]	Half the size of the box on each axis
+    //! @param       t			[out]	Where the segment enters the box, from 0 to 1
+    //!              
+    //! @return      true if the segment touches the box
+    //=========================================================================
+	bool RayHitsBox ( const Float origin[3], const Float direction[3], 
+					  const Float centre[3], const Float halfExtent[3], Float& t )
+	{
+		Float tEnter = 0.0f;
+		Float tExit = 1.0f;
+
+		for ( UInt axis = 0; axis < 3; ++axis )
+		{
+			const Float boxMin = centre[axis] - halfExtent[axis];
+			const Float boxMax = centre[axis] + halfExtent[axis];
+
+			if ( Math::Abs(direction[axis]) < Math::EpsilonE6 )
+			{
+				//Parallel to the slab, so it has to start inside it
+				if ( (origin[axis] < boxMin) || (origin[axis] > boxMax) )
+				{
+					return false;
+				}
+
+				continue;
+			}
+
+			const Float inverseDirection = 1.0f / direction[axis];
+			Float tNear = (boxMin - origin[axis]) * inverseDirection;
+			Float tFar  = (boxMax - origin[axis]) * inverseDirection;
+
+			if ( tNear > tFar )
+			{
+				std::swap ( tNear, tFar );
+			}
+
+			tEnter = std::max ( tEnter, tNear );
+			tExit  = std::min ( tExit, tFar );
+
+			if ( tEnter > tExit )
+			{
+				return false;
+			}
+		}
+
+		t = tEnter;
+		return true;
+	}
+	//End RayHitsBox
+
+}
+//end namespace
+
+
+
+//=========================================================================
+//! @function    EntityIndex::EntityIndex
+//! @brief       EntityIndex constructor
+//!              
+//! @param       cellSize		[in] Length of the side of a grid cell, in world units
+//! @param       bucketCount	[in] Number of hash buckets
+//!              
+//=========================================================================
+EntityIndex::EntityIndex ( Float cellSize, UInt bucketCount )
+: m_cellSize(0.0f), m_inverseCellSize(0.0f), m_entityCount(0), m_queryStamp(0),
+  m_buckets(bucketCount + 1), m_bucketStamps(bucketCount + 1, 0)
+{
+	debug_assert ( bucketCount > 0, "Entity index must have at least one bucket!" );
+	SetCellSize ( cellSize );
+}
+//End EntityIndex::EntityIndex
+
+
+
+//=========================================================================
+//! @function    EntityIndex::SetCellSize
+//! @brief       Set the size of the grid cells, moving every entity to 
+//!				 the bucket of its new cell
+//!              
+//! @param       cellSize [in] Length of the side of a grid cell, in world units
+//!              
+//=========================================================================
+void EntityIndex::SetCellSize ( Float cellSize )
+{
+	debug_assert ( cellSize > 0.0f, "Entity index cell size must be positive!" );
+
+	m_cellSize = cellSize;
+	m_inverseCellSize = 1.0f / cellSize;
+
+	for ( BucketStore::iterator itr = m_buckets.begin(); itr != m_buckets.end(); ++itr )
+	{
+		itr->clear();
+	}
+
+	for ( UInt slot = 0; slot < m_entries.size(); ++slot )
+	{
+		if ( m_entries[slot].entity )
+		{
+			AddToBucket ( slot, BucketForEntry ( m_entries[slot] ) );
+		}
+	}
+}
+//End EntityIndex::SetCellSize
+
+
+
+//=========================================================================
+//! @function    EntityIndex::Insert
+//! @brief       Add an entity to the index
+//!              
+//! @param       entity [in] Entity to add
+//! @param       flags	[in] The entity's flags, which queries are filtered on
+//! @param       box	[in] World space bounding box of the entity
+//!              
+//! @return      Slot holding the entity, to pass to Update and Remove
+//=========================================================================
+UInt EntityIndex::Insert ( EntityNode* entity, const EntityFlagSet& flags, const Math::AxisAlignedBoundingBox& box )
+{
+	debug_assert ( entity, "Inserted a NULL entity into the entity index!" );
+
+	UInt slot = 0;
+
+	if ( m_freeSlots.empty() )
+	{
+		slot = static_cast<UInt>(m_entries.size());
+		m_entries.push_back( Entry() );
+	}
+	else
+	{
+		slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+
+	Entry& entry = m_entries[slot];
+	entry.entity = entity;
+	entry.flags = &flags;
+	SetBounds ( entry, box );
+
+	AddToBucket ( slot, BucketForEntry ( entry ) );
+	++m_entityCount;
+
+	return slot;
+}
+//End EntityIndex::Insert
+
+
+
+//=========================================================================
+//! @function    EntityIndex::Update
+//! @brief       Update the bounds of an entity after it has moved
+//!              
+//!				 The entity only changes bucket if its centre has moved into
+//!				 a cell that hashes to a different bucket
+//!
+//! @param       slot	[in] Slot returned by Insert
+//! @param       box	[in] New world space bounding box of the entity
+//!              
+//=========================================================================
+void EntityIndex::Update ( UInt slot, const Math::AxisAlignedBoundingBox& box )
+{
+	debug_assert ( (slot < m_entries.size()) && m_entries[slot].entity, "Updated an empty entity index slot!" );
+
+	Entry& entry = m_entries[slot];
+	SetBounds ( entry, box );
+
+	const UInt bucket = BucketForEntry ( entry );
+
+	if ( bucket != entry.bucket )
+	{
+		RemoveFromBucket ( slot );
+		AddToBucket ( slot, bucket );
+	}
+}
+//End EntityIndex::Update
+
+
+
+//=========================================================================
+//! @function    EntityIndex::Remove
+//! @brief       Remove an entity from the index
+//!              
+//! @param       slot [in] Slot returned by Insert
+//=========================================================================
+void EntityIndex::Remove ( UInt slot )
+{
+	debug_assert ( (slot < m_entries.size()) && m_entries[slot].entity, "Removed an empty entity index slot!" );
+
+	RemoveFromBucket ( slot );
+
+	m_entries[slot].entity = 0;
+	m_freeSlots.push_back( slot );
+	--m_entityCount;
+}
+//End EntityIndex::Remove
+
+
+
+//=========================================================================
+//! @function    EntityIndex::Query
+//! @brief       Find the entities whose bounding spheres intersect a sphere
+//!              
+//! @param       sphere [in]	World space sphere to query
+//! @param       filter [in]	Flags the entities must have
+//! @param       result [out]	List the entities are appended to
+//=========================================================================
+void EntityIndex::Query ( const Math::BoundingSphere3D& sphere, const EntityQueryFilter& filter, EntityQueryResult& result )
+{
+	const Math::Vector3D& position = sphere.GetPosition();
+	const Float centre[3] = { position.X(), position.Y(), position.Z() };
+	const Float radius = sphere.Radius();
+
+	const Float minCorner[3] = { centre[0] - radius, centre[1] - radius, centre[2] - radius };
+	const Float maxCorner[3] = { centre[0] + radius, centre[1] + radius, centre[2] + radius };
+
+	Core::ScopedLock lock ( m_queryLock );
+
+	GatherBuckets ( minCorner, maxCorner );
+
+	for ( Bucket::const_iterator bucket = m_queryBuckets.begin(); bucket != m_queryBuckets.end(); ++bucket )
+	{
+		const Bucket& slots = m_buckets[*bucket];
+
+		for ( Bucket::const_iterator slot = slots.begin(); slot != slots.end(); ++slot )
+		{
+			const Entry& entry = m_entries[*slot];
+
+			const Float dx = entry.centre[0] - centre[0];
+			const Float dy = entry.centre[1] - centre[1];
+			const Float dz = entry.centre[2] - centre[2];
+			const Float reach = entry.radius + radius;
+
+			if ( ((dx * dx) + (dy * dy) + (dz * dz) <= (reach * reach)) && filter.Accepts ( *entry.flags ) )
+			{
+				result.push_back( entry.entity );
+			}
+		}
+	}
+}
+//End EntityIndex::Query
+
+
+
+//=========================================================================
+//! @function    EntityIndex::Query
+//! @brief       Find the entities whose bounding boxes intersect a box
+//!              
+//! @param       box	[in]	World space box to query
+//! @param       filter [in]	Flags the entities must have
+//! @param       result [out]	List the entities are appended to
+//=========================================================================
+void EntityIndex::Query ( const Math::AxisAlignedBoundingBox& box, const EntityQueryFilter& filter, EntityQueryResult& result )
+{
+	const Math::Vector3D boxMin = box.GetCorner( Math::AxisAlignedBoundingBox::MIN_X_MIN_Y_MIN_Z );
+	const Math::Vector3D boxMax = box.GetCorner( Math::AxisAlignedBoundingBox::MAX_X_MAX_Y_MAX_Z );
+
+	const Float minCorner[3] = { boxMin.X(), boxMin.Y(), boxMin.Z() };
+	const Float maxCorner[3] = { boxMax.X(), boxMax.Y(), boxMax.Z() };
+
+	Core::ScopedLock lock ( m_queryLock );
+
+	GatherBuckets ( minCorner, maxCorner );
+
+	for ( Bucket::const_iterator bucket = m_queryBuckets.begin(); bucket != m_queryBuckets.end(); ++bucket )
+	{
+		const Bucket& slots = m_buckets[*bucket];
+
+		for ( Bucket::const_iterator slot = slots.begin(); slot != slots.end(); ++slot )
+		{
+			const Entry& entry = m_entries[*slot];
+
+			if (   (entry.centre[0] + entry.halfExtent[0] >= minCorner[0]) && (entry.centre[0] - entry.halfExtent[0] <= maxCorner[0])
+				&& (entry.centre[1] + entry.halfExtent[1] >= minCorner[1]) && (entry.centre[1] - entry.halfExtent[1] <= maxCorner[1])
+				&& (entry.centre[2] + entry.halfExtent[2] >= minCorner[2]) && (entry.centre[2] - entry.halfExtent[2] <= maxCorner[2])
+				&& filter.Accepts ( *entry.flags ) )
+			{
+				result.push_back( entry.entity );
+			}
+		}
+	}
+}
+//End EntityIndex::Query
+
+
+
+//=========================================================================
+//! @function    EntityIndex::Query
+//! @brief       Find the entities whose bounding boxes are hit by a line segment
+//!              
+//!				 Only the cells overlapped by the segment's bounding box are visited,
+//!				 so long diagonal rays visit more buckets than they need to
+//!
+//! @param       ray			[in]	World space line segment, from P0 to P1
+//! @param		 sortResults	[in]	Sort the entities by where the ray enters them
+//! @param       filter			[in]	Flags the entities must have
+//! @param       result			[out]	List the entities are appended to
+//=========================================================================
+void EntityIndex::Query ( const Math::ParametricLine3D& ray, bool sortResults, const EntityQueryFilter& filter, 
+						  EntityQueryResult& result )
+{
+	const Float origin[3]	 = { ray.P0().X(), ray.P0().Y(), ray.P0().Z() };
+	const Float direction[3] = { ray.P1().X() - origin[0], ray.P1().Y() - origin[1], ray.P1().Z() - origin[2] };
+
+	const Float minCorner[3] = { std::min(origin[0], ray.P1().X()), std::min(origin[1], ray.P1().Y()), std::min(origin[2], ray.P1().Z()) };
+	const Float maxCorner[3] = { std::max(origin[0], ray.P1().X()), std::max(origin[1], ray.P1().Y()), std::max(origin[2], ray.P1().Z()) };
+
+	Core::ScopedLock lock ( m_queryLock );
+
+	GatherBuckets ( minCorner, maxCorner );
+
+	m_candidates.clear();
+
+	for ( Bucket::const_iterator bucket = m_queryBuckets.begin(); bucket != m_queryBuckets.end(); ++bucket )
+	{
+		const Bucket& slots = m_buckets[*bucket];
+
+		for ( Bucket::const_iterator slot = slots.begin(); slot != slots.end(); ++slot )
+		{
+			const Entry& entry = m_entries[*slot];
+			Candidate candidate;
+
+			if ( RayHitsBox ( origin, direction, entry.centre, entry.halfExtent, candidate.distance ) 
+				 && filter.Accepts ( *entry.flags ) )
+			{
+				candidate.entity = entry.entity;
+				m_candidates.push_back( candidate );
+			}
+		}
+	}
+
+	if ( sortResults )
+	{
+		std::sort ( m_candidates.begin(), m_candidates.end() );
+	}
+
+	for ( CandidateStore::const_iterator itr = m_candidates.begin(); itr != m_candidates.end(); ++itr )
+	{
+		result.push_back( itr->entity );
+	}
+}
+//End EntityIndex::Query
+
+
+
+//=========================================================================
+//! @function    EntityIndex::QueryNearest
+//! @brief       Find the entities closest to a point
+//!              
+//!				 Entities are ordered by the distance from the point to the centre
+//!				 of their bounding box. Only entities whose bounding spheres come
+//!				 within maxDistance of the point are considered
+//!
+//! @param       point			[in]	World space point
+//! @param       count			[in]	Maximum number of entities to return
+//! @param       maxDistance	[in]	Search radius
+//! @param       filter			[in]	Flags the entities must have
+//! @param       result			[out]	List the entities are appended to, nearest first
+//=========================================================================
+void EntityIndex::QueryNearest ( const Math::Vector3D& point, UInt count, Float maxDistance, 
+								 const EntityQueryFilter& filter, EntityQueryResult& result )
+{
+	const Float centre[3] = { point.X(), point.Y(), point.Z() };
+
+	const Float minCorner[3] = { centre[0] - maxDistance, centre[1] - maxDistance, centre[2] - maxDistance };
+	const Float maxCorner[3] = { centre[0] + maxDistance, centre[1] + maxDistance, centre[2] + maxDistance };
+
+	Core::ScopedLock lock ( m_queryLock );
+
+	GatherBuckets ( minCorner, maxCorner );
+
+	m_candidates.clear();
+
+	for ( Bucket::const_iterator bucket = m_queryBuckets.begin(); bucket != m_queryBuckets.end(); ++bucket )
+	{
+		const Bucket& slots = m_buckets[*bucket];
+
+		for ( Bucket::const_iterator slot = slots.begin(); slot != slots.end(); ++slot )
+		{
+			const Entry& entry = m_entries[*slot];
+
+			const Float dx = entry.centre[0] - centre[0];
+			const Float dy = entry.centre[1] - centre[1];
+			const Float dz = entry.centre[2] - centre[2];
+			const Float distanceSquared = (dx * dx) + (dy * dy) + (dz * dz);
+			const Float reach = entry.radius + maxDistance;
+
+			if ( (distanceSquared <= (reach * reach)) && filter.Accepts ( *entry.flags ) )
+			{
+				Candidate candidate;
+				candidate.distance = distanceSquared;
+				candidate.entity = entry.entity;
+				m_candidates.push_back( candidate );
+			}
+		}
+	}
+
+	const UInt resultCount = std::min ( count, static_cast<UInt>(m_candidates.size()) );
+	std::partial_sort ( m_candidates.begin(), m_candidates.begin() + resultCount, m_candidates.end() );
+
+	for ( UInt i = 0; i < resultCount; ++i )
+	{
+		result.push_back( m_candidates[i].entity );
+	}
+}
+//End EntityIndex::QueryNearest
+
+
+
+//=========================================================================
+//! @function    EntityIndex::SetBounds
+//! @brief       Store the centre, half extents and bounding sphere radius of a box in an entry
+//!              
+//! @param       entry	[out]	Entry to update
+//! @param       box	[in]	World space bounding box
+//=========================================================================
+void EntityIndex::SetBounds ( EntityIndex::Entry& entry, const Math::AxisAlignedBoundingBox& box ) const
+{
+	const Math::Vector3D centre = box.GetCentre();
+
+	entry.centre[0] = centre.X();
+	entry.centre[1] = centre.Y();
+	entry.centre[2] = centre.Z();
+
+	entry.halfExtent[0] = box.ExtentX() * 0.5f;
+	entry.halfExtent[1] = box.ExtentY() * 0.5f;
+	entry.halfExtent[2] = box.ExtentZ() * 0.5f;
+
+	entry.radius = Math::Sqrt ( (entry.halfExtent[0] * entry.halfExtent[0]) 
+							  + (entry.halfExtent[1] * entry.halfExtent[1]) 
+							  + (entry.halfExtent[2] * entry.halfExtent[2]) );
+}
+//End EntityIndex::SetBounds
+
+
+
+//=========================================================================
+//! @function    EntityIndex::BucketForEntry
+//! @brief       Get the bucket an entry belongs in
+//!              
+//! @param       entry [in] Entry with up to date bounds
+//!              
+//! @return      The bucket of the cell holding the entry's centre, or the
+//!				 oversized bucket if the entry is too large for a cell
+//=========================================================================
+UInt EntityIndex::BucketForEntry ( const EntityIndex::Entry& entry ) const
+{
+	if ( entry.radius > (m_cellSize * 0.5f) )
+	{
+		return static_cast<UInt>(m_buckets.size() - 1);
+	}
+
+	return HashCell ( CellCoordinate ( entry.centre[0] ), 
+					  CellCoordinate ( entry.centre[1] ), 
+					  CellCoordinate ( entry.centre[2] ) );
+}
+//End EntityIndex::BucketForEntry
+
+
+
+//=========================================================================
+//! @function    EntityIndex::AddToBucket
+//! @brief       Append a slot to a bucket
+//!              
+//! @param       slot	[in] Slot to add
+//! @param       bucket [in] Bucket to add it to
+//=========================================================================
+void EntityIndex::AddToBucket ( UInt slot, UInt bucket )
+{
+	Entry& entry = m_entries[slot];
+
+	entry.bucket = bucket;
+	entry.bucketPosition = static_cast<UInt>(m_buckets[bucket].size());
+
+	m_buckets[bucket].push_back( slot );
+}
+//End EntityIndex::AddToBucket
+
+
+
+//=========================================================================
+//! @function    EntityIndex::RemoveFromBucket
+//! @brief       Remove a slot from its bucket, by moving the last slot
+//!				 in the bucket into its place
+//!              
+//! @param       slot [in] Slot to remove
+//=========================================================================
+void EntityIndex::RemoveFromBucket ( UInt slot )
+{
+	const Entry& entry = m_entries[slot];
+	Bucket& bucket = m_buckets[entry.bucket];
+
+	const UInt last = bucket.back();
+	bucket[entry.bucketPosition] = last;
+	m_entries[last].bucketPosition = entry.bucketPosition;
+
+	bucket.pop_back();
+}
+//End EntityIndex::RemoveFromBucket
+
+
+
+//=========================================================================
+//! @function    EntityIndex::GatherBuckets
+//! @brief       Fill m_queryBuckets with every bucket that may hold an entity
+//!				 touching a box, each one once
+//!              
+//! @param       minCorner [in] Minimum corner of the world space query box
+//! @param       maxCorner [in] Maximum corner of the world space query box
+//=========================================================================
+void EntityIndex::GatherBuckets ( const Float minCorner[3], const Float maxCorner[3] )
+{
+	++m_queryStamp;
+
+	//The stamp has wrapped around, so reset the bucket stamps to avoid
+	//buckets being skipped because they hold a stamp from 4 billion queries ago
+	if ( m_queryStamp == 0 )
+	{
+		std::fill ( m_bucketStamps.begin(), m_bucketStamps.end(), 0 );
+		m_queryStamp = 1;
+	}
+
+	m_queryBuckets.clear();
+
+	const UInt oversizedBucket = static_cast<UInt>(m_buckets.size() - 1);
+	m_queryBuckets.push_back( oversizedBucket );
+
+	//Entities can hang half a cell outside the cell that holds them
+	const Float looseness = m_cellSize * 0.5f;
+
+	const Int minX = CellCoordinate ( minCorner[0] - looseness );
+	const Int minY = CellCoordinate ( minCorner[1] - looseness );
+	const Int minZ = CellCoordinate ( minCorner[2] - looseness );
+	const Int maxX = CellCoordinate ( maxCorner[0] + looseness );
+	const Int maxY = CellCoordinate ( maxCorner[1] + looseness );
+	const Int maxZ = CellCoordinate ( maxCorner[2] + looseness );
+
+	const UInt64 cellCount = static_cast<UInt64>(maxX - minX + 1)
+						   * static_cast<UInt64>(maxY - minY + 1)
+						   * static_cast<UInt64>(maxZ - minZ + 1);
+
+	//If the query covers more cells than there are buckets, every bucket is visited anyway
+	if ( cellCount >= static_cast<UInt64>(oversizedBucket) )
+	{
+		for ( UInt bucket = 0; bucket < oversizedBucket; ++bucket )
+		{
+			if ( !m_buckets[bucket].empty() )
+			{
+				m_queryBuckets.push_back( bucket );
+			}
+		}
+
+		return;
+	}
+
+	for ( Int z = minZ; z <= maxZ; ++z )
+	{
+		for ( Int y = minY; y <= maxY; ++y )
+		{
+			for ( Int x = minX; x <= maxX; ++x )
+			{
+				const UInt bucket = HashCell ( x, y, z );
+
+				if ( (m_bucketStamps[bucket] != m_queryStamp) && (!m_buckets[bucket].empty()) )
+				{
+					m_bucketStamps[bucket] = m_queryStamp;
+					m_queryBuckets.push_back( bucket );
+				}
+			}
+		}
+	}
+}
+//End EntityIndex::GatherBuckets
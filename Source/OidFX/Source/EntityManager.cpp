@@ -122,38 +122,40 @@ boost::shared_ptr<EntityNode> EntityManager::SpawnEntity ( const Char* type, con
 boost::shared_ptr<EntityNode> EntityManager::SpawnEntity ( UInt type, const Math::Vector3D& position )
 {
 	
-	//This might be slow the first few times we spawn an entity
-	//with a type we've not seen before, as it'll construct a new std::list
-	//but typically this will happen at load-time anyway, so I don't think it's a huge problem.
-	if ( m_unspawnedEntities[type].empty() )
+	//This might be slow the first time we spawn an entity with a type we've not 
+	//seen before, or when the pool for the type runs out. Reserve entities at load time to avoid it
+	EntityPool& pool = m_pools[type];
+
+	if ( pool.unspawned.empty() )
 	{
 		//Create a new entity of the type specified by calling ReserveEntity. 
-		//When this call completes, there will be an entity of the appropriate type in the unspawned list
+		//When this call completes, there will be an entity of the appropriate type in the unspawned pool
 		ReserveEntity ( type, 1 );
 	}
 
-	//Get an iterator to the entity
-	EntityList::iterator itr = m_unspawnedEntities[type].begin();
+	boost::shared_ptr<EntityNode> entity = pool.unspawned.back();
 
 	//Spawn the existing entity
-	(*itr)->Spawn( position );
+	entity->Spawn( position );
 
-	//Move the entity from the unspawned list to the spawned list
-	Core::SpliceOntoEnd ( itr, m_unspawnedEntities[type], m_spawnedEntities[type] );
+	//Move the entity from the unspawned pool to the spawned pool. ReserveEntity
+	//made room for every entity of the type, so this won't allocate
+	pool.unspawned.pop_back();
+	pool.spawned.push_back ( entity );
 
 	//Register the entity with the collision manager if necessary
-	if ( (!(*itr)->IsFlagSet( EF_NOCOLLIDE )) &&
-		 (!(*itr)->IsFlagSet( EF_STATIC )) )
+	if ( (!entity->IsFlagSet( EF_NOCOLLIDE )) &&
+		 (!entity->IsFlagSet( EF_STATIC )) )
 	{
-		m_collisionManager.AddCollider( itr->get() );
+		m_collisionManager.AddCollider( entity.get() );
 	}
 
 
 	//Add the entity to the scene graph
-	m_scene.Root()->AddChild( *itr );
+	m_scene.Root()->AddChild( entity );
 
 	//Return the entity
-	return *itr;
+	return entity;
 }
 //End EntityManager::SpawnEntity
 
@@ -170,13 +172,20 @@ void EntityManager::ReserveEntity ( UInt type, UInt count )
 {
 	debug_assert ( count, "Tried to reserve 0 entities" );
 
+	EntityPool& pool = m_pools[type];
+
 	for ( UInt i=0; i < count; ++i )
 	{
-		m_unspawnedEntities[type].push_back( m_entityFactory->Create(type) );
-		debug_assert ( m_unspawnedEntities[type].back(), "Error, entity was not created!" 
+		pool.unspawned.push_back( m_entityFactory->Create(type) );
+		debug_assert ( pool.unspawned.back(), "Error, entity was not created!" 
 						"Are you sure the type was registered with the EntityFactory?" );
 	}
 
+	//Make room for every entity of the type in both stores, so spawning and despawning never allocate
+	const size_t total = pool.spawned.size() + pool.unspawned.size();
+	pool.spawned.reserve ( total );
+	pool.unspawned.reserve ( total );
+
 }
 //End EntityManager::ReserveEntity
 
@@ -185,24 +194,16 @@ void EntityManager::ReserveEntity ( UInt type, UInt count )
 //=========================================================================
 //! @function    EntityManager::Update
 //! @brief       Update the entity manager, moving any newly despawned entities
-//!				 to the unspawned list
+//!				 to the unspawned pool
 //=========================================================================
 void EntityManager::Update ( )
 {
 
-	//Go through each spawned entity list, making sure that there are no
-	//unspawned entities in the list, moving any unspawned entities to the appropriate list
-	//
-	//This approach isn't ideal, but this whole system will be getting redesigned 
-	//when I make the next version of this engine, after I've submitted my demo
-	//
-	//This approach should work fine considering the small number of entities my
-	//demo will have on screen at any one time
-	for ( EntityListMapping::iterator itr = m_spawnedEntities.begin();
-		  itr != m_spawnedEntities.end();
+	for ( EntityPoolMapping::iterator itr = m_pools.begin();
+		  itr != m_pools.end();
 		  ++itr )
 	{
-		UpdateSpawnedList ( itr->first, itr->second );
+		UpdatePool ( itr->second );
 	}	
 
 }
@@ -210,52 +211,39 @@ void EntityManager::Update ( )
 
 
 //=========================================================================
-//! @function    EntityManager::UpdateSpawnedList
-//! @brief       Update the spawned list for a specific type, moving any
-//!				 entities that have recently despawned, to the unspawned list					
+//! @function    EntityManager::UpdatePool
+//! @brief       Despawn any entities in a pool that are waiting to despawn, and
+//!				 move every despawned entity to the unspawned pool
 //!
-//! @param		 type [in]	Type of entities held by the entity list
-//! @param		 list [in]	List to update
+//! @param		 pool [in]	Pool to update
 //! 
 //=========================================================================
-void EntityManager::UpdateSpawnedList ( UInt type, EntityManager::EntityList& list )
+void EntityManager::UpdatePool ( EntityManager::EntityPool& pool )
 {
-	EntityList::iterator itr = list.begin();
+	UInt index = 0;
 
-	while ( itr != list.end() )
+	while ( index < pool.spawned.size() )
 	{
-		if ( (*itr)->IsFlagSet( EF_DESPAWNPENDING ) )
+		EntityNode& entity = *pool.spawned[index];
+
+		if ( entity.IsFlagSet( EF_DESPAWNPENDING ) )
 		{
-			(*itr)->Despawn();
+			entity.Despawn();
 		}
 
-		if ( !(*itr)->IsFlagSet( EF_SPAWNED ) )
+		if ( !entity.IsFlagSet( EF_SPAWNED ) )
 		{
-			//Get the iterator after itr
-			EntityList::iterator temp = itr;
-			++temp;
-
-			//Move itr from the spawned Entity list to the unspawned Entity list
-			Core::SpliceOntoEnd ( itr, list, m_unspawnedEntities[type] );
-
-			//Remove itr from the collision manager, if necessary
-			if ( (!(*itr)->IsFlagSet(EF_NOCOLLIDE)) && (!(*itr)->IsFlagSet(EF_STATIC)) )
-			{
-				m_collisionManager.RemoveCollider( itr->get() );
-			}
-
-			//Set itr to temp, as the item referenced by itr is in another list now
-			itr = temp;
-
+			//The last spawned entity takes this one's place, so look at the same index again
+			ReleaseSpawnedEntity ( pool, index );
 		}
 		else
 		{
-			++itr;
+			++index;
 		}
 	}	
 
 }
-//End EntityManager::UpdateSpawnedList
+//End EntityManager::UpdatePool
 
 
 //=========================================================================
@@ -266,12 +254,12 @@ void EntityManager::UpdateSpawnedList ( UInt type, EntityManager::EntityList& li
 //=========================================================================
 void EntityManager::DespawnAll ()
 {
-	//Go through each spawned entity list, despawning all entities
-	for ( EntityListMapping::iterator itr = m_spawnedEntities.begin();
-		  itr != m_spawnedEntities.end();
+	//Go through each pool, despawning all entities
+	for ( EntityPoolMapping::iterator itr = m_pools.begin();
+		  itr != m_pools.end();
 		  ++itr )
 	{
-		DespawnEntitiesInList ( itr->first, itr->second );
+		DespawnEntitiesInPool ( itr->second );
 	}	
 }
 //End EntityManager::DespawnAll
@@ -279,39 +267,55 @@ void EntityManager::DespawnAll ()
 
 
 //=========================================================================
-//! @function    EntityManager::DespawnEntitiesInList
-//! @brief       Despawn all entities in an entity list
+//! @function    EntityManager::DespawnEntitiesInPool
+//! @brief       Despawn all entities in a pool
 //!              
-//! @param		 type [in] Type ID of the entities in the list
-//! @param		 list [in] List which stores the entities
+//! @param		 pool [in] Pool which stores the entities
 //!              
 //=========================================================================
-void EntityManager::DespawnEntitiesInList( UInt type, EntityManager::EntityList& list )
+void EntityManager::DespawnEntitiesInPool( EntityManager::EntityPool& pool )
 {
-	EntityList::iterator itr = list.begin();
-
-	while ( itr != list.end() )
+	//Work back from the end, so no entity has to be moved to fill a gap
+	while ( !pool.spawned.empty() )
 	{
-		if ( (*itr)->IsFlagSet( EF_SPAWNED ) )
+		const UInt last = static_cast<UInt>(pool.spawned.size()) - 1;
+
+		if ( pool.spawned[last]->IsFlagSet( EF_SPAWNED ) )
 		{
-			(*itr)->Despawn();
+			pool.spawned[last]->Despawn();
 		}
 
-		//Get the iterator after itr
-		EntityList::iterator temp = itr;
-		++temp;
+		ReleaseSpawnedEntity ( pool, last );
+	}	
+}
+//End EntityManager::DespawnEntitiesInPool
 
-		//Move itr from the spawned Entity list to the unspawned Entity list
-		Core::SpliceOntoEnd ( itr, list, m_unspawnedEntities[type] );
 
-		//Remove itr from the collision manager, if necessary
-		if ( (!(*itr)->IsFlagSet(EF_NOCOLLIDE)) && (!(*itr)->IsFlagSet(EF_STATIC)) )
-		{
-			m_collisionManager.RemoveCollider( itr->get() );
-		}
 
-		//Set itr to temp, as the item referenced by itr is in another list now
-		itr = temp;
-	}	
+//=========================================================================
+//! @function    EntityManager::ReleaseSpawnedEntity
+//! @brief       Move a despawned entity from the spawned to the unspawned pool
+//!              
+//!				 The last spawned entity is moved into its place, and it is removed
+//!				 from the collision manager, if it was a collider
+//!
+//! @param		 pool  [in] Pool which stores the entity
+//! @param		 index [in] Index of the entity in the spawned pool
+//=========================================================================
+void EntityManager::ReleaseSpawnedEntity ( EntityManager::EntityPool& pool, UInt index )
+{
+	debug_assert ( index < pool.spawned.size(), "Invalid spawned entity index!" );
+
+	boost::shared_ptr<EntityNode> entity = pool.spawned[index];
+
+	pool.spawned[index] = pool.spawned.back();
+	pool.spawned.pop_back();
+
+	pool.unspawned.push_back ( entity );
+
+	if ( entity->IsCollider() )
+	{
+		m_collisionManager.RemoveCollider( entity.get() );
+	}
 }
-//End EntityManager::DespawnEntitiesInList
\ No newline at end of file
+//End EntityManager::ReleaseSpawnedEntity
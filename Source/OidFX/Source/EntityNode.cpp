@@ -38,6 +38,9 @@
 #include "OidFX/VisibleObjectList.h"
 #include "OidFX/Constants.h"
 #include "OidFX/EntityManager.h"
+#include "OidFX/EntityIndex.h"
+#include "OidFX/CollisionManager.h"
+#include "OidFX/SceneCommandBuffer.h"
 
 
 using namespace OidFX;
@@ -67,8 +70,16 @@ EntityNode::EntityNode ( Scene& scene,
    m_name(name), 
    m_health(100.0f), 
    m_deathTimer(0.0f),
+   m_hasThought(false),
+   m_generation(0),
    m_preferredCollisionType(COLLISIONTYPE_SPHERE),
-   m_explosiveStrength(100.0f)
+   m_explosiveStrength(100.0f),
+   m_interpolatedObjectToParent(toWorld),
+   m_screenSize(1.0f),
+   m_physics(scene.GetEntityPhysics()),
+   m_physicsSlot(m_physics.Allocate(*this)),
+   m_indexSlot(EntityIndex::InvalidSlot),
+   m_colliderSlot(CollisionManager::InvalidSlot)
 {
 
 	//If there is a mesh filename, then load the mesh
@@ -82,6 +93,21 @@ EntityNode::EntityNode ( Scene& scene,
 
 
 
+//=========================================================================
+//! @function    EntityNode::~EntityNode
+//! @brief       EntityNode destructor
+//!              
+//!				 Returns the entity's physics slot and index slot to the scene
+//=========================================================================
+EntityNode::~EntityNode ( )
+{
+	LeaveEntityIndex ( );
+	m_physics.Free ( m_physicsSlot );
+}
+//End EntityNode::~EntityNode
+
+
+
 //=========================================================================
 //! @function    EntityNode::Spawn 
 //! @brief       Spawn an entity into the game world
@@ -91,7 +117,7 @@ EntityNode::EntityNode ( Scene& scene,
 //=========================================================================
 void EntityNode::Spawn ( const Math::Vector3D& spawnPoint)
 {
-	m_position = spawnPoint;
+	Position() = spawnPoint;
 
 	//If the entity is to spawn on the ground, then cast a ray
 	//through the scene, to find the proper height to spawn the entity at
@@ -100,8 +126,8 @@ void EntityNode::Spawn ( const Math::Vector3D& spawnPoint)
 	{
 
 		//Cast a ray through the terrain to get the terrain height
-		Math::ParametricLine3D ray( Math::Vector3D(m_position.X(), 10000.0f, m_position.Z()), 
-									Math::Vector3D(m_position.X(), -10000.0f, m_position.Z()));
+		Math::ParametricLine3D ray( Math::Vector3D(spawnPoint.X(), 10000.0f, spawnPoint.Z()), 
+									Math::Vector3D(spawnPoint.X(), -10000.0f, spawnPoint.Z()));
 
 		SceneQueryResult results;
 		m_scene.QueryScene ( ray, true, results );
@@ -115,8 +141,8 @@ void EntityNode::Spawn ( const Math::Vector3D& spawnPoint)
 
 			std::clog << __FUNCTION__ << ": ray intersects " << results.size() << " triangles" << std::endl;
 
-			ray.PointOnLine( results[0], m_position );
-			std::clog << __FUNCTION__ << ": Spawned entity on ground at position " << m_position 
+			ray.PointOnLine( results[0], Position() );
+			std::clog << __FUNCTION__ << ": Spawned entity on ground at position " << Position() 
 					  << ". t on line = " << results[0] << std::endl;
 		}
 	}
@@ -125,12 +151,12 @@ void EntityNode::Spawn ( const Math::Vector3D& spawnPoint)
 
 
 	//Initialise physics 
-	m_velocity.Set ( 0.0f, 0.0f, 0.0f );
-	m_acceleration.Set ( 0.0f, 0.0f, 0.0f );
-	m_angularVelocity.Set(0.0f, 0.0f, 0.0f );
-	m_angularAcceleration.Set(0.0f, 0.0f, 0.0f);
+	Velocity().Set ( 0.0f, 0.0f, 0.0f );
+	Acceleration().Set ( 0.0f, 0.0f, 0.0f );
+	AngularVelocity().Set(0.0f, 0.0f, 0.0f );
+	AngularAcceleration().Set(0.0f, 0.0f, 0.0f);
 
-	m_orientation = Math::Quaternion(Math::Vector3D::XAxis, 0);
+	Orientation() = Math::Quaternion(Math::Vector3D::XAxis, 0);
 
 	m_health = 100.0f;
 
@@ -141,90 +167,206 @@ void EntityNode::Spawn ( const Math::Vector3D& spawnPoint)
 
 	OnSpawn( spawnPoint );
 
-	UpdatePhysics(0.0f);
+	//The transform would otherwise not be written until the next physics pass
+	SetLocalTransform ( Orientation(), Position() );
+
+	//Don't draw the entity moving from wherever it was before it spawned
+	m_physics.Snap ( m_physicsSlot );
+	SetInterpolatedTransform ( Orientation(), Position() );
 }
 //End EntityNode::Spawn 
 
 
 
 //=========================================================================
-//! @function    EntityNode::UpdatePhysics
-//! @brief       Update position, velocity and acceleration
-//!				 also simulate the effects of friction and gravity
+//! @function    EntityNode::SetLocalTransform
+//! @brief       Rebuild the object to world, and object from world transforms
+//!				 from an orientation and position
 //!              
-//! @param       timeElapsedInSeconds [in] 
-//!              
-//! @return      
-//! @throw       
+//! @param       orientation [in] Orientation of the entity
+//! @param       position	 [in] Position of the entity
 //=========================================================================
-void EntityNode::UpdatePhysics ( Float timeElapsedInSeconds )
+void EntityNode::SetLocalTransform ( const Math::Quaternion& orientation, const Math::Vector3D& position )
 {
-	static Core::ConsoleFloat friction ( "phys_friction", 0.01f );
-	static Core::ConsoleFloat gravity  ( "phys_gravity", 0.98f * meters  );
+	Math::Matrix4x4 objectToWorld ( orientation );
+	objectToWorld.Translate ( position );
 
-	if ( !IsFlagSet ( EF_ANTIGRAVITY ) )
+	//Entities at rest keep their transforms, so nothing below them is updated
+	if ( objectToWorld == m_objectToWorld )
 	{
-		//Simulate the effects of gravity
-		m_acceleration += Math::Vector3D ( 0.0f, -gravity, 0.0f );
+		return;
 	}
 
-	m_velocity += m_acceleration * timeElapsedInSeconds;
+	m_objectToWorld = objectToWorld;
 
-	m_velocity += -m_velocity * friction;
+	//Rotation and translation only, so the inverse is just a transpose
+	m_objectFromWorld = m_objectToWorld;
+	m_objectFromWorld.InvertRigid ( );
 
-	m_position += m_velocity;
+	MarkTransformDirty ( );
+}
+//End EntityNode::SetLocalTransform
 
-	//Update rotational velocity
-	m_angularVelocity += m_angularAcceleration * timeElapsedInSeconds;
-	m_angularVelocity += -m_angularVelocity * friction;
 
-	Math::Quaternion rotation ( m_angularVelocity.Z(), m_angularVelocity.Y(), m_angularVelocity.X() );
 
-	m_orientation *= rotation;
+//=========================================================================
+//! @function    EntityNode::SetInterpolatedTransform
+//! @brief       Set the local transform the entity is drawn with, between physics ticks
+//!              
+//! @param       orientation [in] Interpolated orientation of the entity
+//! @param       position	 [in] Interpolated position of the entity
+//=========================================================================
+void EntityNode::SetInterpolatedTransform ( const Math::Quaternion& orientation, const Math::Vector3D& position )
+{
+	m_interpolatedObjectToParent = Math::Matrix4x4 ( orientation );
+	m_interpolatedObjectToParent.Translate ( position );
 }
-//End EntityNode::UpdatePhysics
+//End EntityNode::SetInterpolatedTransform
 
 
 
 //=========================================================================
-//! @function    EntityNode::Update
-//! @brief       Update the entity
-//!              
-//! @param       toWorldStack 
-//! @param       fromWorldStack 
-//! @param       timeElapsedInSeconds 
+//! @function    EntityNode::InterpolatedObjectToWorld
+//! @brief       Get the object to world transform to draw the entity with
+//!
+//!				 Concatenated with the interpolated transform of the parent, so that
+//!				 entities attached to other entities don't lag behind them
 //!              
-//! @return      
-//! @throw       
+//! @return      The interpolated object to world transform
+//=========================================================================
+Math::Matrix4x4 EntityNode::InterpolatedObjectToWorld ( ) const
+{
+	if ( m_parent == 0 )
+	{
+		return m_interpolatedObjectToParent;
+	}
+
+	return m_parent->InterpolatedObjectToWorld() * m_interpolatedObjectToParent;
+}
+//End EntityNode::InterpolatedObjectToWorld
+
+
+
+//=========================================================================
+//! @function    EntityNode::UpdatePhysicsMotion
+//! @brief       Tell the physics store whether the entity moves, and whether
+//!				 it is affected by gravity, after one of the flags that 
+//!				 decide that has changed
 //=========================================================================
-void EntityNode::Update ( Math::MatrixStack& toWorldStack,
-						 Math::MatrixStack& fromWorldStack,
-						 Float timeElapsedInSeconds )
+void EntityNode::UpdatePhysicsMotion ( )
 {
+	m_physics.SetMotion ( m_physicsSlot, 
+						  IsFlagSet(EF_SPAWNED) && (!IsFlagSet(EF_STATIC)),
+						  !IsFlagSet(EF_ANTIGRAVITY) );
+}
+//End EntityNode::UpdatePhysicsMotion
+
+
 
-	if ( (IsFlagSet(EF_SPAWNED)) && (!IsFlagSet(EF_STATIC)) )
+//=========================================================================
+//! @function    EntityNode::UpdateEntityIndex
+//! @brief       Move the entity to its new bounds in the scene's entity index
+//!
+//!				 Entities attached to other entities are left out of the index,
+//!				 as scene queries have never returned them
+//=========================================================================
+void EntityNode::UpdateEntityIndex ( )
+{
+	if ( (m_parent == 0) || (m_parent->NodeType() == NODETYPE_ENTITY) )
 	{
-		UpdatePhysics( timeElapsedInSeconds );
+		LeaveEntityIndex ( );
+		return;
+	}
 
-		m_orientation.Normalise();
+	if ( m_indexSlot == EntityIndex::InvalidSlot )
+	{
+		m_indexSlot = m_scene.GetEntityIndex().Insert ( this, m_flags, m_boundingBox );
 	}
+	else
+	{
+		m_scene.GetEntityIndex().Update ( m_indexSlot, m_boundingBox );
+	}
+}
+//End EntityNode::UpdateEntityIndex
 
-	m_objectToWorld = Math::Matrix4x4 ( m_orientation );
-	m_objectToWorld.Translate ( m_position );
 
-	m_objectFromWorld = Math::Matrix4x4 ( -m_orientation );
-	m_objectFromWorld.Translate ( -m_position );
 
-	SceneObject::Update( toWorldStack, fromWorldStack, timeElapsedInSeconds );
+//=========================================================================
+//! @function    EntityNode::LeaveEntityIndex
+//! @brief       Remove the entity from the scene's entity index, if it's in it
+//=========================================================================
+void EntityNode::LeaveEntityIndex ( )
+{
+	if ( m_indexSlot != EntityIndex::InvalidSlot )
+	{
+		m_scene.GetEntityIndex().Remove ( m_indexSlot );
+		m_indexSlot = EntityIndex::InvalidSlot;
+	}
+}
+//End EntityNode::LeaveEntityIndex
 
-	OnThink ( timeElapsedInSeconds );
 
-	m_acceleration.Set ( 0.0f, 0.0f, 0.0f );
-	m_angularAcceleration.Set ( 0.0f, 0.0f, 0.0f );
 
-	//Create a timer that despawns the entity shortly after death
+//=========================================================================
+//! @function    EntityNode::IsCollider
+//! @brief       Indicates whether the entity is registered with the collision manager
+//=========================================================================
+bool EntityNode::IsCollider ( ) const throw()
+{
+	return m_colliderSlot != CollisionManager::InvalidSlot;
+}
+//End EntityNode::IsCollider
+
+
+
+//=========================================================================
+//! @function    EntityNode::OnTransformChanged
+//! @brief       Move the entity's bounds, and its place in the entity index
+//!              
+//!				 Called by Update, which may run on an update job, so the entity 
+//!				 index is updated through the scene's command buffer. Entities
+//!				 that haven't moved are not updated at all
+//=========================================================================
+void EntityNode::OnTransformChanged ( )
+{
+	SceneObject::OnTransformChanged ( );
+
+	m_scene.Commands().UpdateEntityIndex ( *this );
+}
+//End EntityNode::OnTransformChanged
+
+
+
+//=========================================================================
+//! @function    EntityNode::Think
+//! @brief       Update the behaviour of the entity, and the entities attached to it
+//!              
+//!				 Called once all entities have been updated, so other entities can 
+//!				 be looked at, but not changed. This may run on an update job, so 
+//!				 changes to anything but the entity itself, and the entities attached
+//!				 to it, must go through the scene's command buffer.
+//!
+//!				 An entity's first Think is always on the thread that updates the scene,
+//!				 so console variables declared at the top of OnThink are created safely
+//!
+//! @param       timeElapsedInSeconds [in] Time elapsed since the last update
+//=========================================================================
+void EntityNode::Think ( Float timeElapsedInSeconds )
+{
 	static Core::ConsoleFloat deathtimeout ( "deathtimeout", 10.0f );
 
+	//Attached entities think first, as they did when they were updated by their parent
+	for ( iterator itr = ChildrenBegin(); itr != ChildrenEnd(); ++itr )
+	{
+		if ( (*itr)->NodeType() == NODETYPE_ENTITY )
+		{
+			static_cast<EntityNode&>(**itr).Think ( timeElapsedInSeconds );
+		}
+	}
+
+	OnThink ( timeElapsedInSeconds );
+
+	//Create a timer that despawns the entity shortly after death
 	if ( IsFlagSet(EF_DEAD) )
 	{
 		m_deathTimer += timeElapsedInSeconds;
@@ -242,8 +384,10 @@ void EntityNode::Update ( Math::MatrixStack& toWorldStack,
 	{	
 		m_deathTimer = 0.0f;
 	}
+
+	m_hasThought = true;
 }
-//End EntityNode::Update
+//End EntityNode::Think
 
 
 
@@ -272,6 +416,15 @@ void EntityNode::FillVisibleObjectList ( VisibleObjectList& visibleObjectList, c
 		{
 			//If we got here the object is in the camera's view frustum, so add it to the visible list
 			visibleObjectList.AddObject ( *this );		
+
+			//Estimate how much of the screen the entity covers, to pick the mesh LOD
+			const Float radius = 0.5f * Math::Sqrt ( (m_boundingBox.ExtentX() * m_boundingBox.ExtentX())
+												   + (m_boundingBox.ExtentY() * m_boundingBox.ExtentY())
+												   + (m_boundingBox.ExtentZ() * m_boundingBox.ExtentZ()) );
+
+			const Float distance = (camera.GetPosition() - m_boundingBox.GetCentre()).Length();
+
+			m_screenSize = (distance > radius) ? (radius / (distance * Math::Tan(camera.FOV() * 0.5f))) : 1.0f;
 		}
 	}
 
@@ -380,8 +533,8 @@ void EntityNode::OnDeath ( )
 void EntityNode::QueueForRendering ( Renderer::RenderQueue& queue )
 {
 
-	//Queue the mesh for rendering
-	m_mesh->QueueForRendering ( queue, m_concatObjectToWorld, m_lodLevel );
+	//Queue the mesh for rendering. The queue keeps its own copy of the matrix
+	m_mesh->QueueForRendering ( queue, InterpolatedObjectToWorld(), m_lodLevel, m_screenSize );
 
 }
 //End EntityNode::QueueForRendering
@@ -415,18 +568,19 @@ void EntityNode::Explode ( )
 
 	Math::Vector3D position = BoundingBox().GetCentre();
 
-	boost::shared_ptr<EntityNode> explosion = m_scene.GetEntityManager().SpawnEntity( "Explosion", position );
-	//explosion->SetVelocity( GetVelocity() );
-	explosion->SetExplosiveStrength( GetExplosiveStrength() );
+	EntityFlagSet explosionFlags;
 
 	if ( IsFlagSet(EF_ALLY) )
 	{
-		explosion->SetFlag(EF_ALLY);
+		explosionFlags.set(EF_ALLY);
 	}
 	else if ( IsFlagSet(EF_ENEMY) )
 	{
-		explosion->SetFlag(EF_ENEMY);
+		explosionFlags.set(EF_ENEMY);
 	}
+
+	//Entities may explode while they think, so the explosion is spawned once the update jobs are done
+	m_scene.Commands().SpawnEntity ( "Explosion", position, GetExplosiveStrength(), explosionFlags );
 }
 //End EntityNode::Explode
 
@@ -497,8 +651,9 @@ void EntityNode::QueryScene ( const Math::BoundingSphere3D& sphere, EntityQueryR
 //! @brief       Register an object to be notified when this entity dies
 //!              
 //!				 Note that the event connection will be severed when this
-//!				 entity is killed
-//!              
+//!				 entity is killed. An entity can kill itself while it thinks,
+//!				 so the handler may be called from an update job
+//!
 //! @param       handler [in]	Object to be notified of this entities death
 //!              
 //! @return      A connection to the death event of this entity
@@ -0,0 +1,333 @@
+//======================================================================================
+//! @file         EntityPhysics.cpp
+//! @brief        Structure of arrays store for entity rigid body state
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+
+#include "Core/Core.h"
+#include "OidFX/EntityPhysics.h"
+#include "OidFX/EntityNode.h"
+#include "OidFX/Constants.h"
+
+
+using namespace OidFX;
+
+
+
+namespace
+{
+	//=========================================================================
+	//! @function    NLerp
+	//! @brief       Normalised linear interpolation between two unit quaternions
+	//!
+	//!				 Orientations only change a little between two simulation ticks,
+	//!				 so this can't be told apart from a slerp, and needs no trig
+	//!              
+	//! @param       from	[in] Orientation at t = 0
+	//! @param       to		[in] Orientation at t = 1
+	//! @param       t		[in] Interpolation factor, 0 <= t <= 1
+	//!              
+	//! @return      The interpolated orientation
+	//=========================================================================
+	Math::Quaternion NLerp ( const Math::Quaternion& from, const Math::Quaternion& to, Float t )
+	{
+		const Float dot = (from.W() * to.W()) + (from.X() * to.X()) + (from.Y() * to.Y()) + (from.Z() * to.Z());
+
+		//q and -q are the same rotation, so take the shorter path
+		const Float sign = (dot < 0.0f) ? -1.0f : 1.0f;
+
+		Math::Quaternion result ( from.W() + ((to.W() * sign) - from.W()) * t,
+								  from.X() + ((to.X() * sign) - from.X()) * t,
+								  from.Y() + ((to.Y() * sign) - from.Y()) * t,
+								  from.Z() + ((to.Z() * sign) - from.Z()) * t );
+		result.Normalise();
+
+		return result;
+	}
+	//End NLerp
+}
+
+
+
+//=========================================================================
+//! @function    EntityPhysics::EntityPhysics
+//! @brief       EntityPhysics constructor
+//!              
+//! @param       reserveCount [in] Number of slots to reserve space for. 
+//!								   Slot references stay valid until this is exceeded
+//=========================================================================
+EntityPhysics::EntityPhysics ( UInt reserveCount )
+{
+	m_positions.reserve ( reserveCount );
+	m_orientations.reserve ( reserveCount );
+	m_velocities.reserve ( reserveCount );
+	m_accelerations.reserve ( reserveCount );
+	m_angularVelocities.reserve ( reserveCount );
+	m_angularAccelerations.reserve ( reserveCount );
+	m_previousPositions.reserve ( reserveCount );
+	m_previousOrientations.reserve ( reserveCount );
+	m_integrateMask.reserve ( reserveCount );
+	m_gravityMask.reserve ( reserveCount );
+	m_owners.reserve ( reserveCount );
+}
+//End EntityPhysics::EntityPhysics
+
+
+
+//=========================================================================
+//! @function    EntityPhysics::Allocate
+//! @brief       Allocate a slot for an entity
+//!
+//!				 The slot starts at rest at the origin, and doesn't move
+//!				 until SetMotion is called for it
+//!              
+//! @param       owner [in] Entity that owns the slot
+//!              
+//! @return      Index of the slot
+//=========================================================================
+UInt EntityPhysics::Allocate ( EntityNode& owner )
+{
+	const Math::Vector3D zero ( 0.0f, 0.0f, 0.0f );
+
+	m_positions.push_back ( zero );
+	m_orientations.push_back ( Math::Quaternion(Math::Vector3D::XAxis, 0) );
+	m_velocities.push_back ( zero );
+	m_accelerations.push_back ( zero );
+	m_angularVelocities.push_back ( zero );
+	m_angularAccelerations.push_back ( zero );
+	m_previousPositions.push_back ( zero );
+	m_previousOrientations.push_back ( Math::Quaternion(Math::Vector3D::XAxis, 0) );
+	m_integrateMask.push_back ( 0.0f );
+	m_gravityMask.push_back ( 0.0f );
+	m_owners.push_back ( &owner );
+
+	return SlotCount() - 1;
+}
+//End EntityPhysics::Allocate
+
+
+
+//=========================================================================
+//! @function    EntityPhysics::Free
+//! @brief       Free a slot
+//!
+//!				 The last slot is moved into the freed one to keep the arrays packed,
+//!				 and its owner is told its new slot index
+//!              
+//! @param       slot [in] Slot to free
+//=========================================================================
+void EntityPhysics::Free ( UInt slot )
+{
+	debug_assert ( slot < SlotCount(), "Invalid physics slot!" );
+
+	const UInt last = SlotCount() - 1;
+
+	if ( slot != last )
+	{
+		m_positions[slot]			 = m_positions[last];
+		m_orientations[slot]		 = m_orientations[last];
+		m_velocities[slot]			 = m_velocities[last];
+		m_accelerations[slot]		 = m_accelerations[last];
+		m_angularVelocities[slot]	 = m_angularVelocities[last];
+		m_angularAccelerations[slot] = m_angularAccelerations[last];
+		m_previousPositions[slot]	 = m_previousPositions[last];
+		m_previousOrientations[slot] = m_previousOrientations[last];
+		m_integrateMask[slot]		 = m_integrateMask[last];
+		m_gravityMask[slot]			 = m_gravityMask[last];
+		m_owners[slot]				 = m_owners[last];
+
+		m_owners[slot]->m_physicsSlot = slot;
+	}
+
+	m_positions.pop_back();
+	m_orientations.pop_back();
+	m_velocities.pop_back();
+	m_accelerations.pop_back();
+	m_angularVelocities.pop_back();
+	m_angularAccelerations.pop_back();
+	m_previousPositions.pop_back();
+	m_previousOrientations.pop_back();
+	m_integrateMask.pop_back();
+	m_gravityMask.pop_back();
+	m_owners.pop_back();
+}
+//End EntityPhysics::Free
+
+
+
+//=========================================================================
+//! @function    EntityPhysics::SetMotion
+//! @brief       Set whether a slot is integrated, and whether gravity affects it
+//!              
+//! @param       slot		[in] Slot to modify
+//! @param       integrate	[in] true if Integrate should move the slot
+//! @param       gravity	[in] true if gravity should be applied to the slot
+//=========================================================================
+void EntityPhysics::SetMotion ( UInt slot, bool integrate, bool gravity )
+{
+	debug_assert ( slot < SlotCount(), "Invalid physics slot!" );
+
+	m_integrateMask[slot] = integrate ? 1.0f : 0.0f;
+	m_gravityMask[slot]   = (integrate && gravity) ? 1.0f : 0.0f;
+}
+//End EntityPhysics::SetMotion
+
+
+
+//=========================================================================
+//! @function    EntityPhysics::Snap
+//! @brief       Make the previous state of a slot the same as its current state
+//!
+//!				 Call this after moving an entity somewhere it didn't travel to, 
+//!				 such as when it spawns, so it isn't drawn sliding there
+//!              
+//! @param       slot [in] Slot to snap
+//=========================================================================
+void EntityPhysics::Snap ( UInt slot )
+{
+	debug_assert ( slot < SlotCount(), "Invalid physics slot!" );
+
+	m_previousPositions[slot]	 = m_positions[slot];
+	m_previousOrientations[slot] = m_orientations[slot];
+}
+//End EntityPhysics::Snap
+
+
+
+//=========================================================================
+//! @function    EntityPhysics::Integrate
+//! @brief       Update position, velocity and orientation of every moving slot
+//!				 also simulate the effects of friction and gravity
+//!
+//!				 Accelerations are cleared afterwards for every slot, so anything
+//!				 that accelerates an entity during a frame is applied on the next call.
+//!
+//!				 The linear pass has no branches, slots that don't move are scaled
+//!				 by a mask of zero, so it can be vectorised over the arrays.
+//!				 Orientation needs trig, so it is done in a second pass that skips 
+//!				 slots which don't move.
+//!              
+//! @param       timeElapsedInSeconds [in] 
+//=========================================================================
+void EntityPhysics::Integrate ( Float timeElapsedInSeconds )
+{
+	static Core::ConsoleFloat friction ( "phys_friction", 0.01f );
+	static Core::ConsoleFloat gravity  ( "phys_gravity", 0.98f * meters  );
+
+	const Math::Vector3D gravityAcceleration ( 0.0f, -gravity, 0.0f );
+	const Float frictionFactor = friction;
+	const UInt count = SlotCount();
+
+	//Keep the state the last tick ended with, for interpolation.
+	//The arrays are the same size, so this never reallocates
+	m_previousPositions = m_positions;
+	m_previousOrientations = m_orientations;
+
+	for ( UInt i = 0; i < count; ++i )
+	{
+		const Float mask		   = m_integrateMask[i];
+		const Float stepTime	   = timeElapsedInSeconds * mask;
+		const Float stepFriction   = frictionFactor * mask;
+
+		Math::Vector3D& acceleration		= m_accelerations[i];
+		Math::Vector3D& velocity			= m_velocities[i];
+		Math::Vector3D& angularAcceleration	= m_angularAccelerations[i];
+		Math::Vector3D& angularVelocity		= m_angularVelocities[i];
+
+		acceleration += gravityAcceleration * m_gravityMask[i];
+
+		velocity += acceleration * stepTime;
+		velocity -= velocity * stepFriction;
+
+		m_positions[i] += velocity * mask;
+
+		//Update rotational velocity
+		angularVelocity += angularAcceleration * stepTime;
+		angularVelocity -= angularVelocity * stepFriction;
+
+		acceleration.Set ( 0.0f, 0.0f, 0.0f );
+		angularAcceleration.Set ( 0.0f, 0.0f, 0.0f );
+	}
+
+	for ( UInt i = 0; i < count; ++i )
+	{
+		if ( m_integrateMask[i] != 0.0f )
+		{
+			const Math::Vector3D& angularVelocity = m_angularVelocities[i];
+
+			m_orientations[i] *= Math::Quaternion ( angularVelocity.Z(), angularVelocity.Y(), angularVelocity.X() );
+			m_orientations[i].Normalise();
+		}
+	}
+}
+//End EntityPhysics::Integrate
+
+
+
+//=========================================================================
+//! @function    EntityPhysics::WriteTransforms
+//! @brief       Rebuild the local transforms of every owner from its slot
+//!
+//!				 Static entities are skipped, since only Spawn moves them, and it
+//!				 writes the transform itself. Owners that haven't moved keep their
+//!				 transforms clean, so the scene graph doesn't update them
+//=========================================================================
+void EntityPhysics::WriteTransforms ( )
+{
+	const UInt count = SlotCount();
+
+	for ( UInt i = 0; i < count; ++i )
+	{
+		if ( !m_owners[i]->IsFlagSet(EF_STATIC) )
+		{
+			m_owners[i]->SetLocalTransform ( m_orientations[i], m_positions[i] );
+		}
+	}
+}
+//End EntityPhysics::WriteTransforms
+
+
+
+//=========================================================================
+//! @function    EntityPhysics::WriteInterpolatedTransforms
+//! @brief       Give every owner a local transform part way between the state
+//!				 before the last Integrate, and the current state
+//!
+//! @param       interpolation [in] 0 for the previous state, 1 for the current state
+//=========================================================================
+void EntityPhysics::WriteInterpolatedTransforms ( Float interpolation )
+{
+	const UInt count = SlotCount();
+
+	for ( UInt i = 0; i < count; ++i )
+	{
+		const Math::Vector3D& previous = m_previousPositions[i];
+		const Math::Vector3D position ( previous + ((m_positions[i] - previous) * interpolation) );
+
+		m_owners[i]->SetInterpolatedTransform ( NLerp(m_previousOrientations[i], m_orientations[i], interpolation), position );
+	}
+}
+//End EntityPhysics::WriteInterpolatedTransforms
@@ -34,7 +34,7 @@
 #include "OidFX/Constants.h"
 #include "OidFX/Explosion.h"
 #include "OidFX/GameApplication.h"
-#include "OidFX/BillboardManager.h"
+#include "OidFX/SceneCommandBuffer.h"
 
 
 
@@ -86,32 +86,27 @@ Explosion::Explosion ( Scene& scene )
 
 
 //=========================================================================
-//! @function    Explosion::Update
-//! @brief       
+//! @function    Explosion::OnThink
+//! @brief       Detonate the explosion as soon as it has spawned, and animate
+//!				 its billboard
 //!              
-//! @param       toWorldStack         [in]
-//! @param		 fromWorldStack		  [in]
-//! @param		 timeElapsedInSeconds [in]
+//! @param		 timeElapsed [in]
 //!              
 //=========================================================================
-void Explosion::Update ( Math::MatrixStack& toWorldStack,
-						 Math::MatrixStack& fromWorldStack,
-						 Float timeElapsedInSeconds )
+void Explosion::OnThink ( Float timeElapsed )
 {
 
-	EntityNode::Update( toWorldStack, fromWorldStack, timeElapsedInSeconds );
-
 	if (!IsFlagSet(EF_DEAD) )
 	{
 		Kill();
 	}
 
 	m_billboard.SetPosition( GetWorldSpacePosition() );
-	m_billboard.Update ( timeElapsedInSeconds );
-	m_scene.Application().GetBillboardManager().AddToBillboardList( m_billboard );
+	m_billboard.Update ( timeElapsed );
+	m_scene.Commands().AddBillboard( m_billboard );
 
 }
-//End  Explosion::Update
+//End Explosion::OnThink
 
 
 
@@ -140,12 +135,17 @@ void Explosion::OnSpawn( const Math::Vector3D& spawnPoint )
 
 //=========================================================================
 //! @function    Explosion::OnDeath
-//! @brief       
+//! @brief       Hurt, and push back, the entities within range of the explosion
 //!              
-    
+//!				 Explosions die while they think, so the other entities are changed
+//!				 through the scene's command buffer
 //=========================================================================
 void Explosion::OnDeath()
 {
+	//Friendly fire on?
+	static Core::ConsoleBool friendly_fire( "friendly_fire", false );
+
+	static Core::ConsoleFloat explosion_kickback_coefficient ( "explosion_kickback_coefficient", 0.5 );
 
 	Math::BoundingSphere3D areaOfEffect( GetExplosiveStrength() * meters, GetWorldSpacePosition() );
 
@@ -161,9 +161,6 @@ void Explosion::OnDeath()
 		  itr != results.end();
 		  ++itr )
 	{
-		
-		//Friendly fire on?
-		static Core::ConsoleBool friendly_fire( "friendly_fire", false );
 
 		//Ignore entity if approriate flags are set
 		if ( !friendly_fire )
@@ -188,8 +185,6 @@ void Explosion::OnDeath()
 		//Kick back from explosion
 		if ( !(*itr)->IsFlagSet(EF_NOEXPLOSIONKICKBACK) )
 		{
-			static Core::ConsoleFloat explosion_kickback_coefficient ( "explosion_kickback_coefficient", 0.5 );
-
 			Math::Vector3D velocity = ((*itr)->GetVelocity() + (displacement * explosionStrength))
 									 * explosion_kickback_coefficient;
 
@@ -201,11 +196,11 @@ void Explosion::OnDeath()
 			}
 
 			displacement.Normalise();
-			(*itr)->SetVelocity( velocity );
+			m_scene.Commands().SetVelocity( **itr, velocity );
 		}
 
 		//Hurt the other entity based on its proximity to the explosion, and the explosive strength
-		(*itr)->Hurt(explosionStrength);
+		m_scene.Commands().Hurt( **itr, explosionStrength );
 
 		std::clog << __FUNCTION__ ": Hurt entity " << (*itr)->ID() << " by " << explosionStrength
 			<< " radius = " << areaOfEffect.Radius() << std::endl;
@@ -29,6 +29,8 @@
 
 
 #include "Core/Core.h"
+#include "Core/WorkerPool.h"
+#include "Core/NullInputSystem.h"
 #include "Renderer/Renderer.h"
 #include "Renderer/FontManager.h"
 #include "Renderer/DisplayModeList.h"
@@ -39,6 +41,7 @@
 #include "Renderer/AutogenTextureManager.h"
 #include "Renderer/StateManager.h"
 #include "Renderer/TexturePrecacheList.h"
+#include "Renderer/NullRendererCreator.h"
 #include "SettingsDialogue/Dialogue.h"
 #include "DirectX9Renderer/DirectXRendererCreator.h"
 #include "DirectX9Input/DirectXInputSystem.h"
@@ -113,18 +116,87 @@ class GameAppExitFunc : public SettingsDialogue::IExitFunc
 
 
 
+//namespace OidFX
+namespace OidFX
+{
+
+	//!@class	FrameSimulationJob
+	//!@brief	Simulates and culls the next frame on the simulation thread, while the
+	//!			main thread draws the current one
+	//!
+	//!			Errors are kept, and rethrown on the main thread by GameApplication::Run,
+	//!			since the worker pool would only report that the job failed
+	class FrameSimulationJob : public Core::IJob
+	{
+		public:
+
+			FrameSimulationJob ( GameApplication& application )
+				: m_application(application), m_timeElapsed(0.0f), m_ticks(0)
+			{
+			}
+
+			void Set ( Float timeElapsed )
+			{
+				m_timeElapsed = timeElapsed;
+				m_ticks = 0;
+				m_error.clear();
+			}
+
+			void Execute ( )
+			{
+				try
+				{
+					//Input is updated on the main thread, along with the window messages
+					m_ticks = m_application.SimulateFrame ( m_timeElapsed, false );
+				}
+				catch ( std::exception& error )
+				{
+					m_error = error.what();
+				}
+				catch ( Core::Exception& error )
+				{
+					m_error = error.What();
+				}
+				catch ( ... )
+				{
+					m_error = "Unknown error";
+				}
+			}
+
+			UInt Ticks ( ) const					{ return m_ticks;	}
+			const std::string& Error ( ) const		{ return m_error;	}
+
+		private:
+
+			GameApplication&	m_application;
+			Float				m_timeElapsed;
+			UInt				m_ticks;
+			std::string			m_error;
+	};
+	//End class FrameSimulationJob
+
+}
+//end namespace OidFX
+
+
+
 //=========================================================================
 //! @function    GameApplication::GameApplication
 //! @brief       Game application constructor
 //!
 //=========================================================================
 GameApplication::GameApplication( )
-: Core::Singleton<GameApplication>(this), m_quit(false), m_framerateCounter()
+: Core::Singleton<GameApplication>(this), m_quit(false), m_framerateCounter(), m_simulationTime(0.0)
 {
 	//Set up the renderer factory
 	m_rendererFactory = boost::shared_ptr<Renderer::RendererFactory>( new Renderer::RendererFactory() );
 	boost::shared_ptr<Renderer::RendererCreator> dxCreator(new DirectX9Renderer::DirectXRendererCreator());
 	m_rendererFactory->RegisterCreator ( dxCreator );
+
+	//The null renderer draws nothing, and records what it is asked to do.
+	//Selected with init_renderer "Null", for profiling and testing without a GPU
+	boost::shared_ptr<Renderer::RendererCreator> nullCreator(new Renderer::NullRendererCreator());
+	m_rendererFactory->RegisterCreator ( nullCreator );
 }
 //End GameApplication::GameApplication
 
@@ -160,6 +232,7 @@ Int GameApplication::Run ( std::vector<std::string>& commandLine, const Char* wi
 		}
 
 		InitialiseInputSystem();
+		InitialiseWorkerPool();
 		InitialiseBillboardManager();
 		InitialiseScriptingSystem();
 		InitialiseMeshManager();
@@ -179,7 +252,13 @@ Int GameApplication::Run ( std::vector<std::string>& commandLine, const Char* wi
 
 		Core::ConsoleBool con_showfps ( "con_showfps", false );
 
-		OidFX::VisibleObjectList visibleObjectList;
+		const bool pipelined = ( m_simulationThread.get() != 0 );
+
+		//There's nothing for the first frame to overlap with, so it's simulated and queued up front
+		if ( pipelined )
+		{
+			QueueFrame ( SimulateFrame ( static_cast<Float>(timeElapsed), true ) > 0 );
+		}
 
 		while (!m_quit)
 		{
@@ -188,6 +267,9 @@ Int GameApplication::Run ( std::vector<std::string>& commandLine, const Char* wi
 			{
 				m_renderer->Restore(true);
 				m_scene->Restore();
+
+				//The device state was lost, so nothing the state manager knows can be trusted
+				m_stateManager->InvalidateShadowState();
 			}
 			
 			//Process any window messages sent to the renderer window
@@ -198,40 +280,52 @@ Int GameApplication::Run ( std::vector<std::string>& commandLine, const Char* wi
 			//Update any effect animations
 			m_effectManager->UpdateEffects( timeElapsed );
 
-			//Clear out the billboard manager
-			m_billboardManager->ClearBillboardList( );
-
-			//Update game logic
-			Update ( timeElapsed );
-
-			//Update the billboard manager
-			m_billboardManager->Update ( timeElapsed );
-
-			//Clear out the render queue
-			m_renderQueue->Clear();
-
-			//Fill the list of visible objects
-			visibleObjectList.Clear();
-			m_scene->FillVisibleObjectList(visibleObjectList, GetCamera());
-
-			//Queue all visible objects for rendering
-			visibleObjectList.QueueAllForRendering ( *m_renderQueue );
-
-			//Sort the render queue
-			m_renderQueue->Sort();
+			if ( pipelined )
+			{
+				//Input calls back into the camera and the game, so it's updated here
+				//rather than on the simulation thread
+				m_inputSystem->Update();
+				m_simulationJob->Set ( static_cast<Float>(timeElapsed) );
+			}
+			else
+			{
+				QueueFrame ( SimulateFrame ( static_cast<Float>(timeElapsed), true ) > 0 );
+			}
 
 			//Start a new frame and clear the screen
 			m_renderer->BeginFrame();
+			m_stateManager->ResetFrameStatistics();
 			m_renderer->Clear( Renderer::COLOUR_BUFFER | Renderer::DEPTH_BUFFER );
 
+			//Draw from where the camera was when the frame was culled
+			m_renderer->SetMatrix ( Renderer::MAT_VIEW, m_frameView.viewMatrix );
+			m_renderer->SetMatrix ( Renderer::MAT_PROJECTION, m_frameView.projectionMatrix );
+
 				PreRender();
 				Render();
 
+				//Simulate and cull the next frame while this one is drawn
+				if ( pipelined )
+				{
+					m_simulationThread->Submit ( *m_simulationJob );
+				}
+
 				//Render the contents of the render queue
 				m_renderQueue->Render();
 
 				//Render all billboards
-				m_billboardManager->Render( GetRenderer(), GetCamera() );
+				m_billboardManager->Render( GetRenderer(), m_frameView );
+
+				//PostRender may display anything from the game, so the simulation has to finish first
+				if ( pipelined )
+				{
+					m_simulationThread->WaitForAll();
+
+					if ( !m_simulationJob->Error().empty() )
+					{
+						throw Core::RuntimeError ( m_simulationJob->Error().c_str(), 0, __FILE__, __FUNCTION__, __LINE__ );
+					}
+				}
 
 				PostRender();
 
@@ -239,6 +333,11 @@ Int GameApplication::Run ( std::vector<std::string>& commandLine, const Char* wi
 			//End the frame
 			m_renderer->EndFrame();
 
+			if ( pipelined )
+			{
+				QueueFrame ( m_simulationJob->Ticks() > 0 );
+			}
+
 			//Update the timer
 			timeElapsed = timer.Update();
 			
@@ -525,6 +624,15 @@ void GameApplication::InitialiseRenderer()
 		throw;
 	}
 
+	//With pipelined frames, the simulation thread may create and release resources while the main thread draws
+	Core::ConsoleBool init_pipelineframes ( "init_pipelineframes", false );
+	Core::ConsoleBool init_multithreaded ( "init_multithreaded", false );
+
+	if ( init_pipelineframes )
+	{
+		init_multithreaded = true;
+	}
+
 	m_renderer->Initialise();
 	
 	//Set the window title
@@ -606,10 +714,19 @@ void GameApplication::InitialiseMeshManager ( )
 //! @function    GameApplication::InitialiseInputSystem
 //! @brief       Create and initalise the input system
 //!              
+//!				 Renderers without a window that can take input, such as the
+//!				 null renderer, get an input system that never produces any
+//!
 //! @throw       
 //=========================================================================
 void GameApplication::InitialiseInputSystem()
 {
+	if ( !GetRenderer().Window().AcceptsInput() )
+	{
+		m_inputSystem = boost::shared_ptr<Core::InputSystem>( new Core::NullInputSystem() );
+		return;
+	}
+
 	m_inputSystem = boost::shared_ptr<Core::InputSystem>( 
 		new DirectX9Input::DirectXInputSystem( GetRenderer().Window().WindowHandle()) );
 }
@@ -631,6 +748,36 @@ void GameApplication::InitialiseBillboardManager ( )
 
 
 
+//=========================================================================
+//! @function    GameApplication::InitialiseWorkerPool
+//! @brief       Create the pool of worker threads used for parallel jobs
+//!              
+//!				 The number of threads is taken from init_workerthreads, which
+//!				 defaults to one less than the number of processors, since the
+//!				 main thread also executes jobs while it waits for them
+//!
+//!				 If init_pipelineframes is set, a separate thread is created to simulate
+//!				 the next frame. It can't come from the worker pool, since culling waits for
+//!				 every job in the pool to finish, and would end up waiting for itself
+//=========================================================================
+void GameApplication::InitialiseWorkerPool ( )
+{
+	const UInt hardwareThreads = Core::WorkerPool::HardwareThreadCount();
+	Core::ConsoleUInt init_workerthreads ( "init_workerthreads", (hardwareThreads > 1) ? hardwareThreads - 1 : 0 );
+	Core::ConsoleBool init_pipelineframes ( "init_pipelineframes", false );
+
+	m_workerPool = boost::shared_ptr<Core::WorkerPool> ( new Core::WorkerPool(init_workerthreads) );
+
+	if ( init_pipelineframes )
+	{
+		m_simulationJob = boost::shared_ptr<FrameSimulationJob> ( new FrameSimulationJob(*this) );
+		m_simulationThread = boost::shared_ptr<Core::WorkerPool> ( new Core::WorkerPool(1) );
+	}
+}
+//End GameApplication::InitialiseWorkerPool
+
+
+
 //=========================================================================
 //! @function    GameApplication::CheckRendererMeetsMinimumSpec
 //! @brief       Check that the renderer meets the minimum specification for OidFX
@@ -653,9 +800,9 @@ void GameApplication::CheckRendererMeetsMinimumSpec()
 
 //=========================================================================
 //! @function    GameApplication::Update
-//! @brief       Update the game world
+//! @brief       Update the game world by one simulation tick
 //!              
-//! @param		 timeElapsed [in] Time elapsed since last update
+//! @param		 timeElapsed [in] Length of the tick
 //!              
 //! @throw       
 //=========================================================================
@@ -667,15 +814,144 @@ void GameApplication::Update(Float timeElapsed)
 
 	//Update the scene
 	UpdateScene(timeElapsed);
+}
+//End GameApplication::Update
+
 
-	//Update the camera
+
+//=========================================================================
+//! @function    GameApplication::UpdateCamera
+//! @brief       Update the camera, once per rendered frame
+//!              
+//!				 The renderer's view and projection matrices are set from the 
+//!				 view captured by QueueFrame, when the frame is drawn
+//!
+//! @param		 timeElapsed [in] Time elapsed since the last frame
+//!              
+//=========================================================================
+void GameApplication::UpdateCamera(Float timeElapsed)
+{
 	GetCamera().Update(timeElapsed);
+}
+//End GameApplication::UpdateCamera
+
+
 
-	//Update the camera
-	m_renderer->SetMatrix ( Renderer::MAT_VIEW, m_camera->ViewMatrix()		);
-	m_renderer->SetMatrix ( Renderer::MAT_PROJECTION, m_camera->ProjectionMatrix() );
+//=========================================================================
+//! @function    GameApplication::SimulateFrame
+//! @brief       Run the simulation ticks due this frame, then cull the scene
+//!				 into the visible object list
+//!              
+//!				 The simulation runs in fixed ticks of 1/sim_tickrate seconds unless sim_fixedstep
+//!				 is cleared, in which case it runs once per frame, as fast as the frames go.
+//!				 Entities are drawn part way between their last two states.
+//!
+//!				 Doesn't call the renderer, so it can run while the previous frame is drawn
+//!
+//! @param		 timeElapsed [in] Time elapsed since the last frame
+//! @param		 updateInput [in] Update the input system before each tick
+//!
+//! @return		 The number of ticks run
+//=========================================================================
+UInt GameApplication::SimulateFrame ( Float timeElapsed, bool updateInput )
+{
+	static Core::ConsoleBool  sim_fixedstep ( "sim_fixedstep", true );
+	static Core::ConsoleFloat sim_tickrate  ( "sim_tickrate", 60.0f );
+	static Core::ConsoleUInt  sim_maxticks  ( "sim_maxticks", 8 );
+
+	//Work out how many simulation ticks to run this frame
+	Float tickLength = timeElapsed;
+	UInt tickCount = 1;
+	Float interpolation = 1.0f;
+
+	if ( sim_fixedstep && (sim_tickrate > 0.0f) )
+	{
+		tickLength = 1.0f / sim_tickrate;
+		m_simulationTime += timeElapsed;
+		tickCount = static_cast<UInt>(m_simulationTime / tickLength);
+
+		//If the simulation can't keep up, let it fall behind real time,
+		//rather than spending longer and longer catching up
+		if ( tickCount > sim_maxticks )
+		{
+			tickCount = sim_maxticks;
+			m_simulationTime = tickCount * tickLength;
+		}
+
+		m_simulationTime -= tickCount * tickLength;
+		interpolation = static_cast<Float>(m_simulationTime / tickLength);
+	}
+
+	for ( UInt tick = 0; tick < tickCount; ++tick )
+	{
+		//The scene adds the billboards it wants drawn on every update
+		m_billboardManager->ClearBillboardList( );
+
+		//Update game logic
+		if ( updateInput )
+		{
+			Update ( tickLength );
+		}
+		else
+		{
+			UpdateScene ( tickLength );
+		}
+	}
+
+	//Update the billboard manager. Without a tick, last tick's billboards are drawn again
+	if ( tickCount > 0 )
+	{
+		m_billboardManager->Update ( tickLength );
+	}
+
+	//Place entities between their last two states, and move the camera to follow them
+	m_scene->Interpolate ( interpolation );
+	UpdateCamera ( timeElapsed );
+
+	//Fill the list of visible objects
+	m_visibleObjects.Clear();
+	m_scene->FillVisibleObjectList ( m_visibleObjects, GetCamera() );
+
+	return tickCount;
 }
-//End GameApplication::Update
+//End GameApplication::SimulateFrame
+
+
+
+//=========================================================================
+//! @function    GameApplication::QueueFrame
+//! @brief       Queue the visible objects for rendering, and capture everything
+//!				 else needed to draw the frame
+//!              
+//!				 Runs on the main thread, since queueing may fill vertex buffers.
+//!				 Once it returns, drawing the frame doesn't read anything that 
+//!				 the next SimulateFrame changes
+//!
+//! @param		 swapBillboards [in] Draw the billboards added since the last frame was queued,
+//!									 rather than the last frame's billboards
+//=========================================================================
+void GameApplication::QueueFrame ( bool swapBillboards )
+{
+	//Clear out the render queue. Nodes removed from the scene while it was 
+	//being drawn aren't needed any more
+	m_renderQueue->Clear();
+	m_scene->ReleaseRemovedNodes();
+
+	if ( swapBillboards )
+	{
+		m_billboardManager->SwapBillboardLists();
+	}
+
+	GetCamera().CaptureView ( m_frameView );
+	m_renderQueue->SetViewerPosition ( m_frameView.position );
+
+	//Queue all visible objects for rendering
+	m_visibleObjects.QueueAllForRendering ( *m_renderQueue );
+
+	//Sort the render queue
+	m_renderQueue->Sort();
+}
+//End GameApplication::QueueFrame
 
 
 
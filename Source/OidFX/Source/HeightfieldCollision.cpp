@@ -0,0 +1,541 @@
+//======================================================================================
+//! @file         HeightfieldCollision.cpp
+//! @brief        Collision queries against a terrain heightmap
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+#include <algorithm>
+#include "Core/Core.h"
+#include "Core/Util.h"
+#include "Math/Math.h"
+#include "Math/Vector3D.h"
+#include "Math/ParametricLine3D.h"
+#include "OidFX/HeightfieldCollision.h"
+
+
+using namespace OidFX;
+
+
+
+//namespace
+namespace
+{
+
+	//! Tolerance on barycentric coordinates, so rays don't slip between neighbouring triangles
+	const Float barycentricEpsilon = 1e-5f;
+
+	//! Direction components smaller than this are treated as parallel to an axis
+	const Float parallelEpsilon = 1e-12f;
+
+
+	//=========================================================================
+    //! @function    ClipToSlab
+    //! @brief       Clip the parametric range of a line to a slab along one axis
+    //!              
+    //! @param       origin		[in]	 Start of the line along the axis
+    //! @param       direction	[in]	 Direction of the line along the axis
+    //! @param       slabMin	[in]	 Start of the slab
+    //! @param       slabMax	[in]	 End of the slab
+    //! @param       tMin		[in/out] Start of the parametric range
+    //! @param       tMax		[in/out] End of the parametric range
+    //!              
+    //! @return      false if nothing is left of the range
+    //=========================================================================
+	bool ClipToSlab ( Float origin, Float direction, Float slabMin, Float slabMax, Float& tMin, Float& tMax )
+	{
+		if ( Math::Abs(direction) < parallelEpsilon )
+		{
+			return (origin >= slabMin) && (origin <= slabMax);
+		}
+
+		Float t0 = (slabMin - origin) / direction;
+		Float t1 = (slabMax - origin) / direction;
+
+		if ( t0 > t1 )
+		{
+			std::swap ( t0, t1 );
+		}
+
+		tMin = Core::Max ( tMin, t0 );
+		tMax = Core::Min ( tMax, t1 );
+
+		return tMin <= tMax;
+	}
+	//End ClipToSlab
+
+
+	//=========================================================================
+    //! @function    IntersectTriangle
+    //! @brief       Intersect a line segment with a double sided triangle
+    //!              
+    //! @param       p0		[in]  Start of the line
+    //! @param       v		[in]  Vector from the start to the end of the line
+    //! @param       a		[in]  First vertex of the triangle
+    //! @param       b		[in]  Second vertex of the triangle
+    //! @param       c		[in]  Third vertex of the triangle
+    //! @param       t		[out] Parametric position of the intersection on the line
+    //!              
+    //! @return      true if the segment intersects the triangle
+    //=========================================================================
+	bool IntersectTriangle ( const Math::Vector3D& p0, 
+							 const Math::Vector3D& v,
+							 const Math::Vector3D& a, 
+							 const Math::Vector3D& b, 
+							 const Math::Vector3D& c,
+							 Float& t )
+	{
+		Math::Vector3D edge1 = b - a;
+		Math::Vector3D edge2 = c - a;
+
+		Math::Vector3D p;
+		Math::Vector3D::CrossProduct ( v, edge2, p );
+
+		Float determinant = Math::Vector3D::DotProduct ( edge1, p );
+
+		if ( Math::Abs(determinant) < parallelEpsilon )
+		{
+			return false;
+		}
+
+		Float inverseDeterminant = 1.0f / determinant;
+
+		Math::Vector3D s = p0 - a;
+		Float u = Math::Vector3D::DotProduct ( s, p ) * inverseDeterminant;
+
+		if ( (u < -barycentricEpsilon) || (u > (1.0f + barycentricEpsilon)) )
+		{
+			return false;
+		}
+
+		Math::Vector3D q;
+		Math::Vector3D::CrossProduct ( s, edge1, q );
+
+		Float w = Math::Vector3D::DotProduct ( v, q ) * inverseDeterminant;
+
+		if ( (w < -barycentricEpsilon) || ((u + w) > (1.0f + barycentricEpsilon)) )
+		{
+			return false;
+		}
+
+		t = Math::Vector3D::DotProduct ( edge2, q ) * inverseDeterminant;
+
+		return (t >= 0.0f) && (t <= 1.0f);
+	}
+	//End IntersectTriangle
+
+}
+//end namespace
+
+
+
+//=========================================================================
+//! @function    HeightfieldCollision::HeightfieldCollision
+//! @brief       Construct an empty heightfield. Initialise must be called before it's queried
+//=========================================================================
+HeightfieldCollision::HeightfieldCollision ( )
+: m_heightMap(0), m_size(0), m_spacing(1.0f)
+{
+}
+//End HeightfieldCollision::HeightfieldCollision
+
+
+
+//=========================================================================
+//! @function    HeightfieldCollision::Initialise
+//! @brief       Set the heightmap that the heightfield queries
+//!              
+//!				 The heightmap isn't copied, so it must outlive the heightfield
+//!
+//! @param       heightMap	[in] Heightmap to query
+//! @param       size		[in] Number of samples along each side to use. 
+//!								 Must be no more than the size of the heightmap
+//! @param       spacing	[in] Distance between samples in local space
+//=========================================================================
+void HeightfieldCollision::Initialise ( const Core::HeightMap& heightMap, UInt size, Float spacing )
+{
+	debug_assert ( (size >= 2) && (size <= heightMap.Size()), "Invalid heightfield size!" );
+	debug_assert ( spacing > 0.0f, "Invalid heightfield spacing!" );
+
+	m_heightMap = &heightMap;
+	m_size = size;
+	m_spacing = spacing;
+}
+//End HeightfieldCollision::Initialise
+
+
+
+//=========================================================================
+//! @function    HeightfieldCollision::WholeRegion
+//! @brief       Get a region covering the whole heightfield
+//=========================================================================
+HeightfieldCollision::Region HeightfieldCollision::WholeRegion ( ) const
+{
+	Region region;
+
+	region.firstRow = 0;
+	region.firstCol = 0;
+	region.lastRow = m_size - 1;
+	region.lastCol = m_size - 1;
+
+	return region;
+}
+//End HeightfieldCollision::WholeRegion
+
+
+
+//=========================================================================
+//! @function    HeightfieldCollision::HeightAt
+//! @brief       Get the height of the surface at a point
+//!              
+//! @param       x [in] Local x position. Clamped to the heightfield
+//! @param       z [in] Local z position. Clamped to the heightfield
+//!              
+//! @return      Height of the surface at (x, z)
+//=========================================================================
+Float HeightfieldCollision::HeightAt ( Float x, Float z ) const
+{
+	debug_assert ( m_heightMap, "Heightfield hasn't been initialised!" );
+
+	const Float maxCell = static_cast<Float>(m_size - 2);
+
+	Float colPosition = Core::Max ( 0.0f, x / m_spacing );
+	Float rowPosition = Core::Max ( 0.0f, z / m_spacing );
+
+	UInt col = static_cast<UInt>( Core::Min ( Math::Floor(colPosition), maxCell ) );
+	UInt row = static_cast<UInt>( Core::Min ( Math::Floor(rowPosition), maxCell ) );
+
+	Float fx = Core::Min ( colPosition - static_cast<Float>(col), 1.0f );
+	Float fz = Core::Min ( rowPosition - static_cast<Float>(row), 1.0f );
+
+	//Pick the triangle either side of the diagonal from (row+1, col) to (row, col+1)
+	if ( (fx + fz) <= 1.0f )
+	{
+		Float h00 = Sample ( row, col );
+
+		return h00 + (fx * (Sample(row, col + 1) - h00)) + (fz * (Sample(row + 1, col) - h00));
+	}
+	else
+	{
+		Float h11 = Sample ( row + 1, col + 1 );
+
+		return h11 + ((1.0f - fx) * (Sample(row + 1, col) - h11)) + ((1.0f - fz) * (Sample(row, col + 1) - h11));
+	}
+}
+//End HeightfieldCollision::HeightAt
+
+
+
+//=========================================================================
+//! @function    HeightfieldCollision::NormalAt
+//! @brief       Get the normal of the surface at a point
+//!              
+//! @param       x [in] Local x position. Clamped to the heightfield
+//! @param       z [in] Local z position. Clamped to the heightfield
+//!              
+//! @return      Unit normal of the triangle under (x, z)
+//=========================================================================
+Math::Vector3D HeightfieldCollision::NormalAt ( Float x, Float z ) const
+{
+	debug_assert ( m_heightMap, "Heightfield hasn't been initialised!" );
+
+	const Float maxCell = static_cast<Float>(m_size - 2);
+
+	Float colPosition = Core::Max ( 0.0f, x / m_spacing );
+	Float rowPosition = Core::Max ( 0.0f, z / m_spacing );
+
+	UInt col = static_cast<UInt>( Core::Min ( Math::Floor(colPosition), maxCell ) );
+	UInt row = static_cast<UInt>( Core::Min ( Math::Floor(rowPosition), maxCell ) );
+
+	Float fx = colPosition - static_cast<Float>(col);
+	Float fz = rowPosition - static_cast<Float>(row);
+
+	//Slopes of the triangle along x and z
+	Float slopeX = 0.0f;
+	Float slopeZ = 0.0f;
+
+	if ( (fx + fz) <= 1.0f )
+	{
+		slopeX = Sample(row, col + 1) - Sample(row, col);
+		slopeZ = Sample(row + 1, col) - Sample(row, col);
+	}
+	else
+	{
+		slopeX = Sample(row + 1, col + 1) - Sample(row + 1, col);
+		slopeZ = Sample(row + 1, col + 1) - Sample(row, col + 1);
+	}
+
+	Math::Vector3D normal ( -slopeX, m_spacing, -slopeZ );
+	normal.Normalise();
+
+	return normal;
+}
+//End HeightfieldCollision::NormalAt
+
+
+
+//=========================================================================
+//! @function    HeightfieldCollision::IntersectRay
+//! @brief       Find the first intersection of a line segment with the heightfield
+//!              
+//!				 Walks the cells under the line in order, so only the cells that
+//!				 the line passes over are tested
+//!
+//! @param       line	[in]  Line segment in the local space of the heightfield
+//! @param       region	[in]  Samples to test against
+//! @param       t		[out] Parametric position of the first intersection on the line
+//!              
+//! @return      true if the line intersects the heightfield within the region
+//=========================================================================
+bool HeightfieldCollision::IntersectRay ( const Math::ParametricLine3D& line, 
+										  const Region& region, 
+										  Float& t ) const
+{
+	debug_assert ( m_heightMap, "Heightfield hasn't been initialised!" );
+	debug_assert ( (region.lastRow < m_size) && (region.lastCol < m_size), "Region is outside the heightfield!" );
+
+	if ( (region.lastRow <= region.firstRow) || (region.lastCol <= region.firstCol) )
+	{
+		return false;
+	}
+
+	const Math::Vector3D& p0 = line.P0();
+	const Math::Vector3D& v = line.V();
+
+	//Clip the line to the region in the xz plane
+	Float tMin = 0.0f;
+	Float tMax = 1.0f;
+
+	if ( !ClipToSlab ( p0.X(), v.X(), region.firstCol * m_spacing, region.lastCol * m_spacing, tMin, tMax )
+		|| !ClipToSlab ( p0.Z(), v.Z(), region.firstRow * m_spacing, region.lastRow * m_spacing, tMin, tMax ) )
+	{
+		return false;
+	}
+
+	//Find the cell that the clipped line starts in
+	Int col = static_cast<Int>( Math::Floor ( (p0.X() + (v.X() * tMin)) / m_spacing ) );
+	Int row = static_cast<Int>( Math::Floor ( (p0.Z() + (v.Z() * tMin)) / m_spacing ) );
+
+	col = Core::Max ( static_cast<Int>(region.firstCol), Core::Min ( col, static_cast<Int>(region.lastCol) - 1 ) );
+	row = Core::Max ( static_cast<Int>(region.firstRow), Core::Min ( row, static_cast<Int>(region.lastRow) - 1 ) );
+
+	//Set up the walk through the grid
+	const Int stepCol = (v.X() > 0.0f) ? 1 : -1;
+	const Int stepRow = (v.Z() > 0.0f) ? 1 : -1;
+
+	Float tNextCol = tMax + 1.0f;
+	Float tNextRow = tMax + 1.0f;
+	Float tDeltaCol = 0.0f;
+	Float tDeltaRow = 0.0f;
+
+	if ( Math::Abs(v.X()) >= parallelEpsilon )
+	{
+		tNextCol = ((static_cast<Float>(col + ((stepCol > 0) ? 1 : 0)) * m_spacing) - p0.X()) / v.X();
+		tDeltaCol = m_spacing / Math::Abs(v.X());
+	}
+
+	if ( Math::Abs(v.Z()) >= parallelEpsilon )
+	{
+		tNextRow = ((static_cast<Float>(row + ((stepRow > 0) ? 1 : 0)) * m_spacing) - p0.Z()) / v.Z();
+		tDeltaRow = m_spacing / Math::Abs(v.Z());
+	}
+
+	for ( ;; )
+	{
+		if ( IntersectCell ( p0, v, row, col, t ) )
+		{
+			return true;
+		}
+
+		if ( tNextCol < tNextRow )
+		{
+			col += stepCol;
+
+			if ( (tNextCol > tMax) || (col < static_cast<Int>(region.firstCol)) || (col >= static_cast<Int>(region.lastCol)) )
+			{
+				break;
+			}
+
+			tNextCol += tDeltaCol;
+		}
+		else
+		{
+			row += stepRow;
+
+			if ( (tNextRow > tMax) || (row < static_cast<Int>(region.firstRow)) || (row >= static_cast<Int>(region.lastRow)) )
+			{
+				break;
+			}
+
+			tNextRow += tDeltaRow;
+		}
+	}
+
+	return false;
+}
+//End HeightfieldCollision::IntersectRay
+
+
+
+//=========================================================================
+//! @function    HeightfieldCollision::IntersectCell
+//! @brief       Intersect a line segment with both triangles of a cell
+//!              
+//! @param       p0		[in]  Start of the line
+//! @param       v		[in]  Vector from the start to the end of the line
+//! @param       row	[in]  Row of the cell
+//! @param       col	[in]  Column of the cell
+//! @param       t		[out] Parametric position of the closest intersection
+//!              
+//! @return      true if the line intersects either triangle
+//=========================================================================
+bool HeightfieldCollision::IntersectCell ( const Math::Vector3D& p0, 
+										   const Math::Vector3D& v, 
+										   UInt row, 
+										   UInt col, 
+										   Float& t ) const
+{
+	const Float x0 = static_cast<Float>(col) * m_spacing;
+	const Float z0 = static_cast<Float>(row) * m_spacing;
+
+	const Math::Vector3D v00 ( x0,			   Sample(row, col),		 z0 );
+	const Math::Vector3D v01 ( x0 + m_spacing, Sample(row, col + 1),	 z0 );
+	const Math::Vector3D v10 ( x0,			   Sample(row + 1, col),	 z0 + m_spacing );
+	const Math::Vector3D v11 ( x0 + m_spacing, Sample(row + 1, col + 1), z0 + m_spacing );
+
+	Float t0 = 0.0f;
+	Float t1 = 0.0f;
+
+	bool hit0 = IntersectTriangle ( p0, v, v00, v10, v01, t0 );
+	bool hit1 = IntersectTriangle ( p0, v, v01, v10, v11, t1 );
+
+	if ( hit0 && hit1 )
+	{
+		t = Core::Min ( t0, t1 );
+	}
+	else if ( hit0 )
+	{
+		t = t0;
+	}
+	else if ( hit1 )
+	{
+		t = t1;
+	}
+
+	return hit0 || hit1;
+}
+//End HeightfieldCollision::IntersectCell
+
+
+
+//=========================================================================
+//! @function    HeightfieldCollision::Collide
+//! @brief       Check a box against the heightfield
+//!              
+//!				 The surface is sampled at every heightmap sample under the box, and at 
+//!				 the corners and centre of the bottom of the box. The deepest of these
+//!				 below the bottom of the box gives the contact.
+//!
+//! @param       minCorner	[in]  Minimum corner of the box, in the local space of the heightfield
+//! @param       maxCorner	[in]  Maximum corner of the box, in the local space of the heightfield
+//! @param       region		[in]  Samples to test against
+//! @param       normal		[out] Normal of the surface at the deepest point
+//! @param       depth		[out] Depth of the deepest point along the normal
+//!              
+//! @return      true if the bottom of the box is below the surface
+//=========================================================================
+bool HeightfieldCollision::Collide ( const Math::Vector3D& minCorner, 
+									 const Math::Vector3D& maxCorner,
+									 const Region& region,
+									 Math::Vector3D& normal,
+									 Float& depth ) const
+{
+	debug_assert ( m_heightMap, "Heightfield hasn't been initialised!" );
+	debug_assert ( (region.lastRow < m_size) && (region.lastCol < m_size), "Region is outside the heightfield!" );
+
+	//Clip the footprint of the box to the region
+	const Float minX = Core::Max ( minCorner.X(), region.firstCol * m_spacing );
+	const Float maxX = Core::Min ( maxCorner.X(), region.lastCol * m_spacing );
+	const Float minZ = Core::Max ( minCorner.Z(), region.firstRow * m_spacing );
+	const Float maxZ = Core::Min ( maxCorner.Z(), region.lastRow * m_spacing );
+
+	if ( (minX > maxX) || (minZ > maxZ) )
+	{
+		return false;
+	}
+
+	const Float bottom = minCorner.Y();
+
+	Float deepest = 0.0f;
+	Float deepestX = 0.0f;
+	Float deepestZ = 0.0f;
+
+	//Corners and centre of the footprint
+	const Float pointsX[] = { minX, maxX, minX, maxX, (minX + maxX) * 0.5f };
+	const Float pointsZ[] = { minZ, minZ, maxZ, maxZ, (minZ + maxZ) * 0.5f };
+
+	for ( UInt i = 0; i < (sizeof(pointsX) / sizeof(pointsX[0])); ++i )
+	{
+		Float penetration = HeightAt ( pointsX[i], pointsZ[i] ) - bottom;
+
+		if ( penetration > deepest )
+		{
+			deepest = penetration;
+			deepestX = pointsX[i];
+			deepestZ = pointsZ[i];
+		}
+	}
+
+	//Samples inside the footprint, which catch peaks smaller than the box
+	const UInt firstCol = static_cast<UInt>( Math::Ceil ( minX / m_spacing ) );
+	const UInt lastCol = static_cast<UInt>( Math::Floor ( maxX / m_spacing ) );
+	const UInt firstRow = static_cast<UInt>( Math::Ceil ( minZ / m_spacing ) );
+	const UInt lastRow = static_cast<UInt>( Math::Floor ( maxZ / m_spacing ) );
+
+	for ( UInt row = firstRow; row <= lastRow; ++row )
+	{
+		for ( UInt col = firstCol; col <= lastCol; ++col )
+		{
+			Float penetration = Sample ( row, col ) - bottom;
+
+			if ( penetration > deepest )
+			{
+				deepest = penetration;
+				deepestX = static_cast<Float>(col) * m_spacing;
+				deepestZ = static_cast<Float>(row) * m_spacing;
+			}
+		}
+	}
+
+	if ( deepest <= 0.0f )
+	{
+		return false;
+	}
+
+	normal = NormalAt ( deepestX, deepestZ );
+	depth = deepest * normal.Y();
+
+	return true;
+}
+//End HeightfieldCollision::Collide
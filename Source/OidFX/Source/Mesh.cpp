@@ -29,10 +29,15 @@
 //======================================================================================
 
 
+#include <cstring>
 #include "Core/Core.h"
 #include "Renderer/Renderer.h"
 #include "Renderer/RenderQueue.h"
+#include "Renderer/VertexCacheOptimiser.h"
+#include "Math/VertexNormalGenerator.h"
+#include "Math/MeshSimplifier.h"
 #include "OidFX/Mesh.h"
+#include "OidFX/CookedMeshLoader.h"
 
 
 
@@ -40,6 +45,16 @@ using namespace OidFX;
 
 
 
+//namespace
+namespace
+{
+	//LODs stop being generated once they would have fewer triangles than this
+	const UInt minLODTriangleCount = 32;
+}
+//end namespace
+
+
+
 //=========================================================================
 //! @function    Mesh::Mesh 
 //! @brief       Mesh constructor
@@ -60,7 +75,7 @@ Mesh::Mesh ( Renderer::IRenderer& renderer,
 			 const std::vector<Renderer::HEffect>& effects,
 			 std::vector<MeshGroupDescriptor>& groupDescriptor )
  :
-   Resource(name)
+   Resource(name), m_lodCount(1)
 {
 
 	//Make sure we have all required input data
@@ -72,14 +87,80 @@ Mesh::Mesh ( Renderer::IRenderer& renderer,
 	std::copy ( effects.begin(), effects.end(), std::back_inserter(m_effects) );
 
 	GenerateBoundingVolumes();
-	BuildGroups ( groupDescriptor );
 	GenerateNormals();
+	BuildGroups ( groupDescriptor );
+
+	if ( m_indices.empty() )
+	{
+		throw Core::RuntimeError ( "Mesh groups have no triangles!", 0, __FILE__, __FUNCTION__, __LINE__ );
+	}
 
-	CreateMeshVertexBuffer( renderer );
+	GenerateLODs();
+	OptimiseVertexCache();
+
+	CreateMeshVertexBuffer( renderer, VertexCount() );
 	FillVertexBuffer();
 
-	CreateMeshIndexBuffer( renderer );
-	FillIndexBuffer();
+	CreateMeshIndexBuffer( renderer, m_indices.size() );
+	FillIndexBuffer( &m_indices[0], m_indices.size() );
+
+}
+//End Mesh::Mesh 
+
+
+
+//=========================================================================
+//! @function    Mesh::Mesh 
+//! @brief       Construct a mesh from cooked data
+//!
+//!				 The data is already in vertex and index buffer format, with normals
+//!				 generated and groups built, so it is copied straight into the buffers.
+//!				 None of it is kept by the mesh, so it can point into a mapped file.
+//!
+//! @param       name		 [in] Name used to identify the mesh
+//! @param		 vertices	 [in] Array of vertices
+//! @param		 vertexCount [in] Number of vertices
+//! @param		 indices	 [in] Array of indices for all groups
+//! @param		 indexCount	 [in] Number of indices
+//! @param		 boundingBox [in] Object space bounding box
+//! @param		 effects	 [in] Array of effects used by the mesh
+//! @param		 groups		 [in] Mesh groups, referring to ranges of indices
+//!   
+//! @throw		 Core::RuntimeError
+//=========================================================================
+Mesh::Mesh ( Renderer::IRenderer& renderer,
+			 const Char* name,
+			 const Mesh::MeshStream0* vertices,
+			 UInt vertexCount,
+			 const UInt16* indices,
+			 UInt indexCount,
+			 const Math::AxisAlignedBoundingBox& boundingBox,
+			 const std::vector<Renderer::HEffect>& effects,
+			 const std::vector<MeshGroup>& groups )
+ :
+   Resource(name), m_boundingBox(boundingBox), m_groups(groups), m_lodCount(0), m_effects(effects)
+{
+
+	if ( (vertexCount == 0) || (indexCount == 0) || groups.empty() )
+	{
+		throw Core::RuntimeError ( "Cooked mesh has no vertices, indices or groups!", 0, __FILE__, __FUNCTION__, __LINE__ );
+	}
+
+	m_lodCount = groups.front().LODCount();
+
+	for ( ConstMeshGroupIterator group = MeshGroupsBegin(); group != MeshGroupsEnd(); ++group )
+	{
+		if ( group->LODCount() != m_lodCount )
+		{
+			throw Core::RuntimeError ( "Cooked mesh groups have different numbers of LODs!", 0, __FILE__, __FUNCTION__, __LINE__ );
+		}
+	}
+
+	CreateMeshVertexBuffer( renderer, vertexCount );
+	FillVertexBuffer( vertices, vertexCount );
+
+	CreateMeshIndexBuffer( renderer, indexCount );
+	FillIndexBuffer( indices, indexCount );
 
 }
 //End Mesh::Mesh 
@@ -190,7 +271,7 @@ void Mesh::GenerateBoundingVolumes ( )
 
 //=========================================================================
 //! @function    Mesh::BuildGroups
-//! @brief       Build the list of mesh groups
+//! @brief       Build the list of mesh groups, and the indices for the index buffer
 //!              
 //! @param		 groupDescriptor [in] Array of descriptors for the mesh groups
 //!
@@ -198,8 +279,6 @@ void Mesh::GenerateBoundingVolumes ( )
 void Mesh::BuildGroups ( std::vector<MeshGroupDescriptor>& groupDescriptor )
 {
 
-	UInt currentStartOffset = 0;
-
 	//iterators
 	std::vector<MeshGroupDescriptor>::iterator itr = groupDescriptor.begin();
 	std::vector<MeshGroupDescriptor>::iterator end = groupDescriptor.end();
@@ -208,12 +287,20 @@ void Mesh::BuildGroups ( std::vector<MeshGroupDescriptor>& groupDescriptor )
 	{
 		m_groups.push_back ( MeshGroup(itr->Name().c_str(), 
 									   itr->GetEffect(), 
-									   currentStartOffset, 
-									   itr->Indices(), 
+									   m_indices.size(), 
+									   itr->IndexCount(), 
 									   0,
 									   m_vertices.size() ) );
 
-		currentStartOffset += (itr->IndexCount() * 3);
+		//Copy the vertex indices of the group's triangles
+		for ( std::vector<UInt>::const_iterator index = itr->Indices().begin();
+			  index != itr->Indices().end();
+			  ++index )
+		{
+			m_indices.push_back ( static_cast<UInt16>(m_triangles[*index].v0) );
+			m_indices.push_back ( static_cast<UInt16>(m_triangles[*index].v1) );
+			m_indices.push_back ( static_cast<UInt16>(m_triangles[*index].v2) );
+		}
 	}
 
 }
@@ -222,57 +309,195 @@ void Mesh::BuildGroups ( std::vector<MeshGroupDescriptor>& groupDescriptor )
 
 
 //=========================================================================
-//! @function    Mesh::GenerateNormals
-//! @brief       Generate face and vertex normals for the mesh
+//! @function    Mesh::GenerateLODs
+//! @brief       Generate lower levels of detail for every group, by simplifying
+//!				 the whole mesh with quadric error metrics
 //!              
+//!				 Each LOD aims for half the triangles of the one before it. The simplified
+//!				 triangles only use the mesh's existing vertices, so every LOD is just
+//!				 another range of indices, appended to the index buffer after the full 
+//!				 detail groups. Edges with only one triangle, including the seams where
+//!				 vertices were split for smoothing groups or texture coordinates, are kept
+//!				 in place, so the mesh doesn't open up as it's simplified.
 //=========================================================================
-void Mesh::GenerateNormals ( )
+void Mesh::GenerateLODs ( )
 {
-	TriangleIterator triangle = TrianglesBegin();
-	TriangleIterator trianglesEnd = TrianglesEnd();
+	const UInt triangleCount = m_indices.size() / 3;
 
+	std::vector<Math::Vector3D> positions ( VertexCount() );
+	std::vector<UInt>			indices ( m_indices.begin(), m_indices.end() );
 
-	//First generate face normals 
-	for ( ; triangle != trianglesEnd; ++triangle )
+	for ( UInt vertex = 0; vertex < VertexCount(); ++vertex )
 	{
-		//Make sure that the vertex indices of the triangle are valid
-		debug_assert ( triangle->v0 <= VertexCount(), "v0 has an invalid vertex index!" );
-		debug_assert ( triangle->v1 <= VertexCount(), "v1 has an invalid vertex index!" );
-		debug_assert ( triangle->v2 <= VertexCount(), "v2 has an invalid vertex index!" );
+		positions[vertex] = m_vertices[vertex].position;
+	}
+
+	Math::MeshSimplifier simplifier;
+	simplifier.Initialise ( &positions[0], VertexCount(), &indices[0], triangleCount );
+
+	std::vector<UInt> sourceTriangles;
+	UInt previousTriangleCount = triangleCount;
+
+	for ( ; m_lodCount < g_maxMeshLODs; ++m_lodCount )
+	{
+		if ( (previousTriangleCount / 2) < minLODTriangleCount )
+		{
+			break;
+		}
 
-		//Calculate the face normal
-		Math::Vector3D v0v1 = m_vertices[triangle->v1].position - m_vertices[triangle->v0].position;
-		Math::Vector3D v0v2 = m_vertices[triangle->v2].position - m_vertices[triangle->v0].position;
+		simplifier.SimplifyTo ( previousTriangleCount / 2 );
 
-		Math::Vector3D::CrossProduct ( v0v1, v0v2, triangle->faceNormal );
-		triangle->faceNormal.Normalise();
+		//Not worth a LOD if the simplifier got stuck early
+		if ( simplifier.TriangleCount() > ((previousTriangleCount * 3) / 4) )
+		{
+			break;
+		}
+
+		simplifier.GetTriangles ( indices, sourceTriangles );
+
+		//Triangles come back in their original order, so each group's triangles are together
+		UInt triangle = 0;
+
+		for ( MeshGroupIterator group = MeshGroupsBegin(); group != MeshGroupsEnd(); ++group )
+		{
+			const UInt groupEnd = (group->LOD(0).StartOffset() / 3) + group->LOD(0).TriangleCount();
+			const UInt startOffset = m_indices.size();
+
+			for ( ; (triangle < sourceTriangles.size()) && (sourceTriangles[triangle] < groupEnd); ++triangle )
+			{
+				m_indices.push_back ( static_cast<UInt16>(indices[(triangle * 3)]) );
+				m_indices.push_back ( static_cast<UInt16>(indices[(triangle * 3) + 1]) );
+				m_indices.push_back ( static_cast<UInt16>(indices[(triangle * 3) + 2]) );
+			}
+
+			group->AddLOD ( startOffset, (m_indices.size() - startOffset) / 3 );
+		}
+
+		previousTriangleCount = simplifier.TriangleCount();
+
+		std::clog << __FUNCTION__ << ": " << Name() << " LOD " << m_lodCount << " has " 
+				  << previousTriangleCount << " triangles, error " << simplifier.Error() << std::endl;
 	}
+}
+//End Mesh::GenerateLODs
 
-	VertexIterator vertex = VerticesBegin();
-	VertexIterator vertexEnd = VerticesEnd();
-	UInt		   vertexUsageCount = 0;
-	UInt		   vertexIndex = 0;
 
-	//Then generate vertex normals
-	for ( ; vertex != vertexEnd; ++vertex, ++vertexIndex )
-	{
-		vertexUsageCount = 0;
 
-		//Go through each triangle, checking to see
-		//if it uses this vertex
-		for ( triangle = TrianglesBegin(); triangle != trianglesEnd; ++triangle )
+//=========================================================================
+//! @function    Mesh::OptimiseVertexCache
+//! @brief       Reorder the triangles of each group and LOD for the vertex cache,
+//!				 then reorder the vertices into the order they're first used
+//!              
+//!				 This runs before the mesh is cooked, so cooked meshes are stored optimised.
+//=========================================================================
+void Mesh::OptimiseVertexCache ( )
+{
+	const Float acmrBefore = Renderer::VertexCacheOptimiser::ACMR ( &m_indices[0], m_indices.size() );
+
+	Renderer::VertexCacheOptimiser optimiser;
+
+	for ( ConstMeshGroupIterator group = MeshGroupsBegin(); group != MeshGroupsEnd(); ++group )
+	{
+		for ( UInt lod = 0; lod < group->LODCount(); ++lod )
 		{
-			if (	( triangle->v0 == vertexIndex )
-				||  ( triangle->v1 == vertexIndex )
-				||  ( triangle->v2 == vertexIndex ) )
+			if ( group->LOD(lod).TriangleCount() > 0 )
 			{
-				++vertexUsageCount;
-				vertex->normal += triangle->faceNormal;
+				optimiser.OptimiseTriangleOrder ( &m_indices[group->LOD(lod).StartOffset()], 
+												  group->LOD(lod).TriangleCount() * 3, 
+												  VertexCount() );
 			}
 		}
+	}
+
+	std::vector<UInt> newVertexIndices;
+	Renderer::VertexCacheOptimiser::ReorderVertices ( &m_indices[0], m_indices.size(), VertexCount(), newVertexIndices );
+
+	VertexStore reorderedVertices ( m_vertices.size() );
+
+	for ( UInt vertex = 0; vertex < m_vertices.size(); ++vertex )
+	{
+		reorderedVertices[newVertexIndices[vertex]] = m_vertices[vertex];
+	}
+
+	m_vertices.swap ( reorderedVertices );
+
+	//Keep the triangles in step with the vertices
+	for ( TriangleIterator triangle = TrianglesBegin(); triangle != TrianglesEnd(); ++triangle )
+	{
+		triangle->v0 = newVertexIndices[triangle->v0];
+		triangle->v1 = newVertexIndices[triangle->v1];
+		triangle->v2 = newVertexIndices[triangle->v2];
+	}
+
+	const Float acmrAfter = Renderer::VertexCacheOptimiser::ACMR ( &m_indices[0], m_indices.size() );
+
+	std::clog << __FUNCTION__ << ": " << Name() << " ACMR " << acmrBefore << " before, " << acmrAfter << " after" << std::endl;
+}
+//End Mesh::OptimiseVertexCache
+
+
 
-		vertex->normal /= vertexUsageCount;
-		vertex->normal.Normalise();
+//=========================================================================
+//! @function    Mesh::GenerateNormals
+//! @brief       Generate face and vertex normals for the mesh
+//!              
+//!				 Vertices shared by triangles in different smoothing groups are split,
+//!				 so this has to be done before the groups are built.
+//!
+//! @throw		 Core::RuntimeError
+//=========================================================================
+void Mesh::GenerateNormals ( )
+{
+	const UInt originalVertexCount = VertexCount();
+	const UInt triangleCount = TriangleCount();
+
+	std::vector<Math::Vector3D> positions ( originalVertexCount );
+	std::vector<UInt>			indices ( triangleCount * 3 );
+	std::vector<UInt>			smoothingGroups ( triangleCount );
+
+	for ( UInt vertex = 0; vertex < originalVertexCount; ++vertex )
+	{
+		positions[vertex] = m_vertices[vertex].position;
+	}
+
+	for ( UInt triangle = 0; triangle < triangleCount; ++triangle )
+	{
+		indices[(triangle * 3)]		= m_triangles[triangle].v0;
+		indices[(triangle * 3) + 1] = m_triangles[triangle].v1;
+		indices[(triangle * 3) + 2] = m_triangles[triangle].v2;
+		smoothingGroups[triangle]	= m_triangles[triangle].smoothingGroup;
+	}
+
+	Math::VertexNormalGenerator generator;
+	generator.Generate ( &positions[0], originalVertexCount, &indices[0], &smoothingGroups[0], triangleCount );
+
+	//The index buffer is 16 bit
+	if ( generator.VertexCount() > 0x10000 )
+	{
+		throw Core::RuntimeError ( "Mesh has too many vertices for a 16 bit index buffer after splitting smoothing groups", 
+								   0, __FILE__, __FUNCTION__, __LINE__ );
+	}
+
+	//Copy the vertices that were split off
+	m_vertices.reserve ( generator.VertexCount() );
+
+	for ( UInt vertex = originalVertexCount; vertex < generator.VertexCount(); ++vertex )
+	{
+		Vertex copy = m_vertices[generator.SourceVertex(vertex)];
+		m_vertices.push_back ( copy );
+	}
+
+	for ( UInt vertex = 0; vertex < generator.VertexCount(); ++vertex )
+	{
+		m_vertices[vertex].normal = generator.VertexNormal(vertex);
+	}
+
+	for ( UInt triangle = 0; triangle < triangleCount; ++triangle )
+	{
+		m_triangles[triangle].v0 = indices[(triangle * 3)];
+		m_triangles[triangle].v1 = indices[(triangle * 3) + 1];
+		m_triangles[triangle].v2 = indices[(triangle * 3) + 2];
+		m_triangles[triangle].faceNormal = generator.FaceNormal(triangle);
 	}
 
 }
@@ -284,15 +509,16 @@ void Mesh::GenerateNormals ( )
 //! @function    Mesh::CreateMeshVertexBuffer
 //! @brief       Create the vertex buffer for the vertex data
 //!              
-//! @param		 renderer [in] Renderer to get the vertex buffer from
+//! @param		 renderer	 [in] Renderer to get the vertex buffer from
+//! @param		 vertexCount [in] Number of vertices in the buffer
 //!
 //! @throw		 Core::RuntimeError
 //=========================================================================
-void Mesh::CreateMeshVertexBuffer ( Renderer::IRenderer& renderer )
+void Mesh::CreateMeshVertexBuffer ( Renderer::IRenderer& renderer, UInt vertexCount )
 {
 	//Create the vertex buffer
 	Renderer::HVertexBuffer stream0 
-				= renderer.CreateVertexBuffer ( sizeof(MeshStream0), m_vertices.size(), Renderer::USAGE_STATICWRITEONLY  );
+				= renderer.CreateVertexBuffer ( sizeof(MeshStream0), vertexCount, Renderer::USAGE_STATICWRITEONLY  );
 
 	m_vertexStreams.SetStream ( stream0, 0 );
 
@@ -313,7 +539,7 @@ void Mesh::CreateMeshVertexBuffer ( Renderer::IRenderer& renderer )
 
 //=========================================================================
 //! @function    Mesh::FillVertexBuffer
-//! @brief       Fill the mesh's vertex buffer
+//! @brief       Fill the mesh's vertex buffer from the mesh's vertices
 //!              
 //! @throw		 Core::RuntimeError              
 //=========================================================================
@@ -336,25 +562,68 @@ void Mesh::FillVertexBuffer ( )
 	//Copy all of the vertices into the vertex buffer
 	for ( ConstVertexIterator itr = VerticesBegin(); itr != VerticesEnd(); ++itr )
 	{
-		vertex->position[0] = itr->position.X();
-		vertex->position[1] = itr->position.Y();
-		vertex->position[2] = itr->position.Z();
+		ConvertVertex ( *itr, *vertex );
+		++vertex;
+	}
+}
+//End Mesh::FillVertexBuffer
 
-		vertex->normal[0] = itr->normal.X();
-		vertex->normal[1] = itr->normal.Y();
-		vertex->normal[2] = itr->normal.Z();
 
-		vertex->colour = itr->colour;
 
-		debug_assert ( vertex->colour = 0xFFFFFFFF, "Bullshit is happening here" );
+//=========================================================================
+//! @function    Mesh::FillVertexBuffer
+//! @brief       Fill the mesh's vertex buffer with vertices that are already in
+//!				 vertex buffer format
+//!              
+//! @param		 vertices	 [in] Array of vertices
+//! @param		 vertexCount [in] Number of vertices
+//!
+//! @throw		 Core::RuntimeError              
+//=========================================================================
+void Mesh::FillVertexBuffer ( const MeshStream0* vertices, UInt vertexCount )
+{
+	Renderer::HVertexBuffer stream0 = m_vertexStreams.GetStream ( 0 );
+
+	debug_assert ( stream0, "Null vertex buffer handle!" );
 
-		vertex->texcoord[0] = itr->texCoord0.X();
-		vertex->texcoord[1] = itr->texCoord0.Y();
+	Renderer::ScopedVertexBufferLock lock = stream0->LockAll ( Renderer::LOCK_NORMAL );
 
-		++vertex;
+	if ( !lock )
+	{
+		throw Core::RuntimeError ( "Error, couldn't lock vertex buffer!", 0, __FILE__, __FUNCTION__, __LINE__ );
 	}
+
+	std::memcpy ( lock.GetLockPointer(), vertices, sizeof(MeshStream0) * vertexCount );
 }
-//End Mesh::FillIndexBuffer
+//End Mesh::FillVertexBuffer
+
+
+
+//=========================================================================
+//! @function    Mesh::ConvertVertex
+//! @brief       Convert a vertex into vertex buffer format
+//!              
+//! @param		 vertex		  [in]	Vertex to convert
+//! @param		 streamVertex [out] Vertex buffer format vertex
+//=========================================================================
+void Mesh::ConvertVertex ( const Vertex& vertex, MeshStream0& streamVertex )
+{
+	streamVertex.position[0] = vertex.position.X();
+	streamVertex.position[1] = vertex.position.Y();
+	streamVertex.position[2] = vertex.position.Z();
+
+	streamVertex.normal[0] = vertex.normal.X();
+	streamVertex.normal[1] = vertex.normal.Y();
+	streamVertex.normal[2] = vertex.normal.Z();
+
+	streamVertex.colour = vertex.colour;
+
+	debug_assert ( streamVertex.colour = 0xFFFFFFFF, "Bullshit is happening here" );
+
+	streamVertex.texcoord[0] = vertex.texCoord0.X();
+	streamVertex.texcoord[1] = vertex.texCoord0.Y();
+}
+//End Mesh::ConvertVertex
 
 
 
@@ -362,24 +631,13 @@ void Mesh::FillVertexBuffer ( )
 //! @function    Mesh::CreateMeshIndexBuffer
 //! @brief       Create the index buffer to store the indices
 //!              
-//! @param       renderer [in] 
+//! @param       renderer	[in] Renderer to get the index buffer from
+//! @param       indexCount [in] Number of indices in the buffer
 //!              
 //! @throw       Core::RuntimeError
 //=========================================================================
-void Mesh::CreateMeshIndexBuffer ( Renderer::IRenderer& renderer )
+void Mesh::CreateMeshIndexBuffer ( Renderer::IRenderer& renderer, UInt indexCount )
 {
-	//Get the number of indices by adding the number of indices from each mesh group
-	UInt indexCount = 0;
-
-	for ( ConstMeshGroupIterator itr = MeshGroupsBegin(); itr != MeshGroupsEnd(); ++itr )
-	{
-		indexCount += itr->IndexCount();
-	}
-
-	//Multiply by three, since each triangle has three vertices
-	indexCount *= 3;
-
-	//Now create the vertex buffer
 	m_indexBuffer = renderer.CreateIndexBuffer ( Renderer::INDEX_16BIT, indexCount, 
 												 Renderer::USAGE_STATICWRITEONLY );
 
@@ -393,12 +651,14 @@ void Mesh::CreateMeshIndexBuffer ( Renderer::IRenderer& renderer )
 
 //=========================================================================
 //! @function    Mesh::FillIndexBuffer
-//! @brief       Fill the mesh index buffer with indices from the mesh groups
+//! @brief       Fill the mesh index buffer
 //!              
+//! @param		 indices	[in] Array of indices for all groups
+//! @param		 indexCount [in] Number of indices
 //!              
 //! @throw       Core::RuntimeError
 //=========================================================================
-void Mesh::FillIndexBuffer ( )
+void Mesh::FillIndexBuffer ( const UInt16* indices, UInt indexCount )
 {
 	
 	//First lock the buffer
@@ -410,46 +670,156 @@ void Mesh::FillIndexBuffer ( )
 									__FILE__, __FUNCTION__, __LINE__ );
 	}
 
-	UInt16*	currentIndex = reinterpret_cast<UInt16*>( lock.GetLockPointer() );
+	std::memcpy ( lock.GetLockPointer(), indices, sizeof(UInt16) * indexCount );
+
+}
+//End Mesh::FillIndexBuffer
+
+
+
+//=========================================================================
+//! @function    Mesh::WriteCooked
+//! @brief       Write the mesh to a stream in the cooked mesh format
+//!              
+//!				 Only meshes built from vertices and triangles can be written, since
+//!				 meshes loaded from cooked files don't keep their data.
+//!
+//! @param       file [in] Binary stream to write to
+//!              
+//! @throw       Core::RuntimeError
+//=========================================================================
+void Mesh::WriteCooked ( std::ostream& file ) const
+{
+	if ( m_vertices.empty() || m_indices.empty() )
+	{
+		throw Core::RuntimeError ( "Mesh has no vertex data to cook!", 0, __FILE__, __FUNCTION__, __LINE__ );
+	}
+
+	CookedMesh::Header header;
+	header.id = CookedMesh::fileId;
+	header.version = CookedMesh::version;
+	header.vertexCount = m_vertices.size();
+	header.indexCount = m_indices.size();
+	header.groupCount = m_groups.size();
+	header.effectCount = m_effects.size();
+	header.lodCount = m_lodCount;
+
+	Math::Vector3D boundsMin = m_boundingBox.GetCorner ( Math::AxisAlignedBoundingBox::MIN_X_MIN_Y_MIN_Z );
+	Math::Vector3D boundsMax = m_boundingBox.GetCorner ( Math::AxisAlignedBoundingBox::MAX_X_MAX_Y_MAX_Z );
+
+	header.boundsMin[0] = boundsMin.X();
+	header.boundsMin[1] = boundsMin.Y();
+	header.boundsMin[2] = boundsMin.Z();
+	header.boundsMax[0] = boundsMax.X();
+	header.boundsMax[1] = boundsMax.Y();
+	header.boundsMax[2] = boundsMax.Z();
+
+	file.write ( reinterpret_cast<const Char*>(&header), sizeof(header) );
+
+	//Vertices
+	std::vector<MeshStream0> streamVertices ( m_vertices.size() );
+
+	for ( UInt vertex = 0; vertex < m_vertices.size(); ++vertex )
+	{
+		ConvertVertex ( m_vertices[vertex], streamVertices[vertex] );
+	}
+
+	file.write ( reinterpret_cast<const Char*>(&streamVertices[0]), sizeof(MeshStream0) * streamVertices.size() );
 
-	//Iterate through each mesh group, copying the vertex indices into the index buffer
+	//Indices, padded so that the groups are aligned
+	const UInt16 padding = 0;
+
+	file.write ( reinterpret_cast<const Char*>(&m_indices[0]), sizeof(UInt16) * m_indices.size() );
+	file.write ( reinterpret_cast<const Char*>(&padding), CookedMesh::IndexPadding(m_indices.size()) );
+
+	//Groups
 	for ( ConstMeshGroupIterator group = MeshGroupsBegin(); group != MeshGroupsEnd(); ++group )
 	{
-		
-		for ( MeshGroup::ConstIndexIterator index = group->IndicesBegin();
-			 index != group->IndicesEnd();
-			 ++index )
+		CookedMesh::Group cookedGroup;
+		std::memset ( &cookedGroup, 0, sizeof(cookedGroup) );
+
+		group->Name().copy ( cookedGroup.name, sizeof(cookedGroup.name) );
+		for ( UInt lod = 0; lod < group->LODCount(); ++lod )
 		{
-		
-			*currentIndex = m_triangles[*index].v0;
-			++currentIndex;
+			cookedGroup.startOffset[lod] = group->LOD(lod).StartOffset();
+			cookedGroup.triangleCount[lod] = group->LOD(lod).TriangleCount();
+		}
 
-			*currentIndex = m_triangles[*index].v1;
-			++currentIndex;
+		cookedGroup.minVertexIndex = group->MinVertexIndex();
+		cookedGroup.maxVertexIndex = group->MaxVertexIndex();
 
-			*currentIndex = m_triangles[*index].v2;
-			++currentIndex;
+		//Groups refer to effects by their index in the effect list
+		cookedGroup.effectIndex = m_effects.size();
 
+		for ( UInt effect = 0; effect < m_effects.size(); ++effect )
+		{
+			if ( static_cast<UInt>(m_effects[effect]) == static_cast<UInt>(group->GetEffect()) )
+			{
+				cookedGroup.effectIndex = effect;
+				break;
+			}
 		}
+
+		if ( cookedGroup.effectIndex == m_effects.size() )
+		{
+			throw Core::RuntimeError ( "Mesh group's effect isn't in the mesh's effect list!", 0, __FILE__, __FUNCTION__, __LINE__ );
+		}
+
+		file.write ( reinterpret_cast<const Char*>(&cookedGroup), sizeof(cookedGroup) );
 	}
 
+	//Effects, by file name
+	for ( ConstEffectIterator effect = EffectsBegin(); effect != EffectsEnd(); ++effect )
+	{
+		CookedMesh::Effect cookedEffect;
+		std::memset ( &cookedEffect, 0, sizeof(cookedEffect) );
+
+		if ( (*effect)->Name().size() > sizeof(cookedEffect.fileName) )
+		{
+			throw Core::RuntimeError ( "Effect file name is too long to cook!", 0, __FILE__, __FUNCTION__, __LINE__ );
+		}
+
+		(*effect)->Name().copy ( cookedEffect.fileName, sizeof(cookedEffect.fileName) );
+
+		file.write ( reinterpret_cast<const Char*>(&cookedEffect), sizeof(cookedEffect) );
+	}
 
+	if ( !file )
+	{
+		throw Core::RuntimeError ( "Error writing cooked mesh!", 0, __FILE__, __FUNCTION__, __LINE__ );
+	}
 }
-//End Mesh::FillIndexBuffer
+//End Mesh::WriteCooked
 
 
 //=========================================================================
 //! @function    Mesh::QueueForRendering
 //! @brief       Queue all mesh groups for rendering
 //!              
+//!				 The geometry LOD drops by one each time the mesh's size on screen halves,
+//!				 starting from mesh_lodscreensize.
+//!
 //! @param		 queue		 [in] Queue to add the mesh to
 //! @param		 worldMatrix [in] worldMatrix, world matrix to transform the mesh by on rendering
-//! @param		 lodIndex	 [in] lodIndex, LOD index at which to render the mesh
+//! @param		 lodIndex	 [in] lodIndex, LOD index used to pick the effect technique
+//! @param		 screenSize	 [in] Projected radius of the mesh, as a fraction of half the screen height
 //!              
 //! @throw       Core::RuntimeError
 //=========================================================================
-void Mesh::QueueForRendering ( Renderer::RenderQueue& queue, const Math::Matrix4x4& worldMatrix, UInt lodIndex )
+void Mesh::QueueForRendering ( Renderer::RenderQueue& queue, const Math::Matrix4x4& worldMatrix, 
+							   UInt lodIndex, Float screenSize )
 {
+	static Core::ConsoleFloat mesh_lodscreensize ( "mesh_lodscreensize", 0.2f );
+
+	UInt  geometryLOD = 0;
+	Float threshold = mesh_lodscreensize;
+
+	while ( ((geometryLOD + 1) < m_lodCount) && (screenSize < threshold) )
+	{
+		++geometryLOD;
+		threshold *= 0.5f;
+	}
+
 	MeshGroupIterator itr = MeshGroupsBegin();
 	MeshGroupIterator end = MeshGroupsEnd();
 
@@ -460,7 +830,8 @@ void Mesh::QueueForRendering ( Renderer::RenderQueue& queue, const Math::Matrix4
 								 m_indexBuffer,
 								 m_vertexStreams,
 								 worldMatrix,
-								 lodIndex );
+								 lodIndex,
+								 geometryLOD );
 	}
 }
 //End Mesh::QueueForRendering
@@ -495,16 +866,18 @@ void Mesh::Render ( Renderer::IRenderer& renderer )
 //! @param       vertexDeclaration 
 //! @param       indexBuffer 
 //! @param       streamBinding 
+//! @param		 worldMatrix [in] World matrix to transform the group by on rendering
+//! @param		 lodIndex	 [in] LOD index used to pick the effect technique
+//! @param		 geometryLOD [in] Level of detail of the triangles to draw
 //!              
-//! @return      
-//! @throw       
 //=========================================================================
 void MeshGroup::QueueForRendering ( Renderer::RenderQueue& queue, 
 									Renderer::HVertexDeclaration& vertexDeclaration,
 									Renderer::HIndexBuffer& indexBuffer,
 									Renderer::VertexStreamBinding& streamBinding,
 									const Math::Matrix4x4& worldMatrix,
-									UInt lodIndex )
+									UInt lodIndex,
+									UInt geometryLOD )
 {
 	if ( !m_effect )
 	{
@@ -512,9 +885,22 @@ void MeshGroup::QueueForRendering ( Renderer::RenderQueue& queue,
 		return;
 	}
 
+	if ( geometryLOD >= m_lods.size() )
+	{
+		geometryLOD = m_lods.size() - 1;
+	}
+
+	//Small groups can be simplified away completely
+	MeshGroupLOD& lod = m_lods[geometryLOD];
+
+	if ( lod.TriangleCount() == 0 )
+	{
+		return;
+	}
+
 	for ( UInt passIndex = 0; passIndex < m_effect->Techniques(0).PassCount(); ++passIndex )
 	{
-		queue.QueueForRendering ( *this, 
+		queue.QueueForRendering ( lod, 
 								  m_effect, 
 								  m_effect->GetBestTechniqueForLOD(lodIndex), 
 								  passIndex,
@@ -530,20 +916,53 @@ void MeshGroup::QueueForRendering ( Renderer::RenderQueue& queue,
 
 //=========================================================================
 //! @function    MeshGroup::Render
-//! @brief       Render a mesh group
+//! @brief       Render a mesh group at full detail
 //!              
 //! @param       renderer [in] 
 //!              
 //=========================================================================
 void MeshGroup::Render ( Renderer::IRenderer& renderer )
+{
+	
+	m_lods[0].Render ( renderer );
+
+}
+//End MeshGroup::Render
+
+
+
+//=========================================================================
+//! @function    MeshGroup::AddLOD
+//! @brief       Add the next level of detail of the group
+//!              
+//! @param       startOffset   [in] First index of the LOD in the index buffer
+//! @param       triangleCount [in] Number of triangles in the LOD
+//!              
+//=========================================================================
+void MeshGroup::AddLOD ( UInt startOffset, UInt triangleCount )
+{
+	m_lods.push_back ( MeshGroupLOD ( startOffset, triangleCount, m_minVertexIndex, m_maxVertexIndex ) );
+}
+//End MeshGroup::AddLOD
+
+
+
+//=========================================================================
+//! @function    MeshGroupLOD::Render
+//! @brief       Render one level of detail of a mesh group
+//!              
+//! @param       renderer [in] 
+//!              
+//=========================================================================
+void MeshGroupLOD::Render ( Renderer::IRenderer& renderer )
 {
 	
 	renderer.DrawIndexedPrimitive ( Renderer::PRIM_TRIANGLELIST,
 									0,
 									m_maxVertexIndex,
 									m_startOffset,
-									m_triangleIndices.size() * 3 );
+									m_triangleCount * 3 );
 
 }
-//End MeshGroup::Render
+//End MeshGroupLOD::Render
 
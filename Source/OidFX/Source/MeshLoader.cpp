@@ -26,12 +26,16 @@
 //
 //======================================================================================
 
+#include <sys/stat.h>
+#include <cstdio>
 #include "Core/Core.h"
+#include "Core/MemoryMappedFile.h"
 #include "Renderer/Renderer.h"
 #include "Renderer/EffectManager.h"
 #include "OidFX/Mesh.h"
 #include "OidFX/MeshLoader.h"
 #include "OidFX/MilkshapeLoader.h"
+#include "OidFX/CookedMeshLoader.h"
 
 
 
@@ -39,10 +43,48 @@ using namespace OidFX;
 
 
 
+//namespace
+namespace
+{
+
+	//=========================================================================
+    //! @function    IsCookedFileCurrent
+    //! @brief       Check that a cooked file exists, and isn't older than its source file.
+	//!				 A cooked file with no source file is always current, so that
+	//!				 cooked files can be shipped on their own
+    //=========================================================================
+	bool IsCookedFileCurrent ( const Char* sourceFileName, const Char* cookedFileName )
+	{
+		struct stat cookedStatus;
+		struct stat sourceStatus;
+
+		if ( stat ( cookedFileName, &cookedStatus ) != 0 )
+		{
+			return false;
+		}
+
+		if ( stat ( sourceFileName, &sourceStatus ) != 0 )
+		{
+			return true;
+		}
+
+		return cookedStatus.st_mtime >= sourceStatus.st_mtime;
+	}
+	//End IsCookedFileCurrent
+
+}
+//end namespace
+
+
+
 //=========================================================================
 //! @function    MeshLoader::Load
-//! @brief       Load a mesh from a milkshape file
+//! @brief       Load a mesh from a cooked mesh file, or from a milkshape file
 //!              
+//!				 If there is an up to date cooked version of the file, it is
+//!				 memory mapped and loaded from. Otherwise the milkshape file is loaded,
+//!				 and the cooked version is written for next time.
+//!
 //!				 Note that the material properties in milkshape are completely
 //!				 ignored. Instead, the name of the material is used to find
 //!				 an effect file,
@@ -56,6 +98,28 @@ boost::shared_ptr<Mesh> MeshLoader::Load ( const Char* fileName )
 {
 	debug_assert ( fileName, "Filname is null!" );
 
+	static Core::ConsoleBool mesh_usecooked ( "mesh_usecooked", true );
+	static Core::ConsoleBool mesh_writecooked ( "mesh_writecooked", true );
+
+	std::string cookedFileName ( fileName );
+	cookedFileName += CookedMesh::fileExtension;
+
+	if ( mesh_usecooked && IsCookedFileCurrent ( fileName, cookedFileName.c_str() ) )
+	{
+		try
+		{
+			Core::MemoryMappedFile cookedFile ( cookedFileName.c_str() );
+			CookedMesh::CookedMeshLoader loader ( m_renderer, m_effectManager );
+
+			return loader.Load ( cookedFile, fileName );
+		}
+		catch ( Core::Exception& error )
+		{
+			std::cerr << __FUNCTION__ << ": Couldn't load cooked mesh " << cookedFileName 
+					  << ", " << error.What() << ". Loading " << fileName << " instead" << std::endl;
+		}
+	}
+
 	std::ifstream meshFile ( fileName, std::ios::binary );
 
 	if ( !meshFile )
@@ -70,7 +134,28 @@ boost::shared_ptr<Mesh> MeshLoader::Load ( const Char* fileName )
 
 	Milkshape::MilkshapeLoader loader ( m_renderer, m_effectManager );
 	
-	return loader.Load ( meshFile, fileName );
+	boost::shared_ptr<Mesh> mesh = loader.Load ( meshFile, fileName );
+
+	if ( mesh_writecooked )
+	{
+		//Failing to cook isn't fatal, the mesh will just be loaded from milkshape again next time
+		std::ofstream cookedFile ( cookedFileName.c_str(), std::ios::binary );
+
+		try
+		{
+			mesh->WriteCooked ( cookedFile );
+		}
+		catch ( Core::Exception& error )
+		{
+			std::cerr << __FUNCTION__ << ": Couldn't write cooked mesh " << cookedFileName 
+					  << ", " << error.What() << std::endl;
+
+			cookedFile.close();
+			std::remove ( cookedFileName.c_str() );
+		}
+	}
+
+	return mesh;
 
 }
-//End MeshLoader::Load
\ No newline at end of file
+//End MeshLoader::Load
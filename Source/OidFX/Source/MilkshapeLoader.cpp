@@ -118,28 +118,19 @@ void MilkshapeLoader::ReadVertices ( VertexStore& vertices, std::istream& file )
 				  ") exceeds milkshapes maximum (" << maxVertices << ") File may be corrupt" << std::endl;
 	}
 
-	//Read in the vertices
-	vertices.reserve ( vertexCount );
+	//Read in all the vertices at once
+	vertices.resize ( vertexCount );
 
-	Milkshape::Vertex tempVertex;
+	if ( vertexCount > 0 )
+	{
+		file.read ( reinterpret_cast<std::ifstream::char_type*>(&vertices[0]), 
+					sizeof(Milkshape::Vertex) * vertexCount );
+	}
 
 	for ( Word i=0; i < vertexCount; ++i )
 	{
-		file.read ( reinterpret_cast<std::ifstream::char_type*>(&tempVertex), sizeof(tempVertex) );
-		vertices.push_back( tempVertex );
-/*
-		std::cout << (UInt)tempVertex.flags << "\t"
-				  << tempVertex.vertex[0] << "\t"
-				  << tempVertex.vertex[1] << "\t"
-				  << tempVertex.vertex[2] << "\t" << std::endl;
-*/
-		debug_assert ( tempVertex.boneId == -1, "Error" );
+		debug_assert ( vertices[i].boneId == -1, "Error" );
 	}
-/*
-	file.read ( reinterpret_cast<std::ifstream::char_type*>(&vertices[0]), 
-				sizeof(Milkshape::Vertex) * vertexCount );
-*/
-
 
 }
 //End MilkshapeLoader::ReadVertices
@@ -168,15 +159,13 @@ void MilkshapeLoader::ReadTriangles ( TriangleStore& triangles, std::istream& fi
 				  ") exceeds milkshapes maximum (" << maxTriangles << ") File may be corrupt" << std::endl;
 	}
 
-	//Read in the triangles
-	triangles.reserve(triangleCount);
-
-	Milkshape::Triangle tempTriangle;
+	//Read in all the triangles at once
+	triangles.resize ( triangleCount );
 
-	for ( UInt i=0; i < triangleCount; ++i )
+	if ( triangleCount > 0 )
 	{
-		file.read ( reinterpret_cast<std::ifstream::char_type*>(&tempTriangle), sizeof(tempTriangle) );
-		triangles.push_back( tempTriangle );
+		file.read ( reinterpret_cast<std::ifstream::char_type*>(&triangles[0]), 
+					sizeof(Milkshape::Triangle) * triangleCount );
 	}
 
 }
@@ -74,36 +74,19 @@ MissileLauncher::MissileLauncher ( Scene& scene,
 
 
 //=========================================================================
-//! @function    MissileLauncher::Update
-//! @brief       Update the missile launcher
+//! @function    MissileLauncher::OnThink
+//! @brief       Reload the missile launcher
 //!              
-//! @param       toWorldStack			[in]	
-//! @param       fromWorldStack			[in]	
-//! @param       timeElapsedInSeconds	[in]	
+//! @param       timeElapsed [in]	
 //!              
 //=========================================================================
-void MissileLauncher::Update ( Math::MatrixStack& toWorldStack, 
-							   Math::MatrixStack& fromWorldStack, 
-							   Float timeElapsedInSeconds )
+void MissileLauncher::OnThink ( Float timeElapsed )
 {
 
-	// HACK Fix broken scene graph implementation. 
-	//
-	//		This is yet another temporary fix that will not be needed, once I find time
-	//		to redesign the scene graph.
-	EntityNode* entity = reinterpret_cast<EntityNode*>( m_parent );
-
-	m_objectToWorld.Identity();
-	m_objectToWorld.Translate( m_position * entity->GetOrientation() );
-
-	//
-	EntityNode::Update( toWorldStack, fromWorldStack, timeElapsedInSeconds );
-
-
 	//Update the launcher state
 	if ( LS_RELOADING == m_launcherState )
 	{
-		m_timeElapsedSinceLastFired += timeElapsedInSeconds;
+		m_timeElapsedSinceLastFired += timeElapsed;
 
 		if ( m_timeElapsedSinceLastFired > m_reloadTime )
 		{
@@ -112,10 +95,8 @@ void MissileLauncher::Update ( Math::MatrixStack& toWorldStack,
 		}
 	}
 
-
-
 }
-//End MissileLauncher::Update
+//End MissileLauncher::OnThink
 
 
 
@@ -123,8 +104,10 @@ void MissileLauncher::Update ( Math::MatrixStack& toWorldStack,
 //! @function    MissileLauncher::LaunchMissile
 //! @brief       Launches a missile if possible
 //!              
-//! @return      
-//! @throw       
+//!				 Called while the parent thinks, so the missile is spawned by 
+//!				 FireMissile once the update jobs have finished
+//!
+//! @return      true if a missile will be launched, false otherwise
 //=========================================================================
 bool MissileLauncher::LaunchMissile ( )
 {
@@ -150,20 +133,42 @@ bool MissileLauncher::LaunchMissile ( )
 		return false;
 	}
 
+	m_launcherState = LS_RELOADING;
+
+	m_scene.Commands().LaunchMissile ( *this );
+
+	return true;
+}
+//End MissileLauncher::LaunchMissile
+
+
+
+//=========================================================================
+//! @function    MissileLauncher::FireMissile
+//! @brief       Spawn the missile requested by LaunchMissile
+//!              
+//!				 If there are no projectiles left, the launcher is made ready
+//!				 again, so that it can try again
+//=========================================================================
+void MissileLauncher::FireMissile ( )
+{
+	static Core::ConsoleFloat missile_escape_velocity ( "missile_escape_velocity", 30.0f );
+	static Core::ConsoleFloat missile_parent_velocity ( "missile_parent_velocity", 1.0f );
+
 	// HACK
 	//This is evil, and further shows the need for a redesign when time permits
 	EntityNode* parent = reinterpret_cast<EntityNode*>( m_parent );
 
 	Math::Vector3D position = GetWorldSpacePosition();
 
-	//If we got this far, then we really should fire a missile
 	ProjectilePtr projectile = m_scene.GetProjectileManager().SpawnProjectile 
 											( position, parent->ID(), GetMesh() );
 
 	//No projectiles left
 	if ( !projectile )
 	{
-		return false;
+		m_launcherState = LS_READY;
+		return;
 	}
 
 	projectile->SetOrientation( parent->GetOrientation() );
@@ -182,18 +187,11 @@ bool MissileLauncher::LaunchMissile ( )
 	Math::Vector3D forward = Forward();
 	forward.Normalise();
 
-	Core::ConsoleFloat missile_escape_velocity ( "missile_escape_velocity", 30.0f );
-	Core::ConsoleFloat missile_parent_velocity ( "missile_parent_velocity", 1.0f );
-
 	//Set the projectile's velocity to the parents velocity plus a little kick in the forward
 	//direction
 	projectile->SetVelocity( (parent->GetVelocity() * missile_parent_velocity)
 								+ (-forward * missile_escape_velocity) );
 
 	projectile->SetTarget( m_targetingComputer.GetCurrentTarget() );
-
-	m_launcherState = LS_RELOADING;
-
-
-	return true;
-}
\ No newline at end of file
+}
+//End MissileLauncher::FireMissile
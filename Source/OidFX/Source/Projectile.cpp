@@ -54,7 +54,7 @@ Projectile::Projectile ( Scene& scene,
 : EntityNode( scene, name, "", toWorld, fromWorld ),
   m_projectileState(PS_LAUNCHSTAGE),
   m_timeOut(0.0f),
-  m_target(0)
+  m_target()
 {
 
 	SetFlag( PF_MISSILE );
@@ -94,8 +94,8 @@ void Projectile::Spawn ( const Math::Vector3D& spawnPoint, UInt ownerID, HMesh&
 	
 	m_ownerID = ownerID;
 
-	Core::ConsoleFloat missile_timetolive ( "missile_timetolive", 3.0f );
-	Core::ConsoleFloat missile_strength   ( "missile_strength", 500.0f );
+	static Core::ConsoleFloat missile_timetolive ( "missile_timetolive", 3.0f );
+	static Core::ConsoleFloat missile_strength   ( "missile_strength", 500.0f );
 
 	m_timeOut = missile_timetolive;
 	m_explosiveStrength = missile_strength;
@@ -111,18 +111,31 @@ void Projectile::Spawn ( const Math::Vector3D& spawnPoint, UInt ownerID, HMesh&
 
 
 //=========================================================================
-//! @function    Projectile::Update
-//! @brief       
+//! @function    Projectile::OnSpawn
+//! @brief       Event handler for spawn event
+//!              
+//! @param       spawnPoint [in]
+//!              
+//=========================================================================
+void Projectile::OnSpawn ( const Math::Vector3D& spawnPoint )
+{
+	
+}
+//End Projectile::OnSpawn
+
+
+//=========================================================================
+//! @function    Projectile::OnThink
+//! @brief       Steer the projectile towards its target, and fire its rockets
+//!				 once it has cleared the launcher
 //!              
-//! @param       toWorldStack			[in]
-//! @param       fromWorldStack			[in]
-//! @param       timeElapsedInSeconds	[in]
+//! @param       timeElapsed [in]
 //!              
 //=========================================================================
-void Projectile::Update ( Math::MatrixStack& toWorldStack,
-						  Math::MatrixStack& fromWorldStack,
-						  Float timeElapsedInSeconds )
+void Projectile::OnThink ( Float timeElapsed )
 {
+	//Time between missile being launched and firing its rockets
+	static Core::ConsoleFloat missile_rocket_delay ( "missile_rocket_delay", 1.0f );
 
 	//Clear target if it's dead or about to despawn
 	if ( (GetTarget()) && 
@@ -131,23 +144,19 @@ void Projectile::Update ( Math::MatrixStack& toWorldStack,
 		ClearTarget();
 	}
 
-	//Time between missile being launched and firing its rockets
-	Core::ConsoleFloat missile_rocket_delay ( "missile_rocket_delay", 1.0f );
-	
 	if ( IsFlagSet(EF_SPAWNED) && (!IsFlagSet(EF_DEAD)))
 	{
 
 		if ( GetTarget() )
 		{
 			//Make the missile turn to face its target
-			static Math::Vector3D v;
-			v = GetTarget()->BoundingBox().GetCentre() - BoundingBox().GetCentre();
+			Math::Vector3D v = GetTarget()->BoundingBox().GetCentre() - BoundingBox().GetCentre();
 			v.Normalise();
 
 			Float accelRight = Math::Vector3D::DotProduct( v, Right() );
 			Float accelUp   = Math::Vector3D::DotProduct( v, Up() );
 
-			m_angularAcceleration = Math::Vector3D( Math::DegreesToRadians(accelUp * 20.0f), 
+			AngularAcceleration() = Math::Vector3D( Math::DegreesToRadians(accelUp * 20.0f), 
 													-Math::DegreesToRadians(accelRight * 20.0f),
 														0.0f );
 		}
@@ -156,7 +165,7 @@ void Projectile::Update ( Math::MatrixStack& toWorldStack,
 		{
 			case PS_LAUNCHSTAGE:
 				
-				m_timeElapsedSinceLaunch += timeElapsedInSeconds;
+				m_timeElapsedSinceLaunch += timeElapsed;
 
 				if ( m_timeElapsedSinceLaunch >= missile_rocket_delay )
 				{
@@ -174,11 +183,11 @@ void Projectile::Update ( Math::MatrixStack& toWorldStack,
 				forward.Normalise();
 
 				//Accelerate 10 meters per second
-				m_acceleration += forward * 10.0f * meters;
+				Acceleration() += forward * 10.0f * meters;
 
 
 				//Make sure the rocket times out after a set period of time
-				m_timeOut -= timeElapsedInSeconds;
+				m_timeOut -= timeElapsed;
 
 				if ( m_timeOut <= 0.0f )
 				{
@@ -189,36 +198,6 @@ void Projectile::Update ( Math::MatrixStack& toWorldStack,
 		}
 	}
 
-	EntityNode::Update( toWorldStack, fromWorldStack, timeElapsedInSeconds );
-
-}
-//End Projectile::Update
-
-
-
-//=========================================================================
-//! @function    Projectile::OnSpawn
-//! @brief       Event handler for spawn event
-//!              
-//! @param       spawnPoint [in]
-//!              
-//=========================================================================
-void Projectile::OnSpawn ( const Math::Vector3D& spawnPoint )
-{
-	
-}
-//End Projectile::OnSpawn
-
-
-//=========================================================================
-//! @function    Projectile::OnThink
-//! @brief       Handle for think event
-//!              
-//! @param       timeElapsed [in]
-//!              
-//=========================================================================
-void Projectile::OnThink ( Float timeElapsed )
-{
 }
 //End Projectile::OnThink
 
@@ -216,6 +216,9 @@ void QuadtreeNode::AddSortedChild ( boost::shared_ptr<SceneObject> node )
 //! @function    QuadtreeNode::FillVisibleObjectList
 //! @brief       Fills the visible object with visible nodes
 //!              
+//!              If the list is being filled for parallel culling, and this node 
+//!				 is at the subtree split level, then the node is deferred, to be
+//!				 culled later by FillSubtreeVisibleObjectList on a worker thread
 //!              
 //! @param       visibleObjectList [out] List of visible objects to append to
 //! @param       camera			   [in] Camera to test visibility against
@@ -227,6 +230,13 @@ void QuadtreeNode::FillVisibleObjectList ( VisibleObjectList& visibleObjectList,
 	//Check whether the bounding box is in the view frustum
 	if ( (Math::Intersects ( m_boundingBox, camera.ViewFrustum())) )
 	{
+		if ( (visibleObjectList.SubtreeSplitLevel() != 0) 
+			 && (m_treeLevel == visibleObjectList.SubtreeSplitLevel()) )
+		{
+			visibleObjectList.DeferSubtree ( *this );
+			return;
+		}
+
 		//Call the base class FillVisibleObjectList to add all children
 		SceneNode::FillVisibleObjectList ( visibleObjectList, camera );
 	}
@@ -236,6 +246,27 @@ void QuadtreeNode::FillVisibleObjectList ( VisibleObjectList& visibleObjectList,
 
 
 
+//=========================================================================
+//! @function    QuadtreeNode::FillSubtreeVisibleObjectList
+//! @brief       Fill the visible object list with the visible children of
+//!				 a node that was deferred by FillVisibleObjectList
+//!
+//!				 The node's own frustum test has already been done, so this
+//!				 goes straight to the children. Safe to call from a worker thread
+//!				 as long as no other thread is culling the same subtree
+//!              
+//! @param       visibleObjectList [out] List of visible objects to append to
+//! @param       camera			   [in] Camera to test visibility against
+//!              
+//=========================================================================
+void QuadtreeNode::FillSubtreeVisibleObjectList ( VisibleObjectList& visibleObjectList, const Camera& camera )
+{
+	SceneNode::FillVisibleObjectList ( visibleObjectList, camera );
+}
+//End QuadtreeNode::FillSubtreeVisibleObjectList
+
+
+
 //=========================================================================
 //! @function    QuadtreeNode::BuildQuadtree
 //! @brief       Recursively adds quadtree nodes, until the quadtree node
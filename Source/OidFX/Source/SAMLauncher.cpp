@@ -122,60 +122,6 @@ SAMLauncher::SAMLauncher ( Scene& scene,
 
 
 
-
-//=========================================================================
-//! @function    SAMLauncher::Update
-//! @brief       Update the SAMLauncher
-//!              
-//! @param       toWorldStack			[in]  
-//! @param       fromWorldStack			[in]  
-//! @param       timeElapsedInSeconds	[in]  
-//!              
-//=========================================================================
-void SAMLauncher::Update ( Math::MatrixStack& toWorldStack, 
-						   Math::MatrixStack& fromWorldStack, 
-						   Float timeElapsedInSeconds )
-{
-
-	//SAM will fire at its target if the absolute value of the dot product between
-	//the vector from the launcher to the target, and the right vector of the launcher
-	//is less than this value
-	static Core::ConsoleFloat sam_firethreshold( "sam_firethreshold", 0.3f );
-
-	//Disable enemy fire debug switch
-	static Core::ConsoleBool dbg_disableenemyfire ( "dbg_disableenemyfire", false );
-
-	//Rotate the SAMLauncher to face its target
-	if ( m_targetingComputer->GetCurrentTarget() 
-		&& (!IsFlagSet(EF_DEAD))
-		&& (IsFlagSet(EF_SPAWNED)))
-	{
-		
-		//Get the normalised vector from the SAMLauncher to the target
-		Math::Vector3D v = m_targetingComputer->GetCurrentTarget()->GetWorldSpacePosition()
-							- GetWorldSpacePosition();
-
-		v.Normalise();
-
-		//Get the dot product between v, and our right vector
-		Float vDotr = Math::Vector3D::DotProduct( v, Right() );
-
-		//
-		m_angularVelocity = Math::Vector3D( 0.0f, Math::DegreesToRadians(10.0f) * -vDotr, 0.0f );
-
-		if ( (vDotr < Math::Abs<Float>(sam_firethreshold))
-			&& (!dbg_disableenemyfire))
-		{
-			LaunchMissile();
-		}
-	}
-
-	EntityNode::Update( toWorldStack, fromWorldStack, timeElapsedInSeconds );
-}
-//End SAMLauncher::Update
-
-
-
 //=========================================================================
 //! @function    SAMLauncher::LaunchMissile
 //! @brief       Make the SAMLauncher launch a missile at its target
@@ -212,15 +158,46 @@ void SAMLauncher::OnSpawn ( const Math::Vector3D& spawnPoint )
 
 //=========================================================================
 //! @function    SAMLauncher::OnThink
-//! @brief       
+//! @brief       Turn the SAMLauncher to face its target, and fire at it
+//!				 once it is close to facing it
 //!              
-//! @param       timeElapsed 
+//! @param       timeElapsed [in]
 //!              
 //=========================================================================
 void SAMLauncher::OnThink ( Float timeElapsed )
 {
+	//SAM will fire at its target if the absolute value of the dot product between
+	//the vector from the launcher to the target, and the right vector of the launcher
+	//is less than this value
+	static Core::ConsoleFloat sam_firethreshold( "sam_firethreshold", 0.3f );
+
+	//Disable enemy fire debug switch
+	static Core::ConsoleBool dbg_disableenemyfire ( "dbg_disableenemyfire", false );
+
+	//Rotate the SAMLauncher to face its target
+	if ( m_targetingComputer->GetCurrentTarget() 
+		&& (!IsFlagSet(EF_DEAD))
+		&& (IsFlagSet(EF_SPAWNED)))
+	{
+		
+		//Get the normalised vector from the SAMLauncher to the target
+		Math::Vector3D v = m_targetingComputer->GetCurrentTarget()->GetWorldSpacePosition()
+							- GetWorldSpacePosition();
+
+		v.Normalise();
+
+		//Get the dot product between v, and our right vector
+		Float vDotr = Math::Vector3D::DotProduct( v, Right() );
 
+		//
+		AngularVelocity() = Math::Vector3D( 0.0f, Math::DegreesToRadians(10.0f) * -vDotr, 0.0f );
 
+		if ( (vDotr < Math::Abs<Float>(sam_firethreshold))
+			&& (!dbg_disableenemyfire))
+		{
+			LaunchMissile();
+		}
+	}
 }
 //End SAMLauncher::OnThink
 
@@ -28,15 +28,21 @@
 
 
 #include "Core/Core.h"
+#include "Core/WorkerPool.h"
 #include "Math/MatrixStack.h"
 #include "Renderer/Renderer.h"
 #include "OidFX/GameApplication.h"
 #include "OidFX/VisibleObjectList.h"
 #include "OidFX/Scene.h"
 #include "OidFX/SceneNode.h"
+#include "OidFX/QuadtreeNode.h"
 #include "OidFX/ProjectileManager.h"
 #include "OidFX/CollisionManager.h"
 #include "OidFX/EntityManager.h"
+#include "OidFX/EntityPhysics.h"
+#include "OidFX/EntityIndex.h"
+#include "OidFX/EntityNode.h"
+#include "OidFX/SceneCommandBuffer.h"
 #include "OidFX/Constants.h"
 
 
@@ -45,6 +51,126 @@ using namespace OidFX;
 
 
 
+//namespace OidFX
+namespace OidFX
+{
+
+	//!@class	SubtreeCullJob
+	//!@brief	Job that culls the children of one deferred quadtree node into its own list
+	class SubtreeCullJob : public Core::IJob
+	{
+		public:
+
+			SubtreeCullJob ( )
+				: m_node(0), m_camera(0)
+			{
+			}
+
+			void Set ( QuadtreeNode& node, const Camera& camera )
+			{
+				m_node = &node;
+				m_camera = &camera;
+				m_visibleObjects.Clear();
+			}
+
+			void Execute ( )
+			{
+				m_node->FillSubtreeVisibleObjectList ( m_visibleObjects, *m_camera );
+			}
+
+			VisibleObjectList& GetVisibleObjects()	{ return m_visibleObjects;	}
+
+		private:
+
+			QuadtreeNode*		m_node;
+			const Camera*		m_camera;
+			VisibleObjectList	m_visibleObjects;
+	};
+	//End class SubtreeCullJob
+
+
+
+	//!@class	EntityUpdateJob
+	//!@brief	Job that runs one phase of the update for a batch of root entities
+	//!
+	//!			Commands made by the entities are recorded in the job's own buffer
+	class EntityUpdateJob : public Core::IJob
+	{
+		public:
+
+			EntityUpdateJob ( Core::ThreadLocalPointer<SceneCommandBuffer>& threadCommands )
+				: m_threadCommands(threadCommands), m_phase(Scene::PHASE_UPDATE), 
+				  m_begin(0), m_end(0), m_timeElapsed(0.0f)
+			{
+			}
+
+			void Set ( Scene::EEntityPhase phase, EntityNode* const* begin, EntityNode* const* end,
+					   const SceneNode& parent, Float timeElapsedInSeconds )
+			{
+				m_phase = phase;
+				m_begin = begin;
+				m_end = end;
+				m_parentToWorld = parent.ConcatObjectToWorld();
+				m_parentFromWorld = parent.ConcatObjectFromWorld();
+				m_timeElapsed = timeElapsedInSeconds;
+			}
+
+			void Execute ( )
+			{
+				SceneCommandBuffer* previousCommands = m_threadCommands.Get();
+				m_threadCommands.Set ( &m_commands );
+
+				try
+				{
+					if ( m_phase == Scene::PHASE_UPDATE )
+					{
+						Math::MatrixStack toWorldStack;
+						Math::MatrixStack fromWorldStack;
+						toWorldStack.Top() = m_parentToWorld;
+						fromWorldStack.Top() = m_parentFromWorld;
+
+						for ( EntityNode* const* entity = m_begin; entity != m_end; ++entity )
+						{
+							(*entity)->Update ( toWorldStack, fromWorldStack, m_timeElapsed );
+						}
+					}
+					else
+					{
+						for ( EntityNode* const* entity = m_begin; entity != m_end; ++entity )
+						{
+							(*entity)->Think ( m_timeElapsed );
+						}
+					}
+				}
+				catch ( ... )
+				{
+					m_threadCommands.Set ( previousCommands );
+					throw;
+				}
+
+				m_threadCommands.Set ( previousCommands );
+			}
+
+			SceneCommandBuffer& GetCommands()	{ return m_commands;	}
+
+		private:
+
+			Core::ThreadLocalPointer<SceneCommandBuffer>& m_threadCommands;
+			SceneCommandBuffer	m_commands;
+			Scene::EEntityPhase	m_phase;
+			EntityNode* const*	m_begin;
+			EntityNode* const*	m_end;
+			Math::Matrix4x4		m_parentToWorld;
+			Math::Matrix4x4		m_parentFromWorld;
+			Float				m_timeElapsed;
+	};
+	//End class EntityUpdateJob
+
+}
+//end namespace OidFX
+
+
+
 //=========================================================================
 //! @function    Scene::Scene
 //! @brief       Scene constructor
@@ -52,8 +178,13 @@ using namespace OidFX;
 //!              Creates the root node of the scene graph
 //=========================================================================
 Scene::Scene ( GameApplication& application )
-: m_application(application)
+: m_updatingGraph(false), m_application(application)
 {
+	m_entityPhysics = boost::shared_ptr<EntityPhysics> ( new EntityPhysics(g_entityPhysicsReserve) );
+	m_entityIndex	= boost::shared_ptr<EntityIndex>   ( new EntityIndex(g_entityIndexCellSize, g_entityIndexBuckets) );
+
+	m_commands = boost::shared_ptr<SceneCommandBuffer> ( new SceneCommandBuffer() );
+
 	m_rootNode = boost::shared_ptr<SceneNode>( new SceneNode(*this) );
 
 	m_collisionManager  = boost::shared_ptr<CollisionManager>  ( new CollisionManager(*this) );
@@ -80,18 +211,48 @@ Scene::~Scene ()
 //! @function    Scene::Update
 //! @brief       Update the scene
 //!              
-//!				 Calls update on the root of the scene graph, which propagates
-//!				 the update call down to all of its children
+//!				 Integrates entity physics in a single pass first, so the local
+//!				 transforms of entities are up to date, then updates the children
+//!				 of the root of the scene graph. Entities are updated by UpdateEntities,
+//!				 everything else is updated on this thread.
 //!
 //! @param       timeElapsedInSeconds [in]	Time elapsed since last update
 //!              
 //=========================================================================
 void Scene::Update ( Float timeElapsedInSeconds )
 {
+	static Core::ConsoleFloat scn_indexcellsize ( "scn_indexcellsize", g_entityIndexCellSize );
+
 	Math::MatrixStack toWorldStack;
 	Math::MatrixStack fromWorldStack;
 
-	m_rootNode->Update ( toWorldStack, fromWorldStack, timeElapsedInSeconds );
+	if ( (scn_indexcellsize > 0.0f) && (scn_indexcellsize != m_entityIndex->CellSize()) )
+	{
+		m_entityIndex->SetCellSize ( scn_indexcellsize );
+	}
+
+	m_entityPhysics->Integrate ( timeElapsedInSeconds );
+	m_entityPhysics->WriteTransforms ( );
+
+	//The root has no parent, so its concatenated transform is its own
+	m_rootNode->SetConcatTransform ( m_rootNode->ObjectToWorld(), m_rootNode->ObjectFromWorld() );
+	toWorldStack.Top() = m_rootNode->ConcatObjectToWorld();
+	fromWorldStack.Top() = m_rootNode->ConcatObjectFromWorld();
+
+	m_updatingGraph = true;
+
+	for ( SceneNode::iterator itr = m_rootNode->ChildrenBegin(); itr != m_rootNode->ChildrenEnd(); ++itr )
+	{
+		if ( (*itr)->NodeType() != NODETYPE_ENTITY )
+		{
+			(*itr)->Update ( toWorldStack, fromWorldStack, timeElapsedInSeconds );
+		}
+	}
+
+	UpdateEntities ( timeElapsedInSeconds );
+
+	m_updatingGraph = false;
+	ApplyQueuedTransformDirty ( );
 
 	GetProjectileManager().Update();
 	GetEntityManager().Update();
@@ -101,11 +262,258 @@ void Scene::Update ( Float timeElapsedInSeconds )
 
 	//Execute the results of the collisions
 	GetCollisionManager().ExecuteCollisionList();
+
+	m_commands->Execute ( *this );
 }
 //End Scene::Update
 
 
 
+//=========================================================================
+//! @function    Scene::UpdateEntities
+//! @brief       Update the entities attached to the root of the scene graph
+//!              
+//!				 Every entity is updated, then every entity thinks. Each phase
+//!				 is split into batches of scn_entityupdatebatch entities, which are
+//!				 run by jobs on the worker pool. Changes an entity makes to the rest
+//!				 of the scene are recorded in the command buffer of its job, and the 
+//!				 buffers are executed in order once the phase is finished.
+//!
+//!				 Entities that have never thought are run on this thread first, so 
+//!				 the function local statics they use are never created by two threads 
+//!				 at once. Setting scn_parallelupdate to false runs every entity here.
+//!
+//! @param       timeElapsedInSeconds [in]	Time elapsed since last update
+//=========================================================================
+void Scene::UpdateEntities ( Float timeElapsedInSeconds )
+{
+	static Core::ConsoleBool scn_parallelupdate	   ( "scn_parallelupdate", true );
+	static Core::ConsoleUInt scn_entityupdatebatch ( "scn_entityupdatebatch", 32 );
+
+	const bool parallel = scn_parallelupdate && (scn_entityupdatebatch != 0)
+						  && (m_application.GetWorkerPool().ThreadCount() > 0);
+
+	m_newEntities.clear();
+	m_updateEntities.clear();
+
+	UInt childCount = 0;
+
+	for ( SceneNode::iterator itr = m_rootNode->ChildrenBegin(); itr != m_rootNode->ChildrenEnd(); ++itr, ++childCount )
+	{
+		if ( (*itr)->NodeType() == NODETYPE_ENTITY )
+		{
+			EntityNode* entity = static_cast<EntityNode*>(itr->get());
+
+			if ( parallel && entity->HasThought() )
+			{
+				m_updateEntities.push_back ( entity );
+			}
+			else
+			{
+				m_newEntities.push_back ( entity );
+			}
+		}
+	}
+
+	RunEntityPhase ( PHASE_UPDATE, scn_entityupdatebatch, timeElapsedInSeconds );
+	RunEntityPhase ( PHASE_THINK, scn_entityupdatebatch, timeElapsedInSeconds );
+
+	UpdateSpawnedEntities ( childCount, timeElapsedInSeconds );
+}
+//End Scene::UpdateEntities
+
+
+
+//=========================================================================
+//! @function    Scene::UpdateSpawnedEntities
+//! @brief       Update the entities spawned by the commands of this update
+//!              
+//!				 An entity spawned during the update used to be added to the end
+//!				 of the root's children, and updated later in the same traversal.
+//!				 This keeps that behaviour, updating them on this thread, until
+//!				 no more entities are spawned
+//!
+//! @param       firstChild			  [in] Index of the first child of the root that hasn't been updated
+//! @param       timeElapsedInSeconds [in] Time elapsed since last update
+//=========================================================================
+void Scene::UpdateSpawnedEntities ( UInt firstChild, Float timeElapsedInSeconds )
+{
+	SceneNode::iterator itr = m_rootNode->ChildrenBegin();
+	std::advance ( itr, firstChild );
+
+	while ( itr != m_rootNode->ChildrenEnd() )
+	{
+		m_newEntities.clear();
+		m_updateEntities.clear();
+
+		for ( ; itr != m_rootNode->ChildrenEnd(); ++itr, ++firstChild )
+		{
+			if ( (*itr)->NodeType() == NODETYPE_ENTITY )
+			{
+				m_newEntities.push_back ( static_cast<EntityNode*>(itr->get()) );
+			}
+		}
+
+		RunEntityPhase ( PHASE_UPDATE, 0, timeElapsedInSeconds );
+		RunEntityPhase ( PHASE_THINK, 0, timeElapsedInSeconds );
+
+		//The end iterator doesn't move to children added after it, so find the first new child again
+		itr = m_rootNode->ChildrenBegin();
+		std::advance ( itr, firstChild );
+	}
+}
+//End Scene::UpdateSpawnedEntities
+
+
+
+//=========================================================================
+//! @function    Scene::RunEntityPhase
+//! @brief       Run one phase of the update, for m_newEntities on this thread,
+//!				 then for m_updateEntities on the worker pool
+//!              
+//!				 Executes the commands recorded by the jobs, in the order of the 
+//!				 entities, followed by any commands made directly on this thread
+//!
+//! @param       phase				  [in] Phase to run
+//! @param       batchSize			  [in] Number of entities in each job
+//! @param       timeElapsedInSeconds [in] Time elapsed since last update
+//=========================================================================
+void Scene::RunEntityPhase ( EEntityPhase phase, UInt batchSize, Float timeElapsedInSeconds )
+{
+	UInt jobCount = 0;
+
+	if ( !m_updateEntities.empty() )
+	{
+		jobCount = (static_cast<UInt>(m_updateEntities.size()) + batchSize - 1) / batchSize;
+	}
+
+	while ( m_updateJobs.size() < (jobCount + 1) )
+	{
+		m_updateJobs.push_back ( boost::shared_ptr<EntityUpdateJob>(new EntityUpdateJob(m_threadCommands)) );
+	}
+
+	//New entities first, to completion, before any other thread can run
+	if ( !m_newEntities.empty() )
+	{
+		m_updateJobs[0]->Set ( phase, &m_newEntities[0], &m_newEntities[0] + m_newEntities.size(), 
+							   *m_rootNode, timeElapsedInSeconds );
+		m_updateJobs[0]->Execute ( );
+	}
+
+	if ( jobCount != 0 )
+	{
+		Core::WorkerPool& workerPool = m_application.GetWorkerPool();
+		EntityNode* const* entities = &m_updateEntities[0];
+		const UInt entityCount = static_cast<UInt>(m_updateEntities.size());
+
+		for ( UInt i=0; i < jobCount; ++i )
+		{
+			const UInt first = i * batchSize;
+			const UInt last  = std::min ( first + batchSize, entityCount );
+
+			m_updateJobs[i+1]->Set ( phase, entities + first, entities + last, *m_rootNode, timeElapsedInSeconds );
+			workerPool.Submit ( *m_updateJobs[i+1] );
+		}
+
+		workerPool.WaitForAll();
+	}
+
+	for ( UInt i=0; i < (jobCount + 1); ++i )
+	{
+		m_updateJobs[i]->GetCommands().Execute ( *this );
+	}
+
+	m_commands->Execute ( *this );
+}
+//End Scene::RunEntityPhase
+
+
+
+//=========================================================================
+//! @function    Scene::Commands
+//! @brief       Get the command buffer that changes to the scene should be recorded in
+//!              
+//!				 On an update job this is the job's own buffer. Anywhere else, it is
+//!				 the scene's buffer, which is executed after each update phase, and at
+//!				 the end of the update
+//!
+//! @return      The command buffer for the calling thread
+//=========================================================================
+SceneCommandBuffer& Scene::Commands ( )
+{
+	SceneCommandBuffer* commands = m_threadCommands.Get();
+
+	if ( commands )
+	{
+		return *commands;
+	}
+
+	return *m_commands;
+}
+//End Scene::Commands
+
+
+
+//=========================================================================
+//! @function    Scene::QueueTransformDirty
+//! @brief       Have the ancestors of a node marked dirty during the update
+//!				 of the scene graph flagged once the update is finished
+//!              
+//! @param       node [in] Node whose transform was marked dirty
+//=========================================================================
+void Scene::QueueTransformDirty ( SceneNode* node )
+{
+	debug_assert ( m_updatingGraph, "Transforms only need queueing while the scene graph is updated!" );
+	m_dirtyNodes.push_back ( node );
+}
+//End Scene::QueueTransformDirty
+
+
+
+//=========================================================================
+//! @function    Scene::ApplyQueuedTransformDirty
+//! @brief       Flag the ancestors of the nodes marked dirty during the update
+//!              
+//!				 Nodes that were updated after they were marked have nothing
+//!				 left to do. The rest are picked up by the next update. Nodes
+//!				 removed during the update are kept alive by ReleaseAfterFrame,
+//!				 so the queued pointers are still valid here.
+//=========================================================================
+void Scene::ApplyQueuedTransformDirty ( )
+{
+	for ( std::vector<SceneNode*>::iterator itr = m_dirtyNodes.begin(); itr != m_dirtyNodes.end(); ++itr )
+	{
+		if ( (*itr)->TransformDirty() )
+		{
+			(*itr)->MarkTransformDirty ( );
+		}
+	}
+
+	m_dirtyNodes.clear();
+}
+//End Scene::ApplyQueuedTransformDirty
+
+
+
+//=========================================================================
+//! @function    Scene::Interpolate
+//! @brief       Place every entity part way between its state at the end of
+//!				 the last two updates, ready for rendering
+//!
+//!				 Lets rendering run at a different rate to the simulation,
+//!				 without moving objects stuttering
+//!              
+//! @param       interpolation [in] 0 for the state at the end of the update before last,
+//!								    1 for the state at the end of the last update
+//=========================================================================
+void Scene::Interpolate ( Float interpolation )
+{
+	m_entityPhysics->WriteInterpolatedTransforms ( interpolation );
+}
+//End Scene::Interpolate
+
+
+
 //=========================================================================
 //! @function    Scene::Restore
 //! @brief       Restore all nodes in the scene graph
@@ -121,6 +529,38 @@ void Scene::Restore ( )
 
 
 
+//=========================================================================
+//! @function    Scene::ReleaseAfterFrame
+//! @brief       Keep a node that has been removed from the scene graph alive
+//!				 until ReleaseRemovedNodes is called
+//!
+//!				 A removed node may still be in the render queue of a frame that
+//!				 is being drawn while the next one is updated
+//!              
+//! @param       node [in] Node that has been removed from the scene graph
+//=========================================================================
+void Scene::ReleaseAfterFrame ( boost::shared_ptr<SceneNode> node )
+{
+	m_removedNodes.push_back ( node );
+}
+//End Scene::ReleaseAfterFrame
+
+
+
+//=========================================================================
+//! @function    Scene::ReleaseRemovedNodes
+//! @brief       Release the nodes passed to ReleaseAfterFrame
+//!              
+//!				 Must only be called when no queued frame refers to them
+//=========================================================================
+void Scene::ReleaseRemovedNodes ( )
+{
+	m_removedNodes.clear();
+}
+//End Scene::ReleaseRemovedNodes
+
+
+
 //=========================================================================
 //! @function    Scene::FillVisibleObjectList
 //! @brief       Gets a list of visible objects which can be seen in the
@@ -128,6 +568,9 @@ void Scene::Restore ( )
 //!
 //!				 Calls FillVisibleObjectList on the root node, which recursively
 //!				 propagates the call down to its children
+//!
+//!				 If scn_parallelcull is set, quadtree subtrees below scn_cullsplitlevel
+//!				 are culled on the worker pool
 //!              
 //!	@param		 visibleObjectList [in] List of visible objects to populate
 //! @param		 camera			   [in] Camera from which the scene is viewed
@@ -135,12 +578,68 @@ void Scene::Restore ( )
 //=========================================================================
 void Scene::FillVisibleObjectList ( VisibleObjectList& visibleObjectList, const Camera& camera )
 {
-	m_rootNode->FillVisibleObjectList( visibleObjectList, camera );
+	static Core::ConsoleBool scn_parallelcull   ( "scn_parallelcull", true );
+	static Core::ConsoleUInt scn_cullsplitlevel ( "scn_cullsplitlevel", 2 );
+
+	if ( scn_parallelcull && (scn_cullsplitlevel != 0) && (m_application.GetWorkerPool().ThreadCount() > 0) )
+	{
+		FillVisibleObjectListParallel ( visibleObjectList, camera, scn_cullsplitlevel );
+	}
+	else
+	{
+		m_rootNode->FillVisibleObjectList( visibleObjectList, camera );
+	}
 }
 //End Scene::FillVisibleObjectList
 
 
 
+//=========================================================================
+//! @function    Scene::FillVisibleObjectListParallel
+//! @brief       Fill the visible object list, culling quadtree subtrees in parallel
+//!
+//!				 The graph is walked down to splitLevel on this thread. Quadtree nodes 
+//!				 at that level which pass the frustum test are deferred, and each one 
+//!				 is then culled into its own list by a job on the worker pool.
+//!				 The lists are merged back in the same order as a serial traversal.
+//!              
+//!	@param		 visibleObjectList [in] List of visible objects to populate
+//! @param		 camera			   [in] Camera from which the scene is viewed
+//! @param		 splitLevel		   [in] Quadtree level to split into jobs at
+//!                
+//=========================================================================
+void Scene::FillVisibleObjectListParallel ( VisibleObjectList& visibleObjectList, const Camera& camera, UInt splitLevel )
+{
+	visibleObjectList.SetSubtreeSplitLevel ( splitLevel );
+	m_rootNode->FillVisibleObjectList( visibleObjectList, camera );
+	visibleObjectList.SetSubtreeSplitLevel ( 0 );
+
+	const UInt subtreeCount = static_cast<UInt>(visibleObjectList.DeferredSubtreeCount());
+
+	while ( m_cullJobs.size() < subtreeCount )
+	{
+		m_cullJobs.push_back ( boost::shared_ptr<SubtreeCullJob>(new SubtreeCullJob()) );
+	}
+
+	Core::WorkerPool& workerPool = m_application.GetWorkerPool();
+	std::vector<VisibleObjectList*> subtreeLists ( subtreeCount );
+
+	for ( UInt i=0; i < subtreeCount; ++i )
+	{
+		m_cullJobs[i]->Set ( visibleObjectList.DeferredSubtree(i), camera );
+		subtreeLists[i] = &m_cullJobs[i]->GetVisibleObjects();
+
+		workerPool.Submit ( *m_cullJobs[i] );
+	}
+
+	workerPool.WaitForAll();
+
+	visibleObjectList.MergeDeferredSubtrees ( subtreeLists );
+}
+//End Scene::FillVisibleObjectListParallel
+
+
+
 //=========================================================================
 //! @function    Scene::QueryScene
 //! @brief       Get a list of triangles which collide with the ray provided
@@ -168,15 +667,97 @@ void Scene::QueryScene ( const Math::ParametricLine3D& ray, bool sortResults, Sc
 //! @function    Scene::QueryScene
 //! @brief       Query the scene for entities within a bounding sphere
 //!              
+//!				 Setting scn_entityindex to false walks the scene graph instead
+//!				 of using the entity index
+//!
 //! @param       sphere [in]	
 //! @param       result [in]	
 //!              
 //=========================================================================
 void Scene::QueryScene ( const Math::BoundingSphere3D& sphere, EntityQueryResult& result )
 {
-	Root()->QueryScene( sphere, result );
+	static Core::ConsoleBool scn_entityindex ( "scn_entityindex", true );
+
+	if ( scn_entityindex )
+	{
+		m_entityIndex->Query ( sphere, EntityQueryFilter(), result );
+	}
+	else
+	{
+		Root()->QueryScene( sphere, result );
+	}
+}
+//End Scene::QueryScene
+
+
+
+//=========================================================================
+//! @function    Scene::QueryScene
+//! @brief       Query the scene for entities within a bounding sphere, 
+//!				 that pass a flag filter
+//!              
+//! @param       sphere [in]	World space sphere
+//! @param       filter [in]	Flags the entities must, or must not, have
+//! @param       result [out]	List the entities are appended to
+//=========================================================================
+void Scene::QueryScene ( const Math::BoundingSphere3D& sphere, const EntityQueryFilter& filter, EntityQueryResult& result )
+{
+	m_entityIndex->Query ( sphere, filter, result );
 }
 //End Scene::QueryScene
 
 
 
+//=========================================================================
+//! @function    Scene::QueryScene
+//! @brief       Query the scene for entities whose bounding boxes intersect a box
+//!              
+//! @param       box	[in]	World space box
+//! @param       filter [in]	Flags the entities must, or must not, have
+//! @param       result [out]	List the entities are appended to
+//=========================================================================
+void Scene::QueryScene ( const Math::AxisAlignedBoundingBox& box, const EntityQueryFilter& filter, EntityQueryResult& result )
+{
+	m_entityIndex->Query ( box, filter, result );
+}
+//End Scene::QueryScene
+
+
+
+//=========================================================================
+//! @function    Scene::QueryScene
+//! @brief       Query the scene for entities whose bounding boxes are hit by a line segment
+//!              
+//! @param       ray			[in]	World space line segment
+//! @param		 sortResults	[in]	Sort the entities by distance along the ray
+//! @param       filter			[in]	Flags the entities must, or must not, have
+//! @param       result			[out]	List the entities are appended to
+//=========================================================================
+void Scene::QueryScene ( const Math::ParametricLine3D& ray, bool sortResults, const EntityQueryFilter& filter, 
+						 EntityQueryResult& result )
+{
+	m_entityIndex->Query ( ray, sortResults, filter, result );
+}
+//End Scene::QueryScene
+
+
+
+//=========================================================================
+//! @function    Scene::QueryNearest
+//! @brief       Find the entities nearest to a point
+//!              
+//! @param       point			[in]	World space point
+//! @param       count			[in]	Maximum number of entities to return
+//! @param       maxDistance	[in]	Search radius
+//! @param       filter			[in]	Flags the entities must, or must not, have
+//! @param       result			[out]	List the entities are appended to, nearest first
+//=========================================================================
+void Scene::QueryNearest ( const Math::Vector3D& point, UInt count, Float maxDistance, 
+						   const EntityQueryFilter& filter, EntityQueryResult& result )
+{
+	m_entityIndex->QueryNearest ( point, count, maxDistance, filter, result );
+}
+//End Scene::QueryNearest
+
+
+
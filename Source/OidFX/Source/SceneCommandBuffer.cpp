@@ -0,0 +1,277 @@
+//======================================================================================
+//! @file         SceneCommandBuffer.cpp
+//! @brief        Side effects of entity updates, recorded on update jobs and applied
+//!               on the thread that runs the scene update
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+#include "Core/Core.h"
+#include "OidFX/Scene.h"
+#include "OidFX/SceneCommandBuffer.h"
+#include "OidFX/EntityNode.h"
+#include "OidFX/EntityManager.h"
+#include "OidFX/MissileLauncher.h"
+#include "OidFX/Billboard.h"
+#include "OidFX/BillboardManager.h"
+#include "OidFX/GameApplication.h"
+
+
+using namespace OidFX;
+
+
+
+//=========================================================================
+//! @function    SceneCommandBuffer::SceneCommandBuffer
+//! @brief       SceneCommandBuffer constructor
+//=========================================================================
+SceneCommandBuffer::SceneCommandBuffer ( )
+{
+}
+//End SceneCommandBuffer::SceneCommandBuffer
+
+
+
+//=========================================================================
+//! @function    SceneCommandBuffer::UpdateEntityIndex
+//! @brief       Move an entity to its new bounds in the scene's entity index
+//!              
+//! @param       entity [in] Entity whose bounds have been updated
+//=========================================================================
+void SceneCommandBuffer::UpdateEntityIndex ( EntityNode& entity )
+{
+	Record ( CMD_UPDATEENTITYINDEX ).entity = &entity;
+}
+//End SceneCommandBuffer::UpdateEntityIndex
+
+
+
+//=========================================================================
+//! @function    SceneCommandBuffer::SpawnEntity
+//! @brief       Spawn an entity through the scene's entity manager
+//!              
+//! @param       type				[in] Entity type name
+//! @param       position			[in] Position to spawn the entity at
+//! @param       explosiveStrength	[in] Explosive strength to give the entity
+//! @param       flags				[in] Flags to set on the entity once it has spawned
+//=========================================================================
+void SceneCommandBuffer::SpawnEntity ( const Char* type, const Math::Vector3D& position, 
+									   Float explosiveStrength, const EntityNode::EntityFlagSet& flags )
+{
+	debug_assert ( type, "Error, type can't be NULL!" );
+
+	Command& command = Record ( CMD_SPAWNENTITY );
+
+	command.entityType	= Core::GenerateHashFromString ( type );
+	command.vector		= position;
+	command.amount		= explosiveStrength;
+	command.flags		= flags;
+}
+//End SceneCommandBuffer::SpawnEntity
+
+
+
+//=========================================================================
+//! @function    SceneCommandBuffer::LaunchMissile
+//! @brief       Spawn a missile from a launcher that has decided to fire
+//!              
+//! @param       launcher [in] Launcher to fire the missile from
+//=========================================================================
+void SceneCommandBuffer::LaunchMissile ( MissileLauncher& launcher )
+{
+	Record ( CMD_LAUNCHMISSILE ).launcher = &launcher;
+}
+//End SceneCommandBuffer::LaunchMissile
+
+
+
+//=========================================================================
+//! @function    SceneCommandBuffer::SetVelocity
+//! @brief       Set the velocity of another entity
+//!              
+//! @param       entity	  [in] Entity to change
+//! @param       velocity [in] New velocity
+//=========================================================================
+void SceneCommandBuffer::SetVelocity ( EntityNode& entity, const Math::Vector3D& velocity )
+{
+	Command& command = Record ( CMD_SETVELOCITY );
+
+	command.entity = &entity;
+	command.vector = velocity;
+}
+//End SceneCommandBuffer::SetVelocity
+
+
+
+//=========================================================================
+//! @function    SceneCommandBuffer::Hurt
+//! @brief       Hurt another entity
+//!              
+//! @param       entity [in] Entity to hurt
+//! @param       amount [in] Amount to reduce its health by
+//=========================================================================
+void SceneCommandBuffer::Hurt ( EntityNode& entity, Float amount )
+{
+	Command& command = Record ( CMD_HURT );
+
+	command.entity = &entity;
+	command.amount = amount;
+}
+//End SceneCommandBuffer::Hurt
+
+
+
+//=========================================================================
+//! @function    SceneCommandBuffer::AddBillboard
+//! @brief       Add a billboard to the billboard manager's list for this frame
+//!              
+//! @param       billboard [in] Billboard to add. The manager copies its state
+//!							    when the command is executed
+//=========================================================================
+void SceneCommandBuffer::AddBillboard ( Billboard& billboard )
+{
+	Record ( CMD_ADDBILLBOARD ).billboard = &billboard;
+}
+//End SceneCommandBuffer::AddBillboard
+
+
+
+//=========================================================================
+//! @function    SceneCommandBuffer::Execute
+//! @brief       Execute the recorded commands in order, and empty the buffer
+//!              
+//!				 A command may record more commands, such as an entity that is 
+//!				 killed by Hurt spawning an explosion. If this is the calling thread's
+//!				 buffer, they are executed too, before this returns
+//!
+//! @param       scene [in] Scene the commands apply to
+//=========================================================================
+void SceneCommandBuffer::Execute ( Scene& scene )
+{
+	while ( !m_commands.empty() )
+	{
+		m_executing.clear();
+		m_executing.swap ( m_commands );
+
+		for ( CommandList::const_iterator itr = m_executing.begin(); itr != m_executing.end(); ++itr )
+		{
+			ExecuteCommand ( scene, *itr );
+		}
+	}
+
+	m_executing.clear();
+}
+//End SceneCommandBuffer::Execute
+
+
+
+//=========================================================================
+//! @function    SceneCommandBuffer::Record
+//! @brief       Add a command to the end of the buffer
+//!              
+//! @param       type [in] Type of command
+//!              
+//! @return      The new command, for the caller to fill in
+//=========================================================================
+SceneCommandBuffer::Command& SceneCommandBuffer::Record ( ECommandType type )
+{
+	m_commands.push_back ( Command() );
+
+	Command& command = m_commands.back();
+
+	command.type		= type;
+	command.entity		= 0;
+	command.launcher	= 0;
+	command.billboard	= 0;
+	command.entityType	= 0;
+	command.amount		= 0.0f;
+
+	return command;
+}
+//End SceneCommandBuffer::Record
+
+
+
+//=========================================================================
+//! @function    SceneCommandBuffer::ExecuteCommand
+//! @brief       Execute a single command
+//!              
+//!				 Entities may have been killed by an earlier command since they were
+//!				 queried, so dead entities are neither hurt nor pushed again, the same
+//!				 as if they had been queried after the earlier command
+//!
+//! @param       scene	 [in] Scene the command applies to
+//! @param       command [in] Command to execute
+//=========================================================================
+void SceneCommandBuffer::ExecuteCommand ( Scene& scene, const SceneCommandBuffer::Command& command )
+{
+	switch ( command.type )
+	{
+		case CMD_UPDATEENTITYINDEX:
+
+			command.entity->UpdateEntityIndex ( );
+			break;
+
+		case CMD_SPAWNENTITY:
+		{
+			EntityPtr entity = scene.GetEntityManager().SpawnEntity ( command.entityType, command.vector );
+			entity->SetExplosiveStrength ( command.amount );
+
+			for ( UInt flag=0; flag < EF_COUNT; ++flag )
+			{
+				if ( command.flags[flag] )
+				{
+					entity->SetFlag ( static_cast<EEntityFlag>(flag) );
+				}
+			}
+		}
+		break;
+
+		case CMD_LAUNCHMISSILE:
+
+			command.launcher->FireMissile ( );
+			break;
+
+		case CMD_SETVELOCITY:
+
+			if ( !command.entity->IsDead() )
+			{
+				command.entity->SetVelocity ( command.vector );
+			}
+			break;
+
+		case CMD_HURT:
+
+			if ( !command.entity->IsDead() )
+			{
+				command.entity->Hurt ( command.amount );
+			}
+			break;
+
+		case CMD_ADDBILLBOARD:
+
+			scene.Application().GetBillboardManager().AddToBillboardList ( *command.billboard );
+			break;
+	}
+}
+//End SceneCommandBuffer::ExecuteCommand
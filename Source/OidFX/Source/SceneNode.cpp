@@ -26,6 +26,7 @@
 
 
 #include "Core/Core.h"
+#include "Core/Atomic.h"
 #include "Math/Matrix4x4.h"
 #include "Math/MatrixStack.h"
 #include "Math/BoundingSphere3D.h"
@@ -60,10 +61,13 @@ SceneNode::SceneNode ( Scene& scene,
   m_objectToWorld(toWorld), 
   m_objectFromWorld(fromWorld), 
   m_lodLevel(0),
-  m_nodeType(nodeType)
+  m_nodeType(nodeType),
+  m_transformDirty(true),
+  m_childTransformDirty(false)
 {	
-	static UInt id = 0;
-	m_id = ++id;
+	//Nodes can be created on loader threads, so the ID counter has to be atomic
+	static Core::AtomicLong id = 0;
+	m_id = static_cast<UInt>( Core::AtomicIncrement ( id ) );
 }
 //End SceneNode::SceneNode
 
@@ -84,9 +88,13 @@ void SceneNode::AddChild ( boost::shared_ptr<SceneNode> node )
 	{
 		node->SetParent(this);
 		m_children.push_back( node );
+		node->m_positionInParent = --m_children.end();
 
 		node->ConcatenateTransformFromParent();
 
+		//The node may have been under another parent, or not in the graph at all
+		node->MarkTransformDirty();
+
 	}
 	catch (...)
 	{
@@ -102,7 +110,8 @@ void SceneNode::AddChild ( boost::shared_ptr<SceneNode> node )
 //! @function    SceneNode::RemoveChild
 //! @brief       Remove the child node with the id specified
 //!              
-//!				 If there is no child node with the specified ID, then nothing will happen
+//!				 If there is no child node with the specified ID, then nothing will happen.
+//!				 This has to search the children, so prefer the overload taking the node
 //!
 //! @param       id [in] ID of the child node to remove
 //!              
@@ -113,10 +122,8 @@ void SceneNode::RemoveChild ( UInt id )
 	{
 		if ( (*itr)->ID() == id )
 		{
-			m_children.erase( itr );
-			
-			//We've erased it, just return. Since IDs are unique, the
-			//entity shouldn't be in the scene graph more than once
+			//Since IDs are unique, the entity shouldn't be in the scene graph more than once
+			RemoveChild ( **itr );
 			return;
 		}
 	}
@@ -127,6 +134,29 @@ void SceneNode::RemoveChild ( UInt id )
 
 
 
+//=========================================================================
+//! @function    SceneNode::RemoveChild
+//! @brief       Remove a child node, in constant time
+//!              
+//!				 The node keeps its position in the list of children, so there's 
+//!				 no need to search for it. Its parent is cleared.
+//!
+//! @param       node [in] Child node to remove
+//=========================================================================
+void SceneNode::RemoveChild ( SceneNode& node )
+{
+	debug_assert ( node.m_parent == this, "Tried to remove a node that isn't a child of this one!" );
+
+	//The node may still be queued for rendering, so the scene holds on to it until the frame is drawn
+	m_scene.ReleaseAfterFrame ( *node.m_positionInParent );
+	m_children.erase ( node.m_positionInParent );
+
+	node.SetParent ( 0 );
+}
+//End SceneNode::RemoveChild
+
+
+
 //=========================================================================
 //! @function    SceneNode::CanCollideWith
 //! @brief       Indicates whether a scene node, or its children can collide with an entity
@@ -261,7 +291,9 @@ void SceneNode::PropagateTransformsToChildren ( )
 //!				 other SetTransform method to this one, as this version carries the
 //!				 overhead of a matrix inversion.
 //!				 This should only be used in situations where there is no method
-//!				 other than matrix inversion, to get the fromWorld transformation
+//!				 other than matrix inversion, to get the fromWorld transformation.
+//!				 Affine matrices, which is nearly all of them, take the cheaper
+//!				 InvertAffine path
 //!              
 //! @param       toWorld [in]	
 //!              
@@ -272,11 +304,15 @@ void SceneNode::SetTransform ( const Math::Matrix4x4& toWorld )
 	m_objectToWorld = toWorld;
 	m_objectFromWorld = toWorld;
 
-	if ( !m_objectFromWorld.Invert() )
+	const bool inverted = toWorld.IsAffine() ? m_objectFromWorld.InvertAffine() : m_objectFromWorld.Invert();
+
+	if ( !inverted )
 	{
 		std::cerr << __FUNCTION__ << ": Error, couldn't invert toWorld matrix";
 	}
 
+	MarkTransformDirty();
+
 }
 //End SceneNode::SetTransform
 
@@ -300,6 +336,8 @@ void SceneNode::SetTransform ( const Math::Matrix4x4& toWorld, const Math::Matri
 	m_objectToWorld = toWorld;
 	m_objectFromWorld = fromWorld;
 
+	MarkTransformDirty();
+
 }
 //End SceneNode::SetTransform
 
@@ -328,6 +366,43 @@ void SceneNode::SetConcatTransform ( const Math::Matrix4x4& concatToWorld, const
 //End SceneNode::SetConcatTransform
 
 
+
+//=========================================================================
+//! @function    SceneNode::MarkTransformDirty
+//! @brief       Have the next update recalculate the concatenated transform of
+//!				 this node and its children
+//!              
+//!				 Must be called whenever the local transform changes. Every node
+//!				 above this one is marked as having a dirty child, so the update
+//!				 can skip any subtree in which nothing has moved.
+//!
+//!				 The ancestors' flags are shared, so this must only be called on 
+//!				 the thread running the simulation, never from an entity update job.
+//!				 While the scene graph is being updated, the ancestors above this node
+//!				 may already have been visited and cleared, so only this node is marked,
+//!				 and the scene marks its ancestors once the traversal is finished.
+//=========================================================================
+void SceneNode::MarkTransformDirty ( )
+{
+	debug_assert ( !m_scene.OnUpdateJob(), "Transforms must not be marked dirty from an entity update job!" );
+
+	m_transformDirty = true;
+
+	if ( m_scene.UpdatingGraph() )
+	{
+		m_scene.QueueTransformDirty ( this );
+		return;
+	}
+
+	//Stop at the first node that is already marked, since the nodes above it will be too
+	for ( SceneNode* node = m_parent; node && (!node->m_childTransformDirty); node = node->m_parent )
+	{
+		node->m_childTransformDirty = true;
+	}
+}
+//End SceneNode::MarkTransformDirty
+
+
 //=========================================================================
 //! @function    SceneNode::Restore
 //! @brief       SceneNode restore
@@ -359,9 +434,14 @@ void SceneNode::Restore ( )
 //! @function    SceneNode::Update
 //! @brief       Updates the scene node and all children
 //!              
-//!				 Updates the m_concatObjectToWorld and m_concatObjectFromWorld matrices
-//!				 pushes the current toWorld and fromWorld matrices onto the appropriate stacks
-//!				 Updates all children, and pops the matrices from the stacks
+//!				 If the node's transform is dirty, it is concatenated with the top
+//!				 of the matrix stacks, and all of the children are marked dirty,
+//!				 since their concatenated transforms depend on it. Otherwise the
+//!				 node's existing concatenated transform is pushed, so children
+//!				 with dirty transforms still get the right one.
+//!
+//!				 Subtrees with no dirty transforms are skipped entirely, so a 
+//!				 static part of the graph costs nothing to update
 //!              
 //! @param       toWorldStack		  [in] Matrix stack for the toWorld transform
 //! @param		 fromWorldStack		  [in] Matrix stack for the fromWorld transform
@@ -373,22 +453,52 @@ void SceneNode::Update ( Math::MatrixStack& toWorldStack,
 						 Float timeElapsedInSeconds )
 {
 
-	toWorldStack.Push ( );
-	toWorldStack.Top() *= m_objectToWorld;
-	m_concatObjectToWorld = toWorldStack.Top();
+	if ( (!m_transformDirty) && (!m_childTransformDirty) )
+	{
+		return;
+	}
 
+	toWorldStack.Push ( );
 	fromWorldStack.Push ( );
-	fromWorldStack.Top() *= m_objectFromWorld;
-	m_concatObjectFromWorld = fromWorldStack.Top();
 
-	iterator current = m_children.begin();
-	iterator end	 = m_children.end();
+	if ( m_transformDirty )
+	{
+		toWorldStack.Top() *= m_objectToWorld;
+		m_concatObjectToWorld = toWorldStack.Top();
 
-	for ( ; current != end; ++current )
+		fromWorldStack.Top() *= m_objectFromWorld;
+		m_concatObjectFromWorld = fromWorldStack.Top();
+
+		m_transformDirty = false;
+
+		for ( iterator child = m_children.begin(); child != m_children.end(); ++child )
+		{
+			(*child)->m_transformDirty = true;
+		}
+
+		m_childTransformDirty = !m_children.empty();
+
+		OnTransformChanged ( );
+	}
+	else
 	{
+		toWorldStack.Top() = m_concatObjectToWorld;
+		fromWorldStack.Top() = m_concatObjectFromWorld;
+	}
 
-		(*current)->Update ( toWorldStack, fromWorldStack, timeElapsedInSeconds );
-		
+	if ( m_childTransformDirty )
+	{
+		m_childTransformDirty = false;
+
+		iterator current = m_children.begin();
+		iterator end	 = m_children.end();
+
+		for ( ; current != end; ++current )
+		{
+
+			(*current)->Update ( toWorldStack, fromWorldStack, timeElapsedInSeconds );
+			
+		}
 	}
 
 	toWorldStack.Pop();
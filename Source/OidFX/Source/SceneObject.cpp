@@ -68,25 +68,14 @@ SceneObject::SceneObject ( Scene& scene,
 
 
 //=========================================================================
-//! @function    SceneObject::Update
-//! @brief       Update a scene object, updating its bounding box if it has moved
-//!              
-//!              
-//! @param       toWorldStack 
-//! @param       fromWorldStack 
-//! @param       timeElapsedInSeconds 
-//!              
+//! @function    SceneObject::OnTransformChanged
+//! @brief       Move the bounding box to the object's new concatenated transform
 //=========================================================================
-void SceneObject::Update ( Math::MatrixStack& toWorldStack, Math::MatrixStack& fromWorldStack, Float timeElapsedInSeconds )
+void SceneObject::OnTransformChanged ( )
 {
-
-	//Call the base class SceneNode::Update, to do the default update
-	SceneNode::Update( toWorldStack, fromWorldStack, timeElapsedInSeconds );
-
 	UpdateBoundsPositionFromConcatTransform();
-
 }
-//End SceneObject::Update
+//End SceneObject::OnTransformChanged
 
 
 
@@ -0,0 +1,245 @@
+//======================================================================================
+//! @file         SpatialHash.cpp
+//! @brief        Uniform grid spatial hash used as a collision broad phase
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+
+#include "Core/Core.h"
+#include "Math/Math.h"
+#include "Math/BoundingBox3D.h"
+#include "OidFX/SpatialHash.h"
+
+
+using namespace OidFX;
+
+
+
+//=========================================================================
+//! @function    SpatialHash::SpatialHash
+//! @brief       SpatialHash constructor
+//!              
+//! @param       cellSize		[in] Length of the side of a grid cell, in world units
+//! @param       bucketCount	[in] Number of hash buckets
+//!              
+//=========================================================================
+SpatialHash::SpatialHash ( Float cellSize, UInt bucketCount )
+: m_cellSize(0.0f), m_inverseCellSize(0.0f), m_queryStamp(0), m_buckets(bucketCount)
+{
+	debug_assert ( bucketCount > 0, "Spatial hash must have at least one bucket!" );
+	SetCellSize ( cellSize );
+}
+//End SpatialHash::SpatialHash
+
+
+
+//=========================================================================
+//! @function    SpatialHash::SetCellSize
+//! @brief       Set the size of the grid cells
+//!              
+//!				 Objects already in the hash are not moved, so this should
+//!				 only be called while the hash is empty
+//!
+//! @param       cellSize [in] Length of the side of a grid cell, in world units
+//!              
+//=========================================================================
+void SpatialHash::SetCellSize ( Float cellSize )
+{
+	debug_assert ( cellSize > 0.0f, "Spatial hash cell size must be positive!" );
+	debug_assert ( m_objects.empty(), "Changed the cell size of a non-empty spatial hash!" );
+
+	m_cellSize = cellSize;
+	m_inverseCellSize = 1.0f / cellSize;
+}
+//End SpatialHash::SetCellSize
+
+
+
+//=========================================================================
+//! @function    SpatialHash::Clear
+//! @brief       Remove all objects from the hash
+//!              
+//=========================================================================
+void SpatialHash::Clear ( )
+{
+	for ( Bucket::const_iterator itr = m_usedBuckets.begin(); itr != m_usedBuckets.end(); ++itr )
+	{
+		m_buckets[*itr].clear();
+	}
+
+	m_usedBuckets.clear();
+	m_oversized.clear();
+	m_objects.clear();
+}
+//End SpatialHash::Clear
+
+
+
+//=========================================================================
+//! @function    SpatialHash::Insert
+//! @brief       Insert an object into each cell overlapped by its bounding box
+//!              
+//! @param       object [in] Object to insert
+//! @param       box	[in] World space bounding box of the object
+//!              
+//=========================================================================
+void SpatialHash::Insert ( SceneObject* object, const Math::AxisAlignedBoundingBox& box )
+{
+	debug_assert ( object, "Inserted a NULL object into the spatial hash!" );
+
+	UInt entryIndex = static_cast<UInt>(m_objects.size());
+
+	Entry entry;
+	entry.object = object;
+	entry.queryStamp = m_queryStamp;
+	m_objects.push_back( entry );
+
+	CellRange range;
+	GetCellRange ( box, range );
+
+	UInt64 cellCount = CellCount ( range );
+
+	if ( cellCount > MaxCellsPerObject )
+	{
+		m_oversized.push_back( entryIndex );
+		return;
+	}
+
+	for ( Int z = range.minZ; z <= range.maxZ; ++z )
+	{
+		for ( Int y = range.minY; y <= range.maxY; ++y )
+		{
+			for ( Int x = range.minX; x <= range.maxX; ++x )
+			{
+				UInt bucketIndex = HashCell ( x, y, z );
+				Bucket& bucket = m_buckets[bucketIndex];
+
+				if ( bucket.empty() )
+				{
+					m_usedBuckets.push_back( bucketIndex );
+				}
+
+				//Several cells of the same object can hash to the same bucket. 
+				//Those are always inserted together, so only the back needs checking
+				if ( bucket.empty() || (bucket.back() != entryIndex) )
+				{
+					bucket.push_back( entryIndex );
+				}
+			}
+		}
+	}
+}
+//End SpatialHash::Insert
+
+
+
+//=========================================================================
+//! @function    SpatialHash::Query
+//! @brief       Find all objects that share a cell with a bounding box
+//!              
+//!				 Each object is added to the results at most once
+//!
+//! @param       box		[in]	World space bounding box to query
+//! @param       results	[out]	List the candidate objects are appended to
+//!              
+//=========================================================================
+void SpatialHash::Query ( const Math::AxisAlignedBoundingBox& box, SpatialHash::ObjectList& results )
+{
+	++m_queryStamp;
+
+	//The stamp has wrapped around, so reset the stamps of all objects to avoid
+	//objects being missed because they hold a stamp from 4 billion queries ago
+	if ( m_queryStamp == 0 )
+	{
+		for ( EntryStore::iterator itr = m_objects.begin(); itr != m_objects.end(); ++itr )
+		{
+			itr->queryStamp = 0;
+		}
+
+		m_queryStamp = 1;
+	}
+
+	for ( Bucket::const_iterator itr = m_oversized.begin(); itr != m_oversized.end(); ++itr )
+	{
+		AddResult ( *itr, results );
+	}
+
+	CellRange range;
+	GetCellRange ( box, range );
+
+	UInt64 cellCount = CellCount ( range );
+
+	//For very large query boxes it's cheaper to return everything
+	if ( cellCount > static_cast<UInt64>(m_objects.size()) * MaxCellsPerObject )
+	{
+		for ( UInt i = 0; i < m_objects.size(); ++i )
+		{
+			AddResult ( i, results );
+		}
+
+		return;
+	}
+
+	for ( Int z = range.minZ; z <= range.maxZ; ++z )
+	{
+		for ( Int y = range.minY; y <= range.maxY; ++y )
+		{
+			for ( Int x = range.minX; x <= range.maxX; ++x )
+			{
+				const Bucket& bucket = m_buckets[ HashCell ( x, y, z ) ];
+
+				for ( Bucket::const_iterator itr = bucket.begin(); itr != bucket.end(); ++itr )
+				{
+					AddResult ( *itr, results );
+				}
+			}
+		}
+	}
+}
+//End SpatialHash::Query
+
+
+
+//=========================================================================
+//! @function    SpatialHash::GetCellRange
+//! @brief       Get the range of cells overlapped by a bounding box
+//!              
+//! @param       box	[in]	World space bounding box
+//! @param       range	[out]	Inclusive range of cell coordinates
+//!              
+//=========================================================================
+void SpatialHash::GetCellRange ( const Math::AxisAlignedBoundingBox& box, SpatialHash::CellRange& range ) const
+{
+	Math::Vector3D minCorner = box.GetCorner( Math::AxisAlignedBoundingBox::MIN_X_MIN_Y_MIN_Z );
+	Math::Vector3D maxCorner = box.GetCorner( Math::AxisAlignedBoundingBox::MAX_X_MAX_Y_MAX_Z );
+
+	range.minX = static_cast<Int>( Math::Floor( minCorner.X() * m_inverseCellSize ) );
+	range.minY = static_cast<Int>( Math::Floor( minCorner.Y() * m_inverseCellSize ) );
+	range.minZ = static_cast<Int>( Math::Floor( minCorner.Z() * m_inverseCellSize ) );
+	range.maxX = static_cast<Int>( Math::Floor( maxCorner.X() * m_inverseCellSize ) );
+	range.maxY = static_cast<Int>( Math::Floor( maxCorner.Y() * m_inverseCellSize ) );
+	range.maxZ = static_cast<Int>( Math::Floor( maxCorner.Z() * m_inverseCellSize ) );
+}
+//End SpatialHash::GetCellRange
@@ -37,8 +37,9 @@
 #include "OidFX/Constants.h"
 #include "OidFX/Scene.h"
 #include "OidFX/TargetingComputer.h"
+#include "OidFX/EntityIndex.h"
 #include "OidFX/GameApplication.h"
-#include "OidFX/BillboardManager.h"
+#include "OidFX/SceneCommandBuffer.h"
 
 
 
@@ -54,7 +55,7 @@ using namespace OidFX;
 //=========================================================================
 TargetingComputer::TargetingComputer ( Scene& scene )
 : EntityNode(scene, "Target-O-Tron-3000", "" ),
-  m_currentTarget(0),
+  m_currentTarget(),
   m_timeSinceLastUpdate(0.0f),
   m_targetDisplay( scene.Application().GetEffectManager().AcquireEffect("Data/Art/Effects/Target.ofx") )
 {
@@ -82,23 +83,20 @@ TargetingComputer::TargetingComputer ( Scene& scene )
 
 
 //=========================================================================
-//! @function    TargetingComputer::Update
-//! @brief       Update the targeting computer
-//!              
-//! @param       toWorldStack 
-//! @param       fromWorldStack 
-//! @param       timeElapsedInSeconds 
+//! @function    TargetingComputer::OnThink
+//! @brief       Look for a new target once a second, and mark the current one
 //!              
+//!				 The first time the computer thinks, it looks for a target straight
+//!				 away. That is always on the thread that updates the scene, so the
+//!				 console variables used by AcquireTarget are created there
+//!
+//! @param       timeElapsed [in]
 //=========================================================================
-void TargetingComputer::Update ( Math::MatrixStack& toWorldStack,
-								Math::MatrixStack& fromWorldStack,
-								Float timeElapsedInSeconds )
+void TargetingComputer::OnThink ( Float timeElapsed )
 {
-	EntityNode::Update ( toWorldStack, fromWorldStack, timeElapsedInSeconds );
+	m_timeSinceLastUpdate += timeElapsed;
 
-	m_timeSinceLastUpdate += timeElapsedInSeconds;
-
-	if ( m_timeSinceLastUpdate > 1.0f )
+	if ( (!HasThought()) || (m_timeSinceLastUpdate > 1.0f) )
 	{
 		AcquireTarget();
 		m_timeSinceLastUpdate = 0.0f;
@@ -106,13 +104,12 @@ void TargetingComputer::Update ( Math::MatrixStack& toWorldStack,
 
 	if ( IsFlagSet(TCF_DRAWTARGET) && GetCurrentTarget() )
 	{
-		m_targetDisplay.Update( timeElapsedInSeconds );
+		m_targetDisplay.Update( timeElapsed );
 		m_targetDisplay.SetPosition( GetCurrentTarget()->BoundingBox().GetCentre() );
-		m_scene.Application().GetBillboardManager().AddToBillboardList(m_targetDisplay);
-
+		m_scene.Commands().AddBillboard ( m_targetDisplay );
 	}
 }
-//End TargetingComputer::Update
+//End TargetingComputer::OnThink
 
 
 
@@ -125,13 +122,34 @@ void TargetingComputer::Update ( Math::MatrixStack& toWorldStack,
 void TargetingComputer::AcquireTarget ( )
 {
 
+	static Core::ConsoleFloat target_threshold( "target_threshold", 0.7f );
+
 	EntityNode* closestTarget = 0;
 	Float distanceSquared = std::numeric_limits<Float>::max();
 
-	//Find all entities within the target radius
+	//Find all entities within the target radius that this computer can target.
+	//CanTarget still checks them, but the filter keeps the rest out of the results
+	EntityQueryFilter filter;
+	filter.NoneOf ( EF_PROJECTILE );
+
+	if ( IsFlagSet(TCF_TARGETPLAYERS) )
+	{
+		filter.AnyOf ( EF_PLAYER );
+	}
+
+	if ( IsFlagSet(TCF_TARGETALLIES) )
+	{
+		filter.AnyOf ( EF_ALLY );
+	}
+
+	if ( IsFlagSet(TCF_TARGETENEMIES) )
+	{
+		filter.AnyOf ( EF_ENEMY );
+	}
+
 	EntityQueryResult results;
 	Math::BoundingSphere3D targetRadius( GetMaxRange(), BoundingBox().GetCentre() );
-	m_scene.QueryScene ( targetRadius, results );
+	m_scene.QueryScene ( targetRadius, filter, results );
 
 	//Find the closest target
 	for ( EntityQueryResult::iterator itr = results.begin();
@@ -143,8 +161,6 @@ void TargetingComputer::AcquireTarget ( )
 			Math::Vector3D v = (*itr)->BoundingBox().GetCentre() - BoundingBox().GetCentre();
 			Float currentDistanceSquared = v.LengthSquared();
 
-			static Core::ConsoleFloat target_threshold( "target_threshold", 0.7f );
-
 			//Only target the object if it's within our view cone
 			if (   ( IsFlagSet(TCF_IGNOREANGLE) )
 				|| (Math::Vector3D::DotProduct( -Forward(), v.Normalise() ) >= target_threshold) )
@@ -158,7 +174,7 @@ void TargetingComputer::AcquireTarget ( )
 		}
 	}
 
-	m_currentTarget = closestTarget;
+	m_currentTarget = EntityHandle ( closestTarget );
 }
 //End  TargetingComputer::AcquireTarget
 
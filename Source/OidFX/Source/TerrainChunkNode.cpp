@@ -33,6 +33,7 @@
 #include "Renderer/Renderer.h"
 #include "Renderer/RenderQueue.h"
 #include "OidFX/GameApplication.h"
+#include "OidFX/VisibleObjectList.h"
 #include "OidFX/Scene.h"
 #include "OidFX/TerrainNode.h"
 #include "OidFX/TerrainChunkNode.h"
@@ -59,44 +60,65 @@ UInt TerrainChunkNode::ms_nodesRendered = 0;
 //! @param       terrainNode	[in] Terrain node that owns this chunk	
 //! @param       chunkRow		[in] Row position of this chunk in the terrain node's chunk list
 //! @param       chunkColumn	[in] Column position of this chunk in the terrain node's chunk list	
-//! @param       indexBuffer	[in] Handle to the shared index buffer used to draw all terrain chunks	
-//! @param       effect			[in] Handle to the shared effect used to draw all terrain chunks	
 //!              
-//! @return      
-//! @throw       
+//!				 Only builds the chunk mesh. @see TerrainChunkNode::CreateResources
 //=========================================================================
 TerrainChunkNode::TerrainChunkNode ( Scene& scene, 
 									 const Math::Matrix4x4& toWorld,
 									 const Math::Matrix4x4& fromWorld,
 									 TerrainNode& terrainNode, 
 									 UInt chunkRow, 
-									 UInt chunkColumn,
-									 Renderer::HIndexBuffer indexBuffer,
-									 Renderer::HEffect effect )
+									 UInt chunkColumn )
 	:	
 		SceneObject(scene, NODETYPE_WORLD, toWorld, fromWorld ), 
 		m_terrainNode(terrainNode), 
 		m_chunkRow(chunkRow),
 		m_chunkColumn(chunkColumn),
-		m_indexBuffer(indexBuffer),
-		m_effect(effect)
+		m_stitchMask(0),
+		m_morphFactor(0.0f),
+		m_filledLODLevel(0),
+		m_filledMorphFactor(0.0f),
+		m_dynamicVertices(false),
+		m_queuedLODLevel(0),
+		m_queuedStitchMask(0)
 {
 
 	std::clog << __FUNCTION__ ": Creating Terrain chunk " << chunkRow << "," << chunkColumn << std::endl;
 
+	const UInt chunkCells = m_terrainNode.ChunkSize() - 1;
+
+	m_heightfieldRegion.firstRow = chunkCells * m_chunkRow;
+	m_heightfieldRegion.firstCol = chunkCells * m_chunkColumn;
+	m_heightfieldRegion.lastRow = m_heightfieldRegion.firstRow + chunkCells;
+	m_heightfieldRegion.lastCol = m_heightfieldRegion.firstCol + chunkCells;
+
 	BuildVertexList();
 	//SmoothTerrainHeights();
 	CalculateNormals();
 	CalculateBoundingBox();
-	BuildCollisionMesh();
 
-	m_collisionVolume = m_scene.GetCollisionManager().CreateTreeCollision( m_collisionMesh.triangles );
+}
+//End TerrainChunkNode::TerrainChunkNode
+
+
+
+//=========================================================================
+//! @function    TerrainChunkNode::CreateResources
+//! @brief       Create the vertex buffer for the chunk
+//!              
+//!				 The renderer isn't thread safe, so this must be called from the main thread
+//!
+//! @throw       Core::RuntimeError if the vertex buffer could not be created
+//=========================================================================
+void TerrainChunkNode::CreateResources ( )
+{
+	m_indexBuffer = m_terrainNode.GetIndexBuffer();
+	m_effect = m_terrainNode.GetEffect();
 
 	CreateChunkVertexBuffer();
 	FillChunkVertexBuffer();
-
 }
-//End TerrainChunkNode::TerrainChunkNode
+//End TerrainChunkNode::CreateResources
 
 
 
@@ -104,10 +126,11 @@ TerrainChunkNode::TerrainChunkNode ( Scene& scene,
 //! @function    TerrainChunkNode::Update
 //! @brief       Updates the terrain chunk and all children
 //!            
-//!				 Essentially identical to the base class Update method,
-//!				 except that it clears the count of nodes rendered.
-//!				 (we keep a count of the number of nodes rendered this frame for
-//!				 debugging purposes)
+//!				 Terrain chunks have no children, and their bounds are built in
+//!				 world space, so only the concatenated transform is recalculated.
+//!				 OnTransformChanged isn't called, since it would move the bounds.
+//!				 The count of nodes rendered is reset by TerrainNode::Update, since 
+//!				 chunks are only updated when their transforms are dirty
 //!              
 //! @param       toWorldStack		  [in] Matrix stack for the toWorld transform
 //! @param		 fromWorldStack		  [in] Matrix stack for the fromWorld transform
@@ -119,10 +142,15 @@ void TerrainChunkNode::Update ( Math::MatrixStack& toWorldStack,
 							   Float timeElapsedInSeconds )
 {
 
-	ms_nodesRendered = 0; 
-	
-	//Terrain does not have child nodes
-	//SceneObject::Update(toWorldStack, fromWorldStack, timeElapsedInSeconds);
+	if ( m_transformDirty )
+	{
+		m_concatObjectToWorld = toWorldStack.Top() * m_objectToWorld;
+		m_concatObjectFromWorld = fromWorldStack.Top() * m_objectFromWorld;
+	}
+
+	//Terrain does not have child nodes, so both flags are clean until the chunk moves again
+	m_transformDirty = false;
+	m_childTransformDirty = false;
 
 }
 //End TerrainChunkNode::Update
@@ -162,6 +190,18 @@ void TerrainChunkNode::QueueForRendering ( Renderer::RenderQueue& queue )
 
 	++ms_nodesRendered;
 
+	//Refill the vertex buffer if the morphed heights have changed since it was last filled
+	if ( m_dynamicVertices 
+		&& ((m_lodLevel != m_filledLODLevel) || (m_morphFactor != m_filledMorphFactor)) )
+	{
+		FillChunkVertexBuffer();
+	}
+
+	//Render draws with the LOD the chunk was queued with, since the next frame's
+	//culling may change it before the queue is drawn
+	m_queuedLODLevel = m_lodLevel;
+	m_queuedStitchMask = m_stitchMask;
+
 	UInt techniqueIndex = m_effect->GetBestTechniqueForLOD(m_lodLevel);
 
 	for ( UInt passIndex = 0; passIndex < m_effect->Techniques(techniqueIndex).PassCount(); ++passIndex )
@@ -188,8 +228,8 @@ void TerrainChunkNode::Render ( Renderer::IRenderer& renderer )
 	renderer.DrawIndexedPrimitive ( Renderer::PRIM_TRIANGLELIST, 
 									0,
 									chunkSize * chunkSize,
-									m_terrainNode.GetLODInfo(m_lodLevel).startIndex,
-									m_terrainNode.GetLODInfo(m_lodLevel).indexCount );
+									m_terrainNode.GetLODInfo(m_queuedLODLevel, m_queuedStitchMask).startIndex,
+									m_terrainNode.GetLODInfo(m_queuedLODLevel, m_queuedStitchMask).indexCount );
 }
 //End TerrainChunkNode::Render
 
@@ -258,7 +298,7 @@ void TerrainChunkNode::BuildVertexList  ( )
 			vertex.texCoord0.Set ( texCoord0U, texCoord0V, 0.0f );
 			vertex.texCoord1.Set ( texCoord1U, texCoord1V, 0.0f );
 
-			m_collisionMesh.vertices.push_back(vertex);
+			m_mesh.vertices.push_back(vertex);
 
 			texCoord0U += texCoord0Increment;
 			texCoord1U += texCoord1Increment;
@@ -340,8 +380,8 @@ void TerrainChunkNode::CalculateNormals ( )
 													(col) + ((chunkSize-1) * m_chunkColumn));
 			}
 
-			m_collisionMesh.vertices[(row * chunkSize) + col].normal.Set((h3-h1), (h4-h2), 2.0f);
-			m_collisionMesh.vertices[(row * chunkSize) + col].normal.Normalise();
+			m_mesh.vertices[(row * chunkSize) + col].normal.Set((h3-h1), (h4-h2), 2.0f);
+			m_mesh.vertices[(row * chunkSize) + col].normal.Normalise();
 		}
 	}
 
@@ -356,10 +396,10 @@ void TerrainChunkNode::CalculateNormals ( )
 //=========================================================================
 void TerrainChunkNode::CalculateBoundingBox ( )
 {
-	debug_assert ( !m_collisionMesh.vertices.empty(), "No vertices!" );
+	debug_assert ( !m_mesh.vertices.empty(), "No vertices!" );
 
-	CollisionMesh::VertexStore::const_iterator itr = m_collisionMesh.vertices.begin();
-	CollisionMesh::VertexStore::const_iterator end = m_collisionMesh.vertices.end();
+	ChunkMesh::VertexStore::const_iterator itr = m_mesh.vertices.begin();
+	ChunkMesh::VertexStore::const_iterator end = m_mesh.vertices.end();
 
 	Math::Vector3D max = itr->position;
 	Math::Vector3D min = itr->position;
@@ -394,32 +434,6 @@ void TerrainChunkNode::CalculateBoundingBox ( )
 
 
 
-//=========================================================================
-//! @function    TerrainChunkNode::BuildCollisionMesh
-//! @brief       Build the collision mesh, from a low LOD version
-//!				 of the terrain
-//!              
-//=========================================================================
-void TerrainChunkNode::BuildCollisionMesh ( )
-{
-
-	for ( UInt i=0; i < m_terrainNode.GetTriangles().size(); i+=2 )
-	{
-
-		m_collisionMesh.triangles.push_back( Math::Triangle(  m_collisionMesh.vertices[m_terrainNode.GetTriangles()[i].v0].position,
-															  m_collisionMesh.vertices[m_terrainNode.GetTriangles()[i].v1].position,
-															  m_collisionMesh.vertices[m_terrainNode.GetTriangles()[i].v2].position ));
-
-		m_collisionMesh.triangles.push_back( Math::Triangle(   m_collisionMesh.vertices[m_terrainNode.GetTriangles()[i+1].v0].position,
-															   m_collisionMesh.vertices[m_terrainNode.GetTriangles()[i+1].v1].position,
-															   m_collisionMesh.vertices[m_terrainNode.GetTriangles()[i+1].v2].position) );
-	}
-
-}
-//End TerrainChunkNode::BuildCollisionMesh
-
-
-
 //=========================================================================
 //! @function    TerrainChunkNode::CreateChunkVertexBuffer
 //! @brief       Create the vertex buffer to hold the 
@@ -438,13 +452,18 @@ void TerrainChunkNode::CreateChunkVertexBuffer ( )
 	descriptor.AddElement ( 0, 28, Renderer::DECLTYPE_FLOAT2, Renderer::DECLUSAGE_TEXCOORD, 0 ); 
 	descriptor.AddElement ( 0, 36, Renderer::DECLTYPE_FLOAT2, Renderer::DECLUSAGE_TEXCOORD, 1 );
 
+	static Core::ConsoleBool ter_geomorph ( "ter_geomorph", true );
+
 	m_vertexDeclaration = m_scene.Application().GetRenderer().AcquireVertexDeclaration( descriptor );
 
+	//Morphing rewrites the vertex heights as the camera moves, so the buffer needs to be dynamic
+	m_dynamicVertices = ter_geomorph;
+
 	Renderer::HVertexBuffer chunkBuffer = 
 				m_scene.Application().GetRenderer().CreateVertexBuffer
 							( sizeof(TerrainVertex), 
 							  m_terrainNode.ChunkSize() *  m_terrainNode.ChunkSize(), 
-							  Renderer::USAGE_STATICWRITEONLY );
+							  m_dynamicVertices ? Renderer::USAGE_DYNAMICWRITEONLY : Renderer::USAGE_STATICWRITEONLY );
 
 	if ( !chunkBuffer )
 	{
@@ -465,6 +484,9 @@ void TerrainChunkNode::CreateChunkVertexBuffer ( )
 //! @brief       This isn't really all that different from the SceneObject
 //!              version, it's just here to keep track of terrain rendering
 //!              for debug purposes
+//!
+//!				 When the terrain is geomorphing, the LOD level has already been set
+//!				 by the terrain node, so the distance based LOD update is skipped
 //!              
 //! @param       visibleObjectList 
 //! @param       camera 
@@ -475,12 +497,53 @@ void TerrainChunkNode::CreateChunkVertexBuffer ( )
 void TerrainChunkNode::FillVisibleObjectList ( VisibleObjectList& visibleObjectList, const Camera& camera )
 {
 
-	SceneObject::FillVisibleObjectList ( visibleObjectList, camera );
+	if ( !m_terrainNode.GeomorphEnabled() )
+	{
+		m_stitchMask = 0;
+		m_morphFactor = 0.0f;
+
+		SceneObject::FillVisibleObjectList ( visibleObjectList, camera );
+		return;
+	}
+
+	//Terrain chunks have no children, so there's nothing to recurse into
+	if ( Math::Intersects ( m_boundingBox, camera.ViewFrustum() ) )
+	{
+		visibleObjectList.AddObject ( *this );
+	}
 
 }
 //End TerrainChunkNode::FillVisibleObjectList
 
 
+
+//=========================================================================
+//! @function    TerrainChunkNode::SetLOD
+//! @brief       Set the LOD level, stitched edges, and morph factor of the chunk
+//!              
+//!				 Called by the terrain node each frame while geomorphing.
+//!				 The morph factor is quantised to ter_morphsteps steps, so that
+//!				 the vertex buffer is only refilled when the heights change visibly
+//!
+//! @param       lodLevel		[in] LOD level to draw the chunk at
+//! @param       stitchMask		[in] Combination of TerrainNode::EStitchSide flags for
+//!									 edges that border a coarser chunk
+//! @param       morphFactor	[in] Amount to morph towards the next LOD level, from 0 to 1
+//!              
+//=========================================================================
+void TerrainChunkNode::SetLOD ( UInt lodLevel, UInt stitchMask, Float morphFactor )
+{
+	static Core::ConsoleUInt ter_morphsteps ( "ter_morphsteps", 32 );
+
+	const Float steps = static_cast<Float>( Core::Max ( static_cast<UInt>(ter_morphsteps), 1U ) );
+
+	m_lodLevel = lodLevel;
+	m_stitchMask = stitchMask;
+	m_morphFactor = Math::Floor ( (morphFactor * steps) + 0.5f ) / steps;
+}
+//End TerrainChunkNode::SetLOD
+
+
 //=========================================================================
 //! @function    TerrainChunkNode::FillChunkVertexBuffer
 //! @brief       Fill the chunk vertex buffer with vertices from the 
@@ -489,7 +552,8 @@ void TerrainChunkNode::FillVisibleObjectList ( VisibleObjectList& visibleObjectL
 //=========================================================================
 void TerrainChunkNode::FillChunkVertexBuffer ( )
 {
-	Renderer::ScopedVertexBufferLock lock = m_vertexStreamBinding.GetStream(0)->LockAll( Renderer::LOCK_NORMAL );
+	Renderer::ScopedVertexBufferLock lock = m_vertexStreamBinding.GetStream(0)->LockAll
+												( m_dynamicVertices ? Renderer::LOCK_DISCARD : Renderer::LOCK_NORMAL );
 
 	if ( !lock )
 	{
@@ -499,14 +563,16 @@ void TerrainChunkNode::FillChunkVertexBuffer ( )
 
 	TerrainVertex* vertexPtr = reinterpret_cast<TerrainVertex*>(lock.GetLockPointer());
 
+	const UInt chunkSize = m_terrainNode.ChunkSize();
+
 	//Copy the vertex data from the collision mesh vertex store into the vertex buffer
-	CollisionMesh::VertexStore::const_iterator itr = m_collisionMesh.vertices.begin();
-	CollisionMesh::VertexStore::const_iterator end = m_collisionMesh.vertices.end();
+	ChunkMesh::VertexStore::const_iterator itr = m_mesh.vertices.begin();
+	ChunkMesh::VertexStore::const_iterator end = m_mesh.vertices.end();
 
-	for ( ; itr != end; ++itr )
+	for ( UInt index = 0; itr != end; ++itr, ++index )
 	{
 		vertexPtr->position[0] = itr->position.X();
-		vertexPtr->position[1] = itr->position.Y();
+		vertexPtr->position[1] = MorphedHeight ( index / chunkSize, index % chunkSize );
 		vertexPtr->position[2] = itr->position.Z();
 
 		vertexPtr->normal[0] = itr->normal.X();
@@ -524,11 +590,76 @@ void TerrainChunkNode::FillChunkVertexBuffer ( )
 		++vertexPtr;
 	}
 
+	m_filledLODLevel = m_lodLevel;
+	m_filledMorphFactor = m_morphFactor;
+
 }
 //End TerrainChunkNode::FillChunkVertexBuffer
 
 
 
+//=========================================================================
+//! @function    TerrainChunkNode::MorphedHeight
+//! @brief       Return the height of a vertex, morphed towards the next LOD level
+//!              
+//!				 Vertices that the next level drops are moved towards the point on the
+//!				 coarser triangle edge that they lie on. Vertices on the chunk edges never move,
+//!				 so that neighbouring chunks with different morph factors still meet exactly
+//!
+//! @param       row [in] Row of the vertex within the chunk
+//! @param       col [in] Column of the vertex within the chunk
+//!              
+//! @return      The morphed height of the vertex
+//=========================================================================
+Float TerrainChunkNode::MorphedHeight ( UInt row, UInt col ) const
+{
+	const UInt chunkSize = m_terrainNode.ChunkSize();
+	const UInt last = chunkSize - 1;
+
+	const Float height = m_mesh.vertices[(row * chunkSize) + col].position.Y();
+
+	if ( (m_morphFactor == 0.0f) 
+		|| (row == 0) || (col == 0) || (row == last) || (col == last) )
+	{
+		return height;
+	}
+
+	//Vertices that aren't drawn at this level don't need morphing
+	const UInt skip = 1 << m_lodLevel;
+
+	if ( (row % skip) || (col % skip) )
+	{
+		return height;
+	}
+
+	const bool oddRow = ((row / skip) & 1) != 0;
+	const bool oddCol = ((col / skip) & 1) != 0;
+
+	Float target = height;
+
+	if ( oddRow && oddCol )
+	{
+		//Centre of a coarse cell, on the diagonal shared by its two triangles
+		target = (m_mesh.vertices[((row + skip) * chunkSize) + (col - skip)].position.Y()
+				+ m_mesh.vertices[((row - skip) * chunkSize) + (col + skip)].position.Y()) * 0.5f;
+	}
+	else if ( oddCol )
+	{
+		target = (m_mesh.vertices[(row * chunkSize) + (col - skip)].position.Y()
+				+ m_mesh.vertices[(row * chunkSize) + (col + skip)].position.Y()) * 0.5f;
+	}
+	else if ( oddRow )
+	{
+		target = (m_mesh.vertices[((row - skip) * chunkSize) + col].position.Y()
+				+ m_mesh.vertices[((row + skip) * chunkSize) + col].position.Y()) * 0.5f;
+	}
+
+	return height + ((target - height) * m_morphFactor);
+}
+//End TerrainChunkNode::MorphedHeight
+
+
+
 //=========================================================================
 //! @function    TerrainChunkNode::InitialiseAutogenAlphaTextures
 //! @brief       Initialise the autogenerated alpha textures
@@ -579,43 +710,21 @@ bool TerrainChunkNode::CollidesWith ( EntityNode* entity,
 									  Float& depth )
 {
 
-
-
 	//First check to see if the bounding boxes of the objects overlap
 	if ( !Math::Intersects( m_boundingBox, entity->BoundingBox() ) )
 	{
 		return false;
 	}
-	else
-	{
-
-		CollisionManager::CollisionInfo contacts;
-		CollisionManager::CollisionInfo normals;
-		CollisionManager::PenetrationInfo penetration;
-
-		//REMOVE ME!!! Debug check!!!
-		entity->GetMesh().SafeDereference();
-
-		if ( m_scene.GetCollisionManager().Collide( GetCollisionVolume(),
-													ConcatObjectToWorld(),
-													entity->GetCollisionVolume(),
-													entity->ConcatObjectToWorld(),
-													1,
-													contacts,
-													normals,
-													penetration ) )
-		{
-			normal = normals[0];
-			depth = penetration[0];
 
-			//REMOVE ME!!! Debug check!!!
-			entity->GetMesh().SafeDereference();
+	//Check the entity's box against the heightfield, in the local space of the terrain
+	Math::Vector3D minCorner = entity->BoundingBox().GetCorner ( Math::AxisAlignedBoundingBox::MIN_X_MIN_Y_MIN_Z );
+	Math::Vector3D maxCorner = entity->BoundingBox().GetCorner ( Math::AxisAlignedBoundingBox::MAX_X_MAX_Y_MAX_Z );
 
-			return true;
-		}	
-	}
+	minCorner *= ConcatObjectFromWorld();
+	maxCorner *= ConcatObjectFromWorld();
 
-	return false;
+	//The terrain is never rotated, so the normal is the same in world space
+	return m_terrainNode.Heightfield().Collide ( minCorner, maxCorner, m_heightfieldRegion, normal, depth );
 	
 }
 //End TerrainChunkNode::CollidesWith
@@ -640,9 +749,11 @@ void TerrainChunkNode::QueryScene ( const Math::ParametricLine3D& ray, SceneQuer
 	if ( Math::Intersects(ray, m_boundingBox, t) != Math::NoIntersect )
 	{
 
-		t = m_scene.GetCollisionManager().Collide(GetCollisionVolume(), ray);
-		
-		if ( Math::InRange(t, 0.0f, 1.0f) )
+		//The parametric position is the same in local space, since the terrain isn't scaled
+		Math::ParametricLine3D localRay ( ray.P0() * ConcatObjectFromWorld(), 
+										  ray.P1() * ConcatObjectFromWorld() );
+
+		if ( m_terrainNode.Heightfield().IntersectRay ( localRay, m_heightfieldRegion, t ) )
 		{
 			result.push_back( t );
 		}
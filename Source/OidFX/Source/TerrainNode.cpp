@@ -27,21 +27,27 @@
 //======================================================================================
 
 
+#include <algorithm>
 #include "Core/Core.h"
+#include "Core/Atomic.h"
+#include "Core/WorkerPool.h"
 #include "Math/Math.h"
 #include "Math/Vector3D.h"
 #include "Math/Matrix4x4.h"
 #include "Math/MatrixStack.h"
 #include "Math/BoundingSphere3D.h"
 #include "Math/IntersectionTests.h"
+#include "Math/ParametricLine3D.h"
 #include "Renderer/Renderer.h"
 #include "Renderer/EffectManager.h"
+#include "Renderer/VertexCacheOptimiser.h"
 #include "OidFX/Constants.h"
 #include "OidFX/Scene.h"
 #include "OidFX/GameApplication.h"
 #include "OidFX/TerrainChunkNode.h"
 #include "OidFX/TerrainNode.h"
 #include "OidFX/QuadtreeNode.h"
+#include "OidFX/EntityNode.h"
 
 
 
@@ -49,6 +55,69 @@ using namespace OidFX;
 
 
 
+//namespace OidFX
+namespace OidFX
+{
+
+	//!@class	TerrainChunkLoadJob
+	//!@brief	Builds the mesh for a single terrain chunk on the terrain loader thread
+	//!
+	//!			The main thread polls Finished, and then creates the chunk's resources
+	//!			and adds it to the scene. @see TerrainNode::UpdatePagedChunks
+	class TerrainChunkLoadJob : public Core::IJob
+	{
+		public:
+
+			TerrainChunkLoadJob ( Scene& scene, TerrainNode& terrain, UInt row, UInt col )
+				: m_scene(scene), m_terrain(terrain), m_row(row), m_col(col), m_finished(0)
+			{
+			}
+
+			void Execute ( )
+			{
+				try
+				{
+					m_chunk = boost::shared_ptr<TerrainChunkNode> 
+								( new TerrainChunkNode ( m_scene, Math::Matrix4x4(), Math::Matrix4x4(), m_terrain, m_row, m_col ) );
+				}
+				catch ( std::exception& error )
+				{
+					m_error = error.what();
+					m_chunk.reset();
+				}
+				catch ( ... )
+				{
+					m_error = "Unknown error";
+					m_chunk.reset();
+				}
+
+				//Publish the result to the main thread
+				Core::AtomicExchange ( m_finished, 1 );
+			}
+
+			bool Finished ( )									{ return Core::AtomicRead(m_finished) != 0;	}
+			UInt Row ( ) const									{ return m_row;		}
+			UInt Column ( ) const								{ return m_col;		}
+			const std::string& Error ( ) const					{ return m_error;	}
+			boost::shared_ptr<TerrainChunkNode> Chunk ( ) const	{ return m_chunk;	}
+
+		private:
+
+			Scene&			 m_scene;
+			TerrainNode&	 m_terrain;
+			UInt			 m_row;
+			UInt			 m_col;
+			Core::AtomicLong m_finished;
+			std::string		 m_error;
+			boost::shared_ptr<TerrainChunkNode> m_chunk;
+	};
+	//End class TerrainChunkLoadJob
+
+}
+//end namespace OidFX
+
+
+
 
 //=========================================================================
 //! @function    TerrainNode::TerrainNode
@@ -63,6 +132,7 @@ using namespace OidFX;
 //!										 randomly, but I've chosen this method for the moment, due to time constraints
 //!										 time constraints
 //! @param		 terrainEffectName	[in] Filename of the effect used to render the terrain
+//! @param		 heightMapFormat	[in] Sample format of the heightmap file. By default it's guessed from the file size
 //!
 //! @throw		 Core::RuntimeError if the terrain heightmap or normals could not be found
 //=========================================================================
@@ -74,14 +144,17 @@ TerrainNode::TerrainNode ( Scene& scene,
 						   const Char* heightmapFileName,
 						   const Char* terrainEffectName,
 						   const Math::Matrix4x4& toWorld, 
-						   const Math::Matrix4x4& fromWorld
+						   const Math::Matrix4x4& fromWorld,
+						   Core::HeightMap::EFormat heightMapFormat
 						   )
 : 
 	 SceneObject(scene, NODETYPE_WORLD, Math::Matrix4x4(), Math::Matrix4x4() ), 
 	 m_heightmapSize(heightmapSize), 
 	 m_chunkSize(chunkSize),
 	 m_terrainSize(terrainSize), 
-	 m_terrainMaxY(terrainMaxY)
+	 m_terrainMaxY(terrainMaxY),
+	 m_geomorphEnabled(false),
+	 m_paged(false)
 {
 
 	//Set the bounding volume of the terrain
@@ -94,7 +167,7 @@ TerrainNode::TerrainNode ( Scene& scene,
 	m_objectFromWorld.Translate ( Math::Vector3D(m_terrainSize/2, 0, m_terrainSize/2) );
 
 	//Load the heightmap
-	LoadHeightMap ( heightmapFileName );
+	LoadHeightMap ( heightmapFileName, heightMapFormat );
 
 	//Load the terrain effect
 	m_effect = m_scene.Application().GetEffectManager().AcquireEffect( terrainEffectName );
@@ -111,9 +184,19 @@ TerrainNode::TerrainNode ( Scene& scene,
 //! @function    TerrainNode::InitialiseTerrain
 //! @brief       Updates the terrain bounding box, and creates all terrain chunks
 //!
+//!				 If ter_paged is set, then no chunks are created here. They are built
+//!				 around the camera once the terrain starts updating
 //=========================================================================
 void TerrainNode::InitialiseTerrain ( )
 {
+	static Core::ConsoleBool ter_paged ( "ter_paged", false );
+
+	m_paged = ter_paged;
+
+	if ( m_paged )
+	{
+		m_loaderPool = boost::shared_ptr<Core::WorkerPool>( new Core::WorkerPool(1) );
+	}
 	
 	//Set the position of the bounding box
 	UpdateBoundsPositionFromLocalTransform();
@@ -144,6 +227,34 @@ void TerrainNode::Restore ( )
 
 
 
+//=========================================================================
+//! @function    TerrainNode::Update
+//! @brief       Update the terrain, paging chunks in and out around the camera
+//!				 if paging is enabled
+//!              
+//! @param       toWorldStack		  [in] Matrix stack for the toWorld transform
+//! @param		 fromWorldStack		  [in] Matrix stack for the fromWorld transform
+//! @param       timeElapsedInSeconds [in] Time elapsed since last update
+//!              
+//=========================================================================
+void TerrainNode::Update ( Math::MatrixStack& toWorldStack, 
+						   Math::MatrixStack& fromWorldStack, 
+						   Float timeElapsedInSeconds )
+{
+	TerrainChunkNode::ResetNodesRendered ( );
+
+	//Page before updating the children, since paging adds and removes chunks from the quadtree
+	if ( m_paged )
+	{
+		UpdatePagedChunks ( m_scene.Application().GetCamera().GetPosition() );
+	}
+
+	SceneNode::Update ( toWorldStack, fromWorldStack, timeElapsedInSeconds );
+}
+//End TerrainNode::Update
+
+
+
 //=========================================================================
 //! @function    TerrainNode::FillVisibleObjectList
 //! @brief       Add the terrain to the visible object list if it is visible
@@ -154,11 +265,22 @@ void TerrainNode::Restore ( )
 //=========================================================================
 void TerrainNode::FillVisibleObjectList ( VisibleObjectList& visibleObjectList, const Camera& camera )
 {
+	static Core::ConsoleBool ter_geomorph ( "ter_geomorph", true );
+
 	if ( !Math::Intersects ( m_boundingBox, camera.ViewFrustum() ) )
 	{
 		return;
 	}
 
+	//Pick the chunk LOD levels here, before the chunks are culled, since the
+	//quadtree below may be culled on several threads, and each chunk's LOD depends on its neighbours
+	m_geomorphEnabled = ter_geomorph;
+
+	if ( m_geomorphEnabled )
+	{
+		UpdateChunkLODs ( camera );
+	}
+
 	//Call the base class FillVisibleObjectList to add all children
 	SceneObject::FillVisibleObjectList ( visibleObjectList, camera );
 }
@@ -168,64 +290,40 @@ void TerrainNode::FillVisibleObjectList ( VisibleObjectList& visibleObjectList,
 
 //=========================================================================
 //! @function    TerrainNode::LoadHeightMap
-//! @brief       Populate the heights list from a RAW file
+//! @brief       Load the heightmap from a RAW file
 //!              
 //!              In future I'll be generating a heightmap randomly
 //!				 but due to time constraints, I've been forced to do it this way
 //!				 for the moment.
+//!
+//!				 16 bit and float heightmaps give much finer height steps than 8 bit
+//!				 ones, which only have 256 levels between 0 and m_terrainMaxY
 //!              
-//! @param       fileName [in]
+//! @param       fileName [in] Name of the heightmap file
+//! @param       format   [in] Sample format of the heightmap file
 //!              
-//! @throw       Core::RuntimeError if the file could not be found
+//! @throw       Core::RuntimeError if the file could not be found, or is too small
 //=========================================================================
-void TerrainNode::LoadHeightMap ( const Char* fileName )
+void TerrainNode::LoadHeightMap ( const Char* fileName, Core::HeightMap::EFormat format )
 {
 	debug_assert ( fileName, "Error, null filename passed to LoadHeightMap!" );
 
-	std::ifstream heightFile ( fileName, std::ios::binary );
-
-	heightFile.seekg( 0, std::ios_base::end );
-	UInt fileSize = heightFile.tellg();
-    heightFile.seekg( 0, std::ios_base::beg );
-
-	if ( !heightFile )
-	{
-		throw Core::RuntimeError ( "Couldn't find heightmap file!", 0, __FILE__, __FUNCTION__, __LINE__ );
-	}
-
-	//Read in the heightmap values
-	UInt bytesToRead = fileSize;
-	m_heights.reserve(bytesToRead);
+	m_heightMap.Load ( fileName, format, m_terrainMaxY );
 
-	UInt fileHeightmapSize = Math::Sqrt(static_cast<Float>(fileSize));
-
-	if ( fileHeightmapSize < m_heightmapSize )
+	if ( m_heightMap.Size() < m_heightmapSize )
 	{
-		m_heightmapSize = fileHeightmapSize;
+		m_heightmapSize = m_heightMap.Size();
 	}
 
-	while ( heightFile && bytesToRead )
-	{
-		UChar heightVal = 0;
-
-		heightFile.read ( (std::istream::char_type*)(&heightVal), 1);
-		m_heights.push_back ( (static_cast<Float>(heightVal) / 255.0) * m_terrainMaxY );
-	
-		--bytesToRead;
-	}
-
-	heightFile.close();
+	m_heightfield.Initialise ( m_heightMap, m_heightmapSize, m_terrainSize / static_cast<Float>(m_heightmapSize - 1) );
 }
 //End TerrainNode::LoadHeightMap
 
 
 //=========================================================================
 //! @function    TerrainNode::PopulateTerrainChunks
-//! @brief       Create the terrain chunks
-//!              
+//! @brief       Create the quadtree, and the terrain chunks if the terrain isn't paged
 //!              
-//! @return      
-//! @throw       
 //=========================================================================
 void TerrainNode::PopulateTerrainChunks ( )
 {
@@ -233,8 +331,6 @@ void TerrainNode::PopulateTerrainChunks ( )
 	//number of rows and columns are identical
 	UInt chunkRows = m_heightmapSize / m_chunkSize;
 
-	Math::Matrix4x4 chunkToWorld;
-	Math::Matrix4x4 chunkFromWorld;
 	Float chunkWorldSize = m_terrainSize / 
 							( static_cast<Float>(m_heightmapSize) / 
 							  static_cast<Float>(m_chunkSize) );
@@ -249,9 +345,21 @@ void TerrainNode::PopulateTerrainChunks ( )
 																	BoundingBox().ExtentY(), 
 																	BoundingBox().ExtentZ()) );
 
-	boost::shared_ptr<QuadtreeNode> quadtreeNode ( new QuadtreeNode( m_scene, quadBoundingBox ) );
-	AddChild( quadtreeNode );
-	quadtreeNode->BuildQuadtree( leafBounds );
+	m_quadtree = boost::shared_ptr<QuadtreeNode>( new QuadtreeNode( m_scene, quadBoundingBox ) );
+	AddChild( m_quadtree );
+	m_quadtree->BuildQuadtree( leafBounds );
+
+	m_chunks.resize ( chunkRows * chunkRows, 0 );
+	m_chunkStates.resize ( chunkRows * chunkRows, CHUNK_UNLOADED );
+	m_chunkLODs.resize ( chunkRows * chunkRows, 0 );
+	m_chunkBandLODs.resize ( chunkRows * chunkRows, 0 );
+	m_chunkMorphFactors.resize ( chunkRows * chunkRows, 0.0f );
+
+	if ( m_paged )
+	{
+		std::clog << __FUNCTION__ ": Terrain is paged, chunks will be built around the camera" << std::endl;
+		return;
+	}
 
 	for ( UInt row = 0; row < chunkRows; ++row )
 	{
@@ -264,19 +372,9 @@ void TerrainNode::PopulateTerrainChunks ( )
 													    Math::Matrix4x4(),
 													   *this,
 													    row,
-													    col,
-														m_indexBuffer,
-														m_effect) );
-
-			//Update the concatenated transform and bounding volume, so that the
-			//node is sorted into the scene graph properly
-			node->SetConcatTransform ( ConcatObjectToWorld() * node->ObjectToWorld(), 
-									   ConcatObjectFromWorld () * node->ObjectFromWorld() );
+													    col) );
 
-			node->UpdateBoundsPositionFromConcatTransform();
-			
-			//Add the node to the quadtree
-			quadtreeNode->AddSortedChild( node );
+			AddChunk ( node, row, col );
 
 			std::clog << __FUNCTION__ ": Added terrain chunk " << row << "," << col << std::endl;
 		}
@@ -285,42 +383,336 @@ void TerrainNode::PopulateTerrainChunks ( )
 //End TerrainNode::PopulateTerrainChunks
 
 
+
+//=========================================================================
+//! @function    TerrainNode::AddChunk
+//! @brief       Create the resources for a chunk, and add it to the quadtree
+//!              
+//! @param       node	[in] Chunk to add
+//! @param       row	[in] Row of the chunk
+//! @param       col	[in] Column of the chunk
+//!              
+//=========================================================================
+void TerrainNode::AddChunk ( boost::shared_ptr<TerrainChunkNode> node, UInt row, UInt col )
+{
+	const UInt chunkRows = m_heightmapSize / m_chunkSize;
+
+	node->CreateResources();
+
+	//Update the concatenated transform and bounding volume, so that the
+	//node is sorted into the scene graph properly
+	node->SetConcatTransform ( ConcatObjectToWorld() * node->ObjectToWorld(), 
+							   ConcatObjectFromWorld () * node->ObjectFromWorld() );
+
+	node->UpdateBoundsPositionFromConcatTransform();
+	
+	//Add the node to the quadtree
+	m_quadtree->AddSortedChild( node );
+
+	m_chunks[(row * chunkRows) + col] = node.get();
+	m_chunkStates[(row * chunkRows) + col] = CHUNK_LOADED;
+}
+//End TerrainNode::AddChunk
+
+
+
+//=========================================================================
+//! @function    TerrainNode::EvictChunk
+//! @brief       Remove a chunk from the quadtree, releasing it and its resources
+//!              
+//! @param       row	[in] Row of the chunk
+//! @param       col	[in] Column of the chunk
+//!              
+//=========================================================================
+void TerrainNode::EvictChunk ( UInt row, UInt col )
+{
+	const UInt index = (row * (m_heightmapSize / m_chunkSize)) + col;
+
+	TerrainChunkNode* chunk = m_chunks[index];
+
+	debug_assert ( chunk, "Tried to evict a chunk that isn't loaded!" );
+	debug_assert ( chunk->Parent(), "Terrain chunk isn't in the quadtree!" );
+
+	m_chunks[index] = 0;
+	m_chunkStates[index] = CHUNK_UNLOADED;
+
+	//The quadtree holds the only reference to the chunk. The scene releases it
+	//once any frame it was queued in has been drawn
+	chunk->Parent()->RemoveChild ( *chunk );
+}
+//End TerrainNode::EvictChunk
+
+
+
+//=========================================================================
+//! @function    TerrainNode::UpdatePagedChunks
+//! @brief       Page chunks in and out around the camera
+//!              
+//!				 Chunks within ter_pageradius of the camera in the xz plane are queued on the
+//!				 loader thread, closest first, with at most ter_pagemaxinflight queued at once.
+//!				 Finished chunks are added to the scene, at most ter_pagemaxfinalise per frame,
+//!				 since creating the vertex buffer and collision tree has to happen on this thread.
+//!				 Chunks further than ter_pageradius * ter_pageevictfactor are evicted.
+//!
+//!				 The first time this is called, the chunks in range are built immediately, so
+//!				 that there is terrain under the camera and entities from the first frame
+//!
+//! @param       cameraPosition [in] World space position of the camera
+//!              
+//=========================================================================
+void TerrainNode::UpdatePagedChunks ( const Math::Vector3D& cameraPosition )
+{
+	static Core::ConsoleFloat ter_pageradius ( "ter_pageradius", 3.0f * kilometers );
+	static Core::ConsoleFloat ter_pageevictfactor ( "ter_pageevictfactor", 1.25f );
+	static Core::ConsoleUInt  ter_pagemaxinflight ( "ter_pagemaxinflight", 4 );
+	static Core::ConsoleUInt  ter_pagemaxfinalise ( "ter_pagemaxfinalise", 2 );
+
+	debug_assert ( m_loaderPool, "Terrain is paged, but has no loader pool!" );
+
+	const UInt chunkRows = m_heightmapSize / m_chunkSize;
+	const Float loadRadius = ter_pageradius;
+	const Float evictRadius = loadRadius * Core::Max ( static_cast<Float>(ter_pageevictfactor), 1.0f );
+
+	//Nothing has been loaded yet, so build everything in range now
+	const bool initialLoad = m_loadJobs.empty() 
+						  && (std::find ( m_chunkStates.begin(), m_chunkStates.end(), CHUNK_LOADED ) == m_chunkStates.end());
+
+	//Add finished chunks to the scene
+	UInt finalised = 0;
+
+	for ( UInt i = 0; (i < m_loadJobs.size()) && (finalised < ter_pagemaxfinalise); )
+	{
+		TerrainChunkLoadJob& job = *m_loadJobs[i];
+
+		if ( !job.Finished() )
+		{
+			++i;
+			continue;
+		}
+
+		const UInt index = (job.Row() * chunkRows) + job.Column();
+
+		if ( !job.Chunk() )
+		{
+			std::cerr << __FUNCTION__ ": Error building terrain chunk " << job.Row() << "," << job.Column() 
+					  << ": " << job.Error() << std::endl;
+
+			m_chunkStates[index] = CHUNK_UNLOADED;
+		}
+		else if ( ChunkDistanceXZ ( job.Row(), job.Column(), cameraPosition ) > evictRadius )
+		{
+			//The camera moved away while the chunk was being built
+			m_chunkStates[index] = CHUNK_UNLOADED;
+		}
+		else
+		{
+			AddChunk ( job.Chunk(), job.Row(), job.Column() );
+			++finalised;
+		}
+
+		m_loadJobs.erase ( m_loadJobs.begin() + i );
+	}
+
+	//Evict chunks that are out of range, and find chunks that should be loaded
+	typedef std::pair<Float, UInt> Candidate;
+	std::vector<Candidate> candidates;
+
+	for ( UInt row = 0; row < chunkRows; ++row )
+	{
+		for ( UInt col = 0; col < chunkRows; ++col )
+		{
+			const UInt index = (row * chunkRows) + col;
+			const Float distance = ChunkDistanceXZ ( row, col, cameraPosition );
+
+			if ( (m_chunkStates[index] == CHUNK_LOADED) && (distance > evictRadius) )
+			{
+				EvictChunk ( row, col );
+			}
+			else if ( (m_chunkStates[index] == CHUNK_UNLOADED) && (distance <= loadRadius) )
+			{
+				candidates.push_back ( Candidate(distance, index) );
+			}
+		}
+	}
+
+	//Queue the closest chunks first
+	std::sort ( candidates.begin(), candidates.end() );
+
+	for ( std::vector<Candidate>::const_iterator itr = candidates.begin(); itr != candidates.end(); ++itr )
+	{
+		const UInt row = itr->second / chunkRows;
+		const UInt col = itr->second % chunkRows;
+
+		boost::shared_ptr<TerrainChunkLoadJob> job ( new TerrainChunkLoadJob ( m_scene, *this, row, col ) );
+
+		if ( initialLoad )
+		{
+			job->Execute();
+
+			if ( !job->Chunk() )
+			{
+				throw Core::RuntimeError ( job->Error().c_str(), 0, __FILE__, __FUNCTION__, __LINE__ );
+			}
+
+			AddChunk ( job->Chunk(), row, col );
+			continue;
+		}
+
+		if ( m_loadJobs.size() >= ter_pagemaxinflight )
+		{
+			break;
+		}
+
+		m_chunkStates[itr->second] = CHUNK_LOADING;
+		m_loadJobs.push_back ( job );
+		m_loaderPool->Submit ( *job );
+	}
+}
+//End TerrainNode::UpdatePagedChunks
+
+
+
+//=========================================================================
+//! @function    TerrainNode::GetChunkBounds
+//! @brief       Get the world space bounds of a chunk from the chunk grid
+//!              
+//!				 Works whether or not the chunk is loaded. The bounds cover
+//!				 the full height range of the terrain
+//!
+//! @param       row		[in]	Row of the chunk
+//! @param       col		[in]	Column of the chunk
+//! @param       minCorner	[out]	Minimum corner of the chunk bounds
+//! @param       maxCorner	[out]	Maximum corner of the chunk bounds
+//!              
+//=========================================================================
+void TerrainNode::GetChunkBounds ( UInt row, UInt col, Math::Vector3D& minCorner, Math::Vector3D& maxCorner ) const
+{
+	const Float chunkWorldSize = (m_terrainSize / static_cast<Float>(m_heightmapSize - 1)) 
+								* static_cast<Float>(m_chunkSize - 1);
+
+	minCorner.Set ( chunkWorldSize * static_cast<Float>(col), 0.0f, chunkWorldSize * static_cast<Float>(row) );
+	maxCorner.Set ( chunkWorldSize * static_cast<Float>(col + 1), m_terrainMaxY, chunkWorldSize * static_cast<Float>(row + 1) );
+
+	minCorner *= ConcatObjectToWorld();
+	maxCorner *= ConcatObjectToWorld();
+}
+//End TerrainNode::GetChunkBounds
+
+
+
+//=========================================================================
+//! @function    TerrainNode::ChunkDistanceXZ
+//! @brief       Get the distance in the xz plane from a point to a chunk
+//!              
+//! @param       row		[in] Row of the chunk
+//! @param       col		[in] Column of the chunk
+//! @param       position	[in] World space position
+//!              
+//! @return      Distance from position to the closest point of the chunk,
+//!				 ignoring height. Zero if the point is above or below the chunk
+//=========================================================================
+Float TerrainNode::ChunkDistanceXZ ( UInt row, UInt col, const Math::Vector3D& position ) const
+{
+	Math::Vector3D minCorner;
+	Math::Vector3D maxCorner;
+
+	GetChunkBounds ( row, col, minCorner, maxCorner );
+
+	Float dx = Core::Max ( Core::Max ( minCorner.X() - position.X(), position.X() - maxCorner.X() ), 0.0f );
+	Float dz = Core::Max ( Core::Max ( minCorner.Z() - position.Z(), position.Z() - maxCorner.Z() ), 0.0f );
+
+	return Math::Sqrt ( (dx * dx) + (dz * dz) );
+}
+//End TerrainNode::ChunkDistanceXZ
+
+
 //=========================================================================
 //! @function    TerrainNode::CreateChunkIndexBuffer
 //! @brief       Create an index buffer shared between the terrain chunks
 //!              
+//!				 Each LOD level has STITCH_COMBINATIONS index ranges, one for every
+//!				 combination of edges that border a chunk of the next coarser level.
+//!				 The indices are generated here, and kept so that the buffer can be
+//!				 refilled when it is restored
+//!
 //=========================================================================
 void TerrainNode::CreateChunkIndexBuffer ( )
 {
+	const UInt chunkCells = m_chunkSize - 1;
 
-	UInt totalIndices = 0;
-	UInt currentLODStartIndex = 0;
+	//Number of vertices to skip for this LOD level. 1 = draw every vertex
+	UInt vertexSkip = 1;
 	UInt currentLOD = 0;
-	UInt currentLODTriCount = ((m_chunkSize-1)/(currentLOD+1)) * 
-							  ((m_chunkSize-1)/(currentLOD+1)) * 2.0f;
 
-	//Get the number of indices for all detail levels
-	while ( (currentLODTriCount > 2)
+	m_indices.clear();
+	m_lodStartIndices.clear();
+
+	Renderer::VertexCacheOptimiser optimiser;
+
+	//Generate indices for every LOD level that has at least two cells along each side,
+	//and whose vertices lie exactly on the chunk edges
+	while ( ((chunkCells / vertexSkip) >= 2)
+		&&  ((chunkCells % vertexSkip) == 0)
 		&&  (currentLOD <= g_lodMax) )
-	{	
-		//Add to the total number of indices
-		totalIndices += currentLODTriCount * 6;
+	{
+		//A chunk can only be stitched to the next level if that level exists
+		const bool canStitch = ((chunkCells % (vertexSkip * 2)) == 0)
+							&& ((chunkCells / (vertexSkip * 2)) >= 2)
+							&& (currentLOD < g_lodMax);
+
+		//Cache misses of the level, before and after reordering its triangles for the vertex cache
+		Float missesBefore = 0.0f;
+		Float missesAfter = 0.0f;
+		UInt  levelTriangles = 0;
 
-		LODInfo info;
-		info.startIndex = currentLODStartIndex;
-		info.indexCount = currentLODTriCount * 6;
+		for ( UInt stitchMask = 0; stitchMask < STITCH_COMBINATIONS; ++stitchMask )
+		{
+			LODInfo info;
+
+			if ( (stitchMask != 0) && (!canStitch) )
+			{
+				//Nothing is ever coarser than this level, so just share the unstitched range
+				info = m_lodStartIndices[currentLOD * STITCH_COMBINATIONS];
+			}
+			else
+			{
+				info.startIndex = static_cast<UInt>(m_indices.size());
+				FillIndexBufferLODLevel ( currentLOD, stitchMask, vertexSkip, m_indices );
+				info.indexCount = static_cast<UInt>(m_indices.size()) - info.startIndex;
 
-		m_lodStartIndices.push_back( info );
+				if ( info.indexCount > 0 )
+				{
+					UInt16*	   rangeIndices = &m_indices[info.startIndex];
+					const UInt rangeTriangles = info.indexCount / 3;
 
-		//Add to the current LOD start index
-		currentLODStartIndex += currentLODTriCount * 6;
+					missesBefore += Renderer::VertexCacheOptimiser::ACMR ( rangeIndices, info.indexCount ) * rangeTriangles;
+					optimiser.OptimiseTriangleOrder ( rangeIndices, info.indexCount, m_chunkSize * m_chunkSize );
+					missesAfter += Renderer::VertexCacheOptimiser::ACMR ( rangeIndices, info.indexCount ) * rangeTriangles;
+
+					levelTriangles += rangeTriangles;
+				}
+			}
+
+			m_lodStartIndices.push_back( info );
+		}
 
+		std::clog << __FUNCTION__ ": Generated index data for LOD level " << currentLOD 
+				  << ", ACMR " << (missesBefore / levelTriangles) << " before, " 
+				  << (missesAfter / levelTriangles) << " after" << std::endl;
+
+		vertexSkip *= 2;
 		++currentLOD;
-		currentLODTriCount = ((m_chunkSize-1)/(currentLOD+1)) * 
-							  ((m_chunkSize-1)/(currentLOD+1)) * 2.0f;
 	}
 
-	m_indexBuffer = m_scene.Application().GetRenderer().CreateIndexBuffer( Renderer::INDEX_16BIT, totalIndices, Renderer::USAGE_STATICWRITEONLY );
+	if ( m_indices.empty() )
+	{
+		throw Core::RuntimeError ( "Terrain chunk size is too small to generate any LOD levels!", 
+									0, __FILE__, __FUNCTION__, __LINE__ );
+	}
+
+	m_indexBuffer = m_scene.Application().GetRenderer().CreateIndexBuffer( Renderer::INDEX_16BIT, 
+																		   static_cast<UInt>(m_indices.size()), 
+																		   Renderer::USAGE_STATICWRITEONLY );
 
 	if ( !m_indexBuffer )
 	{
@@ -343,106 +735,234 @@ void TerrainNode::PopulateChunkIndexBuffer ( )
 	if ( !lock )
 	{
 		std::cerr << __FUNCTION__ << "Error, couldn't lock chunk index buffer!" << std::endl;
+		return;
 	}
 
 	UShort* indexPtr = reinterpret_cast<UShort*>(lock.GetLockPointer());
-	
-	//Number of vertices to skip for this LOD level. 1 = draw every vertex 
-	UInt vertexSkip = 1;
 
-	for ( UInt i=0; i < m_lodStartIndices.size(); ++i )
+	std::copy ( m_indices.begin(), m_indices.end(), indexPtr );
+}
+//End TerrainNode::PopulateChunkIndexBuffer
+
+
+//=========================================================================
+//! @function    TerrainNode::FillIndexBufferLODLevel
+//! @brief       Generate the indices for a specific LOD level
+//!              
+//! @param       lodLevel		[in]	 LOD level of the chunk
+//! @param       stitchMask		[in]	 Combination of EStitchSide flags, for the edges that
+//!										 should be stitched to the next coarser level
+//! @param       vertexSkip		[in]	 Number of vertices to skip in each direction for this LOD
+//! @param       indices		[in/out] Index list to append to
+//!              
+//=========================================================================
+void TerrainNode::FillIndexBufferLODLevel ( UInt lodLevel, 
+											UInt stitchMask,
+											UInt vertexSkip,
+											TerrainNode::IndexStore& indices )
+{
+	const UInt last = m_chunkSize - 1;
+
+	for ( UInt row = 0; (row + vertexSkip) <= last; row += vertexSkip )
 	{
-		
-		FillIndexBufferLODLevel ( i,
-								  indexPtr + m_lodStartIndices[i].startIndex,
-								  m_chunkSize,
-								  m_chunkSize,
-								  vertexSkip,
-								  vertexSkip, 
-								  m_chunkSize );
+		for ( UInt col = 0; (col + vertexSkip) <= last; col += vertexSkip )
+		{
+			//Triangle 1
+			AddStitchedTriangle ( indices, 
+								  row, col,
+								  row + vertexSkip, col,
+								  row, col + vertexSkip,
+								  vertexSkip, stitchMask );
 
-		vertexSkip *= 2;
+			//Triangle 2
+			AddStitchedTriangle ( indices,
+								  row, col + vertexSkip,
+								  row + vertexSkip, col,
+								  row + vertexSkip, col + vertexSkip,
+								  vertexSkip, stitchMask );
+		}
 	}
 
 }
-//End TerrainNode::PopulateChunkIndexBuffer
+//End TerrainNode::FillIndexBufferLODLevel
+
 
 
 //=========================================================================
-//! @function    TerrainNode::FillIndexBufferLODLevel
-//! @brief       Fill the index buffer for a specific LOD level
+//! @function    TerrainNode::AddStitchedTriangle
+//! @brief       Stitch the vertices of a triangle to any coarser neighbours, and add it 
+//!				 to an index list, unless stitching collapsed it to a line or a point
+//!              
+//! @param       indices	[in/out]	Index list to add the triangle to
+//! @param       row0		[in]		Row of the first vertex
+//! @param       col0		[in]		Column of the first vertex
+//! @param       row1		[in]		Row of the second vertex
+//! @param       col1		[in]		Column of the second vertex
+//! @param       row2		[in]		Row of the third vertex
+//! @param       col2		[in]		Column of the third vertex
+//! @param       vertexSkip [in]		Distance between vertices at the current LOD level
+//! @param       stitchMask [in]		Combination of EStitchSide flags
 //!              
+//=========================================================================
+void TerrainNode::AddStitchedTriangle ( TerrainNode::IndexStore& indices, 
+										UInt row0, UInt col0,
+										UInt row1, UInt col1,
+										UInt row2, UInt col2,
+										UInt vertexSkip,
+										UInt stitchMask ) const
+{
+	StitchVertex ( row0, col0, vertexSkip, stitchMask );
+	StitchVertex ( row1, col1, vertexSkip, stitchMask );
+	StitchVertex ( row2, col2, vertexSkip, stitchMask );
+
+	//Twice the signed area of the triangle in grid space. Zero means the triangle has collapsed
+	Int area = ((static_cast<Int>(col1) - static_cast<Int>(col0)) * (static_cast<Int>(row2) - static_cast<Int>(row0)))
+			 - ((static_cast<Int>(col2) - static_cast<Int>(col0)) * (static_cast<Int>(row1) - static_cast<Int>(row0)));
+
+	if ( area == 0 )
+	{
+		return;
+	}
+
+	indices.push_back( static_cast<UShort>((row0 * m_chunkSize) + col0) );
+	indices.push_back( static_cast<UShort>((row1 * m_chunkSize) + col1) );
+	indices.push_back( static_cast<UShort>((row2 * m_chunkSize) + col2) );
+}
+//End TerrainNode::AddStitchedTriangle
+
+
+
+//=========================================================================
+//! @function    TerrainNode::UpdateChunkLODs
+//! @brief       Pick the LOD level, stitch mask, and morph factor for every chunk
 //!              
-//! @param       lodLevel		[in] LOD level of the chunk
-//! @param       buffer			[in] Pointer to the location in the locked buffer
-//!									 to start writing indices for this level of detail
-//! @param       chunkVertsX	[in] Vertices in the x direction at the highest detail level
-//! @param       chunkVertsZ	[in] Vertices in the z direction at the highest detail level
-//! @param       xSkip			[in] Number of vertices to skip in the x direction for this LOD
-//! @param       zSkip			[in] Number of vertices to skip in the y direction for this LOD
-//! @param       bufferPitch	[in] Width of one row of vertices in the index buffer, in vertices
+//!				 Each chunk first gets an LOD level from its distance to the camera, one
+//!				 level per ter_lodbanddistance. The levels are then lowered until no chunk is more
+//!				 than one level coarser than any of its neighbours, since stitching can only join
+//!				 adjacent levels.
+//!
+//!				 Within the last ter_morphregion fraction of each band, the chunk morphs its
+//!				 vertices towards the next level, so that the switch to that level is seamless
+//!
+//! @param       camera [in] Camera the terrain is being viewed from
 //!              
 //=========================================================================
-void TerrainNode::FillIndexBufferLODLevel ( UInt lodLevel, 
-											UShort* buffer,
-											UInt chunkVertsX,
-											UInt chunkVertsZ,
-											UInt xSkip,
-											UInt zSkip,
-											UInt bufferPitch )
+void TerrainNode::UpdateChunkLODs ( const Camera& camera )
 {
+	static Core::ConsoleFloat ter_lodbanddistance ( "ter_lodbanddistance", g_lodPopDistance );
+	static Core::ConsoleFloat ter_morphregion ( "ter_morphregion", 0.3f );
+	static Core::ConsoleBool  dbg_terrainlodenable ( "dbg_terrainlodenable", true );
 
-	std::clog << __FUNCTION__ ": Filling in index data for LOD level " << lodLevel << std::endl;
+	if ( m_chunks.empty() )
+	{
+		return;
+	}
 
-	//Variables to hold the current row and column
-	UInt row = 0;
-	UInt col = 0;
+	const UInt chunkRows = m_heightmapSize / m_chunkSize;
+	const UInt maxLOD = dbg_terrainlodenable ? (LODCount() - 1) : 0;
+	const Float bandDistance = Core::Max ( static_cast<Float>(ter_lodbanddistance), 1.0f );
+	const Float morphRegion = Core::Min ( Core::Max ( static_cast<Float>(ter_morphregion), 0.01f ), 1.0f );
 
-	//Number of verts to step in the z direction
-	UInt zStep = bufferPitch * zSkip;
+	const Math::Vector3D& cameraPosition = camera.GetPosition();
 
-	while ( ((row+1) * zSkip) < chunkVertsZ )
+	//Pick the LOD level for each chunk from its distance to the camera
+	for ( UInt i = 0; i < m_chunks.size(); ++i )
 	{
-		col = 0;
+		Math::Vector3D minCorner;
+		Math::Vector3D maxCorner;
 
-		while ( (col + xSkip) < chunkVertsX )
+		//Paged out chunks still take part, so that the levels don't change as chunks are paged in
+		if ( m_chunks[i] )
+		{
+			minCorner = m_chunks[i]->BoundingBox().GetCorner ( Math::AxisAlignedBoundingBox::MIN_X_MIN_Y_MIN_Z );
+			maxCorner = m_chunks[i]->BoundingBox().GetCorner ( Math::AxisAlignedBoundingBox::MAX_X_MAX_Y_MAX_Z );
+		}
+		else
 		{
+			GetChunkBounds ( i / chunkRows, i % chunkRows, minCorner, maxCorner );
+		}
 
-			//Triangle 1
-			*(buffer++) = (row * zStep) + col;
-			*(buffer++) = ((row+1) * zStep) + col;
-			*(buffer++) = (row * zStep) + (col + xSkip);
+		//Distance to the closest point of the chunk, so the chunk under the camera is always level 0
+		Math::Vector3D closest ( Core::Min ( Core::Max ( cameraPosition.X(), minCorner.X() ), maxCorner.X() ),
+								 Core::Min ( Core::Max ( cameraPosition.Y(), minCorner.Y() ), maxCorner.Y() ),
+								 Core::Min ( Core::Max ( cameraPosition.Z(), minCorner.Z() ), maxCorner.Z() ) );
 
-			//Triangle 2
-			*(buffer++) = (row * zStep) + (col + xSkip);
-			*(buffer++) = ((row+1) * zStep) + col;
-			*(buffer++) = ((row+1) * zStep) + (col + xSkip);
+		Float band = (cameraPosition - closest).Length() / bandDistance;
+		UInt lod = static_cast<UInt>( Math::Floor ( band ) );
 
-			//Fill in the index data for the most detailed LOD level,
-			//if this is LOD 0
-			if ( lodLevel == 0 )
-			{
-				Triangle triangle;
+		if ( lod >= maxLOD )
+		{
+			m_chunkBandLODs[i] = maxLOD;
+			m_chunkMorphFactors[i] = 0.0f;
+		}
+		else
+		{
+			//Morph from 0 to 1 over the last part of the band
+			Float bandPosition = band - static_cast<Float>(lod);
 
-				triangle.v0 = (row * zStep) + col;
-				triangle.v1 = ((row+1) * zStep) + col;
-				triangle.v2 = (row * zStep) + (col + xSkip);
-				m_triangles.push_back(triangle);
+			m_chunkBandLODs[i] = lod;
+			m_chunkMorphFactors[i] = Core::Max ( (bandPosition - (1.0f - morphRegion)) / morphRegion, 0.0f );
+		}
 
-				triangle.v0 = (row * zStep) + (col + xSkip);
-				triangle.v1 = ((row+1) * zStep) + col;
-				triangle.v2 = ((row+1) * zStep) + (col + xSkip);
-				m_triangles.push_back(triangle);
-			}
+		m_chunkLODs[i] = m_chunkBandLODs[i];
+	}
 
-			col += xSkip;
-		}
+	//Lower the levels until neighbours are at most one level apart. Levels only ever go down,
+	//and each pass fixes at least one more level of the difference, so this terminates quickly
+	bool changed = true;
+
+	while ( changed )
+	{
+		changed = false;
 
-		++row;
+		for ( UInt row = 0; row < chunkRows; ++row )
+		{
+			for ( UInt col = 0; col < chunkRows; ++col )
+			{
+				UInt& lod = m_chunkLODs[(row * chunkRows) + col];
+				UInt limit = lod;
+
+				if ( row > 0 )				 limit = Core::Min ( limit, m_chunkLODs[((row-1) * chunkRows) + col] + 1 );
+				if ( (row + 1) < chunkRows ) limit = Core::Min ( limit, m_chunkLODs[((row+1) * chunkRows) + col] + 1 );
+				if ( col > 0 )				 limit = Core::Min ( limit, m_chunkLODs[(row * chunkRows) + (col-1)] + 1 );
+				if ( (col + 1) < chunkRows ) limit = Core::Min ( limit, m_chunkLODs[(row * chunkRows) + (col+1)] + 1 );
+
+				if ( limit < lod )
+				{
+					lod = limit;
+					changed = true;
+				}
+			}
+		}
 	}
 
+	//Set the stitch mask, and morph factor for each chunk
+	for ( UInt row = 0; row < chunkRows; ++row )
+	{
+		for ( UInt col = 0; col < chunkRows; ++col )
+		{
+			const UInt index = (row * chunkRows) + col;
+			const UInt lod = m_chunkLODs[index];
+
+			UInt stitchMask = 0;
+
+			if ( (row > 0)				 && (m_chunkLODs[index - chunkRows] > lod) )	stitchMask |= STITCH_NORTH;
+			if ( ((row + 1) < chunkRows) && (m_chunkLODs[index + chunkRows] > lod) )	stitchMask |= STITCH_SOUTH;
+			if ( (col > 0)				 && (m_chunkLODs[index - 1] > lod) )			stitchMask |= STITCH_WEST;
+			if ( ((col + 1) < chunkRows) && (m_chunkLODs[index + 1] > lod) )			stitchMask |= STITCH_EAST;
+
+			//A chunk forced finer than its distance calls for by a neighbour
+			//should look as much like the next level as it can
+			Float morphFactor = (lod < m_chunkBandLODs[index]) ? 1.0f : m_chunkMorphFactors[index];
+
+			if ( m_chunks[index] )
+			{
+				m_chunks[index]->SetLOD ( lod, stitchMask, morphFactor );
+			}
+		}
+	}
 }
-//End TerrainNode::FillIndexBufferLODLevel
+//End TerrainNode::UpdateChunkLODs
 
 
 
@@ -450,6 +970,10 @@ void TerrainNode::FillIndexBufferLODLevel ( UInt lodLevel,
 //! @function    TerrainNode::CheckCollisions
 //! @brief       Check collisions against an entity
 //!              
+//!				 Normally each chunk checks its own part of the heightfield. When the
+//!				 terrain is paged, the whole heightfield is checked here instead, so that
+//!				 there is still collision where chunks haven't been loaded
+//!
 //! @param       entity				[in]
 //! @param       collisionType		[in] 
 //! @param       collisionFlags		[in]
@@ -461,9 +985,60 @@ void TerrainNode::CheckCollisions ( EntityNode* entity,
 									const NodeCollisionFlags& collisionFlags,
 									CollisionManager& collisionManager )
 {
-	SceneNode::CheckCollisions( entity,
-								collisionType,
-								collisionFlags,
-								collisionManager );
+	if ( !m_paged )
+	{
+		SceneNode::CheckCollisions( entity,
+									collisionType,
+									collisionFlags,
+									collisionManager );
+		return;
+	}
+
+	Math::Vector3D minCorner = entity->BoundingBox().GetCorner ( Math::AxisAlignedBoundingBox::MIN_X_MIN_Y_MIN_Z );
+	Math::Vector3D maxCorner = entity->BoundingBox().GetCorner ( Math::AxisAlignedBoundingBox::MAX_X_MAX_Y_MAX_Z );
+
+	minCorner *= ConcatObjectFromWorld();
+	maxCorner *= ConcatObjectFromWorld();
+
+	Math::Vector3D normal;
+	Float		   depth = 0.0f;
+
+	if ( m_heightfield.Collide ( minCorner, maxCorner, m_heightfield.WholeRegion(), normal, depth ) )
+	{
+		collisionManager.AddCollision( CollisionRecord(entity, this, normal, depth) );
+	}
+}
+//End TerrainNode::CheckCollisions
+
+
+
+//=========================================================================
+//! @function    TerrainNode::QueryScene
+//! @brief       Find where a ray intersects the terrain
+//!              
+//!				 As with CheckCollisions, the chunks answer this unless the terrain
+//!				 is paged
+//!
+//! @param       ray	[in]  Ray to check intesection with
+//! @param       result [out] Parametric positions on the ray where it hits the terrain
+//!              
+//=========================================================================
+void TerrainNode::QueryScene ( const Math::ParametricLine3D& ray, SceneQueryResult& result )
+{
+	if ( !m_paged )
+	{
+		SceneObject::QueryScene ( ray, result );
+		return;
+	}
+
+	Math::ParametricLine3D localRay ( ray.P0() * ConcatObjectFromWorld(), 
+									  ray.P1() * ConcatObjectFromWorld() );
+
+	Float t = 0.0f;
+
+	if ( m_heightfield.IntersectRay ( localRay, m_heightfield.WholeRegion(), t ) )
+	{
+		result.push_back ( t );
+	}
 }
-//End TerrainNode::CheckCollisions
\ No newline at end of file
+//End TerrainNode::QueryScene
\ No newline at end of file
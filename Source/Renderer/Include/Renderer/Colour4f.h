@@ -74,6 +74,14 @@ namespace Renderer
 
 
 
+	//=========================================================================
+	// Free function prototypes
+	//=========================================================================
+	inline bool operator == ( const Colour4f& lhs, const Colour4f& rhs ) throw();
+	inline bool operator != ( const Colour4f& lhs, const Colour4f& rhs ) throw();
+
+
+
 	//=========================================================================
 	//! @function    Colour4f::Colour4f
 	//! @param       red 
@@ -147,6 +155,43 @@ namespace Renderer
 	}
 	//End Colour4f::operator UInt32
 
+
+
+    //=========================================================================
+    //! @function    operator == ( const Colour4f&, const Colour4f& )
+    //! @brief       Exact, component-wise comparison of two colours
+    //!              
+    //! @param       lhs [in]
+    //! @param       rhs [in]
+    //!              
+    //! @return      true if all four components are identical
+    //=========================================================================
+	bool operator == ( const Colour4f& lhs, const Colour4f& rhs ) throw()
+	{
+		return ( lhs.Red() == rhs.Red() ) 
+			&& ( lhs.Green() == rhs.Green() ) 
+			&& ( lhs.Blue() == rhs.Blue() ) 
+			&& ( lhs.Alpha() == rhs.Alpha() );
+	}
+	//End operator == ( const Colour4f&, const Colour4f& )
+
+
+
+    //=========================================================================
+    //! @function    operator != ( const Colour4f&, const Colour4f& )
+    //! @brief       Exact, component-wise comparison of two colours
+    //!              
+    //! @param       lhs [in]
+    //! @param       rhs [in]
+    //!              
+    //! @return      true if any component differs
+    //=========================================================================
+	bool operator != ( const Colour4f& lhs, const Colour4f& rhs ) throw()
+	{
+		return !( lhs == rhs );
+	}
+	//End operator != ( const Colour4f&, const Colour4f& )
+
 };
 //end namespace Renderer
 
@@ -0,0 +1,383 @@
+//======================================================================================
+//! @file         NullRenderer.h
+//! @brief        NullRenderer class
+//!               
+//!               IRenderer implementation that draws nothing, and records
+//!               the calls made to it, for profiling and testing without a GPU
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+#ifndef RENDERER_NULLRENDERER_H
+#define RENDERER_NULLRENDERER_H
+
+
+#include <vector>
+#include <algorithm>
+#include <string>
+#include "Math/Matrix4x4.h"
+#include "Renderer/Renderer.h"
+
+
+//=========================================================================
+// Forward declarations
+//=========================================================================
+namespace Renderer
+{
+	class ITextureCreator;
+	class TextureManager;
+	class IVertexBufferCreator;
+	class VertexBufferManager;
+	class IIndexBufferCreator;
+	class IndexBufferManager;
+	class VertexDeclarationManager;
+	class IVertexDeclarationCreator;
+}
+
+
+//namespace Renderer
+namespace Renderer
+{
+
+    //=========================================================================
+    // Type definitions
+    //=========================================================================
+
+	//! Calls recorded by the null renderer
+	enum ENullCommand
+	{
+		NULLCMD_BEGINFRAME,
+		NULLCMD_ENDFRAME,
+		NULLCMD_CLEAR,
+		NULLCMD_DRAW,
+		NULLCMD_DRAWINDEXED,
+		NULLCMD_BIND_TEXTURE,
+		NULLCMD_BIND_VERTEXBUFFER,
+		NULLCMD_BIND_INDEXBUFFER,
+		NULLCMD_BIND_DECLARATION,
+		NULLCMD_RENDERSTATE_BOOL,
+		NULLCMD_RENDERSTATE_UINT,
+		NULLCMD_RENDERSTATE_FLOAT,
+		NULLCMD_TEXTURESTAGESTATE,
+		NULLCMD_TEXTURESTAGECONSTANT,
+		NULLCMD_COLOUR,
+		NULLCMD_CLEARCOLOUR,
+		NULLCMD_MATERIALSOURCE,
+		NULLCMD_MATERIAL,
+		NULLCMD_TEXTUREADDRESS,
+		NULLCMD_TEXCOORDGEN,
+		NULLCMD_TEXTUREFILTER,
+		NULLCMD_TEXTUREBORDER,
+		NULLCMD_TEXTUREPARAM,
+		NULLCMD_BLENDOP,
+		NULLCMD_BLENDFUNC,
+		NULLCMD_DEPTHFUNC,
+		NULLCMD_ALPHAFUNC,
+		NULLCMD_STENCILFUNC,
+		NULLCMD_STENCILOP,
+		NULLCMD_STENCILFUNCCCW,
+		NULLCMD_STENCILOPCCW,
+		NULLCMD_FOGMODE,
+		NULLCMD_SHADEMODE,
+		NULLCMD_CULLMODE,
+		NULLCMD_FILLMODE,
+		NULLCMD_MATRIX,
+		NULLCMD_ENTER2D,
+		NULLCMD_EXIT2D,
+		NULLCMD_COUNT
+	};
+
+	//!@struct	NullCommand
+	//!@brief	A single call recorded by the null renderer
+	//!
+	//!			What the fields hold depends on the command. For draws, id is the primitive type,
+	//!			arg0 the start index and arg1 the vertex count. For binds, id is the stage or stream,
+	//!			and arg0 the handle. For states, id is the stage or state ID, and the arguments are
+	//!			the values, with floats and colours stored as their bit patterns
+	struct NullCommand
+	{
+		UShort type;	//!< ENullCommand
+		UShort id;		//!< Primitive type, stage, stream, or state ID
+		UInt   arg0;
+		UInt   arg1;
+	};
+
+	typedef std::vector<NullCommand> NullCommandLog;
+
+	//End Type definitions
+
+
+
+	//!@class	NullRenderer
+	//!@brief	IRenderer implementation that draws nothing
+	//!
+	//!			Buffers and textures are kept in system memory, so they can be locked and filled
+	//!			as normal. Every draw, bind, and state call is counted, and, while the console 
+	//!			variable ren_nullrecord is set, appended to a command log. The counts and log of the
+	//!			last completed frame can be read back, which makes it possible to profile the CPU
+	//!			side of the engine, or to test what it submits, on a machine without a GPU.
+	//!
+	//!			Selected by setting init_renderer to "Null"
+	class NullRenderer : public IRenderer
+	{
+		public:
+
+			//!@struct	FrameStatistics
+			//!@brief	Counts of the calls made to the renderer during a frame
+			struct FrameStatistics
+			{
+				FrameStatistics ( ) : primitiveCount(0), vertexCount(0)
+				{
+					std::fill ( commandCount, commandCount + NULLCMD_COUNT, 0 );
+				}
+
+				UInt commandCount[NULLCMD_COUNT];	//!< Number of calls of each ENullCommand type
+				UInt primitiveCount;				//!< Number of primitives drawn
+				UInt vertexCount;					//!< Number of vertices, or indices, drawn
+			};
+
+
+            //=========================================================================
+            // Constructors/Destructor
+            //=========================================================================
+			NullRenderer();
+
+
+            //=========================================================================
+            // Public methods
+            //=========================================================================
+
+			//Get a list of display modes
+			const DisplayModeList& GetDisplayModeList() const;
+
+			//Initialisation and shutdown
+			void Initialise() throw (RendererError);
+			void ShutDown() throw (RendererError);
+
+			//Resources
+			HTexture	  AcquireTexture ( ETextureType type, const Char* fileName, UInt quality, UInt usage, UInt flags );
+			HTexture	  CreateTexture  ( ETextureType type, UInt width, UInt height, Imaging::PixelFormat format, 
+										   UInt quality, UInt usage, UInt flags );
+			HVertexBuffer CreateVertexBuffer( size_t vertexSize, size_t vertexCount, EUsage usage );
+			HIndexBuffer  CreateIndexBuffer ( EIndexSize indexSize, size_t indexCount, EUsage usage );
+			HVertexDeclaration AcquireVertexDeclaration( VertexDeclarationDescriptor& descriptor );
+
+			//Rendering
+			void BeginFrame();
+			void EndFrame();
+			void Clear( UInt bufferFlags );
+
+			void DrawPrimitive( EPrimType type, size_t startIndex, size_t vertexCount );
+
+			void DrawIndexedPrimitive ( EPrimType type, size_t baseVertexIndex,
+										size_t startIndex, size_t vertexCount ); 
+
+			void DrawIndexedPrimitive ( EPrimType type, size_t baseVertexIndex,
+										size_t maxVertexIndex, size_t startIndex, size_t vertexCount );
+
+			//Binding render states
+			bool  Bind ( HTexture& texture, ETextureStageID stageID ) throw();
+			bool  Bind ( HVertexBuffer& buffer, UInt streamIndex ) throw();
+			bool  Bind ( HIndexBuffer& buffer ) throw();
+			bool  Bind ( HVertexDeclaration& decl ) throw();
+
+			//Render states
+			bool SetRenderState ( EBoolStateID stateID, bool value ) throw();
+			bool SetRenderState ( EUIntStateID stateID, UInt value ) throw();
+			bool SetRenderState ( EFloatStateID stateID, Float value ) throw();
+
+			bool SetTextureStageState ( ETextureStageID stageID, ETextureStageStateID stateID, UInt value ) throw();
+			bool SetTextureStageConstantColour ( ETextureStageID stageID, const Colour4f& value ) throw(); 
+			bool SetColour ( EColourStateID stateID, const Colour4f& value ) throw();
+			bool SetClearColour( const Colour4f& colour );
+
+			bool SetMaterialColourSource	( EMaterialSourceType sourceType, EMaterialSource source ) throw();
+			bool SetMaterial				( const Material& material ) throw();
+
+			bool SetTextureAddressingMode	( ETextureStageID stageID, ETextureAddressModeType type, ETextureAddressingMode mode ) throw();
+			bool SetTextureFilter			( ETextureStageID stageID, ETextureFilterType type, ETextureFilter filter ) throw();
+			bool SetTextureCoordGeneration  ( ETextureStageID stageID, UInt textureCoordinateSet, ETextureCoordGen mode ) throw();
+			bool SetTextureBorderColour		( ETextureStageID stageID, const Colour4f& colour ) throw();
+			bool SetTextureParameter		( ETextureStageID stageID, ETextureParamType type, UInt value ) throw();
+
+			//Blending/Depth test/Stencil test/Alpha test
+			bool SetBlendOp	  ( EBlendOp op );
+			bool SetBlendFunc ( EBlendMode src, EBlendMode dst );
+			bool SetDepthFunc ( ECmpFunc cmp );
+			bool SetAlphaFunc ( ECmpFunc cmp );
+			bool SetStencilFunc ( ECmpFunc cmp );
+			bool SetStencilOp   ( EStencilOpType type, EStencilOp op );
+			bool SetStencilFuncCCW ( ECmpFunc cmp );
+			bool SetStencilOpCCW   ( EStencilOpType type, EStencilOp op );
+
+			//Fog
+			bool SetFogMode ( EFogType type, EFogMode mode );
+
+			//Shading/culling
+			bool SetShadeMode ( EShadeMode mode );
+			bool SetCullingMode ( ECullMode mode );
+			bool SetFillMode ( EFillMode mode );
+
+			//Accessors for render states
+			const Colour4f& GetClearColour () const		{ return m_clearColour; }
+
+			//Tranformation matrices
+			void SetMatrix ( EMatrixType type, const Math::Matrix4x4& mat ) throw();
+
+			void SetProjectionOrtho		  ( Math::Scalar left, Math::Scalar right, Math::Scalar bottom, Math::Scalar top, 
+											Math::Scalar zNear, Math::Scalar zFar );
+			void SetProjectionPerspective ( Math::Scalar fovY, Math::Scalar aspectRatio, Math::Scalar zNear, Math::Scalar zFar  );
+			void SetViewLookAt			  ( const Math::Vector3D& eye, const Math::Vector3D& up, const Math::Vector3D& lookAt );
+
+			void GetMatrix ( EMatrixType type, Math::Matrix4x4& mat ) throw();
+			void GetMatrix ( EReadOnlyMatrixType type, Math::Matrix4x4& mat ) throw(); 
+
+			//2D mode
+			void Enter2DMode ();
+			void Exit2DMode ();
+
+			//Renderer capabilities
+			bool  Supports( ERendererCapability capability ) const throw();
+			UInt  GetDeviceProperty ( EIntegerRendererCapability capability ) const throw();
+			Float GetDeviceProperty ( EFloatRendererCapability capability ) const throw();
+
+			//Accessors
+			RendererWindow& Window();
+			const std::string& Name() const				{ return m_name;		 }
+			UInt ScreenWidth() const					{ return m_screenWidth;	 }
+			UInt ScreenHeight() const					{ return m_screenHeight; }
+
+			//The null renderer builds its matrices the same way the DirectX renderer does,
+			//so that the rest of the engine takes the same code paths under both
+			Math::EHandedness GetHandedness() const		{ return Math::LEFT_HANDED; }
+
+			//IRestorable
+			bool RequiresRestore() const				{ return false; }
+			void PrepareForRestore( bool forceRestore );
+			void Restore( bool forceRestore );
+
+			//IResizable
+			void Resize ( UInt width, UInt height );
+
+			//Recorded calls
+			const FrameStatistics& LastFrameStatistics ( ) const	{ return m_lastFrameStatistics; }
+			const NullCommandLog&  LastFrameLog ( ) const			{ return m_lastFrameLog;		}
+			UInt FrameNumber ( ) const								{ return m_frameNumber;			}
+
+			static const Char* CommandName ( UInt type );
+
+		private:
+
+            //=========================================================================
+            // Private methods
+            //=========================================================================
+			inline void Record ( ENullCommand type, UInt id, UInt arg0 = 0, UInt arg1 = 0 );
+			void RecordDraw ( ENullCommand type, EPrimType primType, size_t startIndex, size_t vertexCount );
+
+			void CreateRenderWindow ( );
+			void FillDisplayModeList ( );
+			void PrintFrameStatistics ( ) const;
+
+
+            //=========================================================================
+            // Private data members
+            //=========================================================================
+
+			//Render window
+			boost::shared_ptr<RendererWindow> m_window;
+			
+			//Tranformation matrices
+			Math::Matrix4x4 m_worldTransform;
+			Math::Matrix4x4 m_viewTransform;
+			Math::Matrix4x4 m_projectionTransform;
+			Math::Matrix4x4 m_textureTransform[TEXTURE_STAGE_COUNT];
+			Math::Matrix4x4 m_worldViewMatrix;
+			Math::Matrix4x4 m_viewProjMatrix;
+			bool			m_worldViewOutOfDate;
+			bool			m_viewProjOutOfDate;
+
+			Colour4f		m_clearColour;
+
+			//Resources
+			boost::shared_ptr<ITextureCreator>			 m_textureCreator;
+			boost::shared_ptr<TextureManager>			 m_textureManager;
+			boost::shared_ptr<IVertexBufferCreator>		 m_vertexBufferCreator;
+			boost::shared_ptr<IIndexBufferCreator>		 m_indexBufferCreator;
+			boost::shared_ptr<VertexBufferManager>		 m_vertexBufferManager;
+			boost::shared_ptr<IndexBufferManager>		 m_indexBufferManager;
+			boost::shared_ptr<IVertexDeclarationCreator> m_declarationCreator;
+			boost::shared_ptr<VertexDeclarationManager>	 m_vertexDeclarationManager;
+
+			//Currently set textures
+			HTexture	m_textures[TEXTURE_STAGE_COUNT];
+
+			//Recording
+			bool			m_recording;
+			UInt			m_frameNumber;
+			NullCommandLog	m_frameLog;
+			NullCommandLog	m_lastFrameLog;
+			FrameStatistics	m_frameStatistics;
+			FrameStatistics	m_lastFrameStatistics;
+
+			//Display
+			UInt			m_screenWidth;
+			UInt			m_screenHeight;
+			DisplayModeList m_displayModes;
+			std::string		m_name;
+
+	};
+	//End class NullRenderer
+
+
+
+    //=========================================================================
+    //! @function    NullRenderer::Record
+    //! @brief       Count a call, and append it to the log if recording is enabled
+    //!              
+    //! @param       type [in] Type of call
+    //! @param       id	  [in] Primitive type, stage, stream, or state ID
+    //! @param       arg0 [in] First argument
+    //! @param       arg1 [in] Second argument
+    //=========================================================================
+	void NullRenderer::Record ( ENullCommand type, UInt id, UInt arg0, UInt arg1 )
+	{
+		++m_frameStatistics.commandCount[type];
+
+		if ( m_recording )
+		{
+			NullCommand command;
+			command.type = static_cast<UShort>(type);
+			command.id = static_cast<UShort>(id);
+			command.arg0 = arg0;
+			command.arg1 = arg1;
+
+			m_frameLog.push_back ( command );
+		}
+	}
+	//End NullRenderer::Record
+
+
+};
+//end namespace Renderer
+
+
+#endif
+//#ifndef RENDERER_NULLRENDERER_H
@@ -0,0 +1,63 @@
+//======================================================================================
+//! @file         NullRendererCreator.h
+//! @brief        NullRendererCreator class
+//!               
+//!               RendererCreator that instantiates the NullRenderer class
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+#ifndef RENDERER_NULLRENDERERCREATOR_H
+#define RENDERER_NULLRENDERERCREATOR_H
+
+
+#include "Renderer/RendererFactory.h"
+#include "Renderer/RendererCreator.h"
+
+
+//namespace Renderer
+namespace Renderer
+{
+
+	//!@class	NullRendererCreator
+	//!@brief	RendererCreator that instantiates the NullRenderer class
+	class NullRendererCreator : public RendererCreator
+	{
+		public:
+
+			NullRendererCreator():
+			  RendererCreator( "Null" )
+			  {
+			  }
+
+			  boost::shared_ptr<IRenderer> Create() const;
+
+	};
+	//end class NullRendererCreator
+
+
+};
+//end namespace Renderer
+
+
+#endif
+//#ifndef RENDERER_NULLRENDERERCREATOR_H
@@ -0,0 +1,71 @@
+//======================================================================================
+//! @file         NullRendererWindow.h
+//! @brief        Hidden, message only window for the null renderer
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+#ifndef RENDERER_NULLRENDERERWINDOW_H
+#define RENDERER_NULLRENDERERWINDOW_H
+
+
+#include "Renderer/RendererWindow.h"
+
+
+//namespace Renderer
+namespace Renderer
+{
+
+
+	//!@class	NullRendererWindow
+	//!@brief	Window for the null renderer
+	//!
+	//!			The window is message only, so it's never shown, and never
+	//!			receives input. It's only there so the application still has a 
+	//!			message queue to pump, and a quit message to stop on.
+	class NullRendererWindow : public RendererWindow
+	{
+		public:
+
+			NullRendererWindow ( const Char* className, const Char* title, UInt width, UInt height );
+
+			void Initialise ( );
+
+			bool AcceptsInput ( ) const	{ return false; }
+
+		protected:
+
+			DWORD GetExStyle ( ) const;
+			DWORD GetStyle ( ) const;
+			HWND GetParentWindow ( ) const;
+	};
+	//End class NullRendererWindow
+
+
+};
+//end namespace Renderer
+
+
+#endif
+//#ifndef RENDERER_NULLRENDERERWINDOW_H
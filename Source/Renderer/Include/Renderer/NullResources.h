@@ -0,0 +1,236 @@
+//======================================================================================
+//! @file         NullResources.h
+//! @brief        System memory resources used by the NullRenderer
+//!               
+//!               Vertex buffers, index buffers, textures and vertex declarations
+//!               that live entirely in system memory
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+#ifndef RENDERER_NULLRESOURCES_H
+#define RENDERER_NULLRESOURCES_H
+
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "Renderer/VertexBuffer.h"
+#include "Renderer/IndexBuffer.h"
+#include "Renderer/Texture.h"
+#include "Renderer/VertexDeclaration.h"
+#include "Renderer/TextureCreator.h"
+#include "Renderer/VertexBufferCreator.h"
+#include "Renderer/IndexBufferCreator.h"
+#include "Renderer/VertexDeclarationCreator.h"
+
+
+//namespace Renderer
+namespace Renderer
+{
+
+
+	//!@class	NullVertexBuffer
+	//!@brief	Vertex buffer stored in system memory, for the null renderer
+	class NullVertexBuffer : public VertexBuffer
+	{
+		public:
+
+			NullVertexBuffer ( size_t vertexSize, size_t vertexCount, EUsage usage );
+
+			//Binding is recorded by the renderer, so there is nothing to do here
+			bool Bind( UInt streamNumber ) throw()	{ return true; }
+
+			//Resource implementations
+			void Unload() {}
+
+			//IRestorable implementation. System memory is never lost
+			bool RequiresRestore() const				{ return false; }
+			void PrepareForRestore( bool forceRestore )	{ }
+			void Restore( bool forceRestore )			{ }
+
+		private:
+
+			//Implementation of unlock and lock methods
+			void UnlockImplementation() { }
+			ScopedBufferLock<VertexBuffer> LockImplementation( size_t lockBegin, size_t lockSize, ELock lockOptions ) throw();
+
+			//Private data
+			std::vector<Byte> m_data;
+	};
+	//End NullVertexBuffer
+
+
+
+	//!@class	NullIndexBuffer
+	//!@brief	Index buffer stored in system memory, for the null renderer
+	class NullIndexBuffer : public IndexBuffer
+	{
+		public:
+
+			NullIndexBuffer ( EIndexSize indexSize, size_t indexCount, EUsage usage );
+
+			//Binding is recorded by the renderer, so there is nothing to do here
+			bool Bind( ) throw()	{ return true; }
+
+			//Resource implementations
+			void Unload() {}
+
+			//IRestorable implementation. System memory is never lost
+			bool RequiresRestore() const				{ return false; }
+			void PrepareForRestore( bool forceRestore )	{ }
+			void Restore( bool forceRestore )			{ }
+
+		private:
+
+			//Implementation of unlock and lock methods
+			void UnlockImplementation() { }
+			ScopedBufferLock<IndexBuffer> LockImplementation( size_t lockBegin, size_t lockSize, ELock lockOptions ) throw();
+
+			//Private data
+			std::vector<Byte> m_data;
+	};
+	//End NullIndexBuffer
+
+
+
+	//!@class	NullTexture
+	//!@brief	Texture stored in system memory, for the null renderer
+	//!
+	//!			Only the top level is stored. Textures that are loaded from file
+	//!			can't be decoded without an API specific loader, so they are given
+	//!			a single white texel, which is enough for code that locks or binds them
+	class NullTexture : public Texture
+	{
+		public:
+
+			NullTexture ( ETextureType type, const Char* name, UInt quality, UInt usage, UInt flags );
+			NullTexture ( ETextureType type, UInt width, UInt height, Imaging::PixelFormat format, 
+						  UInt quality, UInt usage, UInt flags );
+
+			//Binding is recorded by the renderer, so there is nothing to do here
+			bool Bind( ETextureStageID stageIndex ) throw()	{ return true; }
+
+			//Set from image
+			bool SetFromImage ( const Imaging::Image& image ) throw();
+
+			//IRestorable implementation. System memory is never lost
+			bool RequiresRestore () const throw()				{ return false; }
+			void PrepareForRestore( bool forceRestore ) throw()	{ }
+			void Restore( bool forceRestore ) throw()			{ }
+
+			//Resource method implementations
+			void Unload() { }
+
+		protected:
+
+			//Protected methods
+			ScopedTextureLock LockImplementation ( UInt level, ELock lockOptions );
+			void UnlockImplementation ( ) { }
+
+		private:
+
+			//Private methods
+			void Allocate ( );
+			UInt Pitch ( ) const;
+
+			//Private data
+			std::vector<Byte> m_data;
+	};
+	//End NullTexture
+
+
+
+	//!@class	NullVertexDeclaration
+	//!@brief	Vertex declaration for the null renderer. Only the descriptor is kept
+	class NullVertexDeclaration : public VertexDeclaration
+	{
+		public:
+
+			NullVertexDeclaration ( const VertexDeclarationDescriptor& desc )
+				: VertexDeclaration(desc)
+			{
+			}
+
+			//Binding is recorded by the renderer, so there is nothing to do here
+			bool Bind()	{ return true; }
+	};
+	//End NullVertexDeclaration
+
+
+
+	//!@class	NullTextureCreator
+	//!@brief	Implementation of ITextureCreator that creates NullTexture objects
+	class NullTextureCreator : public ITextureCreator
+	{
+		public:
+
+			boost::shared_ptr<Texture> CreateTextureFromFile( ETextureType type, const Char* fileName, 
+															  UInt quality, UInt usage, UInt flags );
+
+			boost::shared_ptr<Texture> CreateTexture ( ETextureType type, UInt width, UInt height, 
+													   Imaging::PixelFormat format, UInt quality, 
+													   UInt usage, UInt flags );
+	};
+	//End NullTextureCreator
+
+
+
+	//!@class	NullVertexBufferCreator
+	//!@brief	Implementation of IVertexBufferCreator that creates NullVertexBuffer objects
+	class NullVertexBufferCreator : public IVertexBufferCreator
+	{
+		public:
+
+			boost::shared_ptr<VertexBuffer> CreateVertexBuffer( size_t vertexSize, size_t vertexCount, EUsage usage );
+	};
+	//End NullVertexBufferCreator
+
+
+
+	//!@class	NullIndexBufferCreator
+	//!@brief	Implementation of IIndexBufferCreator that creates NullIndexBuffer objects
+	class NullIndexBufferCreator : public IIndexBufferCreator
+	{
+		public:
+
+			boost::shared_ptr<IndexBuffer> CreateIndexBuffer( EIndexSize indexSize, size_t indexCount, EUsage usage );
+	};
+	//End NullIndexBufferCreator
+
+
+
+	//!@class	NullVertexDeclarationCreator
+	//!@brief	Implementation of IVertexDeclarationCreator that creates NullVertexDeclaration objects
+	class NullVertexDeclarationCreator : public IVertexDeclarationCreator
+	{
+		public:
+
+			boost::shared_ptr<VertexDeclaration> CreateVertexDeclaration ( const VertexDeclarationDescriptor& descriptor );
+	};
+	//End NullVertexDeclarationCreator
+
+
+};
+//end namespace Renderer
+
+
+#endif
+//#ifndef RENDERER_NULLRESOURCES_H
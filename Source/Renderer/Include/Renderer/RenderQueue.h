@@ -30,8 +30,8 @@
 #ifndef RENDERER_RENDERQUEUE_H
 #define RENDERER_RENDERQUEUE_H
 
-#include <list>
-#include <boost/pool/pool_alloc.hpp>
+#include <vector>
+#include "Math/Vector3D.h"
 #include "Renderer/RenderQueueEntry.h"
 #include "Renderer/Effect.h"
 #include "Renderer/IndexBuffer.h"
@@ -53,6 +53,11 @@ namespace Renderer
 	//!@class	RenderQueue
 	//!@brief	Class that queues up IRenderable objects for rendering
 	//!			Renderable objects are ordered in such a way to minimise state changes
+	//!
+	//!			Entries are stored contiguously in the order they were queued.
+	//!			Each one is given a 64 bit sort key (see RenderQueueEntry::GenerateSortKey)
+	//!			and the keys are radix sorted, so that Render can walk the sorted
+	//!			key list linearly without ever moving the entries themselves
 	class RenderQueue
 	{
 		public:
@@ -67,7 +72,7 @@ namespace Renderer
             //=========================================================================
             // Public types
             //=========================================================================
-			typedef std::list<RenderQueueEntry, boost::fast_pool_allocator<RenderQueueEntry> >	RenderQueueStore; 
+			typedef std::vector<RenderQueueEntry>	RenderQueueStore; 
 
             //=========================================================================
             // Public methods
@@ -76,6 +81,10 @@ namespace Renderer
 			//Must be called at the start of the frame to clear out the queue
 			inline void Clear();
 
+			//Set the position that entries are depth sorted relative to.
+			//If it isn't set for a frame, it's taken from the renderer's view matrix
+			inline void SetViewerPosition ( const Math::Vector3D& position );
+
 			//Add an object to the queue
 			inline void QueueForRendering ( IRenderable& renderable, HEffect& effect, UInt techniqueIndex, UInt passIndex,
 				                            HVertexDeclaration& decl, VertexStreamBinding& binding, HIndexBuffer& indexBuffer,
@@ -87,6 +96,9 @@ namespace Renderer
 			//Render all items in the queue
 			void Render();
 
+			//Number of items in the queue
+			UInt Size() const		{ return static_cast<UInt>(m_queue.size());	}
+
 
 		private:
 
@@ -94,15 +106,37 @@ namespace Renderer
 			//=========================================================================
             // Private types
             //=========================================================================
-			typedef RenderQueueStore::iterator iterator;
+			
+			//!@struct	SortKey
+			//!@brief	Sort key, and the index of the entry it was generated from
+			struct SortKey
+			{
+				UInt64	key;
+				UInt	index;
+			};
+
+			typedef std::vector<SortKey>			SortKeyStore;
+			typedef SortKeyStore::iterator			key_iterator;
+
+
+            //=========================================================================
+            // Private methods
+            //=========================================================================
+			UInt QuantiseDepth ( const Math::Matrix4x4& worldMatrix ) const;
+			void ViewerPositionFromView ( );
+			void RadixSort ( );
 
 
             //=========================================================================
             // Private data
             //=========================================================================
 			RenderQueueStore		m_queue;
+			SortKeyStore			m_keys;
+			SortKeyStore			m_scratchKeys;	//!< Ping-pong buffer for the radix sort
 			StateManager&			m_stateManager;
 			IRenderer&				m_renderer;
+			Math::Vector3D			m_viewerPosition;
+			bool					m_viewerPositionSet;	//!< Whether m_viewerPosition is valid for this frame
 
 	};		
 	//End class RenderQueue
@@ -116,12 +150,37 @@ namespace Renderer
 	//=========================================================================
 	void RenderQueue::Clear()
 	{
+		//clear() keeps the capacity, so the queue stops allocating
+		//once it has grown to the size of a typical frame
 		m_queue.clear();
+		m_keys.clear();
+
+		//The viewer has probably moved since the last frame
+		m_viewerPositionSet = false;
 	}
 	//End RenderQueue::Clear
 
 
 
+	//=========================================================================
+	//! @function    RenderQueue::SetViewerPosition
+	//! @brief       Set the position that queued entries are depth sorted relative to
+	//!
+	//!				 Should be called before any objects are queued for the frame.
+	//!				 Applications that don't call it get the position of the
+	//!				 renderer's view matrix when the first object is queued
+	//!              
+	//! @param		 position [in] World space position of the viewer
+	//=========================================================================
+	void RenderQueue::SetViewerPosition ( const Math::Vector3D& position )
+	{
+		m_viewerPosition = position;
+		m_viewerPositionSet = true;
+	}
+	//End RenderQueue::SetViewerPosition
+
+
+
 	//=========================================================================
 	//! @function    RenderQueue::QueueForRendering
 	//! @brief       Queue an object to be rendered
@@ -142,8 +201,19 @@ namespace Renderer
 										  UInt passIndex,  HVertexDeclaration& decl, VertexStreamBinding& binding,
 										  HIndexBuffer& indexBuffer, const Math::Matrix4x4& worldMatrix )
 	{
+		if ( !m_viewerPositionSet )
+		{
+			ViewerPositionFromView();
+		}
+
 		m_queue.push_back ( RenderQueueEntry(renderable, effect, techniqueIndex, passIndex,
 			                decl, binding, indexBuffer, worldMatrix ));
+
+		SortKey sortKey;
+		sortKey.key = m_queue.back().GenerateSortKey( QuantiseDepth(worldMatrix) );
+		sortKey.index = static_cast<UInt>(m_queue.size() - 1);
+
+		m_keys.push_back ( sortKey );
 	}
 	//End RenderQueue::QueueForRendering
 
@@ -169,7 +239,7 @@ namespace Renderer
 
 		#endif
 
-		m_queue.sort();
+		RadixSort();
 
 	}
 	//End RenderQueue::SortQueue
@@ -31,6 +31,7 @@
 #define RENDERER_RENDERQUEUE_ENTRY_H
 
 
+#include "Math/Matrix4x4.h"
 #include "Renderer/Renderable.h"
 #include "Renderer/Effect.h"
 #include "Renderer/RenderState.h"
@@ -48,7 +49,6 @@
 //=========================================================================
 // Forward declaration
 //=========================================================================
-namespace Math		{	class Matrix4x4;	}
 namespace Renderer	{	class VertexData;	}
 
 
@@ -76,46 +76,46 @@ namespace Renderer
             //=========================================================================
             // Public methods
             //=========================================================================
-			inline HVertexDeclaration	GetVertexDeclaration  () throw(); 
-			inline HVertexBuffer		GetStream( UInt index ) throw();
-			inline HIndexBuffer			GetIndexBuffer () throw();
+			inline Core::BorrowedHandle<VertexDeclaration>	GetVertexDeclaration  () const throw(); 
+			inline HVertexBuffer							GetStream( UInt index ) throw();
+			inline Core::BorrowedHandle<IndexBuffer>		GetIndexBuffer () const throw();
 
-			inline VertexStreamBinding& GetStreamBinding() throw() { return m_binding;	}
+			inline VertexStreamBinding& GetStreamBinding() throw() { return *m_binding;	}
 
-			inline IRenderable&	 GetRenderable () throw()	{ return m_renderable;		}
+			inline IRenderable&	 GetRenderable () throw()	{ return *m_renderable;		}
 
-			HEffect& GetEffect ( ) throw()					{ return m_effect;			}
+			Core::BorrowedHandle<Effect> GetEffect ( ) const throw()	{ return m_effect;	}
 			UInt     TechniqueIndex ( ) const throw()		{ return m_techniqueIndex;	}
 			UInt     PassIndex ( ) const throw()			{ return m_passIndex;		}
 			
 			const Math::Matrix4x4& GetWorldMatrix() const throw()	{ return m_worldMatrix;	}
 			
-			
+			UInt64	 GenerateSortKey ( UInt depth ) const;
 
 
-            //=========================================================================
-            // Operator overloads
-            //=========================================================================
-			
-			//Operator <, used for sorting
-			bool operator < ( const RenderQueueEntry& rhs ) const;
-
 		private:
 
 
             //=========================================================================
             // Private data
             //=========================================================================
-			IRenderable&	m_renderable;
-			HEffect			m_effect;
-			UInt			m_techniqueIndex;
-			UInt			m_passIndex;
-
-			HVertexDeclaration			  m_vertexDeclaration;
-			VertexStreamBinding&		  m_binding;
-			HIndexBuffer				  m_indexBuffer;
-
-			const Math::Matrix4x4&		  m_worldMatrix;
+			//Pointers rather than references, so that entries can be stored by value
+			//in the contiguous draw list owned by the render queue.
+			//The handles are borrowed from the renderable, which keeps the resources
+			//alive until the queue is cleared, so queueing an entry doesn't touch any
+			//reference counts.
+			//The world matrix is copied, so that the entry doesn't depend on the renderable's
+			//transform staying put while the queue is drawn
+			IRenderable*					m_renderable;
+			Core::BorrowedHandle<Effect>	m_effect;
+			UInt							m_techniqueIndex;
+			UInt							m_passIndex;
+
+			Core::BorrowedHandle<VertexDeclaration>	m_vertexDeclaration;
+			VertexStreamBinding*					m_binding;
+			Core::BorrowedHandle<IndexBuffer>		m_indexBuffer;
+
+			Math::Matrix4x4						m_worldMatrix;
 			
 	};
 	//End class RenderQueueEntry
@@ -128,7 +128,7 @@ namespace Renderer
     //!              
     //! @return      A handle to the vertex declaration
     //=========================================================================
-	HVertexDeclaration RenderQueueEntry::GetVertexDeclaration ( )
+	Core::BorrowedHandle<VertexDeclaration> RenderQueueEntry::GetVertexDeclaration ( ) const
 	{
 		return m_vertexDeclaration;
 	}
@@ -142,7 +142,7 @@ namespace Renderer
     //!              
     //! @return      A handle to the index buffer
     //=========================================================================
-	HIndexBuffer RenderQueueEntry::GetIndexBuffer () 
+	Core::BorrowedHandle<IndexBuffer> RenderQueueEntry::GetIndexBuffer () const
 	{
 		return m_indexBuffer;
 	}
@@ -157,7 +157,7 @@ namespace Renderer
     //=========================================================================
 	HVertexBuffer RenderQueueEntry::GetStream ( UInt index )
 	{
-		return m_binding.GetStream(index);
+		return m_binding->GetStream(index);
 	}
 	//End RenderQueueEntry::GetStream
 
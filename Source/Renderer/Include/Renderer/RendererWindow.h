@@ -83,6 +83,9 @@ namespace Renderer
 
 			inline HWND WindowHandle ( ) const { return m_hWnd; }
 
+			//! Whether keyboard and mouse input can be read through the window
+			virtual bool AcceptsInput ( ) const	{ return true; }
+
 			void SetTitle ( const Char* title );
 			void SetFullScreenStyle ( bool fullScreen );
 
@@ -103,6 +106,7 @@ namespace Renderer
 			void UnRegisterWindowClass ( );
 			virtual DWORD GetExStyle ( ) const;
 			virtual DWORD GetStyle ( ) const;
+			virtual HWND GetParentWindow ( ) const;
 			void Create ( );
 			void Destroy ( );
 		
@@ -54,14 +54,48 @@ namespace Renderer
 
 
 
+	//=========================================================================
+	// Sizes of the shadow state tables
+	//=========================================================================
+	const UInt g_boolStateCount			 = STATE_INDEXED_VERTEX_BLEND + 1;
+	const UInt g_floatStateCount		 = STATE_POINTSCALE_C + 1;
+	const UInt g_uintStateCount			 = STATE_STENCILWRITEMASK + 1;
+	const UInt g_colourStateCount		 = STATE_BLENDFACTORCOLOUR + 1;
+	const UInt g_materialSourceCount	 = STATE_EMISSIVE_MATERIAL_SOURCE + 1;
+	const UInt g_stencilOpCount			 = STENCILOP_PASS + 1;
+	const UInt g_fogTypeCount			 = FOGTYPE_VERTEX + 1;
+	const UInt g_textureStageStateCount  = TEXSTAGE_RESULTARG + 1;
+	const UInt g_textureFilterTypeCount  = TEXFILTER_MIP + 1;
+	const UInt g_textureParamCount		 = TEXPARAM_MAX_ANISOTROPY + 1;
+	const UInt g_textureAddressTypeCount = TEX_ADDRESS_W + 1;
+
+
+
 	//!@class	StateManager
 	//!@brief	Class to manage the changing of render states in an efficient manner
 	//!
 	//!			Sends only changed render states to the renderer
+	//!
+	//!			A shadow copy of every state sent to the renderer is kept, and
+	//!			each state in an incoming RenderState is compared against it, so only the 
+	//!			fields that actually differ result in renderer calls.
+	//!			The shadow copy must be invalidated with InvalidateShadowState whenever
+	//!			the device state is changed behind the state manager's back, for 
+	//!			example after the renderer has been restored
 	class StateManager
 	{
 		public:
 
+			//!@struct	Statistics
+			//!@brief	Counts of renderer state calls made, and avoided, by the state manager
+			struct Statistics
+			{
+				Statistics ( ) : callsIssued(0), callsAvoided(0) { }
+
+				UInt callsIssued;	//!< Number of state calls passed on to the renderer
+				UInt callsAvoided;	//!< Number of state calls filtered out because the state was already set
+			};
+
             //=========================================================================
             // Constructors
             //=========================================================================
@@ -71,15 +105,25 @@ namespace Renderer
             //=========================================================================
             // Public methods
             //=========================================================================
-			void ActivateRenderState ( HEffect& effect, UInt techniqueIndex, UInt passIndex  );
+			void ActivateRenderState ( const Core::BorrowedHandle<Effect>& effect, UInt techniqueIndex, UInt passIndex  );
 
 			void ActivateRenderState ( const RenderState& state );
 
-			void ActivateVertexDeclaration ( HVertexDeclaration& data );
+			void ActivateVertexDeclaration ( const Core::BorrowedHandle<VertexDeclaration>& data );
 
 			void ActivateVertexStreamBinding ( VertexStreamBinding& binding );
 
-			void ActivateIndexBuffer ( HIndexBuffer& buffer );
+			void ActivateIndexBuffer ( const Core::BorrowedHandle<IndexBuffer>& buffer );
+
+			void InvalidateShadowState ( );
+
+			void ResetFrameStatistics ( );
+
+
+            //=========================================================================
+            // Public accessors
+            //=========================================================================
+			const Statistics& LastFrameStatistics ( ) const		{ return m_lastFrameStatistics; }
 
 
 		private:
@@ -90,6 +134,82 @@ namespace Renderer
 			void SyncRendererState   ( const RenderState& state );
 			void SyncRendererTextureUnit ( const TextureUnit& textureUnit, UInt index );
 
+			template <class T>
+			inline bool ShadowMatches ( T& shadow, const T& value, bool shadowValid );
+
+			//Filtered versions of the renderer's state functions
+			void SetMaterial			  ( const Material& material );
+			void SetMaterialColourSource  ( EMaterialSourceType sourceType, EMaterialSource source );
+			void SetRenderState			  ( EBoolStateID stateID, bool value );
+			void SetRenderState			  ( EUIntStateID stateID, UInt value );
+			void SetRenderState			  ( EFloatStateID stateID, Float value );
+			void SetColour				  ( EColourStateID stateID, const Colour4f& value );
+			void SetBlendOp				  ( EBlendOp op );
+			void SetBlendFunc			  ( EBlendMode src, EBlendMode dst );
+			void SetDepthFunc			  ( ECmpFunc cmp );
+			void SetAlphaFunc			  ( ECmpFunc cmp );
+			void SetStencilFunc			  ( ECmpFunc cmp );
+			void SetStencilOp			  ( EStencilOpType type, EStencilOp op );
+			void SetFogMode				  ( EFogType type, EFogMode mode );
+			void SetShadeMode			  ( EShadeMode mode );
+			void SetCullingMode			  ( ECullMode mode );
+
+			void BindTexture			  ( ETextureStageID stageID, HTexture texture );
+			void BindAutogenTexture		  ( ETextureStageID stageID, UInt textureID );
+			void SetTextureMatrix		  ( ETextureStageID stageID, const Math::Matrix4x4& matrix );
+			void SetTextureStageState	  ( ETextureStageID stageID, ETextureStageStateID stateID, UInt value );
+			void SetTextureFilter		  ( ETextureStageID stageID, ETextureFilterType type, ETextureFilter filter );
+			void SetTextureParameter	  ( ETextureStageID stageID, ETextureParamType type, UInt value );
+			void SetTextureStageConstantColour ( ETextureStageID stageID, const Colour4f& colour );
+			void SetTextureAddressingMode ( ETextureStageID stageID, ETextureAddressModeType type, ETextureAddressingMode mode );
+			void SetTextureCoordinates	  ( ETextureStageID stageID, UInt coordinateSet, ETextureCoordGen mode );
+
+
+            //=========================================================================
+            // Private types
+            //=========================================================================
+
+			//!@struct	ShadowState
+			//!@brief	Last values of the renderer wide states sent to the renderer
+			struct ShadowState
+			{
+				Material		material;
+				EMaterialSource	materialSources[g_materialSourceCount];
+				bool			boolStates[g_boolStateCount];
+				UInt			uintStates[g_uintStateCount];
+				Float			floatStates[g_floatStateCount];
+				Colour4f		colourStates[g_colourStateCount];
+				EBlendOp		blendOp;
+				EBlendMode		sourceBlend;
+				EBlendMode		destBlend;
+				ECmpFunc		depthFunc;
+				ECmpFunc		alphaFunc;
+				ECmpFunc		stencilFunc;
+				EStencilOp		stencilOps[g_stencilOpCount];
+				EFogMode		fogModes[g_fogTypeCount];
+				EShadeMode		shadeMode;
+				ECullMode		cullMode;
+			};
+
+			//!@struct	ShadowTextureStage
+			//!@brief	Last values of the texture stage states sent to the renderer, for one texture stage
+			struct ShadowTextureStage
+			{
+				ShadowTextureStage ( ) : valid(false), autogenID(0) { }
+
+				bool					valid;		//!< False if the values below can't be trusted
+				HTexture				texture;	
+				UInt					autogenID;	//!< Autogen texture bound to the stage, or 0 for a normal texture
+				Math::Matrix4x4			matrix;
+				UInt					stageStates[g_textureStageStateCount];
+				ETextureFilter			filters[g_textureFilterTypeCount];
+				UInt					parameters[g_textureParamCount];
+				Colour4f				constantColour;
+				ETextureAddressingMode	addressingModes[g_textureAddressTypeCount];
+				UInt					coordinateSet;
+				ETextureCoordGen		coordinateGenMode;
+			};
+
 
             //=========================================================================
             // Private data
@@ -107,6 +227,13 @@ namespace Renderer
 			UInt				m_techniqueIndex;
 			UInt				m_passIndex;
 
+			ShadowState			m_shadow;
+			bool				m_shadowValid;
+			ShadowTextureStage	m_shadowStages[TEXTURE_STAGE_COUNT];
+
+			Statistics			m_frameStatistics;
+			Statistics			m_lastFrameStatistics;
+
 	};
 	//End class StateManager
 
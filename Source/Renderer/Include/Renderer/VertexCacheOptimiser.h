@@ -0,0 +1,106 @@
+//======================================================================================
+//! @file         VertexCacheOptimiser.h
+//! @brief        Reorders triangle lists for the post transform vertex cache
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+#ifndef RENDERER_VERTEXCACHEOPTIMISER_H
+#define RENDERER_VERTEXCACHEOPTIMISER_H
+
+
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include "Core/BasicTypes.h"
+
+
+//namespace Renderer
+namespace Renderer
+{
+
+	//!@class	VertexCacheOptimiser
+	//!@brief	Reorders the triangles of an indexed triangle list, so that vertices 
+	//!			are reused while they're still in the post transform vertex cache
+	//!
+	//!			Uses Tom Forsyth's linear speed algorithm. A small LRU cache is simulated,
+	//!			and the triangle added next is always the one with the highest score, 
+	//!			where vertices score highly if they're in the cache, or have few
+	//!			triangles left to draw. The result doesn't depend on the real cache size,
+	//!			so it suits any hardware.
+	//!
+	//!			The scratch arrays are kept between calls, so one optimiser can be
+	//!			reused for many index ranges without allocating.
+	class VertexCacheOptimiser : public boost::noncopyable
+	{
+		public:
+
+            //=========================================================================
+            // Constructors
+            //=========================================================================
+			VertexCacheOptimiser ( );
+
+            //=========================================================================
+            // Public methods
+            //=========================================================================
+			void OptimiseTriangleOrder ( UInt16* indices, UInt indexCount, UInt vertexCount );
+
+			static void  ReorderVertices ( UInt16* indices, UInt indexCount, UInt vertexCount, 
+										   std::vector<UInt>& newVertexIndices );
+
+			static Float ACMR ( const UInt16* indices, UInt indexCount, UInt cacheSize = 16 );
+
+		private:
+
+            //=========================================================================
+            // Private methods
+            //=========================================================================
+			Float VertexScore ( UInt vertex ) const;
+
+            //=========================================================================
+            // Private data
+            //=========================================================================
+
+			//Per vertex
+			std::vector<Int>	m_cachePosition;		//!< Position in the simulated cache, or -1
+			std::vector<UInt>	m_activeTriangleCount;	//!< Triangles not yet added that use the vertex
+			std::vector<UInt>	m_triangleStart;		//!< Start of the vertex's triangles in m_triangles
+			std::vector<Float>	m_vertexScore;
+
+			//Per triangle
+			std::vector<UInt>	m_triangles;			//!< Triangles using each vertex, active ones first
+			std::vector<Float>	m_triangleScore;
+			std::vector<bool>	m_triangleAdded;
+
+			//Output, and the simulated cache. The next cache has room for the three 
+			//vertices being added, which push other vertices out of the cache
+			std::vector<UInt16> m_output;
+			std::vector<UInt>	m_cache;
+			std::vector<UInt>	m_nextCache;
+	};
+	//End class VertexCacheOptimiser
+
+};
+//end namespace Renderer
+
+
+#endif //RENDERER_VERTEXCACHEOPTIMISER_H
@@ -31,6 +31,7 @@
 
 
 
+#include "Core/Atomic.h"
 #include "Core/Handle.h"
 #include "Renderer/VertexElement.h"
 #include "Renderer/VertexDeclarationDescriptor.h"
@@ -65,7 +66,7 @@ namespace Renderer
 			// TODO: Revisit the ResourceManager, and make it more generic, to remove the need
 			// for this
 			UInt ID ( )							{ return m_desc.Checksum(); }	
-			UInt ReferenceCount ( ) const		{ return m_referenceCount;	}
+			UInt ReferenceCount ( ) const		{ return static_cast<UInt>(m_referenceCount);	}
 			std::string Name ( ) const			{ return "VertexDeclaration"; }
 
 		protected:
@@ -73,15 +74,15 @@ namespace Renderer
             //=========================================================================
             // Private methods
             //=========================================================================
-			inline UInt IncrementReferenceCount ( )		{ return ++m_referenceCount;	}
-			inline UInt DecrementReferenceCount ( )		{ return --m_referenceCount;	}
+			inline UInt IncrementReferenceCount ( )		{ return static_cast<UInt>(Core::AtomicIncrement(m_referenceCount));	}
+			inline UInt DecrementReferenceCount ( )		{ return static_cast<UInt>(Core::AtomicDecrement(m_referenceCount));	}
 		
 
             //=========================================================================
             // Private data
             //=========================================================================
 			VertexDeclarationDescriptor m_desc;
-			UInt						m_referenceCount;
+			Core::AtomicLong			m_referenceCount;
 
 	};
 	//end class VertexDeclaration
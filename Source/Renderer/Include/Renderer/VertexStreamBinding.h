@@ -55,6 +55,7 @@ namespace Renderer
 			//Set one of the streams
 			inline void SetStream ( HVertexBuffer& buffer, UInt streamIndex ) throw();
 			inline HVertexBuffer GetStream ( UInt streamIndex ) const throw();
+			inline Core::BorrowedHandle<VertexBuffer> BorrowStream ( UInt streamIndex ) const throw();
 
 			void Bind ( IRenderer& renderer );
 
@@ -105,6 +106,25 @@ namespace Renderer
 	//End VertexStreamBinding::GetStream
 
 
+    //=========================================================================
+    //! @function    VertexStreamBinding::BorrowStream
+    //! @brief       Get the stream bound to a stream index, without taking a reference to it
+	//!				 streamIndex must be less than g_maxStreams @see RendererConstants.h
+    //!              
+    //! @param       streamIndex [in] Stream index
+    //!              
+    //! @return      A borrowed handle to the vertex buffer, valid for as long as
+	//!				 the buffer stays bound to this stream
+    //=========================================================================
+	Core::BorrowedHandle<VertexBuffer> VertexStreamBinding::BorrowStream ( UInt streamIndex ) const
+	{
+		debug_assert ( streamIndex < Renderer::g_maxStreams, "Stream index out of bounds!" );
+
+		return m_bindings[streamIndex];
+	}
+	//End VertexStreamBinding::BorrowStream
+
+
 };
 //end namespace Renderer
 
@@ -0,0 +1,1038 @@
+//======================================================================================
+//! @file         NullRenderer.cpp
+//! @brief        NullRenderer class
+//!               
+//!               IRenderer implementation that draws nothing, and records
+//!               the calls made to it
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+
+#include "Core/Core.h"
+#include "Math/Vector3D.h"
+#include "Math/Matrix4x4.h"
+#include "Renderer/NullRenderer.h"
+#include "Renderer/NullResources.h"
+#include "Renderer/NullRendererWindow.h"
+#include "Renderer/TextureManager.h"
+#include "Renderer/VertexBufferManager.h"
+#include "Renderer/IndexBufferManager.h"
+#include "Renderer/VertexDeclarationManager.h"
+
+
+using namespace Renderer;
+
+
+
+//=========================================================================
+// Static functions
+//=========================================================================
+namespace
+{
+	//=========================================================================
+	//! @function    FloatBits
+	//! @brief       Get the bit pattern of a float, so it can be stored in a command
+	//=========================================================================
+	UInt FloatBits ( Float value )
+	{
+		union { Float f; UInt u; } bits;
+		bits.f = value;
+		return bits.u;
+	}
+	//End FloatBits
+
+
+	//=========================================================================
+	//! @function    PrimitiveCount
+	//! @brief       Work out the number of primitives a draw call renders
+	//!
+	//! @param       type		 [in] Primitive type
+	//! @param       vertexCount [in] Number of vertices, or indices, drawn
+	//=========================================================================
+	UInt PrimitiveCount ( EPrimType type, size_t vertexCount )
+	{
+		switch ( type )
+		{
+			case PRIM_POINTLIST:
+				return vertexCount;
+
+			case PRIM_LINELIST:
+				return vertexCount / 2;
+
+			case PRIM_LINESTRIP:
+				return (vertexCount > 1) ? (vertexCount - 1) : 0;
+
+			case PRIM_TRIANGLELIST:
+				return vertexCount / 3;
+
+			case PRIM_TRIANGLESTRIP:
+			case PRIM_TRIANGLEFAN:
+				return (vertexCount > 2) ? (vertexCount - 2) : 0;
+
+			default:
+				debug_assert ( false, "Invalid primitive type!" );
+				return 0;
+		}
+	}
+	//End PrimitiveCount
+
+
+	//! Names of the ENullCommand values, in order
+	const Char* g_nullCommandNames[NULLCMD_COUNT] =
+	{
+		"BeginFrame", "EndFrame", "Clear", "Draw", "DrawIndexed",
+		"BindTexture", "BindVertexBuffer", "BindIndexBuffer", "BindDeclaration",
+		"RenderStateBool", "RenderStateUInt", "RenderStateFloat",
+		"TextureStageState", "TextureStageConstant", "Colour", "ClearColour",
+		"MaterialSource", "Material",
+		"TextureAddress", "TexCoordGen", "TextureFilter", "TextureBorder", "TextureParam",
+		"BlendOp", "BlendFunc", "DepthFunc", "AlphaFunc",
+		"StencilFunc", "StencilOp", "StencilFuncCCW", "StencilOpCCW",
+		"FogMode", "ShadeMode", "CullMode", "FillMode",
+		"Matrix", "Enter2D", "Exit2D"
+	};
+}
+
+
+
+//=========================================================================
+//! @function    NullRenderer::NullRenderer
+//! @brief       NullRenderer Constructor
+//!              
+//!              Creates the resource managers, and the list of display modes
+//=========================================================================
+NullRenderer::NullRenderer()
+: IRenderer(), m_name("Null"), m_worldViewOutOfDate(true), m_viewProjOutOfDate(true),
+  m_clearColour(0.0f, 0.0f, 0.0f, 1.0f), m_recording(true), m_frameNumber(0),
+  m_screenWidth(0), m_screenHeight(0)
+{
+	m_textureCreator = boost::shared_ptr<ITextureCreator>( new NullTextureCreator() );
+	m_textureManager = boost::shared_ptr<TextureManager>( new TextureManager(*m_textureCreator) );
+
+	m_vertexBufferCreator = boost::shared_ptr<IVertexBufferCreator>( new NullVertexBufferCreator() );
+	m_vertexBufferManager = boost::shared_ptr<VertexBufferManager>( new VertexBufferManager(*m_vertexBufferCreator) );
+
+	m_indexBufferCreator = boost::shared_ptr<IIndexBufferCreator>( new NullIndexBufferCreator() );
+	m_indexBufferManager = boost::shared_ptr<IndexBufferManager>( new IndexBufferManager(*m_indexBufferCreator) );
+
+	m_declarationCreator = boost::shared_ptr<IVertexDeclarationCreator>( new NullVertexDeclarationCreator() );
+	m_vertexDeclarationManager = boost::shared_ptr<VertexDeclarationManager>
+												( new VertexDeclarationManager(*m_declarationCreator) );
+
+	FillDisplayModeList();
+
+	std::clog << "Null Renderer object created" << std::endl;
+}
+//End NullRenderer::NullRenderer
+
+
+
+//=========================================================================
+//! @function    NullRenderer::GetDisplayModeList
+//! @brief       Return the list of display modes the renderer supports
+//=========================================================================
+const DisplayModeList& NullRenderer::GetDisplayModeList() const
+{
+	return m_displayModes;
+}
+//End NullRenderer::GetDisplayModeList
+
+
+
+//=========================================================================
+//! @function    NullRenderer::Initialise
+//! @brief       Fully initialise the renderer
+//!
+//!				 Creates the hidden window that the application pumps messages through.
+//!				 init_fullscreen is ignored, since nothing is ever displayed
+//=========================================================================
+void NullRenderer::Initialise()
+{
+	Core::ConsoleUInt init_bpp("init_bpp", 32 );
+	Core::ConsoleUInt init_mode( "init_mode", 0 );
+
+	const DisplayMode& mode(GetDisplayModeList().GetMode(init_mode, init_bpp));
+
+	m_screenWidth = mode.Width();
+	m_screenHeight = mode.Height();
+
+	std::clog << "Initialising null renderer with display mode: " << init_mode 
+			  << "\n   " << mode.Description() << std::endl;
+
+	CreateRenderWindow();
+}
+//End NullRenderer::Initialise
+
+
+
+//=========================================================================
+//! @function    NullRenderer::ShutDown
+//! @brief       Shuts down the renderer
+//=========================================================================
+void NullRenderer::ShutDown()
+{
+
+}
+//End NullRenderer::ShutDown
+
+
+
+//=========================================================================
+//! @function    NullRenderer::AcquireTexture
+//! @brief       Get a handle to a texture. The file isn't read, see NullTexture
+//=========================================================================
+HTexture NullRenderer::AcquireTexture ( ETextureType type, const Char* fileName, 
+										UInt quality, UInt usage, UInt flags )
+{
+	return m_textureManager->AcquireTexture ( type, fileName, quality, usage, flags );
+}
+//End NullRenderer::AcquireTexture
+
+
+
+//=========================================================================
+//! @function    NullRenderer::CreateTexture
+//! @brief       Create an empty texture in system memory
+//=========================================================================
+HTexture NullRenderer::CreateTexture ( ETextureType type, UInt width, UInt height, 
+									   Imaging::PixelFormat format, UInt quality, UInt usage, UInt flags )
+{
+	return m_textureManager->CreateTexture ( type, width, height, format, quality, usage, flags );
+}
+//End NullRenderer::CreateTexture
+
+
+
+//=========================================================================
+//! @function    NullRenderer::CreateVertexBuffer
+//! @brief       Create a vertex buffer in system memory
+//=========================================================================
+HVertexBuffer NullRenderer::CreateVertexBuffer ( size_t vertexSize, size_t vertexCount, EUsage usage )
+{
+	return m_vertexBufferManager->CreateVertexBuffer ( vertexSize, vertexCount, usage );
+}
+//End NullRenderer::CreateVertexBuffer
+
+
+
+//=========================================================================
+//! @function    NullRenderer::CreateIndexBuffer
+//! @brief       Create an index buffer in system memory
+//=========================================================================
+HIndexBuffer NullRenderer::CreateIndexBuffer ( EIndexSize indexSize, size_t indexCount, EUsage usage )
+{
+	return m_indexBufferManager->CreateIndexBuffer ( indexSize, indexCount, usage );
+}
+//End NullRenderer::CreateIndexBuffer
+
+
+
+//=========================================================================
+//! @function    NullRenderer::AcquireVertexDeclaration
+//! @brief       Get a handle to a vertex declaration matching the descriptor
+//=========================================================================
+HVertexDeclaration NullRenderer::AcquireVertexDeclaration( VertexDeclarationDescriptor& descriptor )
+{
+	return m_vertexDeclarationManager->AcquireVertexDeclaration ( descriptor );
+}
+//End NullRenderer::AcquireVertexDeclaration
+
+
+
+//=========================================================================
+//! @function    NullRenderer::BeginFrame
+//! @brief       Start recording a new frame
+//!              
+//!				 The counts and log of the frame just finished become the
+//!				 last frame's, and ren_nullrecord is sampled for the new frame
+//=========================================================================
+void NullRenderer::BeginFrame()
+{
+	static Core::ConsoleBool ren_nullrecord ( "ren_nullrecord", true );
+
+	m_lastFrameStatistics = m_frameStatistics;
+	m_frameStatistics = FrameStatistics();
+
+	//Swap rather than copy, so that both logs keep their capacity
+	m_lastFrameLog.swap ( m_frameLog );
+	m_frameLog.clear();
+
+	m_recording = ren_nullrecord;
+	++m_frameNumber;
+
+	Record ( NULLCMD_BEGINFRAME, 0, m_frameNumber );
+}
+//End NullRenderer::BeginFrame
+
+
+
+//=========================================================================
+//! @function    NullRenderer::EndFrame
+//! @brief       Ends the current frame
+//!
+//!				 If dbg_nullstats is set, the counts for the frame are printed
+//=========================================================================
+void NullRenderer::EndFrame()
+{
+	static Core::ConsoleBool dbg_nullstats ( "dbg_nullstats", false );
+
+	Record ( NULLCMD_ENDFRAME, 0, m_frameNumber );
+
+	if ( dbg_nullstats )
+	{
+		PrintFrameStatistics();
+	}
+}
+//End NullRenderer::EndFrame
+
+
+
+//=========================================================================
+//! @function    NullRenderer::Clear
+//! @brief       Record a clear of the buffers specified by bufferFlags
+//=========================================================================
+void NullRenderer::Clear ( UInt bufferFlags )
+{
+	Record ( NULLCMD_CLEAR, 0, bufferFlags, m_clearColour );
+}
+//End NullRenderer::Clear
+
+
+
+//=========================================================================
+//! @function    NullRenderer::DrawPrimitive
+//! @brief       Record a draw of non-indexed primitives
+//!              
+//! @param       type		 [in] Primitive type
+//! @param       startIndex  [in] First vertex to be rendered
+//! @param       vertexCount [in] Number of vertices to be rendered
+//=========================================================================
+void NullRenderer::DrawPrimitive( EPrimType type, size_t startIndex, size_t vertexCount )
+{
+	RecordDraw ( NULLCMD_DRAW, type, startIndex, vertexCount );
+}
+//End NullRenderer::DrawPrimitive
+
+
+
+//=========================================================================
+//! @function    NullRenderer::DrawIndexedPrimitive
+//! @brief       Record a draw of indexed primitives
+//!              
+//! @param       type			 [in] Primitive type
+//! @param       baseVertexIndex [in] Offset added to each index
+//! @param       startIndex		 [in] First index to be rendered
+//! @param       vertexCount	 [in] Number of indices to be rendered
+//=========================================================================
+void NullRenderer::DrawIndexedPrimitive ( EPrimType type, size_t baseVertexIndex, 
+										  size_t startIndex, size_t vertexCount )
+{
+	RecordDraw ( NULLCMD_DRAWINDEXED, type, startIndex, vertexCount );
+}
+//End NullRenderer::DrawIndexedPrimitive
+
+
+
+//=========================================================================
+//! @function    NullRenderer::DrawIndexedPrimitive
+//! @brief       Record a draw of indexed primitives
+//!              
+//! @param       type			 [in] Primitive type
+//! @param       baseVertexIndex [in] Offset added to each index
+//! @param       maxVertexIndex  [in] Highest vertex index used
+//! @param       startIndex		 [in] First index to be rendered
+//! @param       vertexCount	 [in] Number of indices to be rendered
+//=========================================================================
+void NullRenderer::DrawIndexedPrimitive ( EPrimType type, size_t baseVertexIndex, size_t maxVertexIndex,
+										  size_t startIndex, size_t vertexCount )
+{
+	RecordDraw ( NULLCMD_DRAWINDEXED, type, startIndex, vertexCount );
+}
+//End NullRenderer::DrawIndexedPrimitive
+
+
+
+//=========================================================================
+//! @function    NullRenderer::Bind (HTexture, ETextureStageID)
+//! @brief       Record the binding of a texture to a texture stage
+//=========================================================================
+bool NullRenderer::Bind ( HTexture& texture, ETextureStageID stageID )
+{
+	Record ( NULLCMD_BIND_TEXTURE, stageID, texture );
+
+	if ( texture.IsNull() )
+	{
+		m_textures[stageID] = Core::NullHandle();
+		return false;
+	}
+
+	m_textures[stageID] = texture;
+	return texture->Bind(stageID);
+}
+//End NullRenderer::Bind (HTexture, ETextureStageID)
+
+
+
+//=========================================================================
+//! @function    NullRenderer::Bind (HVertexBuffer, UInt)
+//! @brief       Record the binding of a vertex buffer to a stream
+//=========================================================================
+bool NullRenderer::Bind ( HVertexBuffer& buffer, UInt streamIndex )
+{
+	Record ( NULLCMD_BIND_VERTEXBUFFER, streamIndex, buffer );
+
+	if ( buffer.IsNull() )
+	{
+		return true;
+	}
+
+	return buffer->Bind(streamIndex);
+}
+//End NullRenderer::Bind (HVertexBuffer, UInt)
+
+
+
+//=========================================================================
+//! @function    NullRenderer::Bind (HIndexBuffer)
+//! @brief       Record the binding of an index buffer
+//=========================================================================
+bool NullRenderer::Bind ( HIndexBuffer& buffer )
+{
+	Record ( NULLCMD_BIND_INDEXBUFFER, 0, buffer );
+
+	if ( buffer.IsNull() )
+	{
+		return true;
+	}
+
+	return buffer->Bind();
+}
+//End NullRenderer::Bind (HIndexBuffer)
+
+
+
+//=========================================================================
+//! @function    NullRenderer::Bind (HVertexDeclaration)
+//! @brief       Record the binding of a vertex declaration
+//=========================================================================
+bool NullRenderer::Bind ( HVertexDeclaration& decl )
+{
+	Record ( NULLCMD_BIND_DECLARATION, 0, decl );
+	return decl->Bind();
+}
+//End NullRenderer::Bind (HVertexDeclaration)
+
+
+
+//=========================================================================
+// Render state calls. Each one is recorded, and always succeeds
+//=========================================================================
+bool NullRenderer::SetRenderState ( EBoolStateID stateID, bool value )
+{
+	Record ( NULLCMD_RENDERSTATE_BOOL, stateID, value );
+	return true;
+}
+
+bool NullRenderer::SetRenderState ( EUIntStateID stateID, UInt value )
+{
+	Record ( NULLCMD_RENDERSTATE_UINT, stateID, value );
+	return true;
+}
+
+bool NullRenderer::SetRenderState ( EFloatStateID stateID, Float value )
+{
+	Record ( NULLCMD_RENDERSTATE_FLOAT, stateID, FloatBits(value) );
+	return true;
+}
+
+bool NullRenderer::SetTextureStageState ( ETextureStageID stageID, ETextureStageStateID stateID, UInt value )
+{
+	Record ( NULLCMD_TEXTURESTAGESTATE, stageID, stateID, value );
+	return true;
+}
+
+bool NullRenderer::SetTextureStageConstantColour ( ETextureStageID stageID, const Colour4f& value )
+{
+	Record ( NULLCMD_TEXTURESTAGECONSTANT, stageID, value );
+	return true;
+}
+
+bool NullRenderer::SetColour ( EColourStateID stateID, const Colour4f& value )
+{
+	Record ( NULLCMD_COLOUR, stateID, value );
+	return true;
+}
+
+bool NullRenderer::SetClearColour ( const Colour4f& colour )
+{
+	m_clearColour = colour;
+	Record ( NULLCMD_CLEARCOLOUR, 0, colour );
+	return true;
+}
+
+bool NullRenderer::SetMaterialColourSource ( EMaterialSourceType sourceType, EMaterialSource source )
+{
+	Record ( NULLCMD_MATERIALSOURCE, sourceType, source );
+	return true;
+}
+
+bool NullRenderer::SetMaterial ( const Material& material )
+{
+	Record ( NULLCMD_MATERIAL, 0, material.GetDiffuse(), material.GetAmbient() );
+	return true;
+}
+
+bool NullRenderer::SetTextureAddressingMode ( ETextureStageID stageID, ETextureAddressModeType type, ETextureAddressingMode mode )
+{
+	Record ( NULLCMD_TEXTUREADDRESS, stageID, type, mode );
+	return true;
+}
+
+bool NullRenderer::SetTextureFilter ( ETextureStageID stageID, ETextureFilterType type, ETextureFilter filter )
+{
+	Record ( NULLCMD_TEXTUREFILTER, stageID, type, filter );
+	return true;
+}
+
+bool NullRenderer::SetTextureCoordGeneration ( ETextureStageID stageID, UInt textureCoordinateSet, ETextureCoordGen mode )
+{
+	Record ( NULLCMD_TEXCOORDGEN, stageID, textureCoordinateSet, mode );
+	return true;
+}
+
+bool NullRenderer::SetTextureBorderColour ( ETextureStageID stageID, const Colour4f& colour )
+{
+	Record ( NULLCMD_TEXTUREBORDER, stageID, colour );
+	return true;
+}
+
+bool NullRenderer::SetTextureParameter ( ETextureStageID stageID, ETextureParamType type, UInt value )
+{
+	Record ( NULLCMD_TEXTUREPARAM, stageID, type, value );
+	return true;
+}
+
+bool NullRenderer::SetBlendOp ( EBlendOp op )
+{
+	Record ( NULLCMD_BLENDOP, 0, op );
+	return true;
+}
+
+bool NullRenderer::SetBlendFunc ( EBlendMode src, EBlendMode dst )
+{
+	Record ( NULLCMD_BLENDFUNC, 0, src, dst );
+	return true;
+}
+
+bool NullRenderer::SetDepthFunc ( ECmpFunc cmp )
+{
+	Record ( NULLCMD_DEPTHFUNC, 0, cmp );
+	return true;
+}
+
+bool NullRenderer::SetAlphaFunc ( ECmpFunc cmp )
+{
+	Record ( NULLCMD_ALPHAFUNC, 0, cmp );
+	return true;
+}
+
+bool NullRenderer::SetStencilFunc ( ECmpFunc cmp )
+{
+	Record ( NULLCMD_STENCILFUNC, 0, cmp );
+	return true;
+}
+
+bool NullRenderer::SetStencilOp ( EStencilOpType type, EStencilOp op )
+{
+	Record ( NULLCMD_STENCILOP, 0, type, op );
+	return true;
+}
+
+bool NullRenderer::SetStencilFuncCCW ( ECmpFunc cmp )
+{
+	Record ( NULLCMD_STENCILFUNCCCW, 0, cmp );
+	return true;
+}
+
+bool NullRenderer::SetStencilOpCCW ( EStencilOpType type, EStencilOp op )
+{
+	Record ( NULLCMD_STENCILOPCCW, 0, type, op );
+	return true;
+}
+
+bool NullRenderer::SetFogMode ( EFogType type, EFogMode mode )
+{
+	Record ( NULLCMD_FOGMODE, 0, type, mode );
+	return true;
+}
+
+bool NullRenderer::SetShadeMode ( EShadeMode mode )
+{
+	Record ( NULLCMD_SHADEMODE, 0, mode );
+	return true;
+}
+
+bool NullRenderer::SetCullingMode ( ECullMode mode )
+{
+	Record ( NULLCMD_CULLMODE, 0, mode );
+	return true;
+}
+
+bool NullRenderer::SetFillMode ( EFillMode mode )
+{
+	Record ( NULLCMD_FILLMODE, 0, mode );
+	return true;
+}
+//End render state calls
+
+
+
+//=========================================================================
+//! @function    NullRenderer::SetMatrix
+//! @brief       Set one of the renderer's matrices
+//!              
+//! @param       type [in] Identifier of matrix to set
+//! @param       mat  [in] Matrix to set the renderer's internal matrix to
+//=========================================================================
+void NullRenderer::SetMatrix ( EMatrixType type, const Math::Matrix4x4& mat )
+{
+	Record ( NULLCMD_MATRIX, type );
+
+	switch ( type )
+	{
+		case MAT_WORLD:
+			m_worldTransform = mat;
+			m_worldViewOutOfDate = true;
+			break;
+
+		case MAT_VIEW:
+			m_viewTransform = mat;
+			m_worldViewOutOfDate = true;
+			m_viewProjOutOfDate = true;
+			break;
+
+		case MAT_PROJECTION:
+			m_projectionTransform = mat;
+			m_viewProjOutOfDate = true;
+			break;
+
+		default:
+			m_textureTransform[type - MAT_TEXTURE0] = mat;
+			break;
+	}
+}
+//End NullRenderer::SetMatrix
+
+
+
+//=========================================================================
+//! @function    NullRenderer::SetProjectionOrtho
+//! @brief       Set the projection matrix to an orthographic projection
+//=========================================================================
+void NullRenderer::SetProjectionOrtho ( Math::Scalar left, Math::Scalar right, Math::Scalar bottom, Math::Scalar top, 
+										Math::Scalar zNear, Math::Scalar zFar )
+{
+	Record ( NULLCMD_MATRIX, MAT_PROJECTION );
+
+	Math::Matrix4x4::CreateOrthographicProjectionLH ( m_projectionTransform, left, right, 
+													  bottom, top, zNear, zFar );
+	m_viewProjOutOfDate = true;
+}
+//End NullRenderer::SetProjectionOrtho
+
+
+
+//=========================================================================
+//! @function    NullRenderer::SetProjectionPerspective
+//! @brief       Set the projection matrix to a perspective projection
+//=========================================================================
+void NullRenderer::SetProjectionPerspective ( Math::Scalar fovY, Math::Scalar aspectRatio, Math::Scalar zNear, Math::Scalar zFar  )
+{
+	Record ( NULLCMD_MATRIX, MAT_PROJECTION );
+
+	Math::Matrix4x4::CreatePerspectiveProjectionLH ( m_projectionTransform, fovY, aspectRatio, zNear, zFar );
+	m_viewProjOutOfDate = true;
+}
+//End NullRenderer::SetProjectionPerspective
+
+
+
+//=========================================================================
+//! @function    NullRenderer::SetViewLookAt
+//! @brief       Set the view matrix to a UVN camera matrix
+//=========================================================================
+void NullRenderer::SetViewLookAt ( const Math::Vector3D& eye, const Math::Vector3D& up, const Math::Vector3D& lookAt )
+{
+	Record ( NULLCMD_MATRIX, MAT_VIEW );
+
+	Math::Matrix4x4::CreateUVNCameraMatrixLH ( m_viewTransform, eye, up, lookAt );
+	m_worldViewOutOfDate = true;
+	m_viewProjOutOfDate = true;
+}
+//End NullRenderer::SetViewLookAt
+
+
+
+//=========================================================================
+//! @function    NullRenderer::GetMatrix
+//! @brief       Get the value of one of the non-read-only matrices
+//=========================================================================
+void NullRenderer::GetMatrix ( EMatrixType type, Math::Matrix4x4& mat )
+{
+	switch ( type )
+	{
+		case MAT_WORLD:
+			mat = m_worldTransform;
+			break;
+
+		case MAT_VIEW:
+			mat = m_viewTransform;
+			break;
+
+		case MAT_PROJECTION:
+			mat = m_projectionTransform;
+			break;
+
+		default:
+			mat = m_textureTransform[type - MAT_TEXTURE0];
+			break;
+	}
+}
+//End NullRenderer::GetMatrix
+
+
+
+//=========================================================================
+//! @function    NullRenderer::GetMatrix
+//! @brief       Get the value of one of the read-only matrices,
+//!				 regenerating it if it is out of date
+//=========================================================================
+void NullRenderer::GetMatrix ( EReadOnlyMatrixType type, Math::Matrix4x4& mat )
+{
+	switch ( type )
+	{
+		case MAT_WORLDVIEW:
+
+			if ( m_worldViewOutOfDate )
+			{
+				m_worldViewMatrix = m_worldTransform;
+				m_worldViewMatrix *= m_viewTransform;
+				m_worldViewOutOfDate = false;
+			}
+
+			mat = m_worldViewMatrix;
+			break;
+
+		case MAT_VIEWPROJECTION:
+
+			if ( m_viewProjOutOfDate )
+			{
+				m_viewProjMatrix = m_viewTransform;
+				m_viewProjMatrix *= m_projectionTransform;
+				m_viewProjOutOfDate = false;
+			}
+
+			mat = m_viewProjMatrix;
+			break;
+	}
+}
+//End NullRenderer::GetMatrix
+
+
+
+//=========================================================================
+//! @function    NullRenderer::Enter2DMode
+//! @brief       Record the switch to 2D rendering
+//!
+//!				 As with the DirectX renderer, the stored matrices aren't altered
+//=========================================================================
+void NullRenderer::Enter2DMode()
+{
+	Record ( NULLCMD_ENTER2D, 0 );
+}
+//End NullRenderer::Enter2DMode
+
+
+
+//=========================================================================
+//! @function    NullRenderer::Exit2DMode
+//! @brief       Record the return from 2D rendering
+//=========================================================================
+void NullRenderer::Exit2DMode()
+{
+	Record ( NULLCMD_EXIT2D, 0 );
+}
+//End NullRenderer::Exit2DMode
+
+
+
+//=========================================================================
+//! @function    NullRenderer::Supports
+//! @brief       Indicates whether or not the renderer supports a feature
+//!              
+//!				 Everything in the fixed function pipeline is reported as supported,
+//!				 so that the engine takes its most complete code paths. Shaders aren't
+//!
+//! @param       capability [in] Feature to check for
+//=========================================================================
+bool NullRenderer::Supports( ERendererCapability capability ) const
+{
+	return ( capability < CAP_SHADER_DIRECTX_VERTEXSHADER_ASM );
+}
+//End NullRenderer::Supports
+
+
+
+//=========================================================================
+//! @function    NullRenderer::GetDeviceProperty
+//! @brief       Return an integer property of the device
+//!              
+//!				 The values are those of a typical DirectX 9 class card
+//!
+//! @param       capability [in] Property to return
+//=========================================================================
+UInt NullRenderer::GetDeviceProperty ( EIntegerRendererCapability capability ) const
+{
+	switch ( capability )
+	{
+		case CAP_TEXTURE_MAX_WIDTH:
+		case CAP_TEXTURE_MAX_HEIGHT:
+		case CAP_TEXTURE_MAX_ASPECTRATIO:
+			return 4096;
+
+		case CAP_TEXTURE_MAX_VOLUMEEXTENT:
+			return 256;
+
+		case CAP_TEXTURE_MAX_TEXTUREREPEAT:
+			return 8192;
+
+		case CAP_TEXTURE_MAX_ANISOTROPY:
+			return 16;
+
+		case CAP_TEXTURE_MAX_BLENDSTAGES:
+		case CAP_TEXTURE_MAX_SIMULTANEOUS:
+			return TEXTURE_STAGE_COUNT;
+
+		case CAP_LIGHT_MAX_ACTIVE:
+			return 8;
+
+		case CAP_MAX_CLIPPLANES:
+			return 6;
+
+		case CAP_MAX_VERTEXBLENDMATRICES:
+			return 4;
+
+		case CAP_MAX_PRIMITIVECOUNT:
+			return 0xFFFFF;
+
+		case CAP_MAX_VERTEXINDEX:
+			return 0xFFFFFF;
+
+		case CAP_MAX_STREAMS:
+			return 16;
+
+		case CAP_MAX_STREAMSTRIDE:
+			return 255;
+
+		case CAP_MAX_SIMULTANEOUS_RENDERTARGETS:
+			return 1;
+
+		default:
+			return 0;
+	}
+}
+//End NullRenderer::GetDeviceProperty
+
+
+
+//=========================================================================
+//! @function    NullRenderer::GetDeviceProperty
+//! @brief       Return a floating point property of the device
+//!              
+//! @param       capability [in] Property to retrieve
+//=========================================================================
+Float NullRenderer::GetDeviceProperty ( EFloatRendererCapability capability ) const
+{
+	switch ( capability )
+	{
+		case CAP_GUARDBAND_LEFT:
+		case CAP_GUARDBAND_TOP:
+			return -8192.0f;
+
+		case CAP_GUARDBAND_RIGHT:
+		case CAP_GUARDBAND_BOTTOM:
+			return 8192.0f;
+
+		case CAP_MAX_POINTSIZE:
+			return 64.0f;
+
+		default:
+			return 0.0f;
+	}
+}
+//End NullRenderer::GetDeviceProperty
+
+
+
+//=========================================================================
+//! @function    NullRenderer::Window
+//! @brief       Get a reference to the renderer's window
+//=========================================================================
+RendererWindow& NullRenderer::Window()
+{
+	debug_assert ( m_window, "Error, attempted to access renderer window, when it hasn't been created!" );
+	return *m_window;
+}
+//End NullRenderer::Window
+
+
+
+//=========================================================================
+//! @function    NullRenderer::PrepareForRestore
+//! @brief       Passes the request on to the resource managers
+//=========================================================================
+void NullRenderer::PrepareForRestore ( bool forceRestore )
+{
+	m_indexBufferManager->PrepareForRestore( forceRestore );
+	m_vertexBufferManager->PrepareForRestore( forceRestore );
+	m_textureManager->PrepareForRestore( forceRestore );
+}
+//End NullRenderer::PrepareForRestore
+
+
+
+//=========================================================================
+//! @function    NullRenderer::Restore
+//! @brief       Passes the request on to the resource managers
+//!
+//!				 Nothing is ever lost, so this only does anything when forced
+//=========================================================================
+void NullRenderer::Restore ( bool forceRestore )
+{
+	m_indexBufferManager->Restore( forceRestore );
+	m_vertexBufferManager->Restore( forceRestore );
+	m_textureManager->Restore( forceRestore );
+}
+//End NullRenderer::Restore
+
+
+
+//=========================================================================
+//! @function    NullRenderer::Resize
+//! @brief       Responds to a window resize
+//=========================================================================
+void NullRenderer::Resize ( UInt width, UInt height )
+{
+	m_screenWidth = width;
+	m_screenHeight = height;
+}
+//End NullRenderer::Resize
+
+
+
+//=========================================================================
+//! @function    NullRenderer::CommandName
+//! @brief       Get the name of an ENullCommand, for printing
+//=========================================================================
+const Char* NullRenderer::CommandName ( UInt type )
+{
+	if ( type >= NULLCMD_COUNT )
+	{
+		return "Unknown";
+	}
+
+	return g_nullCommandNames[type];
+}
+//End NullRenderer::CommandName
+
+
+
+//=========================================================================
+//! @function    NullRenderer::RecordDraw
+//! @brief       Record a draw call, and add its primitives to the frame counts
+//=========================================================================
+void NullRenderer::RecordDraw ( ENullCommand type, EPrimType primType, size_t startIndex, size_t vertexCount )
+{
+	Record ( type, primType, static_cast<UInt>(startIndex), static_cast<UInt>(vertexCount) );
+
+	m_frameStatistics.primitiveCount += PrimitiveCount ( primType, vertexCount );
+	m_frameStatistics.vertexCount += static_cast<UInt>(vertexCount);
+}
+//End NullRenderer::RecordDraw
+
+
+
+//=========================================================================
+//! @function    NullRenderer::CreateRenderWindow
+//! @brief       Create the message only window that stands in for the display
+//=========================================================================
+void NullRenderer::CreateRenderWindow ( )
+{
+	m_window = boost::shared_ptr<RendererWindow>
+					( new NullRendererWindow("NullRenderer", "NullRenderer", m_screenWidth, m_screenHeight) ); 
+
+	m_window->Initialise();
+}
+//End NullRenderer::CreateRenderWindow
+
+
+
+//=========================================================================
+//! @function    NullRenderer::FillDisplayModeList
+//! @brief       Fill the display mode list with a fixed set of modes
+//=========================================================================
+void NullRenderer::FillDisplayModeList ( )
+{
+	const UInt modes[][2] = { {800, 600}, {1024, 768}, {1280, 1024}, {1600, 1200} };
+	const UInt modeCount = sizeof(modes) / sizeof(modes[0]);
+
+	for ( UInt i = 0; i < modeCount; ++i )
+	{
+		m_displayModes.AddMode ( 32, DisplayMode(i, modes[i][0], modes[i][1], 32, 60, true, true) );
+		m_displayModes.AddMode ( 16, DisplayMode(i, modes[i][0], modes[i][1], 16, 60, true, true) );
+	}
+}
+//End NullRenderer::FillDisplayModeList
+
+
+
+//=========================================================================
+//! @function    NullRenderer::PrintFrameStatistics
+//! @brief       Print the counts for the current frame to the log
+//=========================================================================
+void NullRenderer::PrintFrameStatistics ( ) const
+{
+	std::clog << "Null renderer frame " << m_frameNumber << ": " 
+			  << m_frameStatistics.primitiveCount << " primitives, "
+			  << m_frameStatistics.vertexCount << " vertices\n";
+
+	for ( UInt i = 0; i < NULLCMD_COUNT; ++i )
+	{
+		if ( m_frameStatistics.commandCount[i] != 0 )
+		{
+			std::clog << "   " << CommandName(i) << ": " << m_frameStatistics.commandCount[i] << "\n";
+		}
+	}
+
+	std::clog << std::flush;
+}
+//End NullRenderer::PrintFrameStatistics
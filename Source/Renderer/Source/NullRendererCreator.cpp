@@ -0,0 +1,51 @@
+//======================================================================================
+//! @file         NullRendererCreator.cpp
+//! @brief        NullRendererCreator class
+//!               
+//!               RendererCreator that instantiates the NullRenderer class
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+#include "Core/Core.h"
+#include "Renderer/NullRendererCreator.h"
+#include "Renderer/NullRenderer.h"
+
+
+//namespace Renderer
+namespace Renderer
+{
+
+    //=========================================================================
+    //! @function    NullRendererCreator::Create
+    //! @brief       Create a new NullRenderer object
+    //!              
+    //! @return      A new NullRenderer
+    //=========================================================================
+	boost::shared_ptr<IRenderer> NullRendererCreator::Create() const
+	{
+		return boost::shared_ptr<IRenderer>(new NullRenderer());
+	}
+	//End NullRendererCreator::Create
+
+}
+//end namespace Renderer
@@ -0,0 +1,101 @@
+//======================================================================================
+//! @file         NullRendererWindow.cpp
+//! @brief        Hidden, message only window for the null renderer
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+
+#include "Core/Core.h"
+#include "Renderer/NullRendererWindow.h"
+
+
+
+using namespace Renderer;
+
+
+
+//=========================================================================
+//! @function    NullRendererWindow::NullRendererWindow
+//! @brief       NullRendererWindow constructor
+//!              
+//! @param       className	[in] Name of the window class to register
+//! @param       title		[in] Title of the window
+//! @param       width		[in] Width the application believes the window has
+//! @param       height		[in] Height the application believes the window has
+//=========================================================================
+NullRendererWindow::NullRendererWindow ( const Char* className, const Char* title, UInt width, UInt height )
+: RendererWindow(className, title, 0, 0, width, height)
+{
+}
+//End NullRendererWindow::NullRendererWindow
+
+
+
+//=========================================================================
+//! @function    NullRendererWindow::Initialise
+//! @brief       Create the window, without showing it
+//=========================================================================
+void NullRendererWindow::Initialise ( )
+{
+	RegisterWindowClass();
+	Create ( );
+}
+//End NullRendererWindow::Initialise
+
+
+
+//=========================================================================
+//! @function    NullRendererWindow::GetExStyle
+//! @brief       Message only windows have no extended style
+//=========================================================================
+DWORD NullRendererWindow::GetExStyle ( ) const
+{
+	return 0;
+}
+//End NullRendererWindow::GetExStyle
+
+
+
+//=========================================================================
+//! @function    NullRendererWindow::GetStyle
+//! @brief       Message only windows have no style
+//=========================================================================
+DWORD NullRendererWindow::GetStyle ( ) const
+{
+	return 0;
+}
+//End NullRendererWindow::GetStyle
+
+
+
+//=========================================================================
+//! @function    NullRendererWindow::GetParentWindow
+//! @brief       Parent the window to HWND_MESSAGE, making it message only
+//=========================================================================
+HWND NullRendererWindow::GetParentWindow ( ) const
+{
+	return HWND_MESSAGE;
+}
+//End NullRendererWindow::GetParentWindow
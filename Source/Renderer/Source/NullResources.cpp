@@ -0,0 +1,338 @@
+//======================================================================================
+//! @file         NullResources.cpp
+//! @brief        System memory resources used by the NullRenderer
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+
+#include "Core/Core.h"
+#include "Imaging/Image.h"
+#include "Renderer/NullResources.h"
+#include <algorithm>
+
+
+using namespace Renderer;
+
+
+
+//=========================================================================
+// Static functions
+//=========================================================================
+namespace
+{
+	//=========================================================================
+	//! @function    ValidateLockOptions
+	//! @brief       Report lock options that a hardware renderer would reject
+	//!              
+	//!				 The null renderer never fails a lock, but it reports the same
+	//!				 misuse the DirectX renderer does, so that it can be caught headless
+	//!
+	//! @param       usage		 [in] Usage flags the buffer was created with
+	//! @param       lockOptions [in] Lock options passed to Lock
+	//=========================================================================
+	void ValidateLockOptions ( UInt usage, ELock lockOptions )
+	{
+		if ( ((lockOptions == LOCK_DISCARD) || (lockOptions == LOCK_NOOVERWRITE)) 
+			 && !(usage & USAGE_DYNAMIC) )
+		{
+			std::cerr << "Error, tried to lock a static buffer with LOCK_DISCARD or LOCK_NOOVERWRITE, this is not allowed!" << std::endl;
+		}
+	}
+	//End ValidateLockOptions
+}
+
+
+
+//=========================================================================
+//! @function    NullVertexBuffer::NullVertexBuffer
+//! @brief       Create a vertex buffer in system memory
+//!              
+//! @param       vertexSize  [in] Size of a single vertex in the buffer
+//! @param       vertexCount [in] Number of vertices in the buffer
+//! @param       usage		 [in] Usage options for the buffer
+//=========================================================================
+NullVertexBuffer::NullVertexBuffer ( size_t vertexSize, size_t vertexCount, EUsage usage )
+: VertexBuffer ( vertexSize, vertexCount, usage ), m_data( std::max<size_t>(vertexSize * vertexCount, 1) )
+{
+}
+//End NullVertexBuffer::NullVertexBuffer
+
+
+
+//=========================================================================
+//! @function    NullVertexBuffer::LockImplementation
+//! @brief       Lock part of the buffer
+//!              
+//! @param       lockBegin	 [in] Offset from beginning of buffer to start of lock, in bytes
+//! @param       lockSize	 [in] Size of the lock in bytes. Zero locks to the end of the buffer
+//! @param       lockOptions [in] Lock flags
+//!              
+//! @return      A lock into the buffer
+//=========================================================================
+ScopedBufferLock<VertexBuffer> NullVertexBuffer::LockImplementation ( size_t lockBegin, size_t lockSize, ELock lockOptions )
+{
+	debug_assert ( lockBegin + lockSize <= m_data.size(), "Lock extends past the end of the buffer!" );
+
+	ValidateLockOptions ( Usage(), lockOptions );
+
+	return ScopedBufferLock<VertexBuffer>( *this, &m_data[lockBegin] );
+}
+//End NullVertexBuffer::LockImplementation
+
+
+
+//=========================================================================
+//! @function    NullIndexBuffer::NullIndexBuffer
+//! @brief       Create an index buffer in system memory
+//!              
+//! @param       indexSize  [in] Size of each index
+//! @param       indexCount [in] Number of indices in the buffer
+//! @param       usage		[in] Usage options for the buffer
+//=========================================================================
+NullIndexBuffer::NullIndexBuffer ( EIndexSize indexSize, size_t indexCount, EUsage usage )
+: IndexBuffer ( indexSize, indexCount, usage ), m_data( std::max<size_t>((indexSize / 8) * indexCount, 1) )
+{
+}
+//End NullIndexBuffer::NullIndexBuffer
+
+
+
+//=========================================================================
+//! @function    NullIndexBuffer::LockImplementation
+//! @brief       Lock part of the buffer
+//!              
+//! @param       lockBegin	 [in] Offset from beginning of buffer to start of lock, in bytes
+//! @param       lockSize	 [in] Size of the lock in bytes. Zero locks to the end of the buffer
+//! @param       lockOptions [in] Lock flags
+//!              
+//! @return      A lock into the buffer
+//=========================================================================
+ScopedBufferLock<IndexBuffer> NullIndexBuffer::LockImplementation ( size_t lockBegin, size_t lockSize, ELock lockOptions )
+{
+	debug_assert ( lockBegin + lockSize <= m_data.size(), "Lock extends past the end of the buffer!" );
+
+	ValidateLockOptions ( Usage(), lockOptions );
+
+	return ScopedBufferLock<IndexBuffer>( *this, &m_data[lockBegin] );
+}
+//End NullIndexBuffer::LockImplementation
+
+
+
+//=========================================================================
+//! @function    NullTexture::NullTexture
+//! @brief       Create a placeholder for a texture that would be loaded from file
+//!              
+//!				 The file isn't read. The texture is a single white texel
+//!
+//! @param       type	 [in] Type of texture
+//! @param       name	 [in] File name of the texture
+//! @param       quality [in] Reserved
+//! @param       usage	 [in] Usage flags
+//! @param       flags	 [in] Reserved
+//=========================================================================
+NullTexture::NullTexture ( ETextureType type, const Char* name, UInt quality, UInt usage, UInt flags )
+: Texture ( type, name, quality, usage, flags )
+{
+	m_width = 1;
+	m_height = 1;
+	m_format = Imaging::PXFMT_A8R8G8B8;
+
+	Allocate();
+	std::fill ( m_data.begin(), m_data.end(), 0xFF );
+}
+//End NullTexture::NullTexture
+
+
+
+//=========================================================================
+//! @function    NullTexture::NullTexture
+//! @brief       Create an empty texture in system memory
+//!              
+//! @param       type	 [in] Type of texture
+//! @param       width	 [in] Width of the texture
+//! @param       height	 [in] Height of the texture
+//! @param       format	 [in] Pixel format of the texture
+//! @param       quality [in] Reserved
+//! @param       usage	 [in] Usage flags
+//! @param       flags	 [in] Reserved
+//=========================================================================
+NullTexture::NullTexture ( ETextureType type, UInt width, UInt height, Imaging::PixelFormat format, 
+						   UInt quality, UInt usage, UInt flags )
+: Texture ( type, width, height, format, quality, usage, flags )
+{
+	Allocate();
+}
+//End NullTexture::NullTexture
+
+
+
+//=========================================================================
+//! @function    NullTexture::SetFromImage
+//! @brief       Set the contents of the texture from an image
+//!
+//!				 The texture takes on the size and format of the image,
+//!				 no scaling or conversion is done
+//!              
+//! @param       image [in] Image to copy
+//!              
+//! @return      true if succeeded, false if failed
+//=========================================================================
+bool NullTexture::SetFromImage ( const Imaging::Image& image )
+{
+	if ( IsLocked() )
+	{
+		std::cerr << __FUNCTION__ ": Error, can't set a texture from an image while it is locked!" << std::endl;
+		return false;
+	}
+
+	m_width = image.Width();
+	m_height = image.Height();
+	m_format = image.Format();
+	Allocate();
+
+	//Image pitch is the padding at the end of each row, in pixels
+	const UInt sourcePitch = ((image.Width() + image.Pitch()) * image.BitsPerPixel()) / 8;
+	const UInt rowSize = std::min ( Pitch(), sourcePitch );
+	const UChar* source = image.GetBufferPointer();
+
+	for ( UInt row = 0; row < m_height; ++row )
+	{
+		std::copy ( source + (row * sourcePitch), source + (row * sourcePitch) + rowSize, &m_data[row * Pitch()] );
+	}
+
+	return true;
+}
+//End NullTexture::SetFromImage
+
+
+
+//=========================================================================
+//! @function    NullTexture::LockImplementation
+//! @brief       Lock a level of the texture
+//!              
+//! @param       level		 [in] Mip level to lock. Only the top level is stored
+//! @param       lockOptions [in] Lock options
+//!              
+//! @return      A lock on the texture, or a null lock if the level doesn't exist
+//=========================================================================
+ScopedTextureLock NullTexture::LockImplementation ( UInt level, ELock lockOptions )
+{
+	if ( level != 0 )
+	{
+		std::cerr << __FUNCTION__ ": Error, the null renderer only stores the top level of a texture" << std::endl;
+		return ScopedTextureLock();
+	}
+
+	return ScopedTextureLock ( *this, &m_data[0], level, Pitch() );
+}
+//End NullTexture::LockImplementation
+
+
+
+//=========================================================================
+//! @function    NullTexture::Allocate
+//! @brief       Allocate storage for the top level of the texture
+//=========================================================================
+void NullTexture::Allocate ( )
+{
+	m_data.assign ( std::max<UInt>(Pitch() * m_height, 1), 0 );
+}
+//End NullTexture::Allocate
+
+
+
+//=========================================================================
+//! @function    NullTexture::Pitch
+//! @brief       Size of a row of the texture, in bytes
+//=========================================================================
+UInt NullTexture::Pitch ( ) const
+{
+	return std::max<UInt> ( (m_width * BitsPerPixel() + 7) / 8, 1 );
+}
+//End NullTexture::Pitch
+
+
+
+//=========================================================================
+//! @function    NullTextureCreator::CreateTextureFromFile
+//! @brief       Create a placeholder texture for a texture file
+//=========================================================================
+boost::shared_ptr<Texture> NullTextureCreator::CreateTextureFromFile ( ETextureType type, const Char* fileName, 
+																	   UInt quality, UInt usage, UInt flags )
+{
+	return boost::shared_ptr<Texture>( new NullTexture(type, fileName, quality, usage, flags) );
+}
+//End NullTextureCreator::CreateTextureFromFile
+
+
+
+//=========================================================================
+//! @function    NullTextureCreator::CreateTexture
+//! @brief       Create an empty texture in system memory
+//=========================================================================
+boost::shared_ptr<Texture> NullTextureCreator::CreateTexture ( ETextureType type, UInt width, UInt height, 
+															   Imaging::PixelFormat format, UInt quality, 
+															   UInt usage, UInt flags )
+{
+	return boost::shared_ptr<Texture>( new NullTexture(type, width, height, format, quality, usage, flags) );
+}
+//End NullTextureCreator::CreateTexture
+
+
+
+//=========================================================================
+//! @function    NullVertexBufferCreator::CreateVertexBuffer
+//! @brief       Create a vertex buffer in system memory
+//=========================================================================
+boost::shared_ptr<VertexBuffer> NullVertexBufferCreator::CreateVertexBuffer ( size_t vertexSize, size_t vertexCount, EUsage usage )
+{
+	return boost::shared_ptr<VertexBuffer>( new NullVertexBuffer(vertexSize, vertexCount, usage) );
+}
+//End NullVertexBufferCreator::CreateVertexBuffer
+
+
+
+//=========================================================================
+//! @function    NullIndexBufferCreator::CreateIndexBuffer
+//! @brief       Create an index buffer in system memory
+//=========================================================================
+boost::shared_ptr<IndexBuffer> NullIndexBufferCreator::CreateIndexBuffer ( EIndexSize indexSize, size_t indexCount, EUsage usage )
+{
+	return boost::shared_ptr<IndexBuffer>( new NullIndexBuffer(indexSize, indexCount, usage) );
+}
+//End NullIndexBufferCreator::CreateIndexBuffer
+
+
+
+//=========================================================================
+//! @function    NullVertexDeclarationCreator::CreateVertexDeclaration
+//! @brief       Create a vertex declaration for the null renderer
+//=========================================================================
+boost::shared_ptr<VertexDeclaration> NullVertexDeclarationCreator::CreateVertexDeclaration ( const VertexDeclarationDescriptor& descriptor )
+{
+	return boost::shared_ptr<VertexDeclaration>( new NullVertexDeclaration(descriptor) );
+}
+//End NullVertexDeclarationCreator::CreateVertexDeclaration
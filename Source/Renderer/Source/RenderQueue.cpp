@@ -49,7 +49,13 @@ using namespace Renderer;
 //!
 //=========================================================================
 RenderQueue::RenderQueue ( StateManager& stateManager, IRenderer& renderer )
-: m_stateManager(stateManager), m_renderer(renderer)
+: m_queue(),
+  m_keys(),
+  m_scratchKeys(),
+  m_stateManager(stateManager),
+  m_renderer(renderer),
+  m_viewerPosition(0.0f, 0.0f, 0.0f),
+  m_viewerPositionSet(false)
 {
 }
 //End RenderQueue::RenderQueue
@@ -63,8 +69,10 @@ RenderQueue::RenderQueue ( StateManager& stateManager, IRenderer& renderer )
 //=========================================================================
 void RenderQueue::Render ()
 {
-	iterator current = m_queue.begin();
-	iterator end = m_queue.end();
+	key_iterator current = m_keys.begin();
+	key_iterator end = m_keys.end();
+
+	const Math::Matrix4x4* lastWorld = 0;
 
 	#if 0
 	std::clog << "\nBegin frame: " << std::endl;
@@ -72,20 +80,22 @@ void RenderQueue::Render ()
 
 	for ( ; current != end; ++current )
 	{
-		m_stateManager.ActivateIndexBuffer ( current->GetIndexBuffer() );
-		m_stateManager.ActivateVertexStreamBinding ( current->GetStreamBinding() );
-		m_stateManager.ActivateVertexDeclaration ( current->GetVertexDeclaration() );
-		m_stateManager.ActivateRenderState ( current->GetEffect(), current->TechniqueIndex(), current->PassIndex() );
+		RenderQueueEntry& entry = m_queue[current->index];
 
-		static Math::Matrix4x4 world;
-		m_renderer.GetMatrix ( Renderer::MAT_WORLD, world );
+		m_stateManager.ActivateIndexBuffer ( entry.GetIndexBuffer() );
+		m_stateManager.ActivateVertexStreamBinding ( entry.GetStreamBinding() );
+		m_stateManager.ActivateVertexDeclaration ( entry.GetVertexDeclaration() );
+		m_stateManager.ActivateRenderState ( entry.GetEffect(), entry.TechniqueIndex(), entry.PassIndex() );
 
-		if ( !(world == current->GetWorldMatrix()) )
+		//Anything may have changed the world matrix before the queue was rendered, 
+		//so it's always set for the first entry. After that, only the queue sets it
+		if ( ( lastWorld == 0 ) || !( *lastWorld == entry.GetWorldMatrix() ) )
 		{
-			m_renderer.SetMatrix ( Renderer::MAT_WORLD, current->GetWorldMatrix() );
+			m_renderer.SetMatrix ( Renderer::MAT_WORLD, entry.GetWorldMatrix() );
+			lastWorld = &entry.GetWorldMatrix();
 		}
 
-		current->GetRenderable().Render ( m_renderer );
+		entry.GetRenderable().Render ( m_renderer );
 	}
 
 	#if 0
@@ -93,4 +103,139 @@ void RenderQueue::Render ()
 	#endif
 
 }
-//End RenderQueue::Render
\ No newline at end of file
+//End RenderQueue::Render
+
+
+
+//=========================================================================
+//! @function    RenderQueue::QuantiseDepth
+//! @brief       Convert the distance from the viewer to an object into
+//!				 a 16 bit depth value for the sort key
+//!              
+//! @param       worldMatrix [in] World matrix of the object
+//!              
+//! @return      The quantised depth, 0 is nearest
+//=========================================================================
+UInt RenderQueue::QuantiseDepth ( const Math::Matrix4x4& worldMatrix ) const
+{
+	static Core::ConsoleFloat ren_queuedepthrange ( "ren_queuedepthrange", 1000.0f );
+
+	Math::Vector3D offset ( worldMatrix(3,0) - m_viewerPosition.X(), 
+							worldMatrix(3,1) - m_viewerPosition.Y(),
+							worldMatrix(3,2) - m_viewerPosition.Z() );
+
+	const Float maxDepth = 0xFFFF;
+	Float depth = (offset.Length() / static_cast<Float>(ren_queuedepthrange)) * maxDepth;
+
+	if ( depth > maxDepth )
+	{
+		depth = maxDepth;
+	}
+
+	return static_cast<UInt>(depth);
+}
+//End RenderQueue::QuantiseDepth
+
+
+
+//=========================================================================
+//! @function    RenderQueue::ViewerPositionFromView
+//! @brief       Take the viewer position from the renderer's current view matrix
+//!
+//!				 The viewer is at the origin of view space, so its world position
+//!				 is the translation of the inverse view matrix
+//=========================================================================
+void RenderQueue::ViewerPositionFromView ( )
+{
+	Math::Matrix4x4 view;
+	m_renderer.GetMatrix ( Renderer::MAT_VIEW, view );
+
+	Math::Matrix4x4 viewInverse;
+
+	if ( view.Inverse ( viewInverse ) )
+	{
+		m_viewerPosition = Math::Vector3D ( viewInverse(3,0), viewInverse(3,1), viewInverse(3,2) );
+	}
+	else
+	{
+		m_viewerPosition = Math::Vector3D ( 0.0f, 0.0f, 0.0f );
+	}
+
+	m_viewerPositionSet = true;
+}
+//End RenderQueue::ViewerPositionFromView
+
+
+
+//=========================================================================
+//! @function    RenderQueue::RadixSort
+//! @brief       Sort the key list in ascending order
+//!              
+//!              LSD radix sort, one byte per pass. Passes where every key
+//!				 has the same byte are skipped, which is typically most of
+//!				 them for the high (sort value/effect) bytes.
+//!				 The sort is stable, so entries with equal keys are rendered
+//!				 in the order that they were queued
+//=========================================================================
+void RenderQueue::RadixSort ( )
+{
+	const UInt keyCount = static_cast<UInt>(m_keys.size());
+
+	if ( keyCount < 2 )
+	{
+		return;
+	}
+
+	m_scratchKeys.resize ( keyCount );
+
+	SortKey* source = &m_keys[0];
+	SortKey* dest   = &m_scratchKeys[0];
+
+	//Build the histograms for all eight passes in a single sweep over the keys
+	UInt histograms[8][256];
+	std::fill ( &histograms[0][0], &histograms[0][0] + (8*256), 0 );
+
+	for ( UInt i=0; i < keyCount; ++i )
+	{
+		UInt64 key = source[i].key;
+
+		for ( UInt pass=0; pass < 8; ++pass )
+		{
+			++histograms[pass][ static_cast<UInt>(key >> (pass*8)) & 0xFF ];
+		}
+	}
+
+	for ( UInt pass=0; pass < 8; ++pass )
+	{
+		UInt* histogram = histograms[pass];
+
+		//If every key has the same value for this byte, there's nothing to do
+		if ( histogram[ static_cast<UInt>(source[0].key >> (pass*8)) & 0xFF ] == keyCount )
+		{
+			continue;
+		}
+
+		//Convert the counts into offsets
+		UInt offset = 0;
+		for ( UInt bucket=0; bucket < 256; ++bucket )
+		{
+			UInt count = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += count;
+		}
+
+		for ( UInt i=0; i < keyCount; ++i )
+		{
+			dest[ histogram[ static_cast<UInt>(source[i].key >> (pass*8)) & 0xFF ]++ ] = source[i];
+		}
+
+		std::swap ( source, dest );
+	}
+
+	//Make sure the result ends up in m_keys
+	if ( source != &m_keys[0] )
+	{
+		std::copy ( m_scratchKeys.begin(), m_scratchKeys.end(), m_keys.begin() );
+	}
+}
+//End RenderQueue::RadixSort
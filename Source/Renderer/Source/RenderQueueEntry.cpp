@@ -39,6 +39,38 @@ using namespace Renderer;
 
 
 
+//=========================================================================
+// Sort key layout
+//
+// Opaque techniques are sorted by state first, then front to back so that
+// nearby objects fill the depth buffer early. Transparent and refractive
+// techniques must be drawn back to front, so the inverted depth takes
+// priority over the state bits for those.
+//
+// Handle indices are masked to the width of their field. Two resources that
+// alias in the key will merely be grouped less well, the state manager
+// still compares the full handles before changing any state
+//=========================================================================
+namespace
+{
+	const UInt g_sortValueBits		= 2;
+	const UInt g_effectBits			= 12;
+	const UInt g_techniqueBits		= 4;
+	const UInt g_passBits			= 4;
+	const UInt g_declarationBits	= 8;
+	const UInt g_vertexBufferBits	= 12;
+	const UInt g_indexBufferBits	= 12;
+	const UInt g_depthBits			= 10;
+	const UInt g_blendedDepthBits	= 16;
+
+	inline UInt64 Field ( UInt value, UInt bits )
+	{
+		return static_cast<UInt64>( value & ((1 << bits) - 1) );
+	}
+}
+
+
+
 
 //=========================================================================
 //! @function    RenderQueueEntry::RenderQueueEntry
@@ -56,11 +88,11 @@ using namespace Renderer;
 RenderQueueEntry::RenderQueueEntry ( IRenderable& renderable, HEffect& effect, UInt techniqueIndex, UInt passIndex,
 									HVertexDeclaration& decl, VertexStreamBinding& binding, HIndexBuffer& indexBuffer,
 									const Math::Matrix4x4& worldMatrix )
-:	m_renderable(renderable), 
+:	m_renderable(&renderable), 
 	m_effect(effect), 
 	m_techniqueIndex(techniqueIndex),
 	m_passIndex(passIndex),
-	m_binding(binding),
+	m_binding(&binding),
 	m_vertexDeclaration(decl),
 	m_indexBuffer(indexBuffer),
 	m_worldMatrix(worldMatrix)
@@ -77,85 +109,50 @@ RenderQueueEntry::RenderQueueEntry ( IRenderable& renderable, HEffect& effect, U
 
 
 
-
 //=========================================================================
-//! @function    RenderQueueEntry::operator <
-//! @brief       Compare two render queue entries (for render state sorting purposes)
+//! @function    RenderQueueEntry::GenerateSortKey
+//! @brief       Pack the render state of the entry into a 64 bit sort key
 //!
+//!				 Sorting entries by this key orders them by technique sort value,
+//!				 then by effect, technique, pass, vertex format, vertex buffer
+//!				 and index buffer, and finally by depth.
+//!              
+//! @param       depth [in] Quantised distance from the viewer, 0 - 65535
+//!              
+//! @return      The sort key
 //=========================================================================
-bool RenderQueueEntry::operator < ( const RenderQueueEntry& rhs ) const
+UInt64 RenderQueueEntry::GenerateSortKey ( UInt depth ) const
 {
+	const UInt sortValue = static_cast<UInt>(m_effect->Techniques(TechniqueIndex()).SortValue());
+	
+	UInt64 key = Field(sortValue, g_sortValueBits);
 
-	//First sort by the technique's sort value
-	if ( static_cast<UInt>(m_effect->Techniques(TechniqueIndex()).SortValue())
-			< static_cast<UInt>(rhs.m_effect->Techniques(rhs.TechniqueIndex()).SortValue()) )
-	{
-		return true;
-	}
-
-	if ( static_cast<UInt>(m_effect->Techniques(TechniqueIndex()).SortValue())
-			> static_cast<UInt>(rhs.m_effect->Techniques(rhs.TechniqueIndex()).SortValue()) )
-	{
-		return false;
-	}
-
-	//Then sort by effect
-	if ( m_effect.Value() < rhs.m_effect.Value() )
-	{
-		return true;
-	}
-
-	if ( m_effect.Value() > rhs.m_effect.Value() )
-	{	
-		return false;
-	}	
-
-	//Then sort by technique
-	if ( TechniqueIndex() < rhs.TechniqueIndex() )
-	{
-		return true;
-	}
-
-	if ( TechniqueIndex() > rhs.TechniqueIndex() )
-	{
-		return false;
-	}
-
-	//Then sort by pass
-	if ( PassIndex() < rhs.PassIndex() )
-	{	
-		return true;
-	}
-
-	if ( PassIndex() > rhs.PassIndex() )
-	{
-		return false;
-	}
-
-	//Then sort by vertex format
-	if ( m_vertexDeclaration.Value() < rhs.m_vertexDeclaration.Value() )
-	{
-		return true;
-	}
-
-	if ( m_vertexDeclaration.Value() > rhs.m_vertexDeclaration.Value() )
-	{
-		return false;
-	}
-
-	//Then sort by which buffers are set
-	if ( m_binding < rhs.m_binding )
+	if ( (sortValue == SORT_TRANSPARENT) || (sortValue == SORT_REFRACTIVE) )
 	{
-		return true;
+		//Back to front. Depth has priority over state for blended geometry
+		key = (key << g_blendedDepthBits)  | Field(~depth, g_blendedDepthBits);
+		key = (key << g_effectBits)		   | Field(m_effect.Index(), g_effectBits);
+		key = (key << g_techniqueBits)	   | Field(TechniqueIndex(), g_techniqueBits);
+		key = (key << g_passBits)		   | Field(PassIndex(), g_passBits);
+		key = (key << g_declarationBits)   | Field(m_vertexDeclaration.Index(), g_declarationBits);
+		key = (key << g_indexBufferBits)   | Field(m_indexBuffer.Index(), g_indexBufferBits);
+
+		//Pad out the remaining bits so that the sort value lands in the top bits
+		key <<= 64 - ( g_sortValueBits + g_blendedDepthBits + g_effectBits + g_techniqueBits 
+					   + g_passBits + g_declarationBits + g_indexBufferBits );
 	}
-
-	//Then sort by index buffer
-	if ( m_indexBuffer.Value() < rhs.m_indexBuffer.Value() )
+	else
 	{
-		return true;
+		//State first, then front to back
+		key = (key << g_effectBits)		   | Field(m_effect.Index(), g_effectBits);
+		key = (key << g_techniqueBits)	   | Field(TechniqueIndex(), g_techniqueBits);
+		key = (key << g_passBits)		   | Field(PassIndex(), g_passBits);
+		key = (key << g_declarationBits)   | Field(m_vertexDeclaration.Index(), g_declarationBits);
+		key = (key << g_vertexBufferBits)  | Field(m_binding->BorrowStream(0).Index(), g_vertexBufferBits);
+		key = (key << g_indexBufferBits)   | Field(m_indexBuffer.Index(), g_indexBufferBits);
+		key = (key << g_depthBits)		   | Field(depth >> (g_blendedDepthBits - g_depthBits), g_depthBits);
 	}
 
-	return false;
-	
+	return key;
 }
-//End RenderQueueEntry::operator < 
\ No newline at end of file
+//End RenderQueueEntry::GenerateSortKey
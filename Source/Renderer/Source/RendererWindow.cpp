@@ -583,6 +583,18 @@ DWORD RendererWindow::GetStyle ( ) const
 
 
 
+//=========================================================================
+//! @function    RendererWindow::GetParentWindow
+//! @brief       Return the parent of the window, or 0 for a top level window
+//=========================================================================
+HWND RendererWindow::GetParentWindow ( ) const
+{
+	return 0;
+}
+//end RendererWindow::GetParentWindow
+
+
+
 //=========================================================================
 //! @function    RendererWindow::Create
 //! @brief       Create the window
@@ -607,7 +619,7 @@ void RendererWindow::Create ( )
 								dwStyle,								 //dwStyle
 								m_top,m_left,							 //x,y
 								m_width, m_height,						 //nWidth, nHeight
-								0,										 //hWndParent
+								GetParentWindow ( ),					 //hWndParent
 								0,										 //hMenu
 								GetModuleHandle ( NULL ),				 //hInstance
 								reinterpret_cast<LPVOID> ( this ) );	 //lpParam
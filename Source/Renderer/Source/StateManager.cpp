@@ -33,6 +33,7 @@
 #include "Renderer/StateManager.h"
 #include "Renderer/AutogenTextureManager.h"
 #include "Renderer/RenderState.h"
+#include <limits>
 
 
 using namespace Renderer;
@@ -49,9 +50,10 @@ using namespace Renderer;
 //!              
 //=========================================================================
 StateManager::StateManager ( IRenderer& renderer, AutogenTextureManager& autogenManager )
-: m_renderer(renderer), m_renderState(0), m_autogenManager(autogenManager), m_passIndex(0), m_techniqueIndex(0)
+: m_renderer(renderer), m_renderState(0), m_autogenManager(autogenManager), m_passIndex(0), m_techniqueIndex(0),
+  m_shadowValid(false)
 {
-	
+	InvalidateShadowState();
 }
 //End StateManager::StateManager
 
@@ -61,12 +63,15 @@ StateManager::StateManager ( IRenderer& renderer, AutogenTextureManager& autogen
 //! @function    StateManager::ActivateRenderState
 //! @brief       Activates a render state
 //!              
+//!				 The state manager only takes a reference to the effect when
+//!				 it changes, so activating the current effect again is free
+//!
 //! @param       effect			[in] Effect to get the render state from
 //! @param       techniqueIndex [in] Index of technique to get from the effect
 //! @param       passIndex		[in] Index of pass from the technique, that holds the render state
 //!              
 //=========================================================================
-void StateManager::ActivateRenderState ( HEffect& effect, UInt techniqueIndex, UInt passIndex )
+void StateManager::ActivateRenderState ( const Core::BorrowedHandle<Effect>& effect, UInt techniqueIndex, UInt passIndex )
 {
 	debug_assert ( !effect.IsNull(), "Tried to activate a null effect" );
 	debug_assert ( techniqueIndex < effect->TechniqueCount(), "Technique index out of range!" );
@@ -82,7 +87,10 @@ void StateManager::ActivateRenderState ( HEffect& effect, UInt techniqueIndex, U
 
 	//Set the render state
 	m_renderState = &(effect->Techniques( techniqueIndex).Passes(passIndex).GetRenderState());
-	m_effect = effect;
+	if ( effect.Value() != m_effect.Value() )
+	{
+		effect.Acquire().Swap ( m_effect );
+	}
 	m_techniqueIndex = techniqueIndex;
 	m_passIndex = passIndex;
 	
@@ -144,9 +152,11 @@ void StateManager::ActivateVertexStreamBinding ( VertexStreamBinding& binding )
 {
 	for ( UInt i=0; i < g_maxStreams; ++i )
 	{
-		if ( m_vertexBuffers[i].Value() != binding.GetStream(i).Value() )
+		Core::BorrowedHandle<VertexBuffer> stream = binding.BorrowStream(i);
+
+		if ( m_vertexBuffers[i].Value() != stream.Value() )
 		{
-			m_vertexBuffers[i] = binding.GetStream(i);
+			stream.Acquire().Swap ( m_vertexBuffers[i] );
 			m_renderer.Bind ( m_vertexBuffers[i], i );
 		}
 	}
@@ -163,11 +173,11 @@ void StateManager::ActivateVertexStreamBinding ( VertexStreamBinding& binding )
 //! @param       data [in] 
 //!              
 //=========================================================================
-void StateManager::ActivateVertexDeclaration ( HVertexDeclaration& decl )
+void StateManager::ActivateVertexDeclaration ( const Core::BorrowedHandle<VertexDeclaration>& decl )
 {
 	if ( m_declaration.Value() != decl.Value() )
 	{
-		m_declaration = decl;
+		decl.Acquire().Swap ( m_declaration );
 		m_renderer.Bind ( m_declaration );
 	}
 }
@@ -187,11 +197,11 @@ void StateManager::ActivateVertexDeclaration ( HVertexDeclaration& decl )
 //! @return      
 //! @throw       
 //=========================================================================
-void StateManager::ActivateIndexBuffer ( HIndexBuffer& buffer )
+void StateManager::ActivateIndexBuffer ( const Core::BorrowedHandle<IndexBuffer>& buffer )
 {
 	if ( m_indexBuffer.Value() != buffer.Value() )
 	{
-		m_indexBuffer = buffer;
+		buffer.Acquire().Swap ( m_indexBuffer );
 		m_renderer.Bind ( m_indexBuffer );
 	}
 }
@@ -199,6 +209,76 @@ void StateManager::ActivateIndexBuffer ( HIndexBuffer& buffer )
 
 
 
+//=========================================================================
+//! @function    StateManager::InvalidateShadowState
+//! @brief       Forget everything known about the renderer's current state
+//!              
+//!				 The next render state activated will be sent to the renderer
+//!				 in full. This must be called whenever the renderer's state may
+//!				 have been changed without going through the state manager,
+//!				 such as after the device has been restored
+//!              
+//=========================================================================
+void StateManager::InvalidateShadowState ( )
+{
+	m_shadowValid = false;
+
+	//The fog parameters aren't sent when fog is disabled, so they can be left 
+	//untouched by the full sync that follows. NaN never compares equal, so they
+	//will still be sent the first time fog is enabled
+	const Float invalid = std::numeric_limits<Float>::quiet_NaN();
+
+	for ( UInt i=0; i < g_floatStateCount; ++i )
+	{
+		m_shadow.floatStates[i] = invalid;
+	}
+
+	for ( UInt i=0; i < g_colourStateCount; ++i )
+	{
+		m_shadow.colourStates[i] = Colour4f ( invalid, invalid, invalid, invalid );
+	}
+
+	for ( UInt i=0; i < TEXTURE_STAGE_COUNT; ++i )
+	{
+		m_shadowStages[i].valid = false;
+		m_shadowStages[i].texture = Core::NullHandle();
+	}
+
+	for ( UInt i=0; i < g_maxStreams; ++i )
+	{
+		m_vertexBuffers[i] = Core::NullHandle();
+	}
+
+	m_indexBuffer = Core::NullHandle();
+	m_declaration = Core::NullHandle();
+
+	m_renderState = 0;
+	m_effect = Core::NullHandle();
+	m_techniqueIndex = 0;
+	m_passIndex = 0;
+}
+//End StateManager::InvalidateShadowState
+
+
+
+//=========================================================================
+//! @function    StateManager::ResetFrameStatistics
+//! @brief       Store the state call counts for the frame just finished, and
+//!				 start counting again for a new frame
+//!              
+//!				 The counts for the finished frame can be retrieved with
+//!				 LastFrameStatistics
+//!              
+//=========================================================================
+void StateManager::ResetFrameStatistics ( )
+{
+	m_lastFrameStatistics = m_frameStatistics;
+	m_frameStatistics = Statistics();
+}
+//End StateManager::ResetFrameStatistics
+
+
+
 //=========================================================================
 //! @function    StateManager::SyncRendererState
 //! @brief       Synchronises the renderer's state with that of a render state
@@ -209,62 +289,62 @@ void StateManager::ActivateIndexBuffer ( HIndexBuffer& buffer )
 void StateManager::SyncRendererState ( const RenderState& state )
 {
 	//Sync the renderer with our new render state
-	m_renderer.SetMaterial ( state.GetMaterial() );
-	m_renderer.SetMaterialColourSource ( STATE_AMBIENT_MATERIAL_SOURCE, state.GetMaterialSource(STATE_AMBIENT_MATERIAL_SOURCE) ); 
-	m_renderer.SetMaterialColourSource ( STATE_DIFFUSE_MATERIAL_SOURCE, state.GetMaterialSource(STATE_DIFFUSE_MATERIAL_SOURCE) );
-	m_renderer.SetMaterialColourSource ( STATE_SPECULAR_MATERIAL_SOURCE, state.GetMaterialSource(STATE_SPECULAR_MATERIAL_SOURCE) );
-	m_renderer.SetMaterialColourSource ( STATE_EMISSIVE_MATERIAL_SOURCE, state.GetMaterialSource(STATE_EMISSIVE_MATERIAL_SOURCE) );
-
-	m_renderer.SetRenderState ( STATE_BLENDING, state.Blending() );
-	m_renderer.SetBlendOp   ( state.BlendOp() );
-	m_renderer.SetBlendFunc ( state.SourceBlend(), state.DestBlend() );
+	SetMaterial ( state.GetMaterial() );
+	SetMaterialColourSource ( STATE_AMBIENT_MATERIAL_SOURCE, state.GetMaterialSource(STATE_AMBIENT_MATERIAL_SOURCE) ); 
+	SetMaterialColourSource ( STATE_DIFFUSE_MATERIAL_SOURCE, state.GetMaterialSource(STATE_DIFFUSE_MATERIAL_SOURCE) );
+	SetMaterialColourSource ( STATE_SPECULAR_MATERIAL_SOURCE, state.GetMaterialSource(STATE_SPECULAR_MATERIAL_SOURCE) );
+	SetMaterialColourSource ( STATE_EMISSIVE_MATERIAL_SOURCE, state.GetMaterialSource(STATE_EMISSIVE_MATERIAL_SOURCE) );
+
+	SetRenderState ( STATE_BLENDING, state.Blending() );
+	SetBlendOp ( state.BlendOp() );
+	SetBlendFunc ( state.SourceBlend(), state.DestBlend() );
 	
-	m_renderer.SetRenderState ( STATE_DEPTHTEST, state.DepthTest() );
-	m_renderer.SetRenderState ( STATE_DEPTHWRITE, state.DepthWrite() );
-	m_renderer.SetDepthFunc	  ( state.DepthFunc() );
-	m_renderer.SetRenderState ( STATE_DEPTHBIASVALUE, state.DepthBias() );
+	SetRenderState ( STATE_DEPTHTEST, state.DepthTest() );
+	SetRenderState ( STATE_DEPTHWRITE, state.DepthWrite() );
+	SetDepthFunc ( state.DepthFunc() );
+	SetRenderState ( STATE_DEPTHBIASVALUE, state.DepthBias() );
 	
-	m_renderer.SetRenderState ( STATE_ALPHATEST, state.AlphaTest() );
-	m_renderer.SetAlphaFunc	  ( state.AlphaFunc() );
-	m_renderer.SetRenderState ( STATE_ALPHAREFERENCE, state.AlphaReference() );
+	SetRenderState ( STATE_ALPHATEST, state.AlphaTest() );
+	SetAlphaFunc ( state.AlphaFunc() );
+	SetRenderState ( STATE_ALPHAREFERENCE, state.AlphaReference() );
 
-	m_renderer.SetRenderState ( STATE_STENCIL, state.StencilTest() );
-	m_renderer.SetRenderState ( STATE_STENCILREFERENCE, state.StencilRef() );
-	m_renderer.SetRenderState ( STATE_STENCILMASK, state.StencilMask() );
-	m_renderer.SetRenderState ( STATE_STENCILWRITEMASK, state.StencilWriteMask() );
-	m_renderer.SetStencilFunc ( state.StencilFunc() );
-	m_renderer.SetStencilOp	  ( STENCILOP_PASS, state.StencilPass() );
-	m_renderer.SetStencilOp   ( STENCILOP_FAIL, state.StencilFail() );
-	m_renderer.SetStencilOp   ( STENCILOP_ZFAIL, state.StencilZFail() );
+	SetRenderState ( STATE_STENCIL, state.StencilTest() );
+	SetRenderState ( STATE_STENCILREFERENCE, state.StencilRef() );
+	SetRenderState ( STATE_STENCILMASK, state.StencilMask() );
+	SetRenderState ( STATE_STENCILWRITEMASK, state.StencilWriteMask() );
+	SetStencilFunc ( state.StencilFunc() );
+	SetStencilOp ( STENCILOP_PASS, state.StencilPass() );
+	SetStencilOp ( STENCILOP_FAIL, state.StencilFail() );
+	SetStencilOp ( STENCILOP_ZFAIL, state.StencilZFail() );
 
-	m_renderer.SetCullingMode ( state.CullMode() );
+	SetCullingMode ( state.CullMode() );
 
-	m_renderer.SetRenderState ( STATE_LIGHTING, state.Lighting() );
+	SetRenderState ( STATE_LIGHTING, state.Lighting() );
 
-	m_renderer.SetShadeMode ( state.ShadeMode() );
+	SetShadeMode ( state.ShadeMode() );
 
 	if ( state.FogOverride() )
 	{
-		m_renderer.SetRenderState ( STATE_FOGBLENDING, true );
+		SetRenderState ( STATE_FOGBLENDING, true );
 
-		m_renderer.SetFogMode	  ( FOGTYPE_VERTEX, state.FogMode() );
-		m_renderer.SetColour	  ( STATE_FOGCOLOUR, state.FogColour() );
-		m_renderer.SetRenderState ( STATE_FOGDENSITY, state.FogDensity() );
-		m_renderer.SetRenderState ( STATE_FOGSTART, state.FogBegin() );
-		m_renderer.SetRenderState ( STATE_FOGEND, state.FogEnd() );
+		SetFogMode ( FOGTYPE_VERTEX, state.FogMode() );
+		SetColour ( STATE_FOGCOLOUR, state.FogColour() );
+		SetRenderState ( STATE_FOGDENSITY, state.FogDensity() );
+		SetRenderState ( STATE_FOGSTART, state.FogBegin() );
+		SetRenderState ( STATE_FOGEND, state.FogEnd() );
 
 	}
 	else
 	{
 		//TODO: Set the renderer's fog state here
 
-		m_renderer.SetRenderState ( STATE_FOGBLENDING, false );
-		m_renderer.SetFogMode ( FOGTYPE_VERTEX, FOGMODE_NONE );
+		SetRenderState ( STATE_FOGBLENDING, false );
+		SetFogMode ( FOGTYPE_VERTEX, FOGMODE_NONE );
 	}
 
-	m_renderer.SetRenderState ( STATE_COLOURWRITE, state.ColourWrite() );
-	m_renderer.SetRenderState ( STATE_NORMALISENORMALS, state.NormaliseNormals() );
-	m_renderer.SetRenderState ( STATE_SPECULAR, state.SpecularHighlights() );
+	SetRenderState ( STATE_COLOURWRITE, state.ColourWrite() );
+	SetRenderState ( STATE_NORMALISENORMALS, state.NormaliseNormals() );
+	SetRenderState ( STATE_SPECULAR, state.SpecularHighlights() );
 
 	for ( UInt index=0; index < state.TextureUnitCount() ; ++index )
 	{
@@ -282,15 +362,14 @@ void StateManager::SyncRendererState ( const RenderState& state )
 		 (m_renderer.GetDeviceProperty(CAP_TEXTURE_MAX_SIMULTANEOUS) - 1)) )
 	{
 
-		m_autogenManager.UnbindAutogenTexture (  static_cast<ETextureStageID>(state.TextureUnitCount()) );
+		BindTexture ( static_cast<ETextureStageID>(state.TextureUnitCount()), HTexture() );
 
-		m_renderer.Bind( HTexture(), 
-						 static_cast<ETextureStageID>(state.TextureUnitCount()) );
-
-		m_renderer.SetTextureStageState ( static_cast<ETextureStageID>(state.TextureUnitCount()), 
-											TEXSTAGE_COLOUROP, TEXOP_DISABLE ); 
+		SetTextureStageState ( static_cast<ETextureStageID>(state.TextureUnitCount()), 
+							   TEXSTAGE_COLOUROP, TEXOP_DISABLE ); 
 											
 	}
+
+	m_shadowValid = true;
 }
 //End StateManager::SyncRendererState
 
@@ -314,57 +393,514 @@ void StateManager::SyncRendererTextureUnit ( const TextureUnit& textureUnit, UIn
 	//Set the texture for the texture stage
 	if ( !textureUnit.AutoGenerated() )
 	{
-		m_autogenManager.UnbindAutogenTexture ( stageID );
-		m_renderer.Bind ( textureUnit.TextureHandle(), stageID ); 
+		BindTexture ( stageID, textureUnit.TextureHandle() ); 
 	}
 	else
 	{
-		m_autogenManager.BindAutogenTexture ( stageID, textureUnit.NameHash() );
+		BindAutogenTexture ( stageID, textureUnit.NameHash() );
 	}
 
-	m_renderer.SetMatrix ( static_cast<EMatrixType>(MAT_TEXTURE0 + index), 
-							textureUnit.GetTextureMatrix() );
+	SetTextureMatrix ( stageID, textureUnit.GetTextureMatrix() );
 
 	//Set up the texture filters
-	m_renderer.SetTextureFilter ( stageID, TEXFILTER_MIN, textureUnit.MinFilter() );
-	m_renderer.SetTextureFilter ( stageID, TEXFILTER_MAG, textureUnit.MagFilter() );
-	m_renderer.SetTextureFilter ( stageID, TEXFILTER_MIP, textureUnit.MipFilter() );
-	m_renderer.SetTextureParameter ( stageID, TEXPARAM_MAX_ANISOTROPY,
-									 textureUnit.MaxAnisotropy() );
+	SetTextureFilter ( stageID, TEXFILTER_MIN, textureUnit.MinFilter() );
+	SetTextureFilter ( stageID, TEXFILTER_MAG, textureUnit.MagFilter() );
+	SetTextureFilter ( stageID, TEXFILTER_MIP, textureUnit.MipFilter() );
+	SetTextureParameter ( stageID, TEXPARAM_MAX_ANISOTROPY, textureUnit.MaxAnisotropy() );
 
 	//Set up the Colour Op
 	TextureBlendOp op = textureUnit.ColourOp();
-	m_renderer.SetTextureStageState ( stageID, TEXSTAGE_COLOUROP, op.operation );
-	m_renderer.SetTextureStageState ( stageID, TEXSTAGE_COLOURARG0, op.arg1 );
-	m_renderer.SetTextureStageState ( stageID, TEXSTAGE_COLOURARG1, op.arg2 );
+	SetTextureStageState ( stageID, TEXSTAGE_COLOUROP, op.operation );
+	SetTextureStageState ( stageID, TEXSTAGE_COLOURARG0, op.arg1 );
+	SetTextureStageState ( stageID, TEXSTAGE_COLOURARG1, op.arg2 );
 
 	//Set up the Alpha op
 	op = textureUnit.AlphaOp();
-	m_renderer.SetTextureStageState ( stageID, TEXSTAGE_ALPHAOP, op.operation );
-	m_renderer.SetTextureStageState ( stageID, TEXSTAGE_ALPHAARG0, op.arg1 );
-	m_renderer.SetTextureStageState ( stageID, TEXSTAGE_ALPHAARG1, op.arg2 );
+	SetTextureStageState ( stageID, TEXSTAGE_ALPHAOP, op.operation );
+	SetTextureStageState ( stageID, TEXSTAGE_ALPHAARG0, op.arg1 );
+	SetTextureStageState ( stageID, TEXSTAGE_ALPHAARG1, op.arg2 );
 
 	//Set the per-stage constant colour
-	m_renderer.SetTextureStageConstantColour ( stageID, textureUnit.ConstantColour() );
+	SetTextureStageConstantColour ( stageID, textureUnit.ConstantColour() );
 
 	//Set up the addressing mode
-	m_renderer.SetTextureAddressingMode ( stageID, TEX_ADDRESS_U,
-										  textureUnit.AddressingMode(TEX_ADDRESS_U) ); 
-	m_renderer.SetTextureAddressingMode ( stageID, TEX_ADDRESS_V, 
-										  textureUnit.AddressingMode(TEX_ADDRESS_V) );
-	m_renderer.SetTextureAddressingMode ( stageID, TEX_ADDRESS_W,
-										  textureUnit.AddressingMode(TEX_ADDRESS_W) );
+	SetTextureAddressingMode ( stageID, TEX_ADDRESS_U,
+							   textureUnit.AddressingMode(TEX_ADDRESS_U) ); 
+	SetTextureAddressingMode ( stageID, TEX_ADDRESS_V, 
+							   textureUnit.AddressingMode(TEX_ADDRESS_V) );
+	SetTextureAddressingMode ( stageID, TEX_ADDRESS_W,
+							   textureUnit.AddressingMode(TEX_ADDRESS_W) );
 
 	//Set up the texture coordinate set, or texture coordinate generation
-	if ( textureUnit.CoordinateGenMode() == TEXGEN_NONE ) 
+	SetTextureCoordinates ( stageID, textureUnit.CoordinateSet(), textureUnit.CoordinateGenMode() );
+
+	m_shadowStages[stageID].valid = true;
+}
+//End StateManager::SyncRendererTextureUnit
+
+
+
+//=========================================================================
+//! @function    StateManager::ShadowMatches
+//! @brief       Compare a value against its shadow copy, and update the shadow
+//!				 copy and the call counts
+//!              
+//! @param       shadow		 [in/out] Shadow copy of the value last sent to the renderer
+//! @param       value		 [in]	  New value
+//! @param       shadowValid [in]	  false if the shadow copy can't be trusted
+//!              
+//! @return      true if the renderer already has the value, and the call can be skipped
+//=========================================================================
+template <class T>
+bool StateManager::ShadowMatches ( T& shadow, const T& value, bool shadowValid )
+{
+	if ( shadowValid && ( shadow == value ) )
+	{
+		++m_frameStatistics.callsAvoided;
+		return true;
+	}
+
+	shadow = value;
+	++m_frameStatistics.callsIssued;
+	return false;
+}
+//End StateManager::ShadowMatches
+
+
+
+//=========================================================================
+//! @function    StateManager::SetMaterial
+//! @brief       Set the renderer's material, if it differs from the current one
+//=========================================================================
+void StateManager::SetMaterial ( const Material& material )
+{
+	if ( !ShadowMatches ( m_shadow.material, material, m_shadowValid ) )
+	{
+		m_renderer.SetMaterial ( material );
+	}
+}
+//End StateManager::SetMaterial
+
+
+
+//=========================================================================
+//! @function    StateManager::SetMaterialColourSource
+//! @brief       Set a material colour source, if it differs from the current one
+//=========================================================================
+void StateManager::SetMaterialColourSource ( EMaterialSourceType sourceType, EMaterialSource source )
+{
+	if ( !ShadowMatches ( m_shadow.materialSources[sourceType], source, m_shadowValid ) )
+	{
+		m_renderer.SetMaterialColourSource ( sourceType, source );
+	}
+}
+//End StateManager::SetMaterialColourSource
+
+
+
+//=========================================================================
+//! @function    StateManager::SetRenderState
+//! @brief       Set a boolean render state, if it differs from the current value
+//=========================================================================
+void StateManager::SetRenderState ( EBoolStateID stateID, bool value )
+{
+	if ( !ShadowMatches ( m_shadow.boolStates[stateID], value, m_shadowValid ) )
+	{
+		m_renderer.SetRenderState ( stateID, value );
+	}
+}
+//End StateManager::SetRenderState ( EBoolStateID, bool )
+
+
+
+//=========================================================================
+//! @function    StateManager::SetRenderState
+//! @brief       Set an integer render state, if it differs from the current value
+//=========================================================================
+void StateManager::SetRenderState ( EUIntStateID stateID, UInt value )
+{
+	if ( !ShadowMatches ( m_shadow.uintStates[stateID], value, m_shadowValid ) )
+	{
+		m_renderer.SetRenderState ( stateID, value );
+	}
+}
+//End StateManager::SetRenderState ( EUIntStateID, UInt )
+
+
+
+//=========================================================================
+//! @function    StateManager::SetRenderState
+//! @brief       Set a floating point render state, if it differs from the current value
+//=========================================================================
+void StateManager::SetRenderState ( EFloatStateID stateID, Float value )
+{
+	if ( !ShadowMatches ( m_shadow.floatStates[stateID], value, m_shadowValid ) )
+	{
+		m_renderer.SetRenderState ( stateID, value );
+	}
+}
+//End StateManager::SetRenderState ( EFloatStateID, Float )
+
+
+
+//=========================================================================
+//! @function    StateManager::SetColour
+//! @brief       Set a colour render state, if it differs from the current value
+//=========================================================================
+void StateManager::SetColour ( EColourStateID stateID, const Colour4f& value )
+{
+	if ( !ShadowMatches ( m_shadow.colourStates[stateID], value, m_shadowValid ) )
+	{
+		m_renderer.SetColour ( stateID, value );
+	}
+}
+//End StateManager::SetColour
+
+
+
+//=========================================================================
+//! @function    StateManager::SetBlendOp
+//! @brief       Set the blend op, if it differs from the current one
+//=========================================================================
+void StateManager::SetBlendOp ( EBlendOp op )
+{
+	if ( !ShadowMatches ( m_shadow.blendOp, op, m_shadowValid ) )
+	{
+		m_renderer.SetBlendOp ( op );
+	}
+}
+//End StateManager::SetBlendOp
+
+
+
+//=========================================================================
+//! @function    StateManager::SetBlendFunc
+//! @brief       Set the blend function, if either blend mode differs from 
+//!				 the current ones
+//=========================================================================
+void StateManager::SetBlendFunc ( EBlendMode src, EBlendMode dst )
+{
+	if ( m_shadowValid && ( m_shadow.sourceBlend == src ) && ( m_shadow.destBlend == dst ) )
+	{
+		++m_frameStatistics.callsAvoided;
+		return;
+	}
+
+	m_shadow.sourceBlend = src;
+	m_shadow.destBlend = dst;
+	++m_frameStatistics.callsIssued;
+
+	m_renderer.SetBlendFunc ( src, dst );
+}
+//End StateManager::SetBlendFunc
+
+
+
+//=========================================================================
+//! @function    StateManager::SetDepthFunc
+//! @brief       Set the depth comparison function, if it differs from the current one
+//=========================================================================
+void StateManager::SetDepthFunc ( ECmpFunc cmp )
+{
+	if ( !ShadowMatches ( m_shadow.depthFunc, cmp, m_shadowValid ) )
+	{
+		m_renderer.SetDepthFunc ( cmp );
+	}
+}
+//End StateManager::SetDepthFunc
+
+
+
+//=========================================================================
+//! @function    StateManager::SetAlphaFunc
+//! @brief       Set the alpha comparison function, if it differs from the current one
+//=========================================================================
+void StateManager::SetAlphaFunc ( ECmpFunc cmp )
+{
+	if ( !ShadowMatches ( m_shadow.alphaFunc, cmp, m_shadowValid ) )
+	{
+		m_renderer.SetAlphaFunc ( cmp );
+	}
+}
+//End StateManager::SetAlphaFunc
+
+
+
+//=========================================================================
+//! @function    StateManager::SetStencilFunc
+//! @brief       Set the stencil comparison function, if it differs from the current one
+//=========================================================================
+void StateManager::SetStencilFunc ( ECmpFunc cmp )
+{
+	if ( !ShadowMatches ( m_shadow.stencilFunc, cmp, m_shadowValid ) )
+	{
+		m_renderer.SetStencilFunc ( cmp );
+	}
+}
+//End StateManager::SetStencilFunc
+
+
+
+//=========================================================================
+//! @function    StateManager::SetStencilOp
+//! @brief       Set a stencil operation, if it differs from the current one
+//=========================================================================
+void StateManager::SetStencilOp ( EStencilOpType type, EStencilOp op )
+{
+	if ( !ShadowMatches ( m_shadow.stencilOps[type], op, m_shadowValid ) )
+	{
+		m_renderer.SetStencilOp ( type, op );
+	}
+}
+//End StateManager::SetStencilOp
+
+
+
+//=========================================================================
+//! @function    StateManager::SetFogMode
+//! @brief       Set the fog mode, if it differs from the current one
+//=========================================================================
+void StateManager::SetFogMode ( EFogType type, EFogMode mode )
+{
+	if ( !ShadowMatches ( m_shadow.fogModes[type], mode, m_shadowValid ) )
+	{
+		m_renderer.SetFogMode ( type, mode );
+	}
+}
+//End StateManager::SetFogMode
+
+
+
+//=========================================================================
+//! @function    StateManager::SetShadeMode
+//! @brief       Set the shade mode, if it differs from the current one
+//=========================================================================
+void StateManager::SetShadeMode ( EShadeMode mode )
+{
+	if ( !ShadowMatches ( m_shadow.shadeMode, mode, m_shadowValid ) )
+	{
+		m_renderer.SetShadeMode ( mode );
+	}
+}
+//End StateManager::SetShadeMode
+
+
+
+//=========================================================================
+//! @function    StateManager::SetCullingMode
+//! @brief       Set the culling mode, if it differs from the current one
+//=========================================================================
+void StateManager::SetCullingMode ( ECullMode mode )
+{
+	if ( !ShadowMatches ( m_shadow.cullMode, mode, m_shadowValid ) )
+	{
+		m_renderer.SetCullingMode ( mode );
+	}
+}
+//End StateManager::SetCullingMode
+
+
+
+//=========================================================================
+//! @function    StateManager::BindTexture
+//! @brief       Bind a normal texture to a texture stage, if it isn't already bound
+//!              
+//! @param       stageID [in] Texture stage to bind to
+//! @param       texture [in] Texture to bind. May be a null handle
+//!              
+//=========================================================================
+void StateManager::BindTexture ( ETextureStageID stageID, HTexture texture )
+{
+	ShadowTextureStage& stage = m_shadowStages[stageID];
+
+	//Stop the autogen manager from rebinding to this stage
+	m_autogenManager.UnbindAutogenTexture ( stageID );
+
+	if ( stage.valid && ( stage.autogenID == 0 ) && ( stage.texture.Value() == texture.Value() ) )
+	{
+		++m_frameStatistics.callsAvoided;
+		return;
+	}
+
+	stage.autogenID = 0;
+	stage.texture = texture;
+	++m_frameStatistics.callsIssued;
+
+	m_renderer.Bind ( texture, stageID );
+}
+//End StateManager::BindTexture
+
+
+
+//=========================================================================
+//! @function    StateManager::BindAutogenTexture
+//! @brief       Bind an autogenerated texture to a texture stage, if it isn't already bound
+//!              
+//!				 While the binding is in place, the autogen texture manager 
+//!				 rebinds the stage itself when the texture is regenerated
+//!              
+//! @param       stageID	[in] Texture stage to bind to
+//! @param       textureID	[in] Autogen texture ID
+//!              
+//=========================================================================
+void StateManager::BindAutogenTexture ( ETextureStageID stageID, UInt textureID )
+{
+	ShadowTextureStage& stage = m_shadowStages[stageID];
+
+	if ( stage.valid && ( stage.autogenID == textureID ) )
+	{
+		++m_frameStatistics.callsAvoided;
+		return;
+	}
+
+	stage.autogenID = textureID;
+	stage.texture = Core::NullHandle();
+	++m_frameStatistics.callsIssued;
+
+	m_autogenManager.BindAutogenTexture ( stageID, textureID );
+}
+//End StateManager::BindAutogenTexture
+
+
+
+//=========================================================================
+//! @function    StateManager::SetTextureMatrix
+//! @brief       Set a texture stage's matrix, if it differs from the current one
+//=========================================================================
+void StateManager::SetTextureMatrix ( ETextureStageID stageID, const Math::Matrix4x4& matrix )
+{
+	ShadowTextureStage& stage = m_shadowStages[stageID];
+
+	if ( !ShadowMatches ( stage.matrix, matrix, stage.valid ) )
+	{
+		m_renderer.SetMatrix ( static_cast<EMatrixType>(MAT_TEXTURE0 + stageID), matrix );
+	}
+}
+//End StateManager::SetTextureMatrix
+
+
+
+//=========================================================================
+//! @function    StateManager::SetTextureStageState
+//! @brief       Set a texture stage state, if it differs from the current value
+//=========================================================================
+void StateManager::SetTextureStageState ( ETextureStageID stageID, ETextureStageStateID stateID, UInt value )
+{
+	ShadowTextureStage& stage = m_shadowStages[stageID];
+
+	if ( !ShadowMatches ( stage.stageStates[stateID], value, stage.valid ) )
+	{
+		m_renderer.SetTextureStageState ( stageID, stateID, value );
+	}
+}
+//End StateManager::SetTextureStageState
+
+
+
+//=========================================================================
+//! @function    StateManager::SetTextureFilter
+//! @brief       Set a texture filter, if it differs from the current one
+//=========================================================================
+void StateManager::SetTextureFilter ( ETextureStageID stageID, ETextureFilterType type, ETextureFilter filter )
+{
+	ShadowTextureStage& stage = m_shadowStages[stageID];
+
+	if ( !ShadowMatches ( stage.filters[type], filter, stage.valid ) )
+	{
+		m_renderer.SetTextureFilter ( stageID, type, filter );
+	}
+}
+//End StateManager::SetTextureFilter
+
+
+
+//=========================================================================
+//! @function    StateManager::SetTextureParameter
+//! @brief       Set a texture parameter, if it differs from the current value
+//=========================================================================
+void StateManager::SetTextureParameter ( ETextureStageID stageID, ETextureParamType type, UInt value )
+{
+	ShadowTextureStage& stage = m_shadowStages[stageID];
+
+	if ( !ShadowMatches ( stage.parameters[type], value, stage.valid ) )
+	{
+		m_renderer.SetTextureParameter ( stageID, type, value );
+	}
+}
+//End StateManager::SetTextureParameter
+
+
+
+//=========================================================================
+//! @function    StateManager::SetTextureStageConstantColour
+//! @brief       Set a texture stage's constant colour, if it differs from the current one
+//=========================================================================
+void StateManager::SetTextureStageConstantColour ( ETextureStageID stageID, const Colour4f& colour )
+{
+	ShadowTextureStage& stage = m_shadowStages[stageID];
+
+	if ( !ShadowMatches ( stage.constantColour, colour, stage.valid ) )
+	{
+		m_renderer.SetTextureStageConstantColour ( stageID, colour );
+	}
+}
+//End StateManager::SetTextureStageConstantColour
+
+
+
+//=========================================================================
+//! @function    StateManager::SetTextureAddressingMode
+//! @brief       Set a texture addressing mode, if it differs from the current one
+//=========================================================================
+void StateManager::SetTextureAddressingMode ( ETextureStageID stageID, ETextureAddressModeType type, 
+											  ETextureAddressingMode mode )
+{
+	ShadowTextureStage& stage = m_shadowStages[stageID];
+
+	if ( !ShadowMatches ( stage.addressingModes[type], mode, stage.valid ) )
+	{
+		m_renderer.SetTextureAddressingMode ( stageID, type, mode );
+	}
+}
+//End StateManager::SetTextureAddressingMode
+
+
+
+//=========================================================================
+//! @function    StateManager::SetTextureCoordinates
+//! @brief       Set the texture coordinate set and generation mode for a stage,
+//!				 if either differs from the current ones
+//!              
+//!				 Both are set through the same device state, so they are 
+//!				 shadowed together
+//!              
+//! @param       stageID		[in] Texture stage
+//! @param       coordinateSet	[in] Texture coordinate set
+//! @param       mode			[in] Texture coordinate generation mode, TEXGEN_NONE to 
+//!									 use the coordinate set unmodified
+//!              
+//=========================================================================
+void StateManager::SetTextureCoordinates ( ETextureStageID stageID, UInt coordinateSet, ETextureCoordGen mode )
+{
+	ShadowTextureStage& stage = m_shadowStages[stageID];
+
+	if ( stage.valid && ( stage.coordinateSet == coordinateSet ) && ( stage.coordinateGenMode == mode ) )
+	{
+		++m_frameStatistics.callsAvoided;
+		return;
+	}
+
+	stage.coordinateSet = coordinateSet;
+	stage.coordinateGenMode = mode;
+	++m_frameStatistics.callsIssued;
+
+	if ( mode == TEXGEN_NONE ) 
 	{
-		m_renderer.SetTextureStageState ( stageID, TEXSTAGE_TEXCOORDINDEX,
-											textureUnit.CoordinateSet() );
+		m_renderer.SetTextureStageState ( stageID, TEXSTAGE_TEXCOORDINDEX, coordinateSet );
 	}
 	else
 	{
-		m_renderer.SetTextureCoordGeneration ( stageID, textureUnit.CoordinateSet(),
-												textureUnit.CoordinateGenMode() );
+		m_renderer.SetTextureCoordGeneration ( stageID, coordinateSet, mode );
 	}
 }
-//End StateManager::SyncRendererTextureUnit
\ No newline at end of file
+//End StateManager::SetTextureCoordinates
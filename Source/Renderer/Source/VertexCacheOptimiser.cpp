@@ -0,0 +1,371 @@
+//======================================================================================
+//! @file         VertexCacheOptimiser.cpp
+//! @brief        Reorders triangle lists for the post transform vertex cache
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+#include <cmath>
+#include <algorithm>
+#include "Core/Core.h"
+#include "Math/MeshUtility.h"
+#include "Renderer/VertexCacheOptimiser.h"
+
+
+using namespace Renderer;
+
+
+
+//namespace
+namespace
+{
+	//Scoring constants, from Forsyth's "Linear-Speed Vertex Cache Optimisation"
+	const UInt	simulatedCacheSize = 32;
+	const Float	cacheDecayPower = 1.5f;
+	const Float	lastTriangleScore = 0.75f;
+	const Float	valenceBoostScale = 2.0f;
+	const Float	valenceBoostPower = 0.5f;
+
+	const UInt	noTriangle = 0xFFFFFFFF;
+	const UInt	noVertex = 0xFFFFFFFF;
+}
+//end namespace
+
+
+
+//=========================================================================
+//! @function    VertexCacheOptimiser::VertexCacheOptimiser
+//! @brief       VertexCacheOptimiser constructor
+//=========================================================================
+VertexCacheOptimiser::VertexCacheOptimiser ( )
+{
+}
+//End VertexCacheOptimiser::VertexCacheOptimiser
+
+
+
+//=========================================================================
+//! @function    VertexCacheOptimiser::VertexScore
+//! @brief       Score a vertex by its position in the simulated cache, and
+//!				 the number of triangles it has left to draw
+//!              
+//! @param       vertex [in] Index of the vertex
+//!              
+//! @return      The score of the vertex, or -1 if it has no triangles left
+//=========================================================================
+Float VertexCacheOptimiser::VertexScore ( UInt vertex ) const
+{
+	if ( m_activeTriangleCount[vertex] == 0 )
+	{
+		return -1.0f;
+	}
+
+	Float score = 0.0f;
+	const Int position = m_cachePosition[vertex];
+
+	if ( position >= 0 )
+	{
+		if ( position < 3 )
+		{
+			//The vertices of the last triangle get a fixed score, so that the next triangle 
+			//isn't too strongly biased towards any one of its edges
+			score = lastTriangleScore;
+		}
+		else
+		{
+			const Float scale = 1.0f / (simulatedCacheSize - 3);
+			score = std::pow ( 1.0f - ((position - 3) * scale), cacheDecayPower );
+		}
+	}
+
+	//Boost vertices with few triangles left, so that lone triangles get drawn rather than left behind
+	score += valenceBoostScale * std::pow ( static_cast<Float>(m_activeTriangleCount[vertex]), -valenceBoostPower );
+
+	return score;
+}
+//End VertexCacheOptimiser::VertexScore
+
+
+
+//=========================================================================
+//! @function    VertexCacheOptimiser::OptimiseTriangleOrder
+//! @brief       Reorder the triangles of a triangle list for the vertex cache
+//!              
+//! @param       indices	 [in,out] Indices of the triangle list
+//! @param       indexCount	 [in]	  Number of indices. A multiple of three
+//! @param       vertexCount [in]	  Number of vertices the indices refer to
+//=========================================================================
+void VertexCacheOptimiser::OptimiseTriangleOrder ( UInt16* indices, UInt indexCount, UInt vertexCount )
+{
+	debug_assert ( (indexCount % 3) == 0, "Index count isn't a whole number of triangles!" );
+
+	const UInt triangleCount = indexCount / 3;
+
+	if ( triangleCount == 0 )
+	{
+		return;
+	}
+
+	//Gather the triangles that use each vertex. Every one of them is still to be added
+	Math::BuildVertexTriangleAdjacency ( indices, indexCount, vertexCount, m_triangleStart, m_triangles );
+
+	for ( UInt index = 0; index < indexCount; ++index )
+	{
+		m_triangles[index] /= 3;
+	}
+
+	m_activeTriangleCount.resize ( vertexCount );
+
+	for ( UInt vertex = 0; vertex < vertexCount; ++vertex )
+	{
+		m_activeTriangleCount[vertex] = m_triangleStart[vertex + 1] - m_triangleStart[vertex];
+	}
+
+	//Initial scores, with an empty cache
+	m_cachePosition.assign ( vertexCount, -1 );
+	m_vertexScore.resize ( vertexCount );
+
+	for ( UInt vertex = 0; vertex < vertexCount; ++vertex )
+	{
+		m_vertexScore[vertex] = VertexScore ( vertex );
+	}
+
+	m_triangleScore.resize ( triangleCount );
+	m_triangleAdded.assign ( triangleCount, false );
+
+	UInt  bestTriangle = noTriangle;
+	Float bestScore = -1.0f;
+
+	for ( UInt triangle = 0; triangle < triangleCount; ++triangle )
+	{
+		m_triangleScore[triangle] = m_vertexScore[indices[triangle * 3]]
+								  + m_vertexScore[indices[(triangle * 3) + 1]]
+								  + m_vertexScore[indices[(triangle * 3) + 2]];
+
+		if ( m_triangleScore[triangle] > bestScore )
+		{
+			bestScore = m_triangleScore[triangle];
+			bestTriangle = triangle;
+		}
+	}
+
+	m_output.resize ( indexCount );
+	m_cache.clear();
+
+	UInt outputTriangle = 0;
+	UInt firstUnadded = 0;
+
+	while ( bestTriangle != noTriangle )
+	{
+		m_triangleAdded[bestTriangle] = true;
+		m_nextCache.clear();
+
+		for ( UInt corner = 0; corner < 3; ++corner )
+		{
+			const UInt vertex = indices[(bestTriangle * 3) + corner];
+
+			m_output[(outputTriangle * 3) + corner] = static_cast<UInt16>(vertex);
+
+			//Move the triangle out of the vertex's active triangles
+			UInt* triangles = &m_triangles[m_triangleStart[vertex]];
+			UInt& activeCount = m_activeTriangleCount[vertex];
+
+			for ( UInt active = 0; active < activeCount; ++active )
+			{
+				if ( triangles[active] == bestTriangle )
+				{
+					std::swap ( triangles[active], triangles[activeCount - 1] );
+					break;
+				}
+			}
+
+			--activeCount;
+
+			if ( std::find ( m_nextCache.begin(), m_nextCache.end(), vertex ) == m_nextCache.end() )
+			{
+				m_nextCache.push_back ( vertex );
+			}
+		}
+
+		++outputTriangle;
+
+		//The triangle's vertices go to the front of the cache, pushing the rest back
+		const UInt addedCount = m_nextCache.size();
+
+		for ( UInt entry = 0; entry < m_cache.size(); ++entry )
+		{
+			const UInt vertex = m_cache[entry];
+
+			if ( std::find ( &m_nextCache[0], &m_nextCache[0] + addedCount, vertex ) == (&m_nextCache[0] + addedCount) )
+			{
+				m_nextCache.push_back ( vertex );
+			}
+		}
+
+		//Rescore every vertex that moved, including the ones that fell out of the cache
+		for ( UInt entry = 0; entry < m_nextCache.size(); ++entry )
+		{
+			const UInt vertex = m_nextCache[entry];
+
+			m_cachePosition[vertex] = (entry < simulatedCacheSize) ? static_cast<Int>(entry) : -1;
+			m_vertexScore[vertex] = VertexScore ( vertex );
+		}
+
+		//Rescore their triangles, and pick the best one to add next
+		bestTriangle = noTriangle;
+		bestScore = -1.0f;
+
+		for ( UInt entry = 0; entry < m_nextCache.size(); ++entry )
+		{
+			const UInt vertex = m_nextCache[entry];
+			const UInt* triangles = &m_triangles[m_triangleStart[vertex]];
+
+			for ( UInt active = 0; active < m_activeTriangleCount[vertex]; ++active )
+			{
+				const UInt triangle = triangles[active];
+
+				m_triangleScore[triangle] = m_vertexScore[indices[triangle * 3]]
+										  + m_vertexScore[indices[(triangle * 3) + 1]]
+										  + m_vertexScore[indices[(triangle * 3) + 2]];
+
+				if ( m_triangleScore[triangle] > bestScore )
+				{
+					bestScore = m_triangleScore[triangle];
+					bestTriangle = triangle;
+				}
+			}
+		}
+
+		if ( m_nextCache.size() > simulatedCacheSize )
+		{
+			m_nextCache.resize ( simulatedCacheSize );
+		}
+
+		m_cache.swap ( m_nextCache );
+
+		//Nothing in the cache has triangles left, so start again from any triangle that's left
+		if ( bestTriangle == noTriangle )
+		{
+			while ( (firstUnadded < triangleCount) && m_triangleAdded[firstUnadded] )
+			{
+				++firstUnadded;
+			}
+
+			if ( firstUnadded < triangleCount )
+			{
+				bestTriangle = firstUnadded;
+			}
+		}
+	}
+
+	debug_assert ( outputTriangle == triangleCount, "Not every triangle was added!" );
+
+	std::copy ( m_output.begin(), m_output.end(), indices );
+}
+//End VertexCacheOptimiser::OptimiseTriangleOrder
+
+
+
+//=========================================================================
+//! @function    VertexCacheOptimiser::ReorderVertices
+//! @brief       Renumber vertices in the order that the indices first use them,
+//!				 so that the vertices are fetched in order
+//!              
+//!				 Vertices that aren't used go after the used ones. The caller
+//!				 has to move the vertices to match.
+//!
+//! @param       indices		  [in,out] Indices to renumber
+//! @param       indexCount		  [in]	   Number of indices
+//! @param       vertexCount	  [in]	   Number of vertices
+//! @param       newVertexIndices [out]	   New index of each vertex
+//=========================================================================
+void VertexCacheOptimiser::ReorderVertices ( UInt16* indices, UInt indexCount, UInt vertexCount, 
+											 std::vector<UInt>& newVertexIndices )
+{
+	newVertexIndices.assign ( vertexCount, noVertex );
+
+	UInt nextVertex = 0;
+
+	for ( UInt index = 0; index < indexCount; ++index )
+	{
+		debug_assert ( indices[index] < vertexCount, "Index is out of range!" );
+
+		UInt& newIndex = newVertexIndices[indices[index]];
+
+		if ( newIndex == noVertex )
+		{
+			newIndex = nextVertex++;
+		}
+
+		indices[index] = static_cast<UInt16>(newIndex);
+	}
+
+	for ( UInt vertex = 0; vertex < vertexCount; ++vertex )
+	{
+		if ( newVertexIndices[vertex] == noVertex )
+		{
+			newVertexIndices[vertex] = nextVertex++;
+		}
+	}
+}
+//End VertexCacheOptimiser::ReorderVertices
+
+
+
+//=========================================================================
+//! @function    VertexCacheOptimiser::ACMR
+//! @brief       Average cache miss ratio of a triangle list, the number of vertices
+//!				 transformed per triangle, with a FIFO vertex cache
+//!              
+//!				 The best possible is about 0.5 for a regular grid, and the worst is 3.
+//!
+//! @param       indices	[in] Indices of the triangle list
+//! @param       indexCount	[in] Number of indices
+//! @param       cacheSize	[in] Number of entries in the FIFO cache
+//!              
+//! @return      Cache misses per triangle
+//=========================================================================
+Float VertexCacheOptimiser::ACMR ( const UInt16* indices, UInt indexCount, UInt cacheSize )
+{
+	if ( indexCount < 3 )
+	{
+		return 0.0f;
+	}
+
+	std::vector<UInt> cache ( cacheSize, noVertex );
+	UInt next = 0;
+	UInt misses = 0;
+
+	for ( UInt index = 0; index < indexCount; ++index )
+	{
+		if ( std::find ( cache.begin(), cache.end(), indices[index] ) == cache.end() )
+		{
+			++misses;
+			cache[next] = indices[index];
+			next = (next + 1) % cacheSize;
+		}
+	}
+
+	return static_cast<Float>(misses) / static_cast<Float>(indexCount / 3);
+}
+//End VertexCacheOptimiser::ACMR
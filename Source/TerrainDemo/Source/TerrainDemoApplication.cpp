@@ -34,6 +34,7 @@
 #include "Renderer/FontManager.h"
 #include "Renderer/TexturePrecacheList.h"
 #include "Renderer/EffectManager.h"
+#include "Renderer/StateManager.h"
 #include "OidFX/GameApplication.h"
 #include "OidFX/Scene.h"
 #include "OidFX/Camera.h"
@@ -227,6 +228,13 @@ void TerrainDemoApplication::PostRender ( )
 			debugInfo.str("");
 			debugInfo << OidFX::TerrainChunkNode::NodesRenderedThisFrame() << " terrain chunks rendered" << std::endl;
 			m_font->WriteText ( debugInfo.str().c_str(), 50.0f, GetRenderer().ScreenHeight() - 50.0f );
+
+			//Display the number of render state changes made, and filtered out, last frame
+			const Renderer::StateManager::Statistics& stateStatistics = GetStateManager().LastFrameStatistics();
+			debugInfo.str("");
+			debugInfo << stateStatistics.callsIssued << " state changes, " 
+					  << stateStatistics.callsAvoided << " avoided" << std::endl;
+			m_font->WriteText ( debugInfo.str().c_str(), 50.0f, GetRenderer().ScreenHeight() - 150.0f );
 		}
 
 	GetRenderer().Exit2DMode();
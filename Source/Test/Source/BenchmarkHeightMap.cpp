@@ -0,0 +1,195 @@
+//======================================================================================
+//! @file         BenchmarkHeightMap.cpp
+//! @brief        Benchmarks for the heightmap loader
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstdio>
+#include "Core/Core.h"
+#include "Core/Timer.h"
+#include "Core/HeightMap.h"
+#include "Math/Math.h"
+#include "BenchmarkHeightMap.h"
+#include "BenchmarkUtility.h"
+
+
+//namespace
+namespace
+{
+
+	const UInt		 heightmapSize = 1025;
+	const UInt		 loadIterations = 10;
+	const UInt		 convertIterations = 200;
+	const Float		 maxHeight = 8000.0f;
+	const Char*	 heightmap8FileName = "BenchmarkHeightMap8.raw";
+	const Char*	 heightmap16FileName = "BenchmarkHeightMap16.raw";
+
+
+	//=========================================================================
+    //! @function    WriteTestHeightMap
+    //! @brief       Write a heightmap with a repeating pattern of samples
+    //=========================================================================
+	void WriteTestHeightMap ( const Char* fileName, UInt bytesPerSample )
+	{
+		std::ofstream file ( fileName, std::ios::binary );
+
+		for ( UInt i = 0; i < (heightmapSize * heightmapSize); ++i )
+		{
+			for ( UInt byte = 0; byte < bytesPerSample; ++byte )
+			{
+				file.put ( static_cast<Char>((i * 7) + (byte * 13)) );
+			}
+		}
+	}
+	//End WriteTestHeightMap
+
+
+	//=========================================================================
+    //! @function    LoadHeightMapPerByte
+    //! @brief       The old TerrainNode loader, one read and push_back per byte
+    //=========================================================================
+	void LoadHeightMapPerByte ( const Char* fileName, std::vector<Float>& heights )
+	{
+		std::ifstream heightFile ( fileName, std::ios::binary );
+
+		heightFile.seekg( 0, std::ios_base::end );
+		UInt bytesToRead = heightFile.tellg();
+		heightFile.seekg( 0, std::ios_base::beg );
+
+		heights.clear();
+		heights.reserve ( bytesToRead );
+
+		while ( heightFile && bytesToRead )
+		{
+			UChar heightVal = 0;
+
+			heightFile.read ( (std::istream::char_type*)(&heightVal), 1);
+			heights.push_back ( (static_cast<Float>(heightVal) / 255.0f) * maxHeight );
+
+			--bytesToRead;
+		}
+	}
+	//End LoadHeightMapPerByte
+
+}
+//end namespace
+
+
+
+//=========================================================================
+//! @function    BenchmarkHeightMap
+//! @brief       Compare the old per byte heightmap loader with Core::HeightMap,
+//!				 and check that they produce the same heights
+//=========================================================================
+void BenchmarkHeightMap()
+{
+
+	std::cout << "Heightmap benchmark, " << heightmapSize << "x" << heightmapSize << std::endl;
+	std::cout << "=================================================" << std::endl;
+
+	WriteTestHeightMap ( heightmap8FileName, 1 );
+	WriteTestHeightMap ( heightmap16FileName, 2 );
+
+	Core::Timer timer;
+	std::vector<Float> oldHeights;
+	Core::HeightMap heightMap;
+
+	//Loading
+	timer.Update();
+	for ( UInt i = 0; i < loadIterations; ++i )
+	{
+		LoadHeightMapPerByte ( heightmap8FileName, oldHeights );
+	}
+	ReportTime ( "8 bit, ifstream per byte", timer.Update(), loadIterations );
+
+	for ( UInt i = 0; i < loadIterations; ++i )
+	{
+		heightMap.Load ( heightmap8FileName, Core::HeightMap::FORMAT_AUTO, maxHeight );
+	}
+	ReportTime ( "8 bit, HeightMap::Load", timer.Update(), loadIterations );
+
+	debug_assert ( heightMap.Format() == Core::HeightMap::FORMAT_UINT8, "Test failed! 8 bit heightmap detected as the wrong format" );
+	debug_assert ( heightMap.Size() == heightmapSize, "Test failed! Heightmap size is wrong" );
+
+	for ( UInt i = 0; i < oldHeights.size(); ++i )
+	{
+		debug_assert ( Math::Abs ( oldHeights[i] - heightMap.Heights()[i] ) < 0.01f, "Test failed! Heights differ from the old loader" );
+	}
+
+	for ( UInt i = 0; i < loadIterations; ++i )
+	{
+		heightMap.Load ( heightmap16FileName, Core::HeightMap::FORMAT_AUTO, maxHeight );
+	}
+	ReportTime ( "16 bit, HeightMap::Load", timer.Update(), loadIterations );
+
+	debug_assert ( heightMap.Format() == Core::HeightMap::FORMAT_UINT16, "Test failed! 16 bit heightmap detected as the wrong format" );
+
+	//Conversion kernels on their own, from data that's already in memory
+	const UInt sampleCount = heightmapSize * heightmapSize;
+	std::vector<Byte>  source ( sampleCount * 4 );
+	std::vector<Float> dest ( sampleCount );
+
+	for ( UInt i = 0; i < source.size(); ++i )
+	{
+		source[i] = static_cast<Byte>(i * 7);
+	}
+
+	timer.Update();
+	for ( UInt i = 0; i < convertIterations; ++i )
+	{
+		for ( UInt sample = 0; sample < sampleCount; ++sample )
+		{
+			dest[sample] = (static_cast<Float>(source[sample]) / 255.0f) * maxHeight;
+		}
+	}
+	ReportTime ( "8 bit, scalar loop", timer.Update(), convertIterations );
+
+	for ( UInt i = 0; i < convertIterations; ++i )
+	{
+		Core::HeightMap::ConvertUInt8 ( &source[0], &dest[0], sampleCount, maxHeight / 255.0f );
+	}
+	ReportTime ( "8 bit, HeightMap::ConvertUInt8", timer.Update(), convertIterations );
+
+	for ( UInt i = 0; i < convertIterations; ++i )
+	{
+		Core::HeightMap::ConvertUInt16 ( &source[0], &dest[0], sampleCount, maxHeight / 65535.0f );
+	}
+	ReportTime ( "16 bit, HeightMap::ConvertUInt16", timer.Update(), convertIterations );
+
+	for ( UInt i = 0; i < convertIterations; ++i )
+	{
+		Core::HeightMap::ConvertFloat32 ( &source[0], &dest[0], sampleCount, maxHeight );
+	}
+	ReportTime ( "float, HeightMap::ConvertFloat32", timer.Update(), convertIterations );
+
+	std::remove ( heightmap8FileName );
+	std::remove ( heightmap16FileName );
+
+	std::cout << std::endl;
+}
+//End BenchmarkHeightMap
@@ -0,0 +1,314 @@
+//======================================================================================
+//! @file         BenchmarkMatrix.cpp
+//! @brief        Benchmark for the Matrix4x4 and vector transform kernels
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include "Core/Core.h"
+#include "Core/Timer.h"
+#include "Math/Math.h"
+#include "Math/Vector3D.h"
+#include "Math/Matrix4x4.h"
+#include "BenchmarkMatrix.h"
+#include "BenchmarkUtility.h"
+
+
+//namespace
+namespace
+{
+
+	//About the number of moving nodes in a busy scene
+	const UInt matrixCount = 4096;
+	const UInt pointCount = 65536;
+	const UInt iterations = 100;
+	const UInt invertIterations = 10;
+
+
+	//=========================================================================
+    //! @function    MultiplyScalar
+    //! @brief       The scalar Matrix4x4::operator *=, for comparison
+    //=========================================================================
+	void MultiplyScalar ( Math::Matrix4x4& lhs, const Math::Matrix4x4& rhs )
+	{
+		Math::Matrix4x4 result;
+
+		for ( UInt row = 0; row < 4; ++row )
+		{
+			for ( UInt col = 0; col < 4; ++col )
+			{
+				result(row, col) = (lhs(row, 0) * rhs(0, col)) + (lhs(row, 1) * rhs(1, col)) 
+								 + (lhs(row, 2) * rhs(2, col)) + (lhs(row, 3) * rhs(3, col));
+			}
+		}
+
+		lhs = result;
+	}
+	//End MultiplyScalar
+
+
+	//=========================================================================
+    //! @function    TransformScalar
+    //! @brief       The scalar Vector3D operator *= ( const Matrix4x4& ), for comparison
+    //=========================================================================
+	void TransformScalar ( Math::Vector3D& lhs, const Math::Matrix4x4& rhs )
+	{
+		Float x = lhs.X() * rhs(0,0) + lhs.Y() * rhs(1,0) + lhs.Z() * rhs(2,0) + lhs.W() * rhs(3,0);
+		Float y = lhs.X() * rhs(0,1) + lhs.Y() * rhs(1,1) + lhs.Z() * rhs(2,1) + lhs.W() * rhs(3,1);
+		Float z = lhs.X() * rhs(0,2) + lhs.Y() * rhs(1,2) + lhs.Z() * rhs(2,2) + lhs.W() * rhs(3,2);
+
+		lhs.Set ( x, y, z );
+	}
+	//End TransformScalar
+
+
+	//=========================================================================
+    //! @function    BuildTransforms
+    //! @brief       Build a set of scaled, rotated and translated matrices
+    //=========================================================================
+	void BuildTransforms ( std::vector<Math::Matrix4x4>& transforms )
+	{
+		transforms.resize ( matrixCount );
+
+		for ( UInt i = 0; i < matrixCount; ++i )
+		{
+			const Float f = static_cast<Float>(i);
+
+			Math::Matrix4x4::CreateScalingMatrix ( transforms[i], Math::Vector3D ( 1.0f + ((i % 3) * 0.5f), 1.0f, 2.0f ) );
+			transforms[i].Rotate ( Math::Vector3D ( 1.0f, f, 2.0f ).Normalise(), f * 0.01f );
+			transforms[i].Translate ( Math::Vector3D ( f, -f * 0.5f, 100.0f ) );
+		}
+	}
+	//End BuildTransforms
+
+
+	//=========================================================================
+    //! @function    MatricesMatch
+    //! @brief       Check that two matrices are equal, relative to the size of their largest element
+    //=========================================================================
+	bool MatricesMatch ( const Math::Matrix4x4& lhs, const Math::Matrix4x4& rhs )
+	{
+		Float scale = 1.0f;
+
+		for ( UInt row = 0; row < 4; ++row )
+		{
+			for ( UInt col = 0; col < 4; ++col )
+			{
+				scale = std::max ( scale, std::max ( Math::Abs(lhs(row, col)), Math::Abs(rhs(row, col)) ) );
+			}
+		}
+
+		for ( UInt row = 0; row < 4; ++row )
+		{
+			for ( UInt col = 0; col < 4; ++col )
+			{
+				if ( Math::Abs ( lhs(row, col) - rhs(row, col) ) > (scale * 0.001f) )
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+	//End MatricesMatch
+
+}
+//end namespace
+
+
+
+//=========================================================================
+//! @function    BenchmarkMatrix
+//! @brief       Compare the Matrix4x4 kernels with scalar versions of the same
+//!				 operations, and check that they agree
+//=========================================================================
+void BenchmarkMatrix()
+{
+
+#ifdef MATH_SSE
+	std::cout << "Matrix benchmark, SSE kernels, ";
+#else
+	std::cout << "Matrix benchmark, scalar kernels, ";
+#endif
+	std::cout << matrixCount << " matrices, " << pointCount << " points" << std::endl;
+	std::cout << "=================================================" << std::endl;
+
+	std::vector<Math::Matrix4x4> transforms;
+	BuildTransforms ( transforms );
+
+	std::vector<Math::Vector3D> points ( pointCount );
+
+	for ( UInt i = 0; i < pointCount; ++i )
+	{
+		points[i].Set ( static_cast<Float>(i % 101), static_cast<Float>(i % 37), static_cast<Float>(i % 13) );
+	}
+
+	Core::Timer timer;
+	Float checksum = 0.0f;
+
+	//Concatenate every transform onto a parent, as SceneNode::Update does
+	std::vector<Math::Matrix4x4> scalarResults ( transforms );
+	std::vector<Math::Matrix4x4> results ( transforms );
+
+	timer.Update();
+	for ( UInt i = 0; i < iterations; ++i )
+	{
+		for ( UInt matrix = 0; matrix < matrixCount; ++matrix )
+		{
+			scalarResults[matrix] = transforms[(matrix * 7) % matrixCount];
+			MultiplyScalar ( scalarResults[matrix], transforms[matrix] );
+		}
+	}
+	ReportTime ( "Matrix multiply, scalar", timer.Update(), iterations );
+
+	for ( UInt i = 0; i < iterations; ++i )
+	{
+		for ( UInt matrix = 0; matrix < matrixCount; ++matrix )
+		{
+			results[matrix] = transforms[(matrix * 7) % matrixCount];
+			results[matrix] *= transforms[matrix];
+		}
+	}
+	ReportTime ( "Matrix multiply, Matrix4x4", timer.Update(), iterations );
+
+	for ( UInt matrix = 0; matrix < matrixCount; ++matrix )
+	{
+		debug_assert ( MatricesMatch ( results[matrix], scalarResults[matrix] ), "Test failed! Matrix products differ" );
+		checksum += results[matrix](3, 0);
+	}
+
+	//Transform points one at a time, and as a batch
+	std::vector<Math::Vector3D> scalarPoints ( pointCount );
+	std::vector<Math::Vector3D> transformedPoints ( pointCount );
+	std::vector<Math::Vector3D> batchPoints ( pointCount );
+	const Math::Matrix4x4& pointTransform = transforms[matrixCount / 2];
+
+	for ( UInt i = 0; i < iterations; ++i )
+	{
+		for ( UInt point = 0; point < pointCount; ++point )
+		{
+			scalarPoints[point] = points[point];
+			TransformScalar ( scalarPoints[point], pointTransform );
+		}
+	}
+	ReportTime ( "Point transform, scalar", timer.Update(), iterations );
+
+	for ( UInt i = 0; i < iterations; ++i )
+	{
+		for ( UInt point = 0; point < pointCount; ++point )
+		{
+			transformedPoints[point] = points[point];
+			transformedPoints[point] *= pointTransform;
+		}
+	}
+	ReportTime ( "Point transform, operator *=", timer.Update(), iterations );
+
+	for ( UInt i = 0; i < iterations; ++i )
+	{
+		Math::TransformPoints ( &points[0], &batchPoints[0], pointCount, pointTransform );
+	}
+	ReportTime ( "Point transform, TransformPoints", timer.Update(), iterations );
+
+	for ( UInt point = 0; point < pointCount; ++point )
+	{
+		debug_assert ( (transformedPoints[point] - scalarPoints[point]).Length() < 0.01f, "Test failed! Transformed points differ" );
+		debug_assert ( (batchPoints[point] - scalarPoints[point]).Length() < 0.01f, "Test failed! Batch transformed points differ" );
+		debug_assert ( batchPoints[point].W() == 1.0f, "Test failed! Batch transformed point doesn't have w = 1" );
+		checksum += batchPoints[point].X();
+	}
+
+	//Invert every transform. Invert doesn't pivot, so it loses precision on some of these,
+	//and the affine inverse is checked against the identity instead of against Invert
+	std::vector<Math::Matrix4x4> inverses ( transforms );
+	std::vector<Math::Matrix4x4> affineInverses ( transforms );
+
+	for ( UInt i = 0; i < invertIterations; ++i )
+	{
+		for ( UInt matrix = 0; matrix < matrixCount; ++matrix )
+		{
+			inverses[matrix] = transforms[matrix];
+			inverses[matrix].Invert();
+		}
+	}
+	ReportTime ( "Invert", timer.Update(), invertIterations );
+
+	for ( UInt i = 0; i < invertIterations; ++i )
+	{
+		for ( UInt matrix = 0; matrix < matrixCount; ++matrix )
+		{
+			affineInverses[matrix] = transforms[matrix];
+			affineInverses[matrix].InvertAffine();
+		}
+	}
+	ReportTime ( "InvertAffine", timer.Update(), invertIterations );
+
+	for ( UInt matrix = 0; matrix < matrixCount; ++matrix )
+	{
+		debug_assert ( MatricesMatch ( transforms[matrix] * affineInverses[matrix], Math::Matrix4x4::IdentityMatrix ), 
+					   "Test failed! Affine inverse times matrix isn't the identity" );
+		checksum += affineInverses[matrix](3, 2) + inverses[matrix](3, 2);
+	}
+
+	//Rigid transforms, as EntityNode builds from its orientation and position
+	std::vector<Math::Matrix4x4> rigidTransforms ( matrixCount );
+	std::vector<Math::Matrix4x4> rigidInverses ( matrixCount );
+
+	for ( UInt matrix = 0; matrix < matrixCount; ++matrix )
+	{
+		const Float f = static_cast<Float>(matrix);
+		rigidTransforms[matrix].Identity();
+		rigidTransforms[matrix].Rotate ( Math::Vector3D ( 1.0f, f, 2.0f ).Normalise(), f * 0.01f );
+		rigidTransforms[matrix].Translate ( Math::Vector3D ( f, -f * 0.5f, 100.0f ) );
+	}
+
+	timer.Update();
+	for ( UInt i = 0; i < invertIterations; ++i )
+	{
+		for ( UInt matrix = 0; matrix < matrixCount; ++matrix )
+		{
+			rigidInverses[matrix] = rigidTransforms[matrix];
+			rigidInverses[matrix].InvertRigid();
+		}
+	}
+	ReportTime ( "InvertRigid", timer.Update(), invertIterations );
+
+	for ( UInt matrix = 0; matrix < matrixCount; ++matrix )
+	{
+		debug_assert ( MatricesMatch ( rigidTransforms[matrix] * rigidInverses[matrix], Math::Matrix4x4::IdentityMatrix ), 
+					   "Test failed! Rigid inverse times matrix isn't the identity" );
+		checksum += rigidInverses[matrix](3, 1);
+	}
+
+	Math::Matrix4x4 singular;
+	singular.Zero();
+	singular(3, 3) = 1.0f;
+	debug_assert ( !singular.InvertAffine(), "Test failed! Singular matrix was inverted" );
+
+	std::cout << "Checksum " << checksum << std::endl;
+	std::cout << std::endl;
+}
+//End BenchmarkMatrix
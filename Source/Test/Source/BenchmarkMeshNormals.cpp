@@ -0,0 +1,220 @@
+//======================================================================================
+//! @file         BenchmarkMeshNormals.cpp
+//! @brief        Benchmark for mesh vertex normal generation
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+#include <iostream>
+#include <vector>
+#include "Core/Core.h"
+#include "Core/Timer.h"
+#include "Math/Math.h"
+#include "Math/Vector3D.h"
+#include "Math/VertexNormalGenerator.h"
+#include "BenchmarkMeshNormals.h"
+#include "BenchmarkUtility.h"
+
+
+//namespace
+namespace
+{
+
+	//A grid of 101x101 vertices has 20000 triangles, about the size of a detailed model
+	const UInt gridSize = 101;
+	const UInt oldIterations = 1;
+	const UInt newIterations = 50;
+
+
+	//=========================================================================
+    //! @function    BuildGrid
+    //! @brief       Build a bumpy grid of vertices, two triangles per cell
+    //=========================================================================
+	void BuildGrid ( std::vector<Math::Vector3D>& positions, std::vector<UInt>& indices )
+	{
+		positions.clear();
+		indices.clear();
+
+		for ( UInt row = 0; row < gridSize; ++row )
+		{
+			for ( UInt col = 0; col < gridSize; ++col )
+			{
+				Float height = static_cast<Float>((row * 7 + col * 13) % 5);
+				positions.push_back ( Math::Vector3D ( static_cast<Float>(col), height, static_cast<Float>(row) ) );
+			}
+		}
+
+		for ( UInt row = 0; row < (gridSize - 1); ++row )
+		{
+			for ( UInt col = 0; col < (gridSize - 1); ++col )
+			{
+				UInt topLeft = col + (row * gridSize);
+
+				indices.push_back ( topLeft );
+				indices.push_back ( topLeft + gridSize );
+				indices.push_back ( topLeft + 1 );
+
+				indices.push_back ( topLeft + 1 );
+				indices.push_back ( topLeft + gridSize );
+				indices.push_back ( topLeft + gridSize + 1 );
+			}
+		}
+	}
+	//End BuildGrid
+
+
+	//=========================================================================
+    //! @function    GenerateNormalsPerVertexScan
+    //! @brief       The old Mesh::GenerateNormals, which scans every triangle
+	//!				 for every vertex and ignores smoothing groups
+    //=========================================================================
+	void GenerateNormalsPerVertexScan ( const std::vector<Math::Vector3D>& positions, 
+										const std::vector<UInt>& indices, 
+										std::vector<Math::Vector3D>& normals )
+	{
+		const UInt triangleCount = indices.size() / 3;
+		std::vector<Math::Vector3D> faceNormals ( triangleCount );
+
+		for ( UInt triangle = 0; triangle < triangleCount; ++triangle )
+		{
+			Math::Vector3D v0v1 = positions[indices[(triangle * 3) + 1]] - positions[indices[triangle * 3]];
+			Math::Vector3D v0v2 = positions[indices[(triangle * 3) + 2]] - positions[indices[triangle * 3]];
+
+			Math::Vector3D::CrossProduct ( v0v1, v0v2, faceNormals[triangle] );
+			faceNormals[triangle].Normalise();
+		}
+
+		normals.assign ( positions.size(), Math::Vector3D() );
+
+		for ( UInt vertex = 0; vertex < positions.size(); ++vertex )
+		{
+			UInt vertexUsageCount = 0;
+
+			for ( UInt triangle = 0; triangle < triangleCount; ++triangle )
+			{
+				if (	( indices[triangle * 3] == vertex )
+					||  ( indices[(triangle * 3) + 1] == vertex )
+					||  ( indices[(triangle * 3) + 2] == vertex ) )
+				{
+					++vertexUsageCount;
+					normals[vertex] += faceNormals[triangle];
+				}
+			}
+
+			normals[vertex] /= vertexUsageCount;
+			normals[vertex].Normalise();
+		}
+	}
+	//End GenerateNormalsPerVertexScan
+
+}
+//end namespace
+
+
+
+//=========================================================================
+//! @function    BenchmarkMeshNormals
+//! @brief       Compare the old per vertex triangle scan with Math::VertexNormalGenerator,
+//!				 check that they agree for a single smoothing group, and check
+//!				 that vertices are split between smoothing groups
+//=========================================================================
+void BenchmarkMeshNormals()
+{
+
+	std::vector<Math::Vector3D> positions;
+	std::vector<UInt>			gridIndices;
+
+	BuildGrid ( positions, gridIndices );
+
+	const UInt vertexCount = positions.size();
+	const UInt triangleCount = gridIndices.size() / 3;
+
+	std::cout << "Mesh normals benchmark, " << vertexCount << " vertices, " << triangleCount << " triangles" << std::endl;
+	std::cout << "=================================================" << std::endl;
+
+	Core::Timer timer;
+	std::vector<Math::Vector3D> oldNormals;
+	std::vector<UInt>			indices;
+	std::vector<UInt>			smoothingGroups ( triangleCount, 1 );
+	Math::VertexNormalGenerator generator;
+
+	timer.Update();
+	for ( UInt i = 0; i < oldIterations; ++i )
+	{
+		GenerateNormalsPerVertexScan ( positions, gridIndices, oldNormals );
+	}
+	ReportTime ( "Per vertex triangle scan", timer.Update(), oldIterations );
+
+	for ( UInt i = 0; i < newIterations; ++i )
+	{
+		indices = gridIndices;
+		generator.Generate ( &positions[0], vertexCount, &indices[0], &smoothingGroups[0], triangleCount );
+	}
+	ReportTime ( "VertexNormalGenerator, one group", timer.Update(), newIterations );
+
+	debug_assert ( generator.VertexCount() == vertexCount, "Test failed! Vertices were split within one smoothing group" );
+	debug_assert ( indices == gridIndices, "Test failed! Indices changed within one smoothing group" );
+
+	for ( UInt vertex = 0; vertex < vertexCount; ++vertex )
+	{
+		Math::Vector3D difference = oldNormals[vertex] - generator.VertexNormal(vertex);
+		debug_assert ( difference.Length() < 0.001f, "Test failed! Normals differ from the old generator" );
+	}
+
+	//Split the grid down the middle into two groups. The middle column of vertices is shared by both
+	for ( UInt triangle = 0; triangle < triangleCount; ++triangle )
+	{
+		UInt col = (triangle / 2) % (gridSize - 1);
+		smoothingGroups[triangle] = (col < (gridSize / 2)) ? 1 : 2;
+	}
+
+	for ( UInt i = 0; i < newIterations; ++i )
+	{
+		indices = gridIndices;
+		generator.Generate ( &positions[0], vertexCount, &indices[0], &smoothingGroups[0], triangleCount );
+	}
+	ReportTime ( "VertexNormalGenerator, two groups", timer.Update(), newIterations );
+
+	debug_assert ( generator.VertexCount() == (vertexCount + gridSize), "Test failed! Middle column wasn't split" );
+
+	for ( UInt vertex = vertexCount; vertex < generator.VertexCount(); ++vertex )
+	{
+		debug_assert ( (generator.SourceVertex(vertex) % gridSize) == (gridSize / 2), "Test failed! Wrong vertex was split" );
+	}
+
+	//Group 0 isn't smoothed, so every corner gets its own vertex
+	smoothingGroups.assign ( triangleCount, 0 );
+	indices = gridIndices;
+	generator.Generate ( &positions[0], vertexCount, &indices[0], &smoothingGroups[0], triangleCount );
+
+	debug_assert ( generator.VertexCount() == (triangleCount * 3), "Test failed! Group 0 corners share vertices" );
+
+	for ( UInt corner = 0; corner < indices.size(); ++corner )
+	{
+		Math::Vector3D difference = generator.VertexNormal(indices[corner]) - generator.FaceNormal(corner / 3);
+		debug_assert ( difference.Length() < 0.001f, "Test failed! Group 0 normal isn't the face normal" );
+	}
+
+	std::cout << std::endl;
+}
+//End BenchmarkMeshNormals
@@ -0,0 +1,46 @@
+//======================================================================================
+//! @file         BenchmarkUtility.cpp
+//! @brief        Helpers shared by the benchmarks
+//!               
+//!               
+//!               
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+#include <iostream>
+#include <iomanip>
+#include "Core/Core.h"
+#include "Core/Timer.h"
+#include "BenchmarkUtility.h"
+
+
+
+//=========================================================================
+//! @function    ReportTime
+//! @brief       Print the time per iteration of a benchmark
+//=========================================================================
+void ReportTime ( const Char* name, Core::TimerValue seconds, UInt iterations )
+{
+	std::cout << std::setw(40) << std::left << name << ": " 
+			  << std::setprecision(4) << ((seconds * 1000.0) / iterations) << " ms" << std::endl;
+}
+//End ReportTime
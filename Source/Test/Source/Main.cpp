@@ -35,6 +35,10 @@
 #include "Math/Vector3D.h"
 #include "Math/Quaternion.h"
 #include "TestMath.h"
+#include "BenchmarkHeightMap.h"
+#include "BenchmarkMeshNormals.h"
+#include "BenchmarkMatrix.h"
+#include "TestEntityIndex.h"
 
 int main ( int argc, char* argv[])
 {
@@ -53,6 +57,11 @@ int main ( int argc, char* argv[])
 	temp *= q0;
 
 	std::clog << vecResult << "     " << temp << std::endl;
+
+	BenchmarkHeightMap();
+	BenchmarkMeshNormals();
+	BenchmarkMatrix();
+	TestEntityIndex();
 	
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,454 @@
+//======================================================================================
+//! @file         TestEntityIndex.cpp
+//! @brief        Checks the entity index queries against a linear scan
+//!               
+//!               Entities are inserted, moved and removed at random, and the results
+//!               of each query type are compared with a scan over every live entity
+//! @author       Bryan Robertson
+//! @date         Friday, 16 October 2026
+//! @copyright    Bryan Robertson 2005
+//
+//				  This file is part of OidFX Engine.
+//
+//  			  OidFX Engine is free software; you can redistribute it and/or modify
+//  			  it under the terms of the GNU General Public License as published by
+//  			  the Free Software Foundation; either version 2 of the License, or
+//  			  (at your option) any later version.
+//
+//  			  OidFX Engine is distributed in the hope that it will be useful,
+//  			  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  			  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  			  GNU General Public License for more details.
+//
+//  			  You should have received a copy of the GNU General Public License
+//  			  along with OidFX Engine; if not, write to the Free Software
+//  			  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+//======================================================================================
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include "Core/Core.h"
+#include "Math/Math.h"
+#include "Math/Vector3D.h"
+#include "Math/BoundingBox3D.h"
+#include "Math/BoundingSphere3D.h"
+#include "Math/ParametricLine3D.h"
+#include "OidFX/EntityIndex.h"
+#include "TestEntityIndex.h"
+
+
+//namespace
+namespace
+{
+
+	using OidFX::EntityNode;
+	using OidFX::EntityIndex;
+	using OidFX::EntityFlagSet;
+	using OidFX::EntityQueryFilter;
+	using OidFX::EntityQueryResult;
+
+	const UInt	entityCount = 500;
+	const UInt	steps = 2000;
+	const UInt	queriesPerStep = 4;
+	const UInt	bucketCount = 61;
+	const Float	worldSize = 400.0f;
+	const Float	firstCellSize = 16.0f;
+	const Float	secondCellSize = 40.0f;
+
+
+	//!@struct	TestEntity
+	//!@brief	Stands in for an entity. The index never dereferences its 
+	//!			entity pointers, so the address of one of these is used instead
+	struct TestEntity
+	{
+		EntityFlagSet					flags;
+		Math::AxisAlignedBoundingBox	box;
+		Float							centre[3];
+		Float							halfExtent[3];
+		Float							radius;
+		UInt							slot;
+		bool							inIndex;
+	};
+
+	typedef std::vector<TestEntity> TestEntityStore;
+
+
+	//=========================================================================
+    //! @function    AsEntity
+    //! @brief       Get the entity pointer a test entity is stored in the index under
+    //=========================================================================
+	EntityNode* AsEntity ( TestEntity& entity )
+	{
+		return reinterpret_cast<EntityNode*>(&entity);
+	}
+	//End AsEntity
+
+
+	//=========================================================================
+    //! @function    RandomPosition
+    //! @brief       Get a random position in the world
+    //=========================================================================
+	Math::Vector3D RandomPosition ( )
+	{
+		const Float half = worldSize * 0.5f;
+
+		return Math::Vector3D ( Math::RandomFloat(-half, half), 
+								Math::RandomFloat(-half, half), 
+								Math::RandomFloat(-half, half) );
+	}
+	//End RandomPosition
+
+
+	//=========================================================================
+    //! @function    MoveEntity
+    //! @brief       Give an entity a random size and position, and work out its
+    //!				 bounds the same way EntityIndex does
+    //=========================================================================
+	void MoveEntity ( TestEntity& entity )
+	{
+		//One entity in ten is too big for a cell of either size, so it goes in the oversized bucket
+		const Float maxHalfSize = ( Math::RandomUInt(0, 9) == 0 ) ? 60.0f : 4.0f;
+
+		const Math::Vector3D centre = RandomPosition();
+		const Math::Vector3D halfSize ( Math::RandomFloat(0.1f, maxHalfSize), 
+										Math::RandomFloat(0.1f, maxHalfSize), 
+										Math::RandomFloat(0.1f, maxHalfSize) );
+
+		entity.box = Math::AxisAlignedBoundingBox ( centre - halfSize, centre + halfSize );
+
+		const Math::Vector3D boxCentre = entity.box.GetCentre();
+
+		entity.centre[0] = boxCentre.X();
+		entity.centre[1] = boxCentre.Y();
+		entity.centre[2] = boxCentre.Z();
+
+		entity.halfExtent[0] = entity.box.ExtentX() * 0.5f;
+		entity.halfExtent[1] = entity.box.ExtentY() * 0.5f;
+		entity.halfExtent[2] = entity.box.ExtentZ() * 0.5f;
+
+		entity.radius = Math::Sqrt ( (entity.halfExtent[0] * entity.halfExtent[0]) 
+								   + (entity.halfExtent[1] * entity.halfExtent[1]) 
+								   + (entity.halfExtent[2] * entity.halfExtent[2]) );
+	}
+	//End MoveEntity
+
+
+	//=========================================================================
+    //! @function    RandomFlags
+    //! @brief       Give an entity a random mix of the flags the queries filter on
+    //=========================================================================
+	void RandomFlags ( TestEntity& entity )
+	{
+		entity.flags.reset();
+		entity.flags[OidFX::EF_ENEMY] = ( Math::RandomUInt(0, 1) == 0 );
+		entity.flags[OidFX::EF_ALLY] = ( Math::RandomUInt(0, 3) == 0 );
+		entity.flags[OidFX::EF_PROJECTILE] = ( Math::RandomUInt(0, 3) == 0 );
+		entity.flags[OidFX::EF_DEAD] = ( Math::RandomUInt(0, 7) == 0 );
+	}
+	//End RandomFlags
+
+
+	//=========================================================================
+    //! @function    RandomFilter
+    //! @brief       Make one of a few filters like the game uses
+    //=========================================================================
+	EntityQueryFilter RandomFilter ( )
+	{
+		EntityQueryFilter filter;
+
+		switch ( Math::RandomUInt(0, 2) )
+		{
+			case 0:
+				break;
+
+			case 1:
+				filter.AnyOf ( OidFX::EF_ENEMY ).NoneOf ( OidFX::EF_PROJECTILE );
+				break;
+
+			default:
+				filter.AnyOf ( OidFX::EF_ENEMY ).AnyOf ( OidFX::EF_ALLY );
+				break;
+		}
+
+		return filter;
+	}
+	//End RandomFilter
+
+
+	//=========================================================================
+    //! @function    RayHitsBox
+    //! @brief       Slab test of a line segment against a test entity's box
+    //=========================================================================
+	bool RayHitsBox ( const Float origin[3], const Float direction[3], const TestEntity& entity )
+	{
+		Float tEnter = 0.0f;
+		Float tExit = 1.0f;
+
+		for ( UInt axis = 0; axis < 3; ++axis )
+		{
+			const Float boxMin = entity.centre[axis] - entity.halfExtent[axis];
+			const Float boxMax = entity.centre[axis] + entity.halfExtent[axis];
+
+			if ( Math::Abs(direction[axis]) < Math::EpsilonE6 )
+			{
+				if ( (origin[axis] < boxMin) || (origin[axis] > boxMax) )
+				{
+					return false;
+				}
+
+				continue;
+			}
+
+			const Float inverseDirection = 1.0f / direction[axis];
+			Float tNear = (boxMin - origin[axis]) * inverseDirection;
+			Float tFar  = (boxMax - origin[axis]) * inverseDirection;
+
+			if ( tNear > tFar )
+			{
+				std::swap ( tNear, tFar );
+			}
+
+			tEnter = std::max ( tEnter, tNear );
+			tExit  = std::min ( tExit, tFar );
+
+			if ( tEnter > tExit )
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+	//End RayHitsBox
+
+
+	//=========================================================================
+    //! @function    DistanceSquared
+    //! @brief       Squared distance from a point to the centre of a test entity
+    //=========================================================================
+	Float DistanceSquared ( const Float point[3], const TestEntity& entity )
+	{
+		const Float dx = entity.centre[0] - point[0];
+		const Float dy = entity.centre[1] - point[1];
+		const Float dz = entity.centre[2] - point[2];
+
+		return (dx * dx) + (dy * dy) + (dz * dz);
+	}
+	//End DistanceSquared
+
+
+	//=========================================================================
+    //! @function    CheckSameEntities
+    //! @brief       Check that two query results hold the same entities, in any order
+    //=========================================================================
+	void CheckSameEntities ( EntityQueryResult indexResult, EntityQueryResult scanResult, const Char* query )
+	{
+		std::sort ( indexResult.begin(), indexResult.end() );
+		std::sort ( scanResult.begin(), scanResult.end() );
+
+		if ( indexResult != scanResult )
+		{
+			std::cout << query << " query returned " << static_cast<UInt>(indexResult.size()) 
+					  << " entities, the scan found " << static_cast<UInt>(scanResult.size()) << std::endl;
+		}
+
+		debug_assert ( indexResult == scanResult, "Test failed! Entity index query differs from the scan" );
+	}
+	//End CheckSameEntities
+
+
+	//=========================================================================
+    //! @function    CheckQueries
+    //! @brief       Run each type of query at random, and check the index 
+    //!				 against a scan over every live entity
+    //=========================================================================
+	void CheckQueries ( EntityIndex& index, TestEntityStore& entities )
+	{
+		const EntityQueryFilter filter = RandomFilter();
+		const Math::Vector3D position = RandomPosition();
+		const Float point[3] = { position.X(), position.Y(), position.Z() };
+
+		//Small queries visit a few cells, large ones visit every bucket
+		const Float radius = ( Math::RandomUInt(0, 3) == 0 ) ? Math::RandomFloat(100.0f, 300.0f) 
+															 : Math::RandomFloat(1.0f, 30.0f);
+
+		EntityQueryResult indexResult;
+		EntityQueryResult scanResult;
+
+		//Sphere
+		index.Query ( Math::BoundingSphere3D(radius, position), filter, indexResult );
+
+		for ( TestEntityStore::iterator itr = entities.begin(); itr != entities.end(); ++itr )
+		{
+			const Float reach = itr->radius + radius;
+
+			if ( itr->inIndex && (DistanceSquared(point, *itr) <= (reach * reach)) && filter.Accepts(itr->flags) )
+			{
+				scanResult.push_back ( AsEntity(*itr) );
+			}
+		}
+
+		CheckSameEntities ( indexResult, scanResult, "Sphere" );
+
+		//Box
+		const Math::Vector3D halfSize ( radius, radius * 0.5f, radius * 0.25f );
+		const Math::AxisAlignedBoundingBox box ( position - halfSize, position + halfSize );
+		const Math::Vector3D boxMin = box.GetCorner( Math::AxisAlignedBoundingBox::MIN_X_MIN_Y_MIN_Z );
+		const Math::Vector3D boxMax = box.GetCorner( Math::AxisAlignedBoundingBox::MAX_X_MAX_Y_MAX_Z );
+
+		indexResult.clear();
+		scanResult.clear();
+		index.Query ( box, filter, indexResult );
+
+		for ( TestEntityStore::iterator itr = entities.begin(); itr != entities.end(); ++itr )
+		{
+			if (   itr->inIndex
+				&& (itr->centre[0] + itr->halfExtent[0] >= boxMin.X()) && (itr->centre[0] - itr->halfExtent[0] <= boxMax.X())
+				&& (itr->centre[1] + itr->halfExtent[1] >= boxMin.Y()) && (itr->centre[1] - itr->halfExtent[1] <= boxMax.Y())
+				&& (itr->centre[2] + itr->halfExtent[2] >= boxMin.Z()) && (itr->centre[2] - itr->halfExtent[2] <= boxMax.Z())
+				&& filter.Accepts(itr->flags) )
+			{
+				scanResult.push_back ( AsEntity(*itr) );
+			}
+		}
+
+		CheckSameEntities ( indexResult, scanResult, "Box" );
+
+		//Ray, from the query position to another random point
+		const Math::Vector3D end = RandomPosition();
+		const Float origin[3] = { position.X(), position.Y(), position.Z() };
+		const Float direction[3] = { end.X() - origin[0], end.Y() - origin[1], end.Z() - origin[2] };
+
+		indexResult.clear();
+		scanResult.clear();
+		index.Query ( Math::ParametricLine3D(position, end), true, filter, indexResult );
+
+		for ( TestEntityStore::iterator itr = entities.begin(); itr != entities.end(); ++itr )
+		{
+			if ( itr->inIndex && RayHitsBox(origin, direction, *itr) && filter.Accepts(itr->flags) )
+			{
+				scanResult.push_back ( AsEntity(*itr) );
+			}
+		}
+
+		CheckSameEntities ( indexResult, scanResult, "Ray" );
+
+		//Nearest. Entities at the same distance may come back in either order, 
+		//so compare the distances rather than the entities
+		const UInt count = Math::RandomUInt(1, 10);
+
+		indexResult.clear();
+		index.QueryNearest ( position, count, radius, filter, indexResult );
+
+		std::vector<Float> scanDistances;
+
+		for ( TestEntityStore::iterator itr = entities.begin(); itr != entities.end(); ++itr )
+		{
+			const Float reach = itr->radius + radius;
+			const Float distanceSquared = DistanceSquared(point, *itr);
+
+			if ( itr->inIndex && (distanceSquared <= (reach * reach)) && filter.Accepts(itr->flags) )
+			{
+				scanDistances.push_back ( distanceSquared );
+			}
+		}
+
+		std::sort ( scanDistances.begin(), scanDistances.end() );
+		scanDistances.resize ( std::min(count, static_cast<UInt>(scanDistances.size())) );
+
+		debug_assert ( indexResult.size() == scanDistances.size(), "Test failed! Nearest query returned the wrong number of entities" );
+
+		for ( UInt i = 0; i < indexResult.size(); ++i )
+		{
+			const TestEntity& entity = *reinterpret_cast<TestEntity*>(indexResult[i]);
+			debug_assert ( DistanceSquared(point, entity) == scanDistances[i], "Test failed! Nearest query returned the wrong entity" );
+		}
+	}
+	//End CheckQueries
+
+}
+//end namespace
+
+
+
+//=========================================================================
+//! @function    TestEntityIndex
+//! @brief       Insert, move and remove entities at random, checking the 
+//!				 sphere, box, ray and nearest queries as it goes. Halfway
+//!				 through, the cell size is changed
+//=========================================================================
+void TestEntityIndex()
+{
+	std::cout << "Entity index test, " << entityCount << " entities, " << steps << " steps" << std::endl;
+	std::cout << "=================================================" << std::endl;
+
+	//Always test the same sequence, so failures can be reproduced
+	Math::SRand ( 1234 );
+
+	EntityIndex index ( firstCellSize, bucketCount );
+
+	//The index holds pointers to the entities, so the store mustn't reallocate
+	TestEntityStore entities ( entityCount );
+	UInt liveCount = 0;
+
+	for ( TestEntityStore::iterator itr = entities.begin(); itr != entities.end(); ++itr )
+	{
+		itr->inIndex = false;
+		itr->slot = EntityIndex::InvalidSlot;
+	}
+
+	for ( UInt step = 0; step < steps; ++step )
+	{
+		if ( step == (steps / 2) )
+		{
+			index.SetCellSize ( secondCellSize );
+		}
+
+		//Most steps move a handful of entities, the rest add or remove one
+		for ( UInt change = 0; change < 8; ++change )
+		{
+			TestEntity& entity = entities[Math::RandomUInt(0, entityCount - 1)];
+
+			if ( !entity.inIndex )
+			{
+				MoveEntity ( entity );
+				RandomFlags ( entity );
+				entity.slot = index.Insert ( AsEntity(entity), entity.flags, entity.box );
+				entity.inIndex = true;
+				++liveCount;
+			}
+			else if ( Math::RandomUInt(0, 9) == 0 )
+			{
+				index.Remove ( entity.slot );
+				entity.slot = EntityIndex::InvalidSlot;
+				entity.inIndex = false;
+				--liveCount;
+			}
+			else
+			{
+				MoveEntity ( entity );
+
+				//Flags are read through the pointer given to Insert, so they can change at any time
+				if ( Math::RandomUInt(0, 9) == 0 )
+				{
+					RandomFlags ( entity );
+				}
+
+				index.Update ( entity.slot, entity.box );
+			}
+		}
+
+		debug_assert ( index.EntityCount() == liveCount, "Test failed! Entity index count is wrong" );
+
+		for ( UInt query = 0; query < queriesPerStep; ++query )
+		{
+			CheckQueries ( index, entities );
+		}
+	}
+
+	std::cout << "Entity index queries match the scan" << std::endl;
+	std::cout << std::endl;
+}
+//End TestEntityIndex